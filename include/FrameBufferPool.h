@@ -0,0 +1,124 @@
+/*!
+ * FrameBufferPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_FRAMEBUFFERPOOL_H_
+#define INCLUDE_FRAMEBUFFERPOOL_H_
+
+#include <queue>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "SharedFrameRing.h"
+#include "SharedBufferManager.h"
+
+namespace FrameReceiver
+{
+    //! Callback to initialise a newly assigned frame buffer, returning the frame header address
+    typedef boost::function<void*(int)> FrameBufferInitialiser;
+
+    //! FrameBufferSlot - entry in the in-flight frame table mapping a frame to its buffer
+    struct FrameBufferSlot
+    {
+        uint32_t frame_number;  //!< Frame number tag
+        int      buffer_id;     //!< ID of the buffer assigned to the frame, -1 if the slot is empty
+        void*    frame_header;  //!< Address of the frame header in the buffer
+    };
+
+    //! FrameBufferPool - thread-safe assignment of frame buffers to incoming frames
+    //!
+    //! This class holds the queue of empty frame buffers and the table of frames in flight,
+    //! i.e. buffers currently being filled. It may be shared between the frame decoders of
+    //! several RX threads so that packets of one frame arriving on different threads are
+    //! received into the same buffer.
+    //!
+    //! The in-flight frame table is a cache-line aligned array of slots indexed by frame number
+    //! modulo the table capacity, with collisions resolved by linear probing. The capacity is a
+    //! power of two of at least twice the number of buffers, fixed when the pool is set up for a
+    //! shared buffer, so the table never fills and lookups of the few frames in flight touch one
+    //! or two cache lines without any allocation or rehashing on the receive path.
+    //!
+    //! Empty buffers may also be returned through a shared frame release ring, which the pool
+    //! drains under its lock so that it is the single consumer of the ring. Drained buffers are
+    //! marked free in the shared buffer descriptor table, if a buffer manager is registered
+    //! with the ring, so that a buffer is only shown as free once it is back in the pool.
+    //!
+    //! If the shared buffer has several size classes, the size class of each buffer is
+    //! registered with the pool, which then keeps a separate empty buffer queue for each class.
+    //! A frame is assigned a buffer of the class requested by the decoder, or of the next
+    //! larger class with an empty buffer if that class is exhausted.
+    //!
+    //! Spill buffers in a file, if registered, are queued separately and only assigned to
+    //! frames once every buffer in memory is in use.
+
+    class FrameBufferPool
+    {
+    public:
+
+        FrameBufferPool();
+        ~FrameBufferPool();
+
+        void register_decoder(void);
+        void size_frame_table(size_t num_buffers);
+        const bool is_shared(void) const;
+
+        void register_size_classes(const std::vector<unsigned int>& buffer_size_classes);
+        const unsigned int get_num_size_classes(void) const;
+        void register_spill_buffers(int first_spill_buffer);
+
+        void push_empty_buffer(int buffer_id);
+        void register_release_ring(SharedFrameRingPtr release_ring,
+                SharedBufferManagerPtr buffer_manager=SharedBufferManagerPtr());
+        size_t drain_release_ring(void);
+        const size_t get_num_empty_buffers(void) const;
+        const size_t get_num_empty_buffers(unsigned int size_class) const;
+        const size_t get_num_empty_spill_buffers(void) const;
+        const size_t get_num_mapped_buffers(void) const;
+
+        const size_t get_frame_table_capacity(void) const;
+
+        int get_frame_buffer(uint32_t frame_number, const FrameBufferInitialiser& initialiser,
+                void** frame_header=0, unsigned int size_class=0);
+        bool release_frame_buffer(uint32_t frame_number);
+        void get_mapped_frames(std::vector<FrameBufferSlot>& mapped_frames) const;
+
+    private:
+
+        FrameBufferPool(const FrameBufferPool&);
+        FrameBufferPool& operator=(const FrameBufferPool&);
+
+        void push_empty_buffer_locked(int buffer_id);
+        void requeue_empty_buffers_locked(std::vector<std::queue<int> >& queued_buffers);
+        size_t drain_release_ring_locked(void);
+        size_t find_frame_slot(uint32_t frame_number) const;
+        void allocate_frame_table(size_t capacity);
+
+        mutable boost::mutex    mutex_;
+        std::vector<std::queue<int> > empty_buffer_queues_;
+        std::vector<unsigned int>     buffer_size_classes_;
+        std::queue<int>               spill_buffer_queue_;
+        int                           first_spill_buffer_;
+        size_t                        num_empty_buffers_;
+        SharedFrameRingPtr      release_ring_;
+        SharedBufferManagerPtr  release_buffer_manager_;
+        FrameBufferSlot*        frame_table_;
+        size_t                  frame_table_capacity_;
+        size_t                  frame_table_mask_;
+        size_t                  num_mapped_frames_;
+        unsigned int            num_decoders_;
+    };
+
+    typedef boost::shared_ptr<FrameBufferPool> FrameBufferPoolPtr;
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_FRAMEBUFFERPOOL_H_ */
@@ -0,0 +1,78 @@
+/*!
+ * FrameConsumerTracker.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_FRAMECONSUMERTRACKER_H_
+#define INCLUDE_FRAMECONSUMERTRACKER_H_
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "SharedBufferManager.h"
+
+namespace FrameReceiver
+{
+    //! FrameConsumerTracker - reference counting of frames shared by several downstream consumers
+    //!
+    //! This class allows each frame ready notification to be consumed by several downstream
+    //! processes, e.g. a file writer, a live view and a monitor, reading the frame directly
+    //! from the shared buffer. When a frame becomes ready, the reference count of its buffer in
+    //! the shared buffer descriptor table is set to the number of active consumers, and each
+    //! consumer's release decrements it. The buffer is only returned to the frame decoder once
+    //! every consumer has released it.
+    //!
+    //! The buffers held by each consumer are tracked so that its lag, i.e. the number of frames
+    //! notified but not yet released, is known. A consumer whose lag exceeds the maximum is
+    //! dropped: its references are released and it is no longer counted for subsequent frames,
+    //! so a slow consumer cannot starve the frame decoder of buffers. Releases from dropped
+    //! consumers are ignored. The tracker is not thread safe and is owned by the thread handling
+    //! frame releases, i.e. the main thread, or the RX thread when it notifies frames directly.
+
+    class FrameConsumerTracker
+    {
+    public:
+
+        FrameConsumerTracker(SharedBufferManagerPtr buffer_manager, unsigned int num_consumers,
+                unsigned int max_lag=0);
+
+        unsigned int frame_ready(int buffer_id, std::vector<int>& free_buffers);
+        bool frame_released(int buffer_id, unsigned int consumer_id, std::vector<int>& free_buffers);
+        void drop_consumer(unsigned int consumer_id, std::vector<int>& free_buffers);
+
+        const unsigned int get_num_consumers(void) const;
+        const unsigned int get_num_active_consumers(void) const;
+        const bool is_consumer_active(unsigned int consumer_id) const;
+        const unsigned int get_consumer_lag(unsigned int consumer_id) const;
+        const uint64_t get_consumer_releases(unsigned int consumer_id) const;
+
+    private:
+
+        struct Consumer
+        {
+            bool              active;    //!< Consumer is counted for new frames
+            std::vector<bool> held;      //!< Buffers holding frames not yet released, indexed by buffer ID
+            unsigned int      lag;       //!< Number of buffers held
+            uint64_t          releases;  //!< Number of frames released
+        };
+
+        const Consumer& get_consumer(unsigned int consumer_id) const;
+        void release_reference(int buffer_id, std::vector<int>& free_buffers);
+
+        SharedBufferManagerPtr buffer_manager_;
+        std::vector<Consumer>  consumers_;
+        unsigned int           num_active_consumers_;
+        unsigned int           max_lag_;
+    };
+
+    typedef boost::shared_ptr<FrameConsumerTracker> FrameConsumerTrackerPtr;
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_FRAMECONSUMERTRACKER_H_ */
@@ -8,12 +8,10 @@
 #ifndef INCLUDE_FRAMEDECODER_H_
 #define INCLUDE_FRAMEDECODER_H_
 
-#include <queue>
-#include <map>
-
 #include <stddef.h>
 #include <stdint.h>
 #include <netinet/in.h>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
@@ -25,6 +23,7 @@ using namespace log4cxx::helpers;
 
 #include "FrameReceiverException.h"
 #include "SharedBufferManager.h"
+#include "FrameBufferPool.h"
 
 namespace FrameReceiver
 {
@@ -34,7 +33,9 @@ namespace FrameReceiver
         FrameDecoderException(const std::string what) : FrameReceiverException(what) { };
     };
 
-    typedef boost::function<void(int, int)> FrameReadyCallback;
+    //! Function signature for notifying a frame that is ready, called with the buffer ID, frame number,
+    //! FrameDecoder::FrameReceiveState of the frame and time the frame started in ns since the epoch
+    typedef boost::function<void(int, int, int, uint64_t)> FrameReadyCallback;
 
     class FrameDecoder
     {
@@ -49,12 +50,23 @@ namespace FrameReceiver
 			FrameReceiveStateError
         };
 
+        //! Packet receive modes supported by decoders
+        enum PacketReceiveMode
+        {
+            PacketReceiveModeHeaderPeek,  //!< Peek each packet header to determine the payload destination
+            PacketReceiveModeSpeculative  //!< Receive into predicted destinations and relocate after decoding
+        };
+
         FrameDecoder(LoggerPtr& logger, bool enable_packet_logging) :
             logger_(logger),
-            enable_packet_logging_(enable_packet_logging)
+            enable_packet_logging_(enable_packet_logging),
+            buffer_pool_(new FrameBufferPool())
         {
             // Retrieve the packet logger instance
             packet_logger_ = Logger::getLogger("FR.PacketLogger");
+
+            // Register with the default, private, frame buffer pool
+            buffer_pool_->register_decoder();
         };
 
         virtual ~FrameDecoder() = 0;
@@ -62,6 +74,21 @@ namespace FrameReceiver
         void register_buffer_manager(SharedBufferManagerPtr buffer_manager)
         {
             buffer_manager_ = buffer_manager;
+
+            // Size the frame table of the pool once for every buffer in the shared buffer
+            buffer_pool_->size_frame_table(buffer_manager_->get_num_buffers());
+        }
+
+        //! Register a frame buffer pool, allowing the pool to be shared with other decoders
+        void register_buffer_pool(FrameBufferPoolPtr buffer_pool)
+        {
+            buffer_pool_ = buffer_pool;
+            buffer_pool_->register_decoder();
+        }
+
+        FrameBufferPoolPtr get_buffer_pool(void)
+        {
+            return buffer_pool_;
         }
 
         void register_frame_ready_callback(FrameReadyCallback callback)
@@ -72,7 +99,17 @@ namespace FrameReceiver
         virtual const size_t get_frame_buffer_size(void) const = 0;
         virtual const size_t get_frame_header_size(void) const = 0;
 
-        virtual const bool requires_header_peek(void) const = 0;
+        //! Get the buffer sizes required by the frames this decoder produces, largest first.
+        //!
+        //! Decoders producing frames of varying size, e.g. in different readout modes, return
+        //! each size so that the shared buffer holds a size class for each, and request the
+        //! class of each frame from the buffer pool. By default only full size frames are produced.
+        virtual void get_frame_buffer_sizes(std::vector<size_t>& buffer_sizes) const
+        {
+            buffer_sizes.assign(1, get_frame_buffer_size());
+        };
+
+        virtual const PacketReceiveMode get_packet_receive_mode(void) const = 0;
 
         virtual const size_t get_packet_header_size(void) const = 0;
         virtual void* get_packet_header_buffer(void) = 0;
@@ -82,24 +119,61 @@ namespace FrameReceiver
         virtual size_t get_next_payload_size(void) const = 0;
         virtual FrameReceiveState process_packet(size_t bytes_received) = 0;
 
+        //! Allocate speculative receive resources for batches of up to max_batch_packets packets
+        virtual void init_batch_receive(size_t max_batch_packets)
+        {
+            throw FrameDecoderException("Speculative receive is not supported by this frame decoder");
+        };
+
+        //! Prepare header and payload destinations for the next batch of num_packets packets
+        virtual void prepare_batch_receive(size_t num_packets)
+        {
+            throw FrameDecoderException("Speculative receive is not supported by this frame decoder");
+        };
+
+        virtual void* get_batch_header_buffer(size_t packet_idx) { return 0; };
+        virtual void* get_batch_payload_buffer(size_t packet_idx) { return 0; };
+        virtual size_t get_batch_payload_size(size_t packet_idx) const { return 0; };
+
+        //! Process a packet received into the prepared batch slot packet_idx
+        virtual FrameReceiveState process_batch_packet(size_t packet_idx, size_t bytes_received,
+                int port, struct sockaddr_in* from_addr)
+        {
+            throw FrameDecoderException("Speculative receive is not supported by this frame decoder");
+        };
+
+        //! Release incomplete frames whose timeout has expired, called frequently by the RX thread
+        virtual void expire_frames(void) { };
+
         virtual void monitor_buffers(void) = 0;
 
         void push_empty_buffer(int buffer_id)
         {
-        	empty_buffer_queue_.push(buffer_id);
+            if (buffer_manager_)
+            {
+                buffer_manager_->set_buffer_state(buffer_id, BufferStateFree);
+            }
+        	buffer_pool_->push_empty_buffer(buffer_id);
         }
 
         const size_t get_num_empty_buffers(void) const
         {
-        	return empty_buffer_queue_.size();
+        	return buffer_pool_->get_num_empty_buffers();
         }
 
         const size_t get_num_mapped_buffers(void) const
         {
-            return frame_buffer_map_.size();
+            return buffer_pool_->get_num_mapped_buffers();
         }
 
     protected:
+
+        //! Get the size class of the smallest buffers able to hold a frame of the given size
+        const unsigned int get_frame_size_class(size_t frame_size) const
+        {
+            return buffer_manager_ ? buffer_manager_->find_size_class(frame_size) : 0;
+        }
+
         LoggerPtr logger_;
 
         bool enable_packet_logging_;
@@ -108,8 +182,7 @@ namespace FrameReceiver
         SharedBufferManagerPtr buffer_manager_;
         FrameReadyCallback   ready_callback_;
 
-        std::queue<int>    empty_buffer_queue_;
-        std::map<uint32_t, int> frame_buffer_map_;
+        FrameBufferPoolPtr buffer_pool_;
     };
 
     inline FrameDecoder::~FrameDecoder() {};
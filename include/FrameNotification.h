@@ -0,0 +1,85 @@
+/*!
+ * FrameNotification.h - Frame Receiver compact binary frame notification format class
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef FRAMENOTIFICATION_H_
+#define FRAMENOTIFICATION_H_
+
+#include <string>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IpcMessage.h"
+
+namespace FrameReceiver
+{
+
+    //! FrameNotification - compact binary frame ready and release notification
+    //!
+    //! This class implements a fixed-size binary alternative to the IpcMessage JSON format for
+    //! the frame ready and release notifications sent on every frame. The encoded notification
+    //! is a packed little-endian structure starting with a magic word and version, so it can be
+    //! distinguished from a JSON message on the same channel by is_binary(). Encoding and
+    //! decoding copy a few fields, avoiding the JSON document construction, timestamp
+    //! formatting and parsing of an IpcMessage.
+    //!
+    //! The format used on a channel is chosen by the sender. Receivers accept either format
+    //! and reply to a frame ready notification in the format in which it was received, so the
+    //! release channel follows the format of the ready channel.
+
+    class FrameNotification
+    {
+    public:
+
+        //! Magic word at the start of an encoded notification, "FRNT" in little-endian byte order
+        static const uint32_t magic = 0x544e5246;
+
+        //! Version of the encoded notification format
+        static const uint16_t version = 1;
+
+        //! Flag set in the frame state of a frame held in a spill buffer rather than in memory
+        static const uint32_t frame_state_spilled = 0x80000000;
+
+        //! Packed layout of an encoded notification
+        struct Encoded
+        {
+            uint32_t magic;                //!< Magic word identifying a binary notification
+            uint16_t version;              //!< Format version
+            uint16_t msg_val;              //!< Notification value, an IpcMessage::MsgVal
+            uint32_t frame_number;         //!< Frame number
+            int32_t  buffer_id;            //!< ID of the shared buffer holding the frame
+            uint32_t frame_state;          //!< Receive state of the frame, zero if unknown, plus flags
+            uint32_t consumer_id;          //!< Index of the consumer releasing the frame, zero if only one
+            uint64_t frame_timestamp_ns;   //!< Time the frame started, in ns since the epoch, zero if unknown
+            uint64_t notify_timestamp_ns;  //!< Time the notification was created, in ns since the epoch
+        } __attribute__((packed));
+
+        FrameNotification(IpcMessage::MsgVal msg_val, uint32_t frame_number, int buffer_id,
+                uint32_t frame_state=0, uint64_t frame_timestamp_ns=0, uint32_t consumer_id=0);
+        FrameNotification(const std::string& encoded);
+
+        static bool is_binary(const std::string& encoded);
+
+        std::string encode(void) const;
+
+        const IpcMessage::MsgVal get_msg_val(void) const;
+        const uint32_t get_frame_number(void) const;
+        const int get_buffer_id(void) const;
+        const uint32_t get_frame_state(void) const;
+        const bool is_spilled(void) const;
+        const uint64_t get_frame_timestamp_ns(void) const;
+        const uint64_t get_notify_timestamp_ns(void) const;
+        const uint32_t get_consumer_id(void) const;
+
+    private:
+
+        Encoded notification_;
+    };
+
+} // namespace FrameReceiver
+
+#endif /* FRAMENOTIFICATION_H_ */
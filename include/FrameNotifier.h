@@ -0,0 +1,180 @@
+/*!
+ * FrameNotifier.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_FRAMENOTIFIER_H_
+#define INCLUDE_FRAMENOTIFIER_H_
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <log4cxx/logger.h>
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+#include "DebugLevelLogger.h"
+
+#include "IpcChannel.h"
+#include "IpcMessage.h"
+#include "IpcReactor.h"
+#include "FrameReceiverDefaults.h"
+#include "SharedBufferManager.h"
+#include "SharedFrameRing.h"
+#include "FrameBufferPool.h"
+#include "FrameDecoder.h"
+#include "FrameConsumerTracker.h"
+
+namespace FrameReceiver
+{
+    //! FrameNotifier - notification of ready frames from an RX thread to downstream consumers
+    //!
+    //! This abstract class is the interface through which an RX thread notifies frames that are
+    //! ready in the shared buffer and has the buffers of released frames returned to its frame
+    //! buffer pool. Notifiers are created and used only by the RX thread; any channels they
+    //! receive on are registered with the reactor of that thread. The numbers of frames notified
+    //! and released are counted atomically so that they can be read by the main thread.
+
+    class FrameNotifier
+    {
+    public:
+
+        FrameNotifier(LoggerPtr& logger);
+        virtual ~FrameNotifier();
+
+        //! Notify a frame that is ready in a buffer
+        virtual void notify_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns,
+                bool spilled) = 0;
+
+        //! Return the name of the notifier, as reported in the RX thread status
+        virtual const std::string get_name(void) const = 0;
+
+        virtual void register_channels(IpcReactor& reactor);
+        virtual void remove_channels(IpcReactor& reactor);
+        virtual void service_releases(void);
+        virtual void get_status(IpcMessage& status);
+
+        const uint64_t get_frames_notified(void) const;
+        const uint64_t get_frames_released(void) const;
+
+        static std::string encode_frame_ready(int buffer_id, int frame_number, int frame_state,
+                uint64_t frame_timestamp_ns, bool spilled, Defaults::NotifyFormat notify_format);
+        static bool decode_frame_release(const std::string& release_encoded, int& buffer_id,
+                unsigned int& consumer_id, int& frame_number);
+
+    protected:
+
+        void count_frame_notified(void);
+        void count_frames_released(uint64_t num_frames);
+
+        LoggerPtr logger_;
+
+    private:
+
+        uint64_t frames_notified_;
+        uint64_t frames_released_;
+    };
+
+    typedef boost::shared_ptr<FrameNotifier> FrameNotifierPtr;
+
+    //! Function signature for handling a ready frame relayed to the main thread, called with the
+    //! buffer ID, frame number, receive state of the frame, time the frame started in ns since the
+    //! epoch and whether the frame is held in a spill buffer
+    typedef boost::function<void(int, int, int, uint64_t, bool)> FrameRelayCallback;
+
+    //! RelayFrameNotifier - notification of ready frames relayed through the main thread
+    //!
+    //! Frame ready notifications are posted as callbacks to the reactor of the main thread, which
+    //! tracks the consumers, encodes the notifications and forwards them on the frame ready
+    //! channel. Released buffers are returned to the frame buffer pool by the main thread, so
+    //! this notifier never counts any frames as released.
+
+    class RelayFrameNotifier : public FrameNotifier
+    {
+    public:
+
+        RelayFrameNotifier(LoggerPtr& logger, IpcReactor& relay_reactor, FrameRelayCallback relay_callback);
+
+        void notify_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns,
+                bool spilled);
+        const std::string get_name(void) const;
+
+    private:
+
+        IpcReactor&        relay_reactor_;
+        FrameRelayCallback relay_callback_;
+    };
+
+    //! SharedRingFrameNotifier - notification of ready frames through rings in shared memory
+    //!
+    //! Frame descriptors are pushed onto the ready ring of the RX thread in the shared buffer
+    //! and the consumer is woken through the shared event. Buffers released by the consumer
+    //! through the release ring are returned to the frame buffer pool when releases are
+    //! serviced, as well as whenever the pool runs out of empty buffers.
+
+    class SharedRingFrameNotifier : public FrameNotifier
+    {
+    public:
+
+        SharedRingFrameNotifier(LoggerPtr& logger, SharedFrameRingPtr ready_ring, SharedFrameEventPtr ready_event,
+                FrameBufferPoolPtr buffer_pool);
+
+        void notify_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns,
+                bool spilled);
+        const std::string get_name(void) const;
+        void service_releases(void);
+
+    private:
+
+        SharedFrameRingPtr  ready_ring_;
+        SharedFrameEventPtr ready_event_;
+        FrameBufferPoolPtr  buffer_pool_;
+    };
+
+    //! DirectFrameNotifier - notification of ready frames directly from the RX thread
+    //!
+    //! The notifier binds the frame ready and release channels itself, so that notifications are
+    //! published and releases received by the RX thread without passing through the main thread,
+    //! which is left handling control requests. The consumers of each frame are tracked and
+    //! buffers are returned to the frame decoder once every consumer has released them. As
+    //! the channels are bound to a single endpoint, only one RX thread may notify frames directly.
+
+    class DirectFrameNotifier : public FrameNotifier
+    {
+    public:
+
+        DirectFrameNotifier(LoggerPtr& logger, std::string& frame_ready_endpoint, std::string& frame_release_endpoint,
+                Defaults::NotifyFormat notify_format, SharedBufferManagerPtr buffer_manager,
+                FrameDecoderPtr frame_decoder, unsigned int num_consumers, unsigned int max_consumer_lag);
+        ~DirectFrameNotifier();
+
+        void notify_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns,
+                bool spilled);
+        const std::string get_name(void) const;
+        void register_channels(IpcReactor& reactor);
+        void remove_channels(IpcReactor& reactor);
+        void get_status(IpcMessage& status);
+
+        void handle_frame_release_channel(void);
+
+    private:
+
+        void free_frame_buffers(const std::vector<int>& free_buffers);
+
+        IpcChannel             frame_ready_channel_;
+        IpcChannel             frame_release_channel_;
+        Defaults::NotifyFormat notify_format_;
+        FrameDecoderPtr        frame_decoder_;
+        FrameConsumerTracker   consumer_tracker_;
+        unsigned int           max_consumer_lag_;
+    };
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_FRAMENOTIFIER_H_ */
@@ -29,12 +29,14 @@ using namespace log4cxx::helpers;
 
 #include "IpcChannel.h"
 #include "IpcMessage.h"
+#include "FrameNotification.h"
 #include "IpcReactor.h"
 #include "FrameReceiverConfig.h"
 #include "FrameReceiverRxThread.h"
 #include "FrameDecoder.h"
 #include "PercivalEmulatorFrameDecoder.h"
 #include "FrameReceiverException.h"
+#include "FrameConsumerTracker.h"
 
 namespace FrameReceiver
 {
@@ -63,29 +65,38 @@ namespace FrameReceiver
 		void initialise_ipc_channels(void);
 		void cleanup_ipc_channels(void);
         void initialise_frame_decoder(void);
+        FrameDecoderPtr create_frame_decoder(void);
+        void initialise_rx_threads(void);
         void initialise_buffer_manager(void);
         void precharge_buffers(void);
+        void frame_ready(int buffer_id);
+        void free_frame_buffers(const std::vector<int>& free_buffers);
 
         void handle_ctrl_channel(void);
-        void handle_rx_channel(void);
+        void handle_rx_channel(unsigned int thread_idx);
+        void handle_rx_frame_ready(unsigned int thread_idx, int buffer_id, int frame_number, int frame_state,
+                uint64_t frame_timestamp_ns, bool spilled);
         void handle_frame_release_channel(void);
+        void shared_ring_timer_handler(void);
+        void direct_notify_timer_handler(void);
         void rx_ping_timer_handler(void);
         void timer_handler2(void);
 
 		LoggerPtr             logger_;                           //!< Log4CXX logger instance pointer
 		FrameReceiverConfig   config_;                           //!< Configuration storage object
-		boost::scoped_ptr<FrameReceiverRxThread> rx_thread_;     //!< Receiver thread object
-		FrameDecoderPtr frame_decoder_;          //!< Frame decoder object
+		std::vector<boost::shared_ptr<FrameReceiverRxThread> > rx_threads_; //!< Receiver thread objects
+		FrameDecoderPtr frame_decoder_;          //!< Frame decoder object of first receiver thread
 		SharedBufferManagerPtr buffer_manager_;  //!< Buffer manager object
+		FrameConsumerTrackerPtr consumer_tracker_; //!< Reference counting of frames by downstream consumers
 
 		static bool terminate_frame_receiver_;
 
-		IpcChannel rx_channel_;
+		std::vector<boost::shared_ptr<IpcChannel> > rx_channels_;
 		IpcChannel ctrl_channel_;
 		IpcChannel frame_ready_channel_;
 		IpcChannel frame_release_channel_;
 
-		IpcReactor reactor_;
+		boost::scoped_ptr<IpcReactor> reactor_;
 
 		unsigned int frames_received_;
 		unsigned int frames_released_;
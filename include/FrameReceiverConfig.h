@@ -15,6 +15,7 @@
 #include <map>
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include "FrameReceiverDefaults.h"
 
 namespace FrameReceiver
@@ -28,15 +29,46 @@ namespace FrameReceiver
 		    sensor_type_(Defaults::SensorTypeIllegal),
 		    rx_address_(Defaults::default_rx_address),
 		    rx_recv_buffer_size_(Defaults::default_rx_recv_buffer_size),
+		    rx_batch_size_(Defaults::default_rx_batch_size),
+		    rx_force_header_peek_(Defaults::default_rx_force_header_peek),
+		    rx_threads_(Defaults::default_rx_threads),
+		    rx_reuse_port_(Defaults::default_rx_reuse_port),
+		    rx_backend_(Defaults::default_rx_backend),
+		    rx_interface_(Defaults::default_rx_interface),
+		    rx_ring_block_size_(Defaults::default_rx_ring_block_size),
+		    rx_ring_num_blocks_(Defaults::default_rx_ring_num_blocks),
+		    rx_uring_num_buffers_(Defaults::default_rx_uring_num_buffers),
+		    rx_uring_buffer_size_(Defaults::default_rx_uring_buffer_size),
+		    rx_busy_poll_(Defaults::default_rx_busy_poll),
+		    rx_busy_poll_interval_(Defaults::default_rx_busy_poll_interval),
+		    rx_busy_poll_usecs_(Defaults::default_rx_busy_poll_usecs),
+		    rx_udp_gro_(Defaults::default_rx_udp_gro),
 		    rx_channel_endpoint_(Defaults::default_rx_chan_endpoint),
 		    ctrl_channel_endpoint_(Defaults::default_ctrl_chan_endpoint),
 		    frame_ready_endpoint_(Defaults::default_frame_ready_endpoint),
 		    frame_release_endpoint_(Defaults::default_frame_release_endpoint),
 		    shared_buffer_name_(Defaults::default_shared_buffer_name),
+		    shared_frame_rings_(Defaults::default_shared_frame_rings),
+		    direct_frame_notify_(Defaults::default_direct_frame_notify),
+		    huge_pages_(Defaults::default_huge_pages),
+		    huge_page_dir_(Defaults::default_huge_page_dir),
+		    buffer_numa_policy_(Defaults::default_buffer_numa_policy),
+		    prefault_buffers_(Defaults::default_prefault_buffers),
+		    prefault_threads_(Defaults::default_prefault_threads),
+		    lock_buffers_(Defaults::default_lock_buffers),
+		    spill_mem_(Defaults::default_spill_mem),
+		    spill_file_(Defaults::default_spill_file),
+		    frame_notify_format_(Defaults::default_frame_notify_format),
+		    frame_consumers_(Defaults::default_frame_consumers),
+		    max_consumer_lag_(Defaults::default_max_consumer_lag),
 		    frame_timeout_ms_(Defaults::default_frame_timeout_ms),
+		    reactor_backend_(Defaults::default_reactor_backend),
 		    enable_packet_logging_(Defaults::default_enable_packet_logging)
 		{
 		    tokenize_port_list(rx_ports_, Defaults::default_rx_port_list);
+		    tokenize_cpu_list(rx_thread_cpus_, Defaults::default_rx_thread_cpu_list);
+		    tokenize_cpu_list(rx_thread_numa_nodes_, Defaults::default_rx_thread_numa_node_list);
+		    tokenize_cpu_list(buffer_numa_nodes_, Defaults::default_buffer_numa_node_list);
 		};
 
 		void tokenize_port_list(std::vector<uint16_t>& port_list, const std::string port_list_str)
@@ -58,6 +90,38 @@ namespace FrameReceiver
             }
 		}
 
+		void tokenize_cpu_list(std::vector<int>& cpu_list, const std::string cpu_list_str)
+		{
+		    const std::string delimiter(",");
+		    std::size_t start = 0, end = 0;
+
+		    while ((end != std::string::npos) && (start < cpu_list_str.size()))
+		    {
+		        end = cpu_list_str.find(delimiter, start);
+		        std::string cpu_str = cpu_list_str.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+		        start = ((end > (std::string::npos - delimiter.size())) ? std::string::npos : end + delimiter.size());
+
+		        char* end_ptr;
+		        long cpu = strtol(cpu_str.c_str(), &end_ptr, 0);
+		        if ((end_ptr != cpu_str.c_str()) && (cpu >= 0))
+		        {
+		            cpu_list.push_back(static_cast<int>(cpu));
+		        }
+		    }
+		}
+
+		std::string rx_thread_channel_endpoint(unsigned int thread_idx)
+		{
+		    // The first RX thread uses the configured endpoint, subsequent threads append their index
+		    std::stringstream ss;
+		    ss << rx_channel_endpoint_;
+		    if (thread_idx > 0)
+		    {
+		        ss << "_" << thread_idx;
+		    }
+		    return ss.str();
+		}
+
 		Defaults::SensorType map_sensor_name_to_type(std::string& sensor_name)
 		{
 
@@ -81,6 +145,92 @@ namespace FrameReceiver
 		    return sensor_type;
 		}
 
+		Defaults::RxBackend map_rx_backend_name_to_type(std::string& backend_name)
+		{
+
+		    Defaults::RxBackend rx_backend = Defaults::RxBackendIllegal;
+
+		    static std::map<std::string, Defaults::RxBackend> rx_backend_name_map;
+
+		    if (rx_backend_name_map.empty())
+		    {
+		        rx_backend_name_map["socket"]     = Defaults::RxBackendSocket;
+		        rx_backend_name_map["packetring"] = Defaults::RxBackendPacketRing;
+		        rx_backend_name_map["iouring"]    = Defaults::RxBackendIoUring;
+		    }
+
+		    if (rx_backend_name_map.count(backend_name))
+		    {
+		        rx_backend = rx_backend_name_map[backend_name];
+		    }
+
+		    return rx_backend;
+		}
+
+		Defaults::NumaPolicy map_numa_policy_name_to_type(std::string& policy_name)
+		{
+
+		    Defaults::NumaPolicy numa_policy = Defaults::NumaPolicyIllegal;
+
+		    static std::map<std::string, Defaults::NumaPolicy> numa_policy_name_map;
+
+		    if (numa_policy_name_map.empty())
+		    {
+		        numa_policy_name_map["default"]    = Defaults::NumaPolicyDefault;
+		        numa_policy_name_map["bind"]       = Defaults::NumaPolicyBind;
+		        numa_policy_name_map["interleave"] = Defaults::NumaPolicyInterleave;
+		    }
+
+		    if (numa_policy_name_map.count(policy_name))
+		    {
+		        numa_policy = numa_policy_name_map[policy_name];
+		    }
+
+		    return numa_policy;
+		}
+
+		Defaults::NotifyFormat map_notify_format_name_to_type(std::string& format_name)
+		{
+
+		    Defaults::NotifyFormat notify_format = Defaults::NotifyFormatIllegal;
+
+		    static std::map<std::string, Defaults::NotifyFormat> notify_format_name_map;
+
+		    if (notify_format_name_map.empty())
+		    {
+		        notify_format_name_map["json"]   = Defaults::NotifyFormatJson;
+		        notify_format_name_map["binary"] = Defaults::NotifyFormatBinary;
+		    }
+
+		    if (notify_format_name_map.count(format_name))
+		    {
+		        notify_format = notify_format_name_map[format_name];
+		    }
+
+		    return notify_format;
+		}
+
+		Defaults::ReactorBackend map_reactor_backend_name_to_type(std::string& backend_name)
+		{
+
+		    Defaults::ReactorBackend reactor_backend = Defaults::ReactorBackendIllegal;
+
+		    static std::map<std::string, Defaults::ReactorBackend> reactor_backend_name_map;
+
+		    if (reactor_backend_name_map.empty())
+		    {
+		        reactor_backend_name_map["poll"]  = Defaults::ReactorBackendPoll;
+		        reactor_backend_name_map["epoll"] = Defaults::ReactorBackendEpoll;
+		    }
+
+		    if (reactor_backend_name_map.count(backend_name))
+		    {
+		        reactor_backend = reactor_backend_name_map[backend_name];
+		    }
+
+		    return reactor_backend;
+		}
+
 	private:
 
 		std::size_t           max_buffer_mem_;         //!< Amount of shared buffer memory to allocate for frame buffers
@@ -88,12 +238,43 @@ namespace FrameReceiver
 		std::vector<uint16_t> rx_ports_;               //!< Port(s) to receive frame data on
 		std::string           rx_address_;             //!< IP address to receive frame data on
 		int                   rx_recv_buffer_size_;    //!< Receive socket buffer size
+		unsigned int          rx_batch_size_;          //!< Maximum number of packets to receive per socket read
+		bool                  rx_force_header_peek_;   //!< Force header peek receive even if decoder supports speculative receive
+		unsigned int          rx_threads_;             //!< Number of RX threads to receive frame data with
+		bool                  rx_reuse_port_;          //!< Bind all ports in every RX thread with SO_REUSEPORT
+		std::vector<int>      rx_thread_cpus_;         //!< CPU core(s) to pin RX threads to
+		std::vector<int>      rx_thread_numa_nodes_;   //!< NUMA node(s) to bind RX threads to
+		Defaults::RxBackend   rx_backend_;             //!< Receive backend to capture packets with
+		std::string           rx_interface_;           //!< Network interface to capture packets on with packet ring backend
+		std::size_t           rx_ring_block_size_;     //!< Packet ring block size in bytes
+		unsigned int          rx_ring_num_blocks_;     //!< Number of blocks in packet ring
+		unsigned int          rx_uring_num_buffers_;   //!< Number of io_uring provided receive buffers
+		std::size_t           rx_uring_buffer_size_;   //!< Size of each io_uring receive buffer in bytes
+		bool                  rx_busy_poll_;           //!< Spin on non-blocking receives instead of polling for packets
+		unsigned int          rx_busy_poll_interval_;  //!< Number of busy-poll iterations between servicing channels and timers
+		int                   rx_busy_poll_usecs_;     //!< SO_BUSY_POLL time in microseconds to set on receive sockets, 0 = not set
+		bool                  rx_udp_gro_;             //!< Enable UDP GRO on receive sockets, splitting coalesced datagrams into packets
 		std::string           rx_channel_endpoint_;    //!< IPC channel endpoint for RX thread communication
 		std::string           ctrl_channel_endpoint_;  //!< IPC channel endpoint for control communication with other processes
 		std::string           frame_ready_endpoint_;   //!< IPC channel endpoint for transmitting frame ready notifications to other processes
         std::string           frame_release_endpoint_; //!< IPC channel endpoint for receiving frame release notifications from other processes
 		std::string           shared_buffer_name_;     //!< Shared memory frame buffer name
+		bool                  shared_frame_rings_;     //!< Pass frame notifications through rings in shared memory
+		bool                  direct_frame_notify_;    //!< Publish and receive frame notifications in the RX thread
+		bool                  huge_pages_;             //!< Back the shared memory frame buffer with huge pages
+		std::string           huge_page_dir_;          //!< hugetlbfs mount directory for the huge page frame buffer
+		Defaults::NumaPolicy  buffer_numa_policy_;     //!< NUMA memory policy for the shared memory frame buffer
+		std::vector<int>      buffer_numa_nodes_;      //!< NUMA node(s) for the shared memory frame buffer policy
+		bool                  prefault_buffers_;       //!< Prefault the shared memory frame buffer pages at startup
+		unsigned int          prefault_threads_;       //!< Number of threads to prefault the frame buffer pages with
+		bool                  lock_buffers_;           //!< Lock the shared memory frame buffer into memory
+		std::size_t           spill_mem_;              //!< Size of the spill file in bytes
+		std::string           spill_file_;             //!< Path of the memory-mapped spill file for overflow frames, empty = none
+		Defaults::NotifyFormat frame_notify_format_;   //!< Encoding of frame ready notifications sent on channels
+		unsigned int          frame_consumers_;        //!< Number of downstream consumers that must release each frame
+		unsigned int          max_consumer_lag_;       //!< Number of unreleased frames at which a consumer is dropped, 0 = no limit
 		unsigned int          frame_timeout_ms_;       //!< Incomplete frame timeout in milliseconds
+		Defaults::ReactorBackend reactor_backend_;     //!< Backend used by the reactors to wait for events
 		unsigned int          frame_count_;            //!< Number of frames to receive before terminating
 		bool                  enable_packet_logging_;  //!< Enable packet diagnostic logging
 
@@ -25,20 +25,92 @@ namespace FrameReceiver
 			SensorTypeExcalibur3M,
 		};
 
+		enum RxBackend
+		{
+			RxBackendIllegal = -1,
+			RxBackendSocket,
+			RxBackendPacketRing,
+			RxBackendIoUring,
+		};
+
+		enum NotifyFormat
+		{
+			NotifyFormatIllegal = -1,
+			NotifyFormatJson,
+			NotifyFormatBinary,
+		};
+
+		enum ReactorBackend
+		{
+			ReactorBackendIllegal = -1,
+			ReactorBackendPoll,
+			ReactorBackendEpoll,
+		};
+
+		enum NumaPolicy
+		{
+			NumaPolicyIllegal = -1,
+			NumaPolicyDefault,
+			NumaPolicyBind,
+			NumaPolicyInterleave,
+		};
+
 		const int          default_node                   = 1;
 		const std::size_t  default_max_buffer_mem         = 1048576;
 		const SensorType   default_sensor_type            = SensorTypeIllegal;
         const std::string  default_rx_port_list           = "8989,8990";
 		const std::string  default_rx_address             = "0.0.0.0";
 		const int          default_rx_recv_buffer_size    = 30000000;
+		const unsigned int default_rx_batch_size          = 1;
+		const bool         default_rx_force_header_peek   = false;
+		const unsigned int default_rx_threads             = 1;
+		const unsigned int default_rx_tick_period_ms      = 100;
+		const unsigned int default_rx_frame_expiry_period_ms = 1;
+		const bool         default_rx_reuse_port          = false;
+		const std::string  default_rx_thread_cpu_list     = "";
+		const std::string  default_rx_thread_numa_node_list = "";
+		const RxBackend    default_rx_backend             = RxBackendSocket;
+		const std::string  default_rx_interface           = "lo";
+		const std::size_t  default_rx_ring_block_size     = 4194304;
+		const unsigned int default_rx_ring_num_blocks     = 64;
+		const unsigned int default_rx_ring_block_timeout_ms = 10;
+		const unsigned int default_rx_uring_num_buffers   = 4096;
+		const std::size_t  default_rx_uring_buffer_size   = 9216;
+		const bool         default_rx_busy_poll           = false;
+		const unsigned int default_rx_busy_poll_interval  = 1000;
+		const int          default_rx_busy_poll_usecs     = 0;
+		const bool         default_rx_udp_gro             = false;
 		const std::string  default_rx_chan_endpoint       = "inproc://rx_channel";
 		const std::string  default_ctrl_chan_endpoint     = "tcp://*:5000";
 		const std::string  default_frame_ready_endpoint   = "tcp://*:5001";
 		const std::string  default_frame_release_endpoint = "tcp://*:5002";
 		const std::string  default_shared_buffer_name     = "FrameReceiverBuffer";
+		const bool         default_shared_frame_rings     = false;
+		const bool         default_direct_frame_notify    = false;
+		const bool         default_huge_pages             = false;
+		const std::string  default_huge_page_dir          = "/dev/hugepages";
+		const NumaPolicy   default_buffer_numa_policy     = NumaPolicyDefault;
+		const std::string  default_buffer_numa_node_list  = "";
+		const bool         default_prefault_buffers       = false;
+		const unsigned int default_prefault_threads       = 4;
+		const bool         default_lock_buffers           = false;
+		const std::string  default_spill_file             = "";
+		const std::size_t  default_spill_mem              = 0;
+		const NotifyFormat default_frame_notify_format    = NotifyFormatJson;
+		const unsigned int default_frame_consumers        = 1;
+		const unsigned int default_max_consumer_lag       = 0;
+		const unsigned int default_shared_ring_poll_ms    = 10;
+		const unsigned int default_direct_notify_poll_ms  = 10;
 		const unsigned int default_frame_timeout_ms       = 1000;
 		const unsigned int default_frame_count            = 0;
 		const bool         default_enable_packet_logging  = false;
+#ifdef __linux__
+		const ReactorBackend default_reactor_backend      = ReactorBackendEpoll;
+		const std::string  default_reactor_backend_name   = "epoll";
+#else
+		const ReactorBackend default_reactor_backend      = ReactorBackendPoll;
+		const std::string  default_reactor_backend_name   = "poll";
+#endif
 
 	}
 }
@@ -11,6 +11,9 @@
 #include <boost/thread.hpp>
 #include <boost/asio.hpp>
 
+#include <sys/socket.h>
+#include <netinet/in.h>
+
 #include <log4cxx/logger.h>
 using namespace log4cxx;
 using namespace log4cxx::helpers;
@@ -18,9 +21,14 @@ using namespace log4cxx::helpers;
 
 #include "IpcChannel.h"
 #include "IpcMessage.h"
+#include "FrameNotification.h"
 #include "IpcReactor.h"
 #include "SharedBufferManager.h"
+#include "NumaBinding.h"
 #include "FrameDecoder.h"
+#include "FrameNotifier.h"
+#include "PacketRingReceiver.h"
+#include "IoUringReceiver.h"
 
 #include "FrameReceiverConfig.h"
 #include "FrameReceiverException.h"
@@ -39,34 +47,95 @@ namespace FrameReceiver
     public:
         FrameReceiverRxThread(FrameReceiverConfig& config, LoggerPtr& logger,
                 SharedBufferManagerPtr buffer_manager, FrameDecoderPtr frame_decoder,
-                unsigned int tick_period_ms=100);
+                IpcReactor& relay_reactor, FrameRelayCallback relay_callback,
+                unsigned int tick_period_ms=Defaults::default_rx_tick_period_ms, unsigned int thread_idx=0);
         virtual ~FrameReceiverRxThread();
 
         void start();
         void stop();
 
-        void frame_ready(int buffer_id, int frame_number);
+        void frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns);
+        void release_buffers(const std::vector<int>& buffer_ids);
+
+        const uint64_t get_frames_notified(void) const;
+        const uint64_t get_frames_released(void) const;
 
     private:
 
         void run_service(void);
+        bool bind_thread_to_cpu(int cpu);
+        bool bind_thread_to_numa_node(int node);
+        bool init_receive_sockets(void);
+        bool init_packet_ring(void);
+        bool init_io_uring(void);
+        bool init_frame_notifier(void);
+        void register_receive_handler(int fd, ReactorCallback callback);
+        void run_busy_poll(void);
+        uint64_t get_socket_drops(void);
 
         void handle_rx_channel(void);
+        void push_empty_buffers(const std::vector<int>& buffer_ids);
         void handle_receive_socket(int socket_fd, int recv_port);
+        void handle_receive_socket_speculative(int socket_fd, int recv_port);
+        void handle_packet_ring(void);
+        void handle_io_uring(void);
+        void handle_ring_packet(uint8_t* packet, size_t packet_size, int recv_port, struct sockaddr_in* from_addr);
+#ifdef __linux__
+        void init_batch_receive(void);
+        void handle_receive_socket_batch(int socket_fd, int recv_port);
+        void init_gro_receive(void);
+        bool enable_udp_gro(int socket_fd, int recv_port);
+        void handle_receive_socket_gro(int socket_fd, int recv_port);
+#endif
         void tick_timer(void);
+        void frame_expiry_timer(void);
         void buffer_monitor_timer(void);
 
         FrameReceiverConfig&   config_;
         LoggerPtr              logger_;
         SharedBufferManagerPtr buffer_manager_;
         FrameDecoderPtr        frame_decoder_;
+        unsigned int           thread_idx_;
         unsigned int           tick_period_ms_;
+        IpcReactor&            relay_reactor_;
+        FrameRelayCallback     relay_callback_;
 
         IpcChannel             rx_channel_;
         int                    recv_socket_;
         std::vector<int>       recv_sockets_;
+        std::vector<int>       recv_ports_;
         IpcReactor             reactor_;
 
+        FrameDecoder::PacketReceiveMode packet_receive_mode_;
+        bool                   use_batch_receive_;
+
+        PacketRingReceiverPtr  packet_ring_;
+        PacketRingHandler      packet_ring_handler_;
+        IoUringReceiverPtr     io_uring_;
+
+        std::vector<ReactorCallback> busy_poll_handlers_;
+        uint64_t               busy_poll_iterations_;
+
+#ifdef __linux__
+        std::vector<struct mmsghdr>      batch_msgs_;
+        std::vector<struct iovec>        batch_iovecs_;
+        std::vector<struct sockaddr_in>  batch_addrs_;
+
+        std::vector<struct mmsghdr>      gro_msgs_;
+        std::vector<struct iovec>        gro_iovecs_;
+        std::vector<struct sockaddr_in>  gro_addrs_;
+        std::vector<uint8_t>             gro_buffers_;
+        std::vector<uint8_t>             gro_control_;
+#endif
+        bool                   use_udp_gro_;
+        unsigned int           gro_sockets_;
+        uint64_t               gro_datagrams_;
+        uint64_t               gro_segments_;
+        uint64_t               gro_truncated_;
+        uint64_t               frames_spilled_;
+
+        FrameNotifierPtr       frame_notifier_;
+
         bool                   run_thread_;
         bool                   thread_running_;
         bool                   thread_init_error_;
@@ -0,0 +1,72 @@
+/*!
+ * FrameTimerWheel.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_FRAMETIMERWHEEL_H_
+#define INCLUDE_FRAMETIMERWHEEL_H_
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FrameReceiver
+{
+    //! FrameTimerExpiry - frame buffer whose timeout has expired
+    struct FrameTimerExpiry
+    {
+        int      buffer_id;     //!< ID of the buffer assigned to the frame
+        uint32_t frame_number;  //!< Frame number
+    };
+
+    //! FrameTimerWheel - hashed timer wheel tracking the timeouts of incomplete frames
+    //!
+    //! This class tracks a timeout for each frame buffer being filled, keyed by buffer ID since a
+    //! buffer holds at most one frame at a time. Timeouts are held in a wheel of slots, each
+    //! covering one millisecond tick and holding a doubly-linked list of the timeouts due in that
+    //! tick modulo the wheel size. Scheduling and cancelling a timeout are constant time and
+    //! advancing the wheel only visits the slots for the ticks elapsed, so the work done is
+    //! proportional to the number of expired frames rather than the number in flight. Timeouts
+    //! further ahead than the wheel size remain in their slot until the wheel has turned enough
+    //! times. The wheel is not thread safe and is owned by a single frame decoder.
+
+    class FrameTimerWheel
+    {
+    public:
+
+        FrameTimerWheel(size_t num_slots=1024);
+
+        void schedule(int buffer_id, uint32_t frame_number, uint64_t expiry_ms);
+        bool cancel(int buffer_id);
+        size_t advance(uint64_t now_ms, std::vector<FrameTimerExpiry>& expired);
+
+        const size_t get_num_slots(void) const;
+        const size_t get_num_scheduled(void) const;
+
+    private:
+
+        struct TimerEntry
+        {
+            uint32_t frame_number;
+            uint64_t expiry_ms;
+            int      prev;
+            int      next;
+            bool     active;
+        };
+
+        void unlink(int buffer_id);
+
+        std::vector<int>        slots_;
+        size_t                  slot_mask_;
+        std::vector<TimerEntry> entries_;
+        size_t                  num_scheduled_;
+        uint64_t                current_ms_;
+        bool                    started_;
+    };
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_FRAMETIMERWHEEL_H_ */
@@ -0,0 +1,119 @@
+/*!
+ * IoUringReceiver.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_IOURINGRECEIVER_H_
+#define INCLUDE_IOURINGRECEIVER_H_
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <log4cxx/logger.h>
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+#include "DebugLevelLogger.h"
+
+#include "FrameReceiverException.h"
+#include "PacketRingReceiver.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace FrameReceiver
+{
+    //! IoUringReceiverException - custom exception class implementing "what" for error string
+    class IoUringReceiverException : public FrameReceiverException
+    {
+    public:
+        IoUringReceiverException(const std::string what) : FrameReceiverException(what) { };
+    };
+
+    //! IoUringReceiver - io_uring multishot receive of UDP packets
+    //!
+    //! This class receives packets from a set of bound UDP sockets through an io_uring instance.
+    //! A single multishot receive request is armed on each socket, which the kernel completes
+    //! once per packet into a buffer it selects from a ring of provided buffers, so no system
+    //! call is made per packet. Completions are signalled on an eventfd which can be polled by
+    //! an IpcReactor. Payloads are passed to a handler with the same signature as used by the
+    //! PacketRingReceiver and the buffers are then returned to the kernel. io_uring multishot
+    //! receive requires Linux 6.0 or later and support is detected at build time.
+
+    class IoUringReceiver
+    {
+    public:
+
+        IoUringReceiver(LoggerPtr& logger, const std::vector<int>& sockets, const std::vector<int>& ports,
+                unsigned int num_buffers, size_t buffer_size);
+        ~IoUringReceiver();
+
+        static bool is_supported(void);
+
+        int get_event_fd(void) const;
+        size_t process_completions(const PacketRingHandler& handler);
+
+        const uint64_t get_packets_received(void) const;
+        const uint64_t get_packets_truncated(void) const;
+        const uint64_t get_buffer_stalls(void) const;
+
+    private:
+
+        void arm_receive(unsigned int socket_idx);
+        void submit(void);
+        void recycle_buffer(uint16_t buffer_id);
+        void cleanup(void);
+
+        LoggerPtr             logger_;
+        std::vector<int>      sockets_;
+        std::vector<int>      ports_;
+        unsigned int          num_buffers_;
+        size_t                buffer_size_;
+
+        int                   ring_fd_;
+        int                   event_fd_;
+
+        uint8_t*              sq_ring_;
+        size_t                sq_ring_size_;
+        uint8_t*              cq_ring_;
+        size_t                cq_ring_size_;
+        struct io_uring_sqe*  sqes_;
+        size_t                sqes_size_;
+
+        unsigned int*         sq_head_;
+        unsigned int*         sq_tail_;
+        unsigned int*         sq_array_;
+        unsigned int          sq_mask_;
+        unsigned int          sq_entries_;
+        unsigned int          sq_pending_;
+        unsigned int*         cq_head_;
+        unsigned int*         cq_tail_;
+        unsigned int          cq_mask_;
+        struct io_uring_cqe*  cqes_;
+
+        struct io_uring_buf_ring* buf_ring_;
+        size_t                buf_ring_size_;
+        uint16_t              buf_ring_tail_;
+        uint8_t*              buffers_;
+
+        struct msghdr         recv_msg_;
+
+        uint64_t              packets_received_;
+        uint64_t              packets_truncated_;
+        uint64_t              buffer_stalls_;
+    };
+
+    typedef boost::shared_ptr<IoUringReceiver> IoUringReceiverPtr;
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_IOURINGRECEIVER_H_ */
@@ -30,6 +30,35 @@ namespace FrameReceiver
         zmq::context_t zmq_context_;
     };
 
+    //! Function signature for freeing the memory of a zero-copy message part once it has been sent
+    typedef zmq::free_fn IpcFreeFunction;
+
+    //! IpcMessagePart - a message part received on an IPC channel without copying
+    //!
+    //! The part owns the message received, so its data remain valid until the part is received
+    //! into again or destroyed. Parts cannot be copied.
+
+    class IpcMessagePart
+    {
+    public:
+
+        IpcMessagePart();
+
+        const void* data(void) const;
+        size_t size(void) const;
+        bool more(void) const;
+
+        friend class IpcChannel;
+
+    private:
+
+        IpcMessagePart(const IpcMessagePart&);
+        IpcMessagePart& operator=(const IpcMessagePart&);
+
+        zmq::message_t msg_;
+        bool           more_;
+    };
+
     class IpcChannel
     {
     public:
@@ -43,10 +72,13 @@ namespace FrameReceiver
 
         void subscribe(const char* topic);
 
-        void send(std::string& message_str);
-        void send(const char* message);
+        void send(std::string& message_str, bool more=false);
+        void send(const char* message, bool more=false);
+        void send(void* data, size_t size, IpcFreeFunction* free_fn, void* hint=0, bool more=false);
 
         const std::string recv(void);
+        void recv(IpcMessagePart& part);
+        bool recv_more(void);
 
         bool poll(long timeout_ms = -1);
         void close(void);
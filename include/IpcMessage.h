@@ -14,7 +14,9 @@
 #include <algorithm>
 #include <map>
 #include <sstream>
+#include <vector>
 #include <time.h>
+#include <stdint.h>
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 #include "boost/bimap.hpp"
@@ -101,7 +103,7 @@ namespace FrameReceiver
 
 		IpcMessage(MsgType msg_type=MsgTypeIllegal, MsgVal msg_val=MsgValIllegal, bool strict_validation=true);
 
-    IpcMessage(const char* json_msg, bool strict_validation=true);
+    IpcMessage(const char* json_msg, bool strict_validation=true, bool defer_timestamp=false);
 
     IpcMessage(const rapidjson::Value& value,
                MsgType msg_type=MsgTypeIllegal,
@@ -182,10 +184,14 @@ namespace FrameReceiver
       bool found_array = false;
       std::vector<std::string> names;
       // Split the name by / character
-      std::stringstream ss(param_name);
-      std::string item;
-      while (getline(ss, item, '/')) {
-        names.push_back(item);
+      std::string::size_type item_start = 0;
+      std::string::size_type item_end;
+      while ((item_end = param_name.find('/', item_start)) != std::string::npos) {
+        names.push_back(param_name.substr(item_start, item_end - item_start));
+        item_start = item_end + 1;
+      }
+      if (item_start < param_name.size()) {
+        names.push_back(param_name.substr(item_start));
       }
       // Get the top level name
       std::string tl_param_name = names[0];
@@ -198,7 +204,7 @@ namespace FrameReceiver
         this->internal_set_param(tl_param_name, rapidjson::Value().SetObject());
       }
       // Get the reference to the parameter
-      next = &(doc_["params"][rapidjson::Value().SetObject().SetString(tl_param_name.c_str(), doc_.GetAllocator())]);
+      next = &(doc_["params"][tl_param_name.c_str()]);
 
       std::vector<std::string>::iterator iter;
       for (iter = names.begin(); iter != names.end(); ++iter){
@@ -259,6 +265,15 @@ namespace FrameReceiver
 	    //! Returns a JSON-encoded string of the message
 		const char* encode(void);
 
+		//! Resets the message to an empty message of the given type and value, reusing its storage
+		void reset(MsgType msg_type=MsgTypeIllegal, MsgVal msg_val=MsgValIllegal);
+
+		//! Decodes a JSON-formatted string into the message, reusing its storage
+		void decode(const char* json_msg, bool defer_timestamp=false);
+
+		//! Returns the current local time as used to timestamp new messages
+		static boost::posix_time::ptime current_timestamp(void);
+
 		//! Overloaded equality relational operator
 		friend bool operator ==(IpcMessage const& lhs_msg, IpcMessage const& rhs_msg);
 
@@ -422,18 +437,44 @@ namespace FrameReceiver
 	    //! Maps an internal message timestamp representation to an ISO8601 extended format string
 		std::string valid_msg_timestamp(boost::posix_time::ptime msg_timestamp);
 
+	    //! Parses a message timestamp string, returning not_a_date_time if it is not valid
+		static boost::posix_time::ptime parse_msg_timestamp(const char* msg_timestamp_text);
+
+	    //! Formats a message timestamp as an ISO8601 extended format string into a buffer
+		static size_t format_msg_timestamp(boost::posix_time::ptime const& msg_timestamp, char* buffer);
+
+	    //! Returns the message timestamp, parsing it first if parsing was deferred
+		const boost::posix_time::ptime& resolve_msg_timestamp(void) const;
+
+	    //! Parses a JSON-formatted string in place into the message document
+		void parse_message(const char* json_msg, bool defer_timestamp);
+
+	    //! Empties the message document and returns all its memory to the document allocator
+		void clear_document(void);
+
 	    //! Indicates if the message has a params block
 		bool has_params(void) const;
 
+		//! Size of the buffer in the message used by the document allocator before allocating chunks
+		static const size_t allocator_buffer_size = 4096;
+
+		//! Size of an ISO8601 extended format timestamp string with microseconds, including terminator
+		static const size_t timestamp_buffer_size = 27;
+
 		// Private member variables
 
 		bool strict_validation_;                  //!< Strict validation enabled flag
+		uint64_t allocator_buffer_[allocator_buffer_size / sizeof(uint64_t)]; //!< Initial memory for the document allocator
+		rapidjson::MemoryPoolAllocator<> allocator_; //!< RapidJSON memory pool allocator used by the document
 		rapidjson::Document doc_;                 //!< RapidJSON document object
 		MsgType msg_type_;                        //!< Message type attribute
 		MsgVal msg_val_;                          //!< Message value attribute
-		boost::posix_time::ptime msg_timestamp_;  //!< Message timestamp (internal representation)
+		mutable boost::posix_time::ptime msg_timestamp_;  //!< Message timestamp (internal representation)
+		mutable bool msg_timestamp_deferred_;     //!< Indicates the timestamp attribute has not been parsed yet
 
+		std::vector<char> parse_buffer_;          //!< Copy of the JSON-formatted string parsed in place
 		rapidjson::StringBuffer encode_buffer_;   //!< Encoding buffer used to encode message to JSON string
+		rapidjson::Writer<rapidjson::StringBuffer> encode_writer_; //!< Writer reused to encode the message
 		static MsgTypeMap msg_type_map_;          //!< Bi-directional message type map
 		static MsgValMap msg_val_map_;            //!< Bi-directional message value map
 
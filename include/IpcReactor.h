@@ -10,6 +10,28 @@
  * or run indefinitely. The reactor polls all registered channels with a 'tickless' event
  * loop to minimise load.
  *
+ * Two backends are available to wait for events. The poll backend rebuilds a list of poll items
+ * and calls zmq::poll on each iteration, checking every item on return. On Linux the epoll
+ * backend registers the file descriptors of raw sockets, and the ZMQ_FD descriptors of channels,
+ * with an epoll instance once, so that each iteration only dispatches the handlers that are
+ * ready. Channel descriptors are edge-triggered, and using a channel may consume an edge, so a
+ * channel that has signalled or whose handler has been called is checked for further messages
+ * with ZMQ_EVENTS before the next wait rather than waiting for another edge. Every channel is
+ * checked after socket handlers, timers or posted callbacks have been called, or when the caller
+ * runs a single iteration, since these may use any channel.
+ *
+ * Timers have microsecond resolution and are held in a min-heap ordered by when they are next
+ * due, so finding the next timer and the timers that have fired does not scan every timer.
+ * With the epoll backend the next due time is armed on a timerfd registered with the epoll
+ * instance, so timers are just another event source and fire with microsecond precision; the
+ * poll backend rounds the poll timeout up to the next millisecond.
+ *
+ * Other threads can hand work to the thread running the reactor by posting a callback, which is
+ * queued on a lock-free multiple-producer, single-consumer queue and called from the reactor loop.
+ * The reactor is woken by an eventfd (a pipe on other platforms) polled alongside the channels,
+ * which is only written when the queue may have been drained, so posting normally costs one
+ * allocation and two atomic operations.
+ *
  *  Created on: Feb 16, 2015
  *      Author: Tim Nicholls, STFC Application Engineering Group
  */
@@ -20,6 +42,7 @@
 #include "zmq/zmq.hpp"
 #include "IpcChannel.h"
 #include "FrameReceiverException.h"
+#include "FrameReceiverDefaults.h"
 #include <iostream>
 #include <sstream>
 #include <boost/bind.hpp>
@@ -27,7 +50,13 @@
 #include <boost/ref.hpp>
 #include <boost/shared_ptr.hpp>
 #include <map>
+#include <vector>
 #include <time.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#endif
 
 namespace FrameReceiver
 {
@@ -44,12 +73,15 @@ namespace FrameReceiver
     //! Reactor millisecond time type
     typedef int64_t TimeMs;
 
+    //! Reactor microsecond time type
+    typedef int64_t TimeUs;
+
     //! IpcReactorTimer - timer objects for use in the IpcReactor class
     class IpcReactorTimer
     {
     public:
 
-        IpcReactorTimer(size_t delay_ms, size_t times, TimerCallback callback);
+        IpcReactorTimer(TimeUs delay_us, size_t times, TimerCallback callback);
         ~IpcReactorTimer();
 
         //! get_id - returns the unique ID of the timer instance
@@ -60,24 +92,28 @@ namespace FrameReceiver
 
         //! Indicates if the timer has fired (e.g. is due for handling)
         bool has_fired(void);
+        bool has_fired(TimeUs now_us);
 
         //! Indicates if the timer has expired, i.e. reached its maximum times fired
         bool has_expired(void);
 
-        //! Indicates when (in absolute monotonic time) the timer is due to fire
-        TimeMs when(void);
+        //! Indicates when (in absolute monotonic time in microseconds) the timer is due to fire
+        TimeUs when(void);
 
         //! Returns the current monotonic clock time in milliseconds (static method)
         static TimeMs clock_mono_ms(void);
 
+        //! Returns the current monotonic clock time in microseconds (static method)
+        static TimeUs clock_mono_us(void);
+
     private:
 
         // Private member variables
         int timer_id_;             //!< Unique ID for the timer
-        size_t delay_ms_;          //!< Timer delay in milliseconds
+        TimeUs delay_us_;          //!< Timer delay in microseconds
         size_t times_;             //!< Number of times the timer has left to fire
         TimerCallback callback_;   //!< Callback method to be called when the timer fires
-        TimeMs when_;              //!< Time when the timer is next due to fire
+        TimeUs when_;              //!< Time when the timer is next due to fire
         bool expired_;             //!< Indicates timers has expired
 
         static int last_timer_id_; //!< Class variable of last timer ID assigned
@@ -94,14 +130,37 @@ namespace FrameReceiver
 
     typedef std::map<int, ReactorCallback> SocketMap;
 
+    //! Internal map to associate channel socket with its ZMQ_FD file descriptor in the epoll backend
+    typedef std::map<SocketPtr, int> ChannelFdMap;
+
     //! Internal map to associate timer ID with a timer
     typedef std::map<int, boost::shared_ptr<IpcReactorTimer> > TimerMap;
 
+    //! Entry in the timer heap, giving when a timer is next due to fire
+    struct TimerHeapEntry
+    {
+        TimeUs when_us;   //!< Time when the timer is due to fire
+        int    timer_id;  //!< Unique ID of the timer
+
+        //! Orders entries so that the standard heap algorithms keep the earliest at the front
+        bool operator<(const TimerHeapEntry& other) const
+        {
+            return when_us > other.when_us;
+        }
+    };
+
+    //! Callback posted to the reactor, linked in the posted task queue
+    struct PostedTask
+    {
+        ReactorCallback callback; //!< Callback to call from the reactor loop
+        PostedTask*     next;     //!< Next task in the queue, 0 if none
+    };
+
     class IpcReactor
     {
     public:
 
-        IpcReactor(void);
+        IpcReactor(Defaults::ReactorBackend backend=Defaults::default_reactor_backend);
         ~IpcReactor();
 
          //! Adds an IPC channel and associated callback to the reactor
@@ -117,33 +176,108 @@ namespace FrameReceiver
          //! Adds a timer to the reactor
          int register_timer(size_t delay_ms, size_t times, ReactorCallback callback);
 
+         //! Adds a timer with a delay in microseconds to the reactor
+         int register_timer_us(size_t delay_us, size_t times, ReactorCallback callback);
+
          //! Removes a timer from the reactor
          void remove_timer(int timer_id);
 
+         //! Posts a callback to be called from the reactor loop, from any thread
+         void post(ReactorCallback callback);
+
         //! Runs the reactor polling loop
         int run(void);
 
+        //! Runs a single iteration of the reactor polling loop
+        int run_once(long timeout_ms);
+
         //! Signals that the reactor polling loop should stop gracefully
         void stop(void);
 
+        //! Indicates if the reactor has been signalled to stop
+        bool is_stopped(void) const;
+
+        //! Returns the backend used to wait for events
+        Defaults::ReactorBackend get_backend(void) const;
+
     private:
 
+        //! Runs a single iteration of the reactor polling loop, called from the loop itself
+        int run_iteration(long timeout_ms);
+
+        //! Polls the channels and sockets with zmq::poll and calls the handlers of those ready
+        int dispatch_poll(long timeout_ms);
+
+        //! Waits for events with epoll and calls the handlers of the channels and sockets ready
+        int dispatch_epoll(long timeout_ms);
+
+        //! Calls the handlers of timers that have fired, removing those that have expired
+        void dispatch_timers(void);
+
+        //! Returns when the next timer is due to fire, discarding heap entries of removed timers
+        bool next_timer_due(TimeUs& when_us);
+
+        //! Discards the heap entries of removed timers and rebuilds the heap from those remaining
+        void compact_timer_heap(void);
+
+        //! Arms the timerfd of the epoll backend for the next timer due to fire
+        void arm_timer_fd(void);
+
+        //! Calls the callbacks posted to the reactor
+        void dispatch_posted(void);
+
+        //! Wakes the reactor to call posted callbacks, unless a wake-up is already pending
+        void wake_posted(void);
+
+        //! Adds or removes a file descriptor in the epoll instance
+        void epoll_add(int fd, bool edge_triggered);
+        void epoll_remove(int fd);
+        void set_fd_item(int fd, size_t item);
+
+        //! Indicates if a channel socket has a message to receive
+        bool channel_has_message(SocketPtr socket);
+
         //! Rebuilds the internal list of polling items
         void rebuild_pollitems(void);
 
         //! Calculates the next poll timeout based on the tickless pattern
         long calculate_timeout(void);
 
+        //! Converts the time until a timer is due into a poll timeout, rounded up to milliseconds
+        static long timeout_until(TimeUs when_us, TimeUs now_us);
+
         // Private member variables
 
         bool terminate_reactor_;         //!< Indicates that the reactor loop should terminate
         ChannelMap channels_;            //!< Map of channels associated with the reactor
         SocketMap  sockets_;
         TimerMap   timers_;              //!< Map of timers associated with the reactor
+        std::vector<TimerHeapEntry> timer_heap_; //!< Min-heap of when each timer is next due
+        std::vector<TimerHeapEntry> fired_timers_; //!< Timers that have fired, popped from the heap
         zmq::pollitem_t* pollitems_;     //!< Ptr to array of pollitems to use in poll call
         ReactorCallback* callbacks_;     //!< Ptr to matched array of callbacks
         std::size_t      pollsize_;      //!< Number if active items to poll
         bool             needs_rebuild_; //!< Indicates that the poll item list needs rebuilding
+
+        Defaults::ReactorBackend backend_;           //!< Backend used to wait for events
+        int                      epoll_fd_;          //!< epoll instance file descriptor, -1 with the poll backend
+        ChannelFdMap             channel_fds_;       //!< ZMQ_FD file descriptors of channels registered with epoll
+        std::vector<SocketPtr>   item_channels_;     //!< Channel socket of each item, matched to the callback array
+        std::vector<int>         fd_items_;          //!< Item index of each registered file descriptor, -1 if none
+        std::vector<bool>        channel_pending_;   //!< Channels to check for messages, having signalled or had messages remaining
+        bool                     channels_pending_;  //!< Indicates that at least one channel has messages remaining
+        bool                     recheck_channels_;  //!< Indicates that every channel must be checked for messages
+        int                      timer_fd_;          //!< timerfd armed for the next timer with the epoll backend, -1 if none
+        TimeUs                   timer_fd_when_;     //!< Time the timerfd is armed for, 0 if disarmed
+
+        PostedTask*              post_head_;         //!< Last task posted, exchanged atomically by posting threads
+        PostedTask*              post_tail_;         //!< Last task called, whose next task is the first waiting
+        int                      post_fd_;           //!< Descriptor polled to wake the reactor for posted tasks
+        int                      post_wake_fd_;      //!< Descriptor written to wake the reactor for posted tasks
+        bool                     post_wake_pending_; //!< Indicates the reactor has been woken and not yet drained the queue
+#ifdef __linux__
+        std::vector<struct epoll_event> epoll_events_; //!< Events returned by epoll_wait
+#endif
     };
 
 } // namespace FrameReceiver
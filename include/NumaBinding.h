@@ -0,0 +1,46 @@
+/*!
+ * NumaBinding.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_NUMABINDING_H_
+#define INCLUDE_NUMABINDING_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "FrameReceiverDefaults.h"
+
+namespace FrameReceiver
+{
+    //! NumaBinding - NUMA memory placement and thread binding
+    //!
+    //! This class provides static helpers to keep the data path on the NUMA node local to the
+    //! receiving NIC. Memory regions, e.g. the shared frame buffer, can be bound to or
+    //! interleaved across nodes, and threads can be bound to the CPUs of a node with their
+    //! own allocations preferring that node. The memory policy system calls are used
+    //! directly, so there is no dependency on libnuma. Errors are reported by throwing a
+    //! FrameReceiverException; binding is not supported on platforms other than Linux.
+
+    class NumaBinding
+    {
+    public:
+
+        static void bind_memory(void* addr, size_t length, Defaults::NumaPolicy policy,
+                const std::vector<int>& nodes);
+        static void bind_thread(int node, bool set_affinity=true);
+
+        static void get_node_cpus(int node, std::vector<int>& cpus);
+        static void parse_cpu_list(const std::string& cpu_list_str, std::vector<int>& cpus);
+
+    private:
+
+        static void build_node_mask(const std::vector<int>& nodes, std::vector<unsigned long>& node_mask);
+    };
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_NUMABINDING_H_ */
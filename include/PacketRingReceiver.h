@@ -0,0 +1,95 @@
+/*!
+ * PacketRingReceiver.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_PACKETRINGRECEIVER_H_
+#define INCLUDE_PACKETRINGRECEIVER_H_
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <netinet/in.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include <log4cxx/logger.h>
+using namespace log4cxx;
+using namespace log4cxx::helpers;
+#include "DebugLevelLogger.h"
+
+#include "FrameReceiverException.h"
+
+namespace FrameReceiver
+{
+    //! PacketRingReceiverException - custom exception class implementing "what" for error string
+    class PacketRingReceiverException : public FrameReceiverException
+    {
+    public:
+        PacketRingReceiverException(const std::string what) : FrameReceiverException(what) { };
+    };
+
+    //! Callback type for UDP payloads extracted from the ring: payload, size, destination port, source address
+    typedef boost::function<void(uint8_t*, size_t, int, struct sockaddr_in*)> PacketRingHandler;
+
+    //! PacketRingReceiver - AF_PACKET TPACKET_V3 ring buffer capture of UDP packets
+    //!
+    //! This class captures packets on a network interface into a memory-mapped block ring shared
+    //! with the kernel, delivering many packets per wake-up with no per-packet system call. The
+    //! Ethernet, IP and UDP headers of each packet are parsed in user space and the UDP payloads
+    //! of packets addressed to the receive ports are passed to a handler. Fragmented IP datagrams
+    //! are not reassembled, so the interface MTU must be large enough for the detector packets.
+    //! Capturing requires the CAP_NET_RAW capability and is only supported on Linux.
+
+    class PacketRingReceiver
+    {
+    public:
+
+        PacketRingReceiver(LoggerPtr& logger, const std::string& interface, const std::string& address,
+                const std::vector<uint16_t>& ports, size_t block_size, unsigned int num_blocks,
+                unsigned int block_timeout_ms);
+        ~PacketRingReceiver();
+
+        void join_fanout_group(uint16_t group_id);
+
+        int get_socket(void) const;
+        size_t process_blocks(const PacketRingHandler& handler);
+
+        void update_statistics(void);
+        const uint64_t get_packets_captured(void) const;
+        const uint64_t get_packets_dropped(void) const;
+        const uint64_t get_packets_received(void) const;
+        const uint64_t get_packets_ignored(void) const;
+
+    private:
+
+        bool is_receive_port(uint16_t port) const;
+
+        LoggerPtr             logger_;
+        std::string           interface_;
+        in_addr_t             address_;
+        std::vector<uint16_t> ports_;
+
+        int                   socket_;
+        uint8_t*              ring_;
+        size_t                ring_size_;
+        size_t                block_size_;
+        unsigned int          num_blocks_;
+        unsigned int          current_block_;
+
+        uint64_t              packets_captured_;
+        uint64_t              packets_dropped_;
+        uint64_t              packets_received_;
+        uint64_t              packets_ignored_;
+    };
+
+    typedef boost::shared_ptr<PacketRingReceiver> PacketRingReceiverPtr;
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_PACKETRINGRECEIVER_H_ */
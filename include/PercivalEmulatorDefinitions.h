@@ -10,6 +10,11 @@
 
 #define P2M_EMULATOR_NEW_FIRMWARE 1
 
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
 namespace PercivalEmulator {
 
 #ifdef P2M_EMULATOR_NEW_FIRMWARE
@@ -63,22 +68,107 @@ namespace PercivalEmulator {
         PacketTypeReset  = 1,
     } PacketType;
 
+    static const size_t num_frame_packets   = num_subframes * num_data_types *
+                                              (num_primary_packets + num_tail_packets);
+
+    //! Magic value and version of the frame header layout, which downstream readers should check
+    //! before interpreting the header. Both lead the header, so keep their offsets in this and
+    //! every later layout. Version 1 headers, with per-packet state bytes, have no magic or
+    //! version, and version 2 carried its version at an offset holding frame info bytes in
+    //! version 1, so a header is only recognised when the magic matches as well as the version.
+    //! Version 3 moved the magic and version to the start of the header and dropped the packet
+    //! counter, packets received being counted from the packet state bitmap.
+    static const uint32_t frame_header_magic   = 0x5043564c;
+    static const uint32_t frame_header_version = 3;
+
+    //! Packet state is a bitmap indexed by the linear packet index in the frame, i.e.
+    //! ((data type * num_subframes) + subframe) * packets per subframe + packet number
+    static const size_t packet_state_word_bits = 64;
+    static const size_t num_packet_state_words = (num_frame_packets + packet_state_word_bits - 1)
+                                               / packet_state_word_bits;
+
     typedef struct
     {
+        uint32_t header_magic;
+        uint32_t header_version;
         uint32_t frame_number;
         uint32_t frame_state;
         struct timespec frame_start_time;
-        uint32_t packets_received;
         uint8_t  frame_info[frame_info_size];
-        uint8_t  packet_state[num_data_types][num_subframes][num_primary_packets + num_tail_packets];
+        uint64_t packet_state[num_packet_state_words] __attribute__((aligned(8)));
     } FrameHeader;
 
     static const size_t subframe_size       = (num_primary_packets * primary_packet_size)
                                             + (num_tail_packets * tail_packet_size);
     static const size_t data_type_size      = subframe_size * num_subframes;
     static const size_t total_frame_size    = (data_type_size * num_data_types) + sizeof(FrameHeader);
-    static const size_t num_frame_packets   = num_subframes * num_data_types *
-                                              (num_primary_packets + num_tail_packets);
+
+    //! Test whether a frame header has the magic value and layout version of this definition
+    inline bool is_supported_header(const FrameHeader* header)
+    {
+        return (header->header_magic == frame_header_magic) &&
+                (header->header_version == frame_header_version);
+    }
+
+    //! Return the linear index of a packet in the frame packet state bitmap
+    inline size_t packet_state_index(size_t type, size_t subframe, size_t packet_number)
+    {
+        return ((type * num_subframes) + subframe) * (num_primary_packets + num_tail_packets) + packet_number;
+    }
+
+    //! Test whether a packet has been received into a frame
+    inline bool test_packet_state(const FrameHeader* header, size_t packet_idx)
+    {
+        return (header->packet_state[packet_idx / packet_state_word_bits] >>
+                (packet_idx % packet_state_word_bits)) & 1;
+    }
+
+    //! Mark a packet as received in a frame, returning true if it had already been received.
+    //! The update is atomic as packets of a frame may be received in several threads.
+    inline bool test_and_set_packet_state(FrameHeader* header, size_t packet_idx)
+    {
+        uint64_t mask = static_cast<uint64_t>(1) << (packet_idx % packet_state_word_bits);
+        uint64_t* word = &(header->packet_state[packet_idx / packet_state_word_bits]);
+        if (*word & mask)
+        {
+            return true;
+        }
+        return (__sync_fetch_and_or(word, mask) & mask) != 0;
+    }
+
+    //! Count the packets received into a frame from its packet state bitmap
+    inline size_t count_packet_state(const FrameHeader* header)
+    {
+        size_t packets = 0;
+        for (size_t word_idx = 0; word_idx < num_packet_state_words; word_idx++)
+        {
+            packets += __builtin_popcountll(header->packet_state[word_idx]);
+        }
+        return packets;
+    }
+
+    //! Append the linear indices of packets missing from a frame to a vector, returning the
+    //! number appended. Received packets are skipped a word at a time.
+    inline size_t get_missing_packets(const FrameHeader* header, std::vector<size_t>& missing_packets)
+    {
+        size_t num_missing = 0;
+        for (size_t word_idx = 0; word_idx < num_packet_state_words; word_idx++)
+        {
+            uint64_t missing = ~(header->packet_state[word_idx]);
+            while (missing)
+            {
+                size_t packet_idx = (word_idx * packet_state_word_bits) + __builtin_ctzll(missing);
+                if (packet_idx >= num_frame_packets)
+                {
+                    break;
+                }
+                missing_packets.push_back(packet_idx);
+                num_missing++;
+                missing &= (missing - 1);
+            }
+        }
+        return num_missing;
+    }
 
 }
 
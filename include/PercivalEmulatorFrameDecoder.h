@@ -10,7 +10,9 @@
 
 #include "FrameDecoder.h"
 #include "PercivalEmulatorDefinitions.h"
+#include "FrameTimerWheel.h"
 #include <iostream>
+#include <vector>
 #include <stdint.h>
 #include <time.h>
 
@@ -27,7 +29,10 @@ namespace FrameReceiver
         const size_t get_frame_buffer_size(void) const;
         const size_t get_frame_header_size(void) const;
 
-        inline const bool requires_header_peek(void) const { return true; };
+        inline const FrameDecoder::PacketReceiveMode get_packet_receive_mode(void) const
+        {
+            return FrameDecoder::PacketReceiveModeSpeculative;
+        };
         const size_t get_packet_header_size(void) const;
         void process_packet_header(size_t bytes_received, int port, struct sockaddr_in* from_addr);
 
@@ -35,6 +40,15 @@ namespace FrameReceiver
         size_t get_next_payload_size(void) const;
         FrameDecoder::FrameReceiveState process_packet(size_t bytes_received);
 
+        void init_batch_receive(size_t max_batch_packets);
+        void prepare_batch_receive(size_t num_packets);
+        void* get_batch_header_buffer(size_t packet_idx);
+        void* get_batch_payload_buffer(size_t packet_idx);
+        size_t get_batch_payload_size(size_t packet_idx) const;
+        FrameDecoder::FrameReceiveState process_batch_packet(size_t packet_idx, size_t bytes_received,
+                int port, struct sockaddr_in* from_addr);
+
+        void expire_frames(void);
         void monitor_buffers(void);
 
         void* get_packet_header_buffer(void);
@@ -51,23 +65,59 @@ namespace FrameReceiver
 #endif
         uint8_t* get_frame_info(void) const;
 
+        const uint64_t get_packets_duplicated(void) const;
+
     private:
 
+        void decode_packet_header(size_t bytes_received, int port, struct sockaddr_in* from_addr);
+        void* initialise_frame_buffer(int buffer_id);
+        bool lookup_frame_cache(uint32_t frame_number);
+        void update_frame_cache(uint32_t frame_number, int buffer_id, void* frame_header);
+        void evict_frame_cache(uint32_t frame_number);
+        void initialise_frame_header(PercivalEmulator::FrameHeader* header_ptr);
+        uint8_t* speculate_payload_buffer(size_t packet_idx) const;
+        void relocate_batch_payload(size_t packet_idx, size_t bytes_received);
+
         uint8_t* raw_packet_header(void) const;
-        unsigned int elapsed_ms(struct timespec& start, struct timespec& end);
+        static uint64_t timespec_to_ms(const struct timespec& time);
+        static uint64_t frame_start_time_ns(const PercivalEmulator::FrameHeader* frame_header);
 
         boost::shared_ptr<void> current_packet_header_;
+        uint8_t* packet_header_;
         boost::shared_ptr<void> dropped_frame_buffer_;
 
         uint32_t current_frame_seen_;
         int current_frame_buffer_id_;
         void* current_frame_buffer_;
         PercivalEmulator::FrameHeader* current_frame_header_;
+        int current_packet_index_;
 
         bool dropping_frame_data_;
+        FrameBufferInitialiser frame_buffer_initialiser_;
+
+        //! Number of recently seen frames cached to avoid pool lookups for interleaved packets
+        static const unsigned int frame_cache_size = 4;
+        FrameBufferSlot frame_cache_[frame_cache_size];
+        unsigned int frame_cache_next_;
 
         unsigned int frame_timeout_ms_;
+        FrameTimerWheel frame_timer_wheel_;
+        std::vector<FrameTimerExpiry> expired_frames_;
+        std::vector<struct timespec> frame_start_times_;
         unsigned int frames_timedout_;
+        unsigned int frames_timedout_reported_;
+
+        bool current_packet_duplicate_;
+        uint64_t packets_duplicated_;
+        std::vector<size_t> missing_packets_;
+
+        size_t batch_capacity_;
+        size_t batch_size_;
+        std::vector<uint8_t>  batch_headers_;
+        std::vector<uint8_t>  batch_scratch_;
+        std::vector<uint8_t>  batch_swap_;
+        std::vector<uint8_t*> batch_payload_buffers_;
+        unsigned int batch_packets_relocated_;
     };
 
 } // namespace FrameReceiver
@@ -9,13 +9,17 @@
 #define SHAREDBUFFERMANAGER_H_
 
 #include "FrameReceiverException.h"
+#include "SharedFrameRing.h"
+#include "FrameReceiverDefaults.h"
 
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 #include <stddef.h>
+#include <stdint.h>
 
 namespace FrameReceiver
 {
@@ -26,6 +30,71 @@ namespace FrameReceiver
         SharedBufferManagerException(const std::string what) : FrameReceiverException(what) { }
     };
 
+    //! States of a frame buffer recorded in its descriptor
+    enum BufferState
+    {
+        BufferStateFree,     //!< Empty and available to a frame decoder
+        BufferStateFilling,  //!< Receiving frame data
+        BufferStateReady,    //!< Holding a frame ready for processing
+        BufferStateInUse,    //!< Being processed by a consumer
+        NumBufferStates
+    };
+
+    //! BufferDescriptor - state of a frame buffer, held in shared memory
+    //!
+    //! Each descriptor occupies its own cache line so that processes updating different buffers
+    //! do not contend. The state is written last, with release ordering, so the other fields are
+    //! valid once a state is observed.
+    struct BufferDescriptor
+    {
+        uint32_t state;          //!< Buffer state, a BufferState value
+        uint32_t frame_number;   //!< Number of the frame held in the buffer
+        uint32_t owner;          //!< Process ID of the buffer owner, zero when free
+        uint32_t generation;     //!< Number of times the buffer has been filled
+        uint32_t ref_count;      //!< Number of consumers yet to release the frame in the buffer
+        uint32_t size_class;     //!< Size class of the buffer, zero being the largest buffers
+        uint8_t  pad[40];        //!< Padding to a cache line
+    };
+
+    //! SharedBufferManager - manages frame buffers in a named shared memory segment
+    //!
+    //! The segment starts with a header followed by the frame buffers. A cache-line aligned table
+    //! of buffer descriptors follows the buffers, recording the state, frame number, owner and
+    //! generation of each buffer, so that any process can inspect or claim buffers and snapshot
+    //! their occupancy without exchanging messages. Each descriptor also counts the consumers yet
+    //! to release the frame in the buffer, so a frame can be shared by several consumers without
+    //! copying.
+    //!
+    //! The segment may optionally hold a frame ring area after the descriptor table, containing a
+    //! ready ring for each producer of frames, a release ring returning buffers to the producers,
+    //! and an event used to wake the consumer. This allows frame ready and release notifications
+    //! to be passed between processes as descriptors in shared memory rather than as messages.
+    //! The descriptor table and ring area are located from the buffer layout and identified by
+    //! magic words, so the header is unchanged and existing clients mapping the segment by name
+    //! are unaffected.
+    //!
+    //! The segment is normally a POSIX shared memory object using the system page size. It may
+    //! instead be backed by huge pages as a file in a hugetlbfs mount, in which case the page size
+    //! is that of the mount, e.g. 2 MiB or 1 GiB. The buffer stride is then aligned to the page
+    //! size, or to a power of two dividing it for buffers smaller than a page, and recorded in the
+    //! header as the buffer size, so that clients address buffers as for any other segment.
+    //!
+    //! Buffers may be divided into several size classes, so that decoders producing frames of
+    //! varying size need not reserve a maximum-sized buffer for every frame. The shared memory is
+    //! split equally between the classes. The buffers of the largest class are described by the
+    //! header as before, while those of smaller classes follow the ring area, each class starting
+    //! on a page boundary. A size class table after the buffer descriptors records the size, number,
+    //! first buffer index and offset of each class, and each descriptor records its buffer's class.
+    //! Buffer indices run through the classes in order, largest first, so clients unaware of size
+    //! classes see only the largest buffers.
+    //!
+    //! An overflow tier of full size spill buffers may be added in a memory-mapped file, e.g. on
+    //! local NVMe or tmpfs, to absorb short downstream stalls when the buffers in memory run out.
+    //! Spill buffers take the indices following all the buffers in memory and have descriptors
+    //! like any other buffer. The spill file path is recorded after the size class table, so a
+    //! client mapping the segment by name also maps the spill file and addresses spill buffers
+    //! transparently.
+
     class SharedBufferManager
     {
     public:
@@ -38,25 +107,138 @@ namespace FrameReceiver
         } Header;
 
         SharedBufferManager(const std::string& shared_mem_name, const size_t shared_mem_size,
-                const size_t buffer_size, bool remove_when_deleted=true);
-        SharedBufferManager(const std::string& shared_mem_name);
+                const size_t buffer_size, bool remove_when_deleted=true, unsigned int num_ready_rings=0,
+                const std::string& huge_page_dir="",
+                const std::vector<size_t>& size_class_buffer_sizes=std::vector<size_t>(),
+                const std::string& spill_file_path="", const size_t spill_file_size=0);
+        SharedBufferManager(const std::string& shared_mem_name,
+                const std::string& huge_page_dir=Defaults::default_huge_page_dir);
 
         ~SharedBufferManager();
 
         const size_t get_manager_id(void) const;
         const size_t get_num_buffers(void) const;
         const size_t get_buffer_size(void) const;
+        const size_t get_buffer_size(const unsigned int buffer) const;
 
         void* get_buffer_address(const unsigned int buffer) const;
 
+        const unsigned int get_num_size_classes(void) const;
+        const unsigned int get_size_class(const unsigned int buffer) const;
+        const size_t get_size_class_buffer_size(const unsigned int size_class) const;
+        const size_t get_size_class_num_buffers(const unsigned int size_class) const;
+        const unsigned int find_size_class(const size_t frame_size) const;
+
+        const bool has_spill_buffers(void) const;
+        const size_t get_num_spill_buffers(void) const;
+        const bool is_spill_buffer(const unsigned int buffer) const;
+        const std::string& get_spill_file_path(void) const;
+
+        const size_t get_page_size(void) const;
+        const bool is_huge_page_backed(void) const;
+        static size_t get_huge_page_buffer_stride(size_t buffer_size, size_t page_size);
+
+        void bind_numa_policy(Defaults::NumaPolicy policy, const std::vector<int>& nodes);
+        void prefault(unsigned int num_threads=1, bool lock=false);
+        const bool is_locked(void) const;
+
+        const bool has_buffer_descriptors(void) const;
+        void reset_buffer_descriptors(void);
+        void set_buffer_state(const unsigned int buffer, BufferState state, uint32_t frame_number=0);
+        bool claim_buffer(const unsigned int buffer, BufferState from_state, BufferState to_state);
+        bool get_buffer_descriptor(const unsigned int buffer, BufferDescriptor& descriptor) const;
+        void get_buffer_occupancy(std::vector<size_t>& state_counts) const;
+        void set_buffer_references(const unsigned int buffer, uint32_t references);
+        uint32_t release_buffer_reference(const unsigned int buffer);
+
+        const bool has_frame_rings(void) const;
+        const unsigned int get_num_ready_rings(void) const;
+        SharedFrameRingPtr get_ready_ring(const unsigned int ring_idx) const;
+        SharedFrameRingPtr get_release_ring(void) const;
+        SharedFrameEventPtr get_ready_event(void) const;
+
     private:
 
+        typedef struct
+        {
+            uint64_t magic;
+            uint32_t num_ready_rings;
+            uint32_t reserved;
+            uint64_t ring_capacity;
+            uint8_t  pad[40];
+        } RingAreaHeader;
+
+        typedef struct
+        {
+            uint64_t magic;
+            uint64_t num_descriptors;
+            uint32_t num_size_classes;
+            uint32_t num_spill_buffers;
+            uint8_t  pad[40];
+        } DescriptorTableHeader;
+
+        typedef struct
+        {
+            uint64_t buffer_size;
+            uint64_t num_buffers;
+            uint64_t first_buffer;
+            uint64_t offset;
+        } SizeClassEntry;
+
+        typedef struct
+        {
+            uint64_t buffer_size;
+            uint64_t num_buffers;
+            char     path[240];
+        } SpillFileEntry;
+
+        struct SizeClass
+        {
+            size_t buffer_size;   //!< Size of each buffer in the class
+            size_t num_buffers;   //!< Number of buffers in the class
+            size_t first_buffer;  //!< Index of the first buffer in the class
+            size_t offset;        //!< Offset of the first buffer from the start of the region
+        };
+
+        const size_t get_descriptor_table_offset(void) const;
+        static size_t get_descriptor_table_size(size_t num_buffers, size_t num_size_classes, bool spill_file);
+        void map_size_classes(void);
+        void map_spill_file(bool create);
+        BufferDescriptor* get_descriptor(const unsigned int buffer) const;
+        const size_t get_ring_area_offset(void) const;
+        static size_t get_ring_area_size(unsigned int num_ready_rings, size_t ring_capacity);
+        int open_huge_page_file(int flags);
+        void map_huge_page_file(int fd, size_t region_size);
+        void remove_huge_page_file(void);
+        void discard_huge_page_file(int fd);
+        void release_region(void);
+        static void prefault_pages(char* start, char* end, size_t page_size);
+        void map_frame_rings(bool initialise);
+
         std::string shared_mem_name_;
         size_t      shared_mem_size_;
         bool        remove_when_deleted_;
         boost::interprocess::shared_memory_object shared_mem_;
         boost::interprocess::mapped_region        shared_mem_region_;
+        std::string                               huge_page_path_;
+        void*                                     huge_page_region_;
+        char*                                     region_addr_;
+        size_t                                    region_size_;
+        size_t                                    page_size_;
+        bool                                      locked_;
+        size_t                                    num_buffers_;
+        std::vector<SizeClass>                    size_classes_;
+        std::string                               spill_file_path_;
+        char*                                     spill_region_addr_;
+        size_t                                    spill_region_size_;
+        size_t                                    num_spill_buffers_;
         Header*                                   manager_hdr_;
+        DescriptorTableHeader*                    descriptor_table_hdr_;
+        BufferDescriptor*                         descriptors_;
+        RingAreaHeader*                           ring_area_hdr_;
+        std::vector<SharedFrameRingPtr>           ready_rings_;
+        SharedFrameRingPtr                        release_ring_;
+        SharedFrameEventPtr                       ready_event_;
 
         static size_t last_manager_id;
     };
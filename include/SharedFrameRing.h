@@ -0,0 +1,115 @@
+/*!
+ * SharedFrameRing.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef INCLUDE_SHAREDFRAMERING_H_
+#define INCLUDE_SHAREDFRAMERING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+namespace FrameReceiver
+{
+    //! FrameDescriptor - fixed-size notification of a frame buffer passed between processes
+    struct FrameDescriptor
+    {
+        uint32_t frame_number;   //!< Frame number
+        int32_t  buffer_id;      //!< ID of the shared buffer holding the frame
+        uint64_t timestamp_ns;   //!< Time the frame started, in nanoseconds since the epoch, zero if unknown
+        uint32_t reserved[4];    //!< Frame state and flags, see below, then reserved and set to zero,
+                                 //!< padding the descriptor to 32 bytes
+    };
+
+    //! Index in FrameDescriptor::reserved of the FrameDecoder::FrameReceiveState of the frame
+    const unsigned int frame_descriptor_state_idx = 0;
+    //! Index in FrameDescriptor::reserved of the frame flags
+    const unsigned int frame_descriptor_flags_idx = 1;
+    //! Frame flag set if the frame is held in a spill buffer rather than in memory
+    const uint32_t frame_descriptor_flag_spilled = 0x1;
+
+    //! SharedFrameRing - single-producer, single-consumer ring of frame descriptors
+    //!
+    //! This class implements a lock-free ring of frame descriptors in memory that may be shared
+    //! between processes, e.g. within a SharedBufferManager segment. The producer and consumer
+    //! indices are free-running 64-bit counters held on separate cache lines, so that each side
+    //! only writes its own line and reads the other. Exactly one thread may push and one thread
+    //! pop at any time; callers sharing either side between threads must serialise access.
+    //! The ring does not block; consumers wait for new descriptors with a SharedFrameEvent.
+
+    class SharedFrameRing
+    {
+    public:
+
+        SharedFrameRing(void* ring_address, size_t capacity, bool initialise);
+
+        static size_t get_required_size(size_t capacity);
+
+        bool push(const FrameDescriptor& descriptor);
+        bool pop(FrameDescriptor& descriptor);
+
+        const size_t get_capacity(void) const;
+        const size_t get_size(void) const;
+        const uint64_t get_num_pushed(void) const;
+        const uint64_t get_num_popped(void) const;
+
+    private:
+
+        struct RingHeader
+        {
+            uint64_t capacity;
+            uint8_t  pad0[56];
+            uint64_t head;       //!< Number of descriptors pushed, written by the producer
+            uint8_t  pad1[56];
+            uint64_t tail;       //!< Number of descriptors popped, written by the consumer
+            uint8_t  pad2[56];
+        };
+
+        RingHeader*      header_;
+        FrameDescriptor* descriptors_;
+        uint64_t         mask_;
+    };
+
+    typedef boost::shared_ptr<SharedFrameRing> SharedFrameRingPtr;
+
+    //! SharedFrameEvent - wake-up event for consumers of shared frame rings
+    //!
+    //! This class signals consumers waiting for descriptors to be pushed onto one or more rings.
+    //! It holds a sequence number and a count of waiters in shared memory. Producers increment
+    //! the sequence after pushing and only make a system call to wake the consumer if it is
+    //! waiting. On Linux, waiting uses a futex on the sequence number, which works between
+    //! processes; on other platforms the consumer sleeps briefly instead.
+
+    class SharedFrameEvent
+    {
+    public:
+
+        SharedFrameEvent(void* event_address, bool initialise);
+
+        static size_t get_required_size(void);
+
+        void signal(void);
+        const uint32_t get_sequence(void) const;
+        bool wait(uint32_t sequence, unsigned int timeout_ms);
+
+    private:
+
+        struct EventHeader
+        {
+            uint32_t sequence;
+            uint32_t waiters;
+            uint8_t  pad[56];
+        };
+
+        EventHeader* header_;
+    };
+
+    typedef boost::shared_ptr<SharedFrameEvent> SharedFrameEventPtr;
+
+} // namespace FrameReceiver
+
+#endif /* INCLUDE_SHAREDFRAMERING_H_ */
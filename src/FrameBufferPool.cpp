@@ -0,0 +1,483 @@
+/*!
+ * FrameBufferPool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "FrameBufferPool.h"
+#include "FrameReceiverException.h"
+
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+
+using namespace FrameReceiver;
+
+namespace
+{
+    // Alignment of the in-flight frame table, matching the cache line size
+    const size_t frame_table_alignment = 64;
+
+    // Capacity of the in-flight frame table until it is sized for a shared buffer
+    const size_t default_frame_table_capacity = 64;
+}
+
+//! Constructor for FrameBufferPool class.
+//!
+//! This constructor initialises an empty pool with no registered decoders.
+
+FrameBufferPool::FrameBufferPool() :
+    empty_buffer_queues_(1),
+    first_spill_buffer_(-1),
+    num_empty_buffers_(0),
+    frame_table_(0),
+    frame_table_capacity_(0),
+    frame_table_mask_(0),
+    num_mapped_frames_(0),
+    num_decoders_(0)
+{
+    allocate_frame_table(default_frame_table_capacity);
+}
+
+//! Destructor for FrameBufferPool class.
+
+FrameBufferPool::~FrameBufferPool()
+{
+    free(frame_table_);
+}
+
+//! Register a frame decoder as a user of the pool.
+//!
+//! Decoders register with the pool so that they can determine if buffers are shared with
+//! decoders running in other threads, in which case they must not speculatively receive
+//! packet data into frame buffers.
+
+void FrameBufferPool::register_decoder(void)
+{
+    __atomic_add_fetch(&num_decoders_, 1, __ATOMIC_SEQ_CST);
+}
+
+//! Indicate if the pool is shared by more than one decoder.
+//!
+//! This is called on the receive path, so reads the decoder count without taking the lock.
+//!
+//! \return true if more than one decoder is registered with the pool
+
+const bool FrameBufferPool::is_shared(void) const
+{
+    return (__atomic_load_n(&num_decoders_, __ATOMIC_SEQ_CST) > 1);
+}
+
+//! Size the in-flight frame table for the number of buffers in the shared buffer.
+//!
+//! The table capacity is set to the smallest power of two of at least twice the number of
+//! buffers, and is not changed again as buffers are added to the pool. This must be called
+//! when the pool is set up, before any frames are assigned buffers.
+//!
+//! \param num_buffers - total number of buffers that may be pushed onto the pool
+
+void FrameBufferPool::size_frame_table(size_t num_buffers)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if (num_mapped_frames_ > 0)
+    {
+        throw FrameReceiverException("Cannot size the frame table of a pool with frames in flight");
+    }
+
+    size_t capacity = default_frame_table_capacity;
+    while (capacity < (num_buffers * 2))
+    {
+        capacity *= 2;
+    }
+    if (capacity != frame_table_capacity_)
+    {
+        allocate_frame_table(capacity);
+    }
+}
+
+//! Register the size class of each buffer, creating an empty buffer queue for each class.
+//!
+//! Any buffers already queued are moved to the queue of their class. Buffers not covered by
+//! the mapping are assigned to the first class.
+//!
+//! \param buffer_size_classes - size class of each buffer, indexed by buffer ID
+
+void FrameBufferPool::register_size_classes(const std::vector<unsigned int>& buffer_size_classes)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    unsigned int num_size_classes = 1;
+    for (std::vector<unsigned int>::const_iterator class_itr = buffer_size_classes.begin();
+            class_itr != buffer_size_classes.end(); class_itr++)
+    {
+        num_size_classes = std::max(num_size_classes, *class_itr + 1);
+    }
+
+    std::vector<std::queue<int> > queued_buffers(num_size_classes);
+    queued_buffers.swap(empty_buffer_queues_);
+    buffer_size_classes_ = buffer_size_classes;
+    requeue_empty_buffers_locked(queued_buffers);
+}
+
+//! Return the number of buffer size classes in the pool.
+//!
+//! \return number of size classes
+
+const unsigned int FrameBufferPool::get_num_size_classes(void) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return empty_buffer_queues_.size();
+}
+
+//! Register the range of buffer IDs that are spill buffers, queueing them separately.
+//!
+//! Any buffers already queued in that range are moved to the spill buffer queue.
+//!
+//! \param first_spill_buffer - ID of the first spill buffer, all higher IDs are also spill buffers
+
+void FrameBufferPool::register_spill_buffers(int first_spill_buffer)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    std::vector<std::queue<int> > queued_buffers(empty_buffer_queues_.size());
+    queued_buffers.swap(empty_buffer_queues_);
+    queued_buffers.push_back(spill_buffer_queue_);
+    spill_buffer_queue_ = std::queue<int>();
+    first_spill_buffer_ = first_spill_buffer;
+    requeue_empty_buffers_locked(queued_buffers);
+}
+
+//! Push an empty buffer onto the pool queue of its size class.
+//!
+//! \param buffer_id - ID of the empty buffer
+
+void FrameBufferPool::push_empty_buffer(int buffer_id)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    push_empty_buffer_locked(buffer_id);
+}
+
+//! Register a shared frame release ring from which released buffers are returned to the pool.
+//!
+//! \param release_ring - release ring, which must have no other consumer
+//! \param buffer_manager - shared buffer manager in which to mark drained buffers free, if any
+
+void FrameBufferPool::register_release_ring(SharedFrameRingPtr release_ring, SharedBufferManagerPtr buffer_manager)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    release_ring_ = release_ring;
+    release_buffer_manager_ = buffer_manager;
+}
+
+//! Drain released buffers from the release ring onto the empty buffer queue.
+//!
+//! This is called periodically so that released buffers are counted as empty, as well as
+//! when the queue runs out of buffers.
+//!
+//! \return number of buffers drained from the ring
+
+size_t FrameBufferPool::drain_release_ring(void)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return drain_release_ring_locked();
+}
+
+//! Return the number of empty buffers available in the pool.
+//!
+//! \return number of empty buffers
+
+const size_t FrameBufferPool::get_num_empty_buffers(void) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return num_empty_buffers_;
+}
+
+//! Return the number of empty buffers of a size class available in the pool.
+//!
+//! \param size_class - size class index
+//! \return number of empty buffers in the class, zero for an unknown class
+
+const size_t FrameBufferPool::get_num_empty_buffers(unsigned int size_class) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return (size_class < empty_buffer_queues_.size()) ? empty_buffer_queues_[size_class].size() : 0;
+}
+
+//! Return the number of empty spill buffers available in the pool.
+//!
+//! \return number of empty spill buffers
+
+const size_t FrameBufferPool::get_num_empty_spill_buffers(void) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return spill_buffer_queue_.size();
+}
+
+//! Return the number of buffers currently mapped to frames.
+//!
+//! \return number of mapped buffers
+
+const size_t FrameBufferPool::get_num_mapped_buffers(void) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return num_mapped_frames_;
+}
+
+//! Return the number of slots in the in-flight frame table.
+//!
+//! \return frame table capacity
+
+const size_t FrameBufferPool::get_frame_table_capacity(void) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+    return frame_table_capacity_;
+}
+
+//! Get the buffer assigned to a frame, assigning an empty buffer if necessary.
+//!
+//! This method returns the ID of the buffer mapped to the specified frame. If the frame is not
+//! yet mapped, the next empty buffer of the requested size class, or failing that of the
+//! smallest larger class available, or failing that a spill buffer, is assigned to it and the
+//! initialiser is called with the
+//! buffer ID while the pool lock is held, ensuring that the frame header is initialised before
+//! any other thread can receive packets into that buffer. The frame header address returned
+//! by the initialiser is stored in the frame table and returned to subsequent callers.
+//!
+//! \param frame_number - number of the frame
+//! \param initialiser - callback to initialise a newly assigned buffer
+//! \param frame_header - if not null, set to the frame header address of the buffer
+//! \param size_class - size class of buffer required by the frame, zero being the largest
+//! \return ID of the buffer assigned to the frame, or -1 if no suitable empty buffers are available
+//!         or the frame table has no free slot for another frame
+
+int FrameBufferPool::get_frame_buffer(uint32_t frame_number, const FrameBufferInitialiser& initialiser,
+        void** frame_header, unsigned int size_class)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    FrameBufferSlot& slot = frame_table_[find_frame_slot(frame_number)];
+    if (slot.buffer_id < 0)
+    {
+        // Always leave one slot empty so that probing for an unmapped frame terminates
+        if ((num_mapped_frames_ + 1) >= frame_table_capacity_)
+        {
+            return -1;
+        }
+
+        // Search from the requested class towards the largest buffers, refilling the queues
+        // from the release ring before falling back to the spill buffers
+        size_class = std::min(size_class, static_cast<unsigned int>(empty_buffer_queues_.size() - 1));
+        int queue_idx = size_class;
+        while ((queue_idx >= 0) && empty_buffer_queues_[queue_idx].empty())
+        {
+            queue_idx--;
+            if ((queue_idx < 0) && drain_release_ring_locked())
+            {
+                queue_idx = size_class;
+            }
+        }
+        std::queue<int>& empty_buffer_queue = (queue_idx < 0) ? spill_buffer_queue_ : empty_buffer_queues_[queue_idx];
+        if (empty_buffer_queue.empty())
+        {
+            return -1;
+        }
+
+        slot.frame_number = frame_number;
+        slot.buffer_id = empty_buffer_queue.front();
+        empty_buffer_queue.pop();
+        num_empty_buffers_--;
+        slot.frame_header = initialiser(slot.buffer_id);
+        num_mapped_frames_++;
+    }
+
+    if (frame_header)
+    {
+        *frame_header = slot.frame_header;
+    }
+
+    return slot.buffer_id;
+}
+
+//! Release the buffer mapping for a frame.
+//!
+//! This method removes the mapping for the specified frame. Only the first caller for a given
+//! frame will succeed, allowing decoders in several threads to arbitrate which one notifies
+//! that a frame is ready.
+//!
+//! \param frame_number - number of the frame to release
+//! \return true if the frame was mapped and has been released
+
+bool FrameBufferPool::release_frame_buffer(uint32_t frame_number)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    size_t slot_idx = find_frame_slot(frame_number);
+    if (frame_table_[slot_idx].buffer_id < 0)
+    {
+        return false;
+    }
+
+    frame_table_[slot_idx].buffer_id = -1;
+    num_mapped_frames_--;
+
+    // Shift back any subsequent entries of the probe sequence that can no longer be reached
+    // past the slot just emptied, so that lookups can stop at the first empty slot
+    size_t empty_idx = slot_idx;
+    size_t next_idx = slot_idx;
+    while (true)
+    {
+        next_idx = (next_idx + 1) & frame_table_mask_;
+        if (frame_table_[next_idx].buffer_id < 0)
+        {
+            break;
+        }
+
+        size_t home_idx = frame_table_[next_idx].frame_number & frame_table_mask_;
+        bool reachable = (empty_idx <= next_idx) ?
+                ((empty_idx < home_idx) && (home_idx <= next_idx)) :
+                ((empty_idx < home_idx) || (home_idx <= next_idx));
+        if (!reachable)
+        {
+            frame_table_[empty_idx] = frame_table_[next_idx];
+            frame_table_[next_idx].buffer_id = -1;
+            empty_idx = next_idx;
+        }
+    }
+
+    return true;
+}
+
+//! Take a snapshot of the frames currently mapped to buffers.
+//!
+//! The vector is cleared and filled without reallocation if it has sufficient capacity, so
+//! callers polling the pool periodically should reuse the same vector.
+//!
+//! \param mapped_frames - vector to fill with the frame table slots in use
+
+void FrameBufferPool::get_mapped_frames(std::vector<FrameBufferSlot>& mapped_frames) const
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    mapped_frames.clear();
+    for (size_t slot_idx = 0; slot_idx < frame_table_capacity_; slot_idx++)
+    {
+        if (frame_table_[slot_idx].buffer_id >= 0)
+        {
+            mapped_frames.push_back(frame_table_[slot_idx]);
+        }
+    }
+}
+
+//! Push an empty buffer onto the queue of its size class.
+//!
+//! Must be called with the pool lock held.
+//!
+//! \param buffer_id - ID of the empty buffer
+
+void FrameBufferPool::push_empty_buffer_locked(int buffer_id)
+{
+    if ((first_spill_buffer_ >= 0) && (buffer_id >= first_spill_buffer_))
+    {
+        spill_buffer_queue_.push(buffer_id);
+        num_empty_buffers_++;
+        return;
+    }
+
+    unsigned int size_class = 0;
+    if ((buffer_id >= 0) && (static_cast<size_t>(buffer_id) < buffer_size_classes_.size()))
+    {
+        size_class = buffer_size_classes_[buffer_id];
+    }
+    empty_buffer_queues_[size_class].push(buffer_id);
+    num_empty_buffers_++;
+}
+
+//! Requeue buffers removed from the empty buffer queues after the queue mapping has changed.
+//!
+//! Must be called with the pool lock held.
+//!
+//! \param queued_buffers - queues of buffers to requeue, emptied by this call
+
+void FrameBufferPool::requeue_empty_buffers_locked(std::vector<std::queue<int> >& queued_buffers)
+{
+    num_empty_buffers_ = 0;
+    for (std::vector<std::queue<int> >::iterator queue_itr = queued_buffers.begin();
+            queue_itr != queued_buffers.end(); queue_itr++)
+    {
+        while (!queue_itr->empty())
+        {
+            push_empty_buffer_locked(queue_itr->front());
+            queue_itr->pop();
+        }
+    }
+}
+
+//! Drain the release ring onto the empty buffer queues.
+//!
+//! Must be called with the pool lock held.
+//!
+//! \return number of buffers drained from the ring
+
+size_t FrameBufferPool::drain_release_ring_locked(void)
+{
+    size_t num_drained = 0;
+    if (release_ring_)
+    {
+        FrameDescriptor descriptor;
+        while (release_ring_->pop(descriptor))
+        {
+            if (release_buffer_manager_)
+            {
+                release_buffer_manager_->set_buffer_state(descriptor.buffer_id, BufferStateFree);
+            }
+            push_empty_buffer_locked(descriptor.buffer_id);
+            num_drained++;
+        }
+    }
+    return num_drained;
+}
+
+//! Find the frame table slot for a frame.
+//!
+//! Must be called with the pool lock held.
+//!
+//! \param frame_number - number of the frame
+//! \return index of the slot holding the frame, or of the empty slot it would be assigned to
+
+size_t FrameBufferPool::find_frame_slot(uint32_t frame_number) const
+{
+    size_t slot_idx = frame_number & frame_table_mask_;
+    while ((frame_table_[slot_idx].buffer_id >= 0) && (frame_table_[slot_idx].frame_number != frame_number))
+    {
+        slot_idx = (slot_idx + 1) & frame_table_mask_;
+    }
+    return slot_idx;
+}
+
+//! Allocate an empty frame table of the given capacity, releasing any previous table.
+//!
+//! Must be called with the pool lock held and no frames mapped.
+//!
+//! \param capacity - number of slots, must be a power of two
+
+void FrameBufferPool::allocate_frame_table(size_t capacity)
+{
+    void* table_addr = 0;
+    if (posix_memalign(&table_addr, frame_table_alignment, capacity * sizeof(FrameBufferSlot)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    free(frame_table_);
+    frame_table_ = reinterpret_cast<FrameBufferSlot*>(table_addr);
+    frame_table_capacity_ = capacity;
+    frame_table_mask_ = capacity - 1;
+    for (size_t slot_idx = 0; slot_idx < frame_table_capacity_; slot_idx++)
+    {
+        frame_table_[slot_idx].frame_number = 0;
+        frame_table_[slot_idx].buffer_id = -1;
+        frame_table_[slot_idx].frame_header = 0;
+    }
+}
@@ -0,0 +1,216 @@
+/*!
+ * FrameConsumerTracker.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "FrameConsumerTracker.h"
+#include "FrameReceiverException.h"
+
+#include <sstream>
+
+using namespace FrameReceiver;
+
+//! Constructor for FrameConsumerTracker class.
+//!
+//! Several consumers can only be tracked if the shared buffer has a descriptor table to hold the
+//! reference counts.
+//!
+//! \param buffer_manager - shared buffer manager holding the frame buffers
+//! \param num_consumers - number of consumers that must release each frame
+//! \param max_lag - maximum number of frames a consumer may hold before it is dropped, zero for no limit
+
+FrameConsumerTracker::FrameConsumerTracker(SharedBufferManagerPtr buffer_manager, unsigned int num_consumers,
+        unsigned int max_lag) :
+    buffer_manager_(buffer_manager),
+    num_active_consumers_(num_consumers),
+    max_lag_(max_lag)
+{
+    if (num_consumers == 0)
+    {
+        throw FrameReceiverException("At least one frame consumer must be specified");
+    }
+    if ((num_consumers > 1) && !buffer_manager_->has_buffer_descriptors())
+    {
+        throw FrameReceiverException("Multiple frame consumers require a shared buffer with a descriptor table");
+    }
+
+    Consumer consumer;
+    consumer.active = true;
+    consumer.held.assign(buffer_manager_->get_num_buffers(), false);
+    consumer.lag = 0;
+    consumer.releases = 0;
+    consumers_.assign(num_consumers, consumer);
+}
+
+//! Record a frame that has become ready and is about to be notified to the consumers.
+//!
+//! The buffer reference count is set to the number of active consumers, so this must be called
+//! before the frame is notified. Any consumer whose lag then exceeds the maximum is dropped. If
+//! there are no active consumers the buffer is freed immediately.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param free_buffers - IDs of buffers that can be returned to the frame decoder are appended
+//! \return number of consumers dropped
+
+unsigned int FrameConsumerTracker::frame_ready(int buffer_id, std::vector<int>& free_buffers)
+{
+    if ((buffer_id < 0) || (static_cast<size_t>(buffer_id) >= buffer_manager_->get_num_buffers()))
+    {
+        std::stringstream ss;
+        ss << "Illegal buffer ID specified for ready frame: " << buffer_id;
+        throw FrameReceiverException(ss.str());
+    }
+
+    if (num_active_consumers_ == 0)
+    {
+        free_buffers.push_back(buffer_id);
+        return 0;
+    }
+
+    buffer_manager_->set_buffer_references(buffer_id, num_active_consumers_);
+
+    unsigned int consumers_dropped = 0;
+    for (unsigned int consumer_id = 0; consumer_id < consumers_.size(); consumer_id++)
+    {
+        Consumer& consumer = consumers_[consumer_id];
+        if (!consumer.active)
+        {
+            continue;
+        }
+
+        consumer.held[buffer_id] = true;
+        consumer.lag++;
+        if (max_lag_ && (consumer.lag > max_lag_))
+        {
+            drop_consumer(consumer_id, free_buffers);
+            consumers_dropped++;
+        }
+    }
+    return consumers_dropped;
+}
+
+//! Record the release of a frame by a consumer.
+//!
+//! Releases from unknown or dropped consumers, or of buffers the consumer does not hold, are
+//! ignored.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param consumer_id - index of the consumer releasing the frame
+//! \param free_buffers - IDs of buffers that can be returned to the frame decoder are appended
+//! \return true if the release was accepted
+
+bool FrameConsumerTracker::frame_released(int buffer_id, unsigned int consumer_id, std::vector<int>& free_buffers)
+{
+    if ((consumer_id >= consumers_.size()) || (buffer_id < 0) ||
+        (static_cast<size_t>(buffer_id) >= buffer_manager_->get_num_buffers()))
+    {
+        return false;
+    }
+
+    Consumer& consumer = consumers_[consumer_id];
+    if (!consumer.active || !consumer.held[buffer_id])
+    {
+        return false;
+    }
+
+    consumer.held[buffer_id] = false;
+    consumer.lag--;
+    consumer.releases++;
+    release_reference(buffer_id, free_buffers);
+    return true;
+}
+
+//! Drop a consumer, releasing its references to all the buffers it holds.
+//!
+//! \param consumer_id - index of the consumer
+//! \param free_buffers - IDs of buffers that can be returned to the frame decoder are appended
+
+void FrameConsumerTracker::drop_consumer(unsigned int consumer_id, std::vector<int>& free_buffers)
+{
+    if (!is_consumer_active(consumer_id))
+    {
+        return;
+    }
+
+    Consumer& consumer = consumers_[consumer_id];
+    consumer.active = false;
+    num_active_consumers_--;
+    for (size_t buffer_id = 0; buffer_id < consumer.held.size(); buffer_id++)
+    {
+        if (consumer.held[buffer_id])
+        {
+            consumer.held[buffer_id] = false;
+            release_reference(static_cast<int>(buffer_id), free_buffers);
+        }
+    }
+    consumer.lag = 0;
+}
+
+//! Return the number of consumers.
+//!
+//! \return number of consumers, including any dropped
+
+const unsigned int FrameConsumerTracker::get_num_consumers(void) const
+{
+    return consumers_.size();
+}
+
+//! Return the number of active consumers.
+//!
+//! \return number of consumers that have not been dropped
+
+const unsigned int FrameConsumerTracker::get_num_active_consumers(void) const
+{
+    return num_active_consumers_;
+}
+
+//! Indicate if a consumer is active.
+//!
+//! \param consumer_id - index of the consumer
+//! \return true if the consumer has not been dropped
+
+const bool FrameConsumerTracker::is_consumer_active(unsigned int consumer_id) const
+{
+    return get_consumer(consumer_id).active;
+}
+
+//! Return the lag of a consumer.
+//!
+//! \param consumer_id - index of the consumer
+//! \return number of frames notified to the consumer and not yet released
+
+const unsigned int FrameConsumerTracker::get_consumer_lag(unsigned int consumer_id) const
+{
+    return get_consumer(consumer_id).lag;
+}
+
+//! Return the number of frames released by a consumer.
+//!
+//! \param consumer_id - index of the consumer
+//! \return number of frames released
+
+const uint64_t FrameConsumerTracker::get_consumer_releases(unsigned int consumer_id) const
+{
+    return get_consumer(consumer_id).releases;
+}
+
+const FrameConsumerTracker::Consumer& FrameConsumerTracker::get_consumer(unsigned int consumer_id) const
+{
+    if (consumer_id >= consumers_.size())
+    {
+        std::stringstream ss;
+        ss << "Illegal frame consumer specified: " << consumer_id;
+        throw FrameReceiverException(ss.str());
+    }
+    return consumers_[consumer_id];
+}
+
+void FrameConsumerTracker::release_reference(int buffer_id, std::vector<int>& free_buffers)
+{
+    if (buffer_manager_->release_buffer_reference(buffer_id) == 0)
+    {
+        free_buffers.push_back(buffer_id);
+    }
+}
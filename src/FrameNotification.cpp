@@ -0,0 +1,180 @@
+/*!
+ * FrameNotification.cpp - Frame Receiver compact binary frame notification format class
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "FrameNotification.h"
+
+#include <sstream>
+#include <string.h>
+#include <time.h>
+
+using namespace FrameReceiver;
+
+const uint32_t FrameNotification::magic;
+const uint16_t FrameNotification::version;
+const uint32_t FrameNotification::frame_state_spilled;
+
+//! Constructor for a notification to be encoded and sent.
+//!
+//! The notification timestamp is set to the current time.
+//!
+//! \param msg_val - notification value, either frame ready or frame release
+//! \param frame_number - frame number
+//! \param buffer_id - ID of the shared buffer holding the frame
+//! \param frame_state - receive state of the frame, zero if unknown, plus any flags
+//! \param frame_timestamp_ns - time the frame started in nanoseconds since the epoch, zero if unknown
+//! \param consumer_id - index of the consumer releasing the frame, zero if there is only one
+
+FrameNotification::FrameNotification(IpcMessage::MsgVal msg_val, uint32_t frame_number, int buffer_id,
+        uint32_t frame_state, uint64_t frame_timestamp_ns, uint32_t consumer_id)
+{
+    if ((msg_val != IpcMessage::MsgValNotifyFrameReady) && (msg_val != IpcMessage::MsgValNotifyFrameRelease))
+    {
+        throw IpcMessageException("Illegal frame notification value");
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    memset(&notification_, 0, sizeof(notification_));
+    notification_.magic = magic;
+    notification_.version = version;
+    notification_.msg_val = static_cast<uint16_t>(msg_val);
+    notification_.frame_number = frame_number;
+    notification_.buffer_id = buffer_id;
+    notification_.frame_state = frame_state;
+    notification_.consumer_id = consumer_id;
+    notification_.frame_timestamp_ns = frame_timestamp_ns;
+    notification_.notify_timestamp_ns = (static_cast<uint64_t>(now.tv_sec) * 1000000000) + now.tv_nsec;
+}
+
+//! Constructor decoding a received notification.
+//!
+//! An IpcMessageException is thrown if the encoded notification is malformed, is of an
+//! unsupported version or is not a frame notification.
+//!
+//! \param encoded - encoded notification as received from a channel
+
+FrameNotification::FrameNotification(const std::string& encoded)
+{
+    if (!is_binary(encoded))
+    {
+        throw IpcMessageException("Illegal binary frame notification format");
+    }
+
+    memcpy(&notification_, encoded.data(), sizeof(notification_));
+
+    if (notification_.version != version)
+    {
+        std::stringstream ss;
+        ss << "Unsupported binary frame notification version " << notification_.version;
+        throw IpcMessageException(ss.str());
+    }
+
+    if ((notification_.msg_val != IpcMessage::MsgValNotifyFrameReady) &&
+        (notification_.msg_val != IpcMessage::MsgValNotifyFrameRelease))
+    {
+        std::stringstream ss;
+        ss << "Illegal binary frame notification value " << notification_.msg_val;
+        throw IpcMessageException(ss.str());
+    }
+}
+
+//! Indicate if a received message is a binary frame notification rather than a JSON message.
+//!
+//! \param encoded - message as received from a channel
+//! \return true if the message is a binary frame notification
+
+bool FrameNotification::is_binary(const std::string& encoded)
+{
+    uint32_t encoded_magic = 0;
+    if (encoded.size() == sizeof(Encoded))
+    {
+        memcpy(&encoded_magic, encoded.data(), sizeof(encoded_magic));
+    }
+    return (encoded_magic == magic);
+}
+
+//! Encode the notification for sending on a channel.
+//!
+//! \return encoded notification
+
+std::string FrameNotification::encode(void) const
+{
+    return std::string(reinterpret_cast<const char*>(&notification_), sizeof(notification_));
+}
+
+//! Return the notification value.
+//!
+//! \return notification value, either frame ready or frame release
+
+const IpcMessage::MsgVal FrameNotification::get_msg_val(void) const
+{
+    return static_cast<IpcMessage::MsgVal>(notification_.msg_val);
+}
+
+//! Return the frame number.
+//!
+//! \return frame number
+
+const uint32_t FrameNotification::get_frame_number(void) const
+{
+    return notification_.frame_number;
+}
+
+//! Return the ID of the shared buffer holding the frame.
+//!
+//! \return buffer ID
+
+const int FrameNotification::get_buffer_id(void) const
+{
+    return notification_.buffer_id;
+}
+
+//! Return the receive state of the frame.
+//!
+//! \return frame state, zero if unknown, including any flags
+
+const uint32_t FrameNotification::get_frame_state(void) const
+{
+    return notification_.frame_state;
+}
+
+//! Indicate if the frame is held in a spill buffer rather than in memory.
+//!
+//! \return true if the spilled flag is set in the frame state
+
+const bool FrameNotification::is_spilled(void) const
+{
+    return (notification_.frame_state & frame_state_spilled) != 0;
+}
+
+//! Return the time the frame started.
+//!
+//! \return frame timestamp in nanoseconds since the epoch, zero if unknown
+
+const uint64_t FrameNotification::get_frame_timestamp_ns(void) const
+{
+    return notification_.frame_timestamp_ns;
+}
+
+//! Return the time the notification was created.
+//!
+//! \return notification timestamp in nanoseconds since the epoch
+
+const uint64_t FrameNotification::get_notify_timestamp_ns(void) const
+{
+    return notification_.notify_timestamp_ns;
+}
+
+//! Return the index of the consumer releasing the frame.
+//!
+//! \return consumer index, zero if there is only one consumer
+
+const uint32_t FrameNotification::get_consumer_id(void) const
+{
+    return notification_.consumer_id;
+}
@@ -0,0 +1,424 @@
+/*!
+ * FrameNotifier.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "FrameNotifier.h"
+#include "FrameNotification.h"
+
+#include <string.h>
+
+#include <boost/bind.hpp>
+
+using namespace FrameReceiver;
+
+//! Constructor for FrameNotifier class.
+//!
+//! \param logger - logger of the owning RX thread
+
+FrameNotifier::FrameNotifier(LoggerPtr& logger) :
+    logger_(logger),
+    frames_notified_(0),
+    frames_released_(0)
+{
+}
+
+//! Destructor for FrameNotifier class.
+
+FrameNotifier::~FrameNotifier()
+{
+}
+
+//! Register any channels the notifier receives on with the reactor of the RX thread.
+//!
+//! \param reactor - reactor of the RX thread
+
+void FrameNotifier::register_channels(IpcReactor& reactor)
+{
+}
+
+//! Remove any channels the notifier receives on from the reactor of the RX thread.
+//!
+//! \param reactor - reactor of the RX thread
+
+void FrameNotifier::remove_channels(IpcReactor& reactor)
+{
+}
+
+//! Return released buffers to the frame buffer pool, called periodically by the RX thread.
+
+void FrameNotifier::service_releases(void)
+{
+}
+
+//! Add notifier parameters to an RX thread status reply.
+//!
+//! \param status - status reply message
+
+void FrameNotifier::get_status(IpcMessage& status)
+{
+    status.set_param("frame_notifier", get_name());
+}
+
+//! Return the number of frames notified.
+//!
+//! \return number of frames notified
+
+const uint64_t FrameNotifier::get_frames_notified(void) const
+{
+    return __atomic_load_n(&frames_notified_, __ATOMIC_RELAXED);
+}
+
+//! Return the number of frames released and returned to the frame buffer pool by the notifier.
+//!
+//! \return number of frames released
+
+const uint64_t FrameNotifier::get_frames_released(void) const
+{
+    return __atomic_load_n(&frames_released_, __ATOMIC_RELAXED);
+}
+
+//! Encode a frame ready notification in the format sent on channels.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param frame_number - frame number
+//! \param frame_state - FrameDecoder::FrameReceiveState of the frame
+//! \param frame_timestamp_ns - time the frame started in nanoseconds since the epoch
+//! \param spilled - frame is held in a spill buffer
+//! \param notify_format - encoding of the notification
+//! \return encoded notification
+
+std::string FrameNotifier::encode_frame_ready(int buffer_id, int frame_number, int frame_state,
+        uint64_t frame_timestamp_ns, bool spilled, Defaults::NotifyFormat notify_format)
+{
+    if (notify_format == Defaults::NotifyFormatBinary)
+    {
+        uint32_t notification_state = static_cast<uint32_t>(frame_state);
+        if (spilled)
+        {
+            notification_state |= FrameNotification::frame_state_spilled;
+        }
+        FrameNotification ready_notification(IpcMessage::MsgValNotifyFrameReady, frame_number, buffer_id,
+                notification_state, frame_timestamp_ns);
+        return ready_notification.encode();
+    }
+
+    IpcMessage ready_msg(IpcMessage::MsgTypeNotify, IpcMessage::MsgValNotifyFrameReady);
+    ready_msg.set_param("frame", frame_number);
+    ready_msg.set_param("buffer_id", buffer_id);
+    if (spilled)
+    {
+        ready_msg.set_param("spilled", true);
+    }
+    return ready_msg.encode();
+}
+
+//! Decode a frame release notification received from a downstream consumer.
+//!
+//! Consumers reply in the format of the frame ready notification, so either format is accepted.
+//! An IpcMessageException is thrown if a JSON message cannot be decoded.
+//!
+//! \param release_encoded - encoded notification
+//! \param buffer_id - set to the ID of the buffer released
+//! \param consumer_id - set to the index of the consumer releasing the buffer
+//! \param frame_number - set to the number of the frame released
+//! \return true if the message is a frame release notification
+
+bool FrameNotifier::decode_frame_release(const std::string& release_encoded, int& buffer_id,
+        unsigned int& consumer_id, int& frame_number)
+{
+    if (FrameNotification::is_binary(release_encoded))
+    {
+        FrameNotification frame_release(release_encoded);
+        if (frame_release.get_msg_val() != IpcMessage::MsgValNotifyFrameRelease)
+        {
+            return false;
+        }
+        buffer_id = frame_release.get_buffer_id();
+        consumer_id = frame_release.get_consumer_id();
+        frame_number = frame_release.get_frame_number();
+        return true;
+    }
+
+    // The timestamp of a release is never used, so parsing it is deferred
+    IpcMessage frame_release(release_encoded.c_str(), true, true);
+    if ((frame_release.get_msg_type() != IpcMessage::MsgTypeNotify) ||
+        (frame_release.get_msg_val() != IpcMessage::MsgValNotifyFrameRelease))
+    {
+        return false;
+    }
+    buffer_id = frame_release.get_param<int>("buffer_id", -1);
+    consumer_id = frame_release.get_param<unsigned int>("consumer", 0);
+    frame_number = frame_release.get_param<int>("frame", -1);
+    return true;
+}
+
+void FrameNotifier::count_frame_notified(void)
+{
+    __atomic_add_fetch(&frames_notified_, 1, __ATOMIC_RELAXED);
+}
+
+void FrameNotifier::count_frames_released(uint64_t num_frames)
+{
+    __atomic_add_fetch(&frames_released_, num_frames, __ATOMIC_RELAXED);
+}
+
+//! Constructor for RelayFrameNotifier class.
+//!
+//! \param logger - logger of the owning RX thread
+//! \param relay_reactor - reactor of the main thread
+//! \param relay_callback - callback handling ready frames in the main thread
+
+RelayFrameNotifier::RelayFrameNotifier(LoggerPtr& logger, IpcReactor& relay_reactor,
+        FrameRelayCallback relay_callback) :
+    FrameNotifier(logger),
+    relay_reactor_(relay_reactor),
+    relay_callback_(relay_callback)
+{
+}
+
+//! Notify a frame that is ready in a buffer to the main thread.
+//!
+//! The frame is posted to the reactor of the main thread, which encodes the notification, so
+//! nothing is serialised by the RX thread.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param frame_number - frame number
+//! \param frame_state - FrameDecoder::FrameReceiveState of the frame
+//! \param frame_timestamp_ns - time the frame started in nanoseconds since the epoch
+//! \param spilled - frame is held in a spill buffer
+
+void RelayFrameNotifier::notify_frame_ready(int buffer_id, int frame_number, int frame_state,
+        uint64_t frame_timestamp_ns, bool spilled)
+{
+    relay_reactor_.post(boost::bind(relay_callback_, buffer_id, frame_number, frame_state, frame_timestamp_ns, spilled));
+    count_frame_notified();
+}
+
+const std::string RelayFrameNotifier::get_name(void) const
+{
+    return "relay";
+}
+
+//! Constructor for SharedRingFrameNotifier class.
+//!
+//! \param logger - logger of the owning RX thread
+//! \param ready_ring - ring in shared memory to push ready frame descriptors onto
+//! \param ready_event - event to wake the consumer of the ring
+//! \param buffer_pool - frame buffer pool draining the release ring
+
+SharedRingFrameNotifier::SharedRingFrameNotifier(LoggerPtr& logger, SharedFrameRingPtr ready_ring,
+        SharedFrameEventPtr ready_event, FrameBufferPoolPtr buffer_pool) :
+    FrameNotifier(logger),
+    ready_ring_(ready_ring),
+    ready_event_(ready_event),
+    buffer_pool_(buffer_pool)
+{
+}
+
+//! Notify a frame that is ready in a buffer through the shared memory ring.
+//!
+//! The frame state and spill flag are carried in the reserved words of the descriptor. If the
+//! ring is full the notification is dropped and an error logged.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param frame_number - frame number
+//! \param frame_state - FrameDecoder::FrameReceiveState of the frame
+//! \param frame_timestamp_ns - time the frame started in nanoseconds since the epoch
+//! \param spilled - frame is held in a spill buffer
+
+void SharedRingFrameNotifier::notify_frame_ready(int buffer_id, int frame_number, int frame_state,
+        uint64_t frame_timestamp_ns, bool spilled)
+{
+    FrameDescriptor descriptor;
+    memset(&descriptor, 0, sizeof(descriptor));
+    descriptor.frame_number = frame_number;
+    descriptor.buffer_id = buffer_id;
+    descriptor.timestamp_ns = frame_timestamp_ns;
+    descriptor.reserved[frame_descriptor_state_idx] = static_cast<uint32_t>(frame_state);
+    descriptor.reserved[frame_descriptor_flags_idx] = spilled ? frame_descriptor_flag_spilled : 0;
+
+    if (ready_ring_->push(descriptor))
+    {
+        ready_event_->signal();
+        count_frame_notified();
+    }
+    else
+    {
+        LOG4CXX_ERROR(logger_, "Frame ready ring is full, dropping frame " << frame_number
+                << " in buffer " << buffer_id);
+    }
+}
+
+const std::string SharedRingFrameNotifier::get_name(void) const
+{
+    return "sharedring";
+}
+
+//! Return buffers released through the shared memory ring to the frame buffer pool.
+
+void SharedRingFrameNotifier::service_releases(void)
+{
+    count_frames_released(buffer_pool_->drain_release_ring());
+}
+
+//! Constructor for DirectFrameNotifier class.
+//!
+//! The frame ready and release channels are bound, throwing a zmq::error_t if either endpoint
+//! cannot be bound. The notifier must be constructed in the RX thread that uses it.
+//!
+//! \param logger - logger of the owning RX thread
+//! \param frame_ready_endpoint - endpoint to publish frame ready notifications on
+//! \param frame_release_endpoint - endpoint to receive frame release notifications on
+//! \param notify_format - encoding of frame ready notifications
+//! \param buffer_manager - shared buffer manager holding the frame buffers
+//! \param frame_decoder - frame decoder to return released buffers to
+//! \param num_consumers - number of consumers that must release each frame
+//! \param max_consumer_lag - number of unreleased frames at which a consumer is dropped, zero for no limit
+
+DirectFrameNotifier::DirectFrameNotifier(LoggerPtr& logger, std::string& frame_ready_endpoint,
+        std::string& frame_release_endpoint, Defaults::NotifyFormat notify_format,
+        SharedBufferManagerPtr buffer_manager, FrameDecoderPtr frame_decoder, unsigned int num_consumers,
+        unsigned int max_consumer_lag) :
+    FrameNotifier(logger),
+    frame_ready_channel_(ZMQ_PUB),
+    frame_release_channel_(ZMQ_SUB),
+    notify_format_(notify_format),
+    frame_decoder_(frame_decoder),
+    consumer_tracker_(buffer_manager, num_consumers, max_consumer_lag),
+    max_consumer_lag_(max_consumer_lag)
+{
+    frame_ready_channel_.bind(frame_ready_endpoint);
+    frame_release_channel_.bind(frame_release_endpoint);
+    frame_release_channel_.subscribe("");
+}
+
+//! Destructor for DirectFrameNotifier class.
+
+DirectFrameNotifier::~DirectFrameNotifier()
+{
+    frame_ready_channel_.close();
+    frame_release_channel_.close();
+}
+
+//! Notify a frame that is ready in a buffer directly on the frame ready channel.
+//!
+//! The number of consumers that must release the frame is set before it is notified, dropping
+//! any consumer that has fallen too far behind.
+//!
+//! \param buffer_id - ID of the buffer holding the frame
+//! \param frame_number - frame number
+//! \param frame_state - FrameDecoder::FrameReceiveState of the frame
+//! \param frame_timestamp_ns - time the frame started in nanoseconds since the epoch
+//! \param spilled - frame is held in a spill buffer
+
+void DirectFrameNotifier::notify_frame_ready(int buffer_id, int frame_number, int frame_state,
+        uint64_t frame_timestamp_ns, bool spilled)
+{
+    std::vector<int> free_buffers;
+    unsigned int consumers_dropped = consumer_tracker_.frame_ready(buffer_id, free_buffers);
+    if (consumers_dropped)
+    {
+        LOG4CXX_WARN(logger_, "Dropped " << consumers_dropped << " frame consumer(s) exceeding the maximum lag of "
+                << max_consumer_lag_ << " frames, " << consumer_tracker_.get_num_active_consumers()
+                << " consumer(s) remain active");
+    }
+
+    std::string ready_encoded = encode_frame_ready(buffer_id, frame_number, frame_state, frame_timestamp_ns, spilled,
+            notify_format_);
+    frame_ready_channel_.send(ready_encoded);
+    count_frame_notified();
+
+    free_frame_buffers(free_buffers);
+}
+
+const std::string DirectFrameNotifier::get_name(void) const
+{
+    return "direct";
+}
+
+//! Register the frame release channel with the reactor of the RX thread.
+//!
+//! \param reactor - reactor of the RX thread
+
+void DirectFrameNotifier::register_channels(IpcReactor& reactor)
+{
+    reactor.register_channel(frame_release_channel_,
+            boost::bind(&DirectFrameNotifier::handle_frame_release_channel, this));
+}
+
+//! Remove the frame release channel from the reactor of the RX thread.
+//!
+//! \param reactor - reactor of the RX thread
+
+void DirectFrameNotifier::remove_channels(IpcReactor& reactor)
+{
+    reactor.remove_channel(frame_release_channel_);
+}
+
+//! Add notifier parameters, including the lag of each consumer, to an RX thread status reply.
+//!
+//! The lag and active state of each consumer are reported as arrays indexed by consumer.
+//!
+//! \param status - status reply message
+
+void DirectFrameNotifier::get_status(IpcMessage& status)
+{
+    FrameNotifier::get_status(status);
+    status.set_param("frames_notified", get_frames_notified());
+    status.set_param("frames_released", get_frames_released());
+    status.set_param("consumers_active", consumer_tracker_.get_num_active_consumers());
+    for (unsigned int consumer_id = 0; consumer_id < consumer_tracker_.get_num_consumers(); consumer_id++)
+    {
+        status.set_param("consumers/lag[]", consumer_tracker_.get_consumer_lag(consumer_id));
+        status.set_param("consumers/active[]", consumer_tracker_.is_consumer_active(consumer_id));
+    }
+}
+
+//! Handle a frame release notification received on the frame release channel.
+//!
+//! The buffer is returned to the frame decoder once every consumer has released it.
+
+void DirectFrameNotifier::handle_frame_release_channel(void)
+{
+    std::string frame_release_encoded = frame_release_channel_.recv();
+    try {
+        int buffer_id = -1;
+        unsigned int consumer_id = 0;
+        int frame_number = -1;
+        if (!decode_frame_release(frame_release_encoded, buffer_id, consumer_id, frame_number))
+        {
+            LOG4CXX_ERROR(logger_, "Got unexpected message on frame release channel: " << frame_release_encoded);
+            return;
+        }
+        LOG4CXX_DEBUG_LEVEL(2, logger_, "Got frame release notification from consumer " << consumer_id
+                << " for frame " << frame_number << " in buffer " << buffer_id);
+
+        std::vector<int> free_buffers;
+        if (consumer_tracker_.frame_released(buffer_id, consumer_id, free_buffers))
+        {
+            free_frame_buffers(free_buffers);
+        }
+        else
+        {
+            LOG4CXX_WARN(logger_, "Ignoring release of buffer " << buffer_id << " by consumer " << consumer_id
+                    << ", which is unknown, dropped or does not hold the buffer");
+        }
+    }
+    catch (IpcMessageException& e)
+    {
+        LOG4CXX_ERROR(logger_, "Error decoding message on frame release channel: " << e.what());
+    }
+}
+
+void DirectFrameNotifier::free_frame_buffers(const std::vector<int>& free_buffers)
+{
+    for (std::vector<int>::const_iterator buffer_itr = free_buffers.begin(); buffer_itr != free_buffers.end();
+            buffer_itr++)
+    {
+        frame_decoder_->push_empty_buffer(*buffer_itr);
+    }
+    count_frames_released(free_buffers.size());
+}
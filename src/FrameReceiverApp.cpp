@@ -8,6 +8,7 @@
 #include "FrameReceiverApp.h"
 #include "FrameReceiverConfig.h"
 #include "SharedBufferManager.h"
+#include "gettime.h"
 
 #include <iostream>
 #include <iomanip>
@@ -39,7 +40,6 @@ static bool has_suffix(const std::string &str, const std::string &suffix)
 //! This constructor initialises the FrameRecevierApp instance
 
 FrameReceiverApp::FrameReceiverApp(void) :
-    rx_channel_(ZMQ_PAIR),
     ctrl_channel_(ZMQ_REP),
     frame_ready_channel_(ZMQ_PUB),
     frame_release_channel_(ZMQ_SUB),
@@ -56,9 +56,8 @@ FrameReceiverApp::FrameReceiverApp(void) :
 FrameReceiverApp::~FrameReceiverApp()
 {
 
-    // Delete the RX thread object by resetting the scoped pointer, allowing the IPC channel
-    // to be closed cleanly
-    rx_thread_.reset();
+    // Delete the RX thread objects, allowing the IPC channels to be closed cleanly
+    rx_threads_.clear();
 
 }
 
@@ -113,14 +112,76 @@ int FrameReceiverApp::parse_arguments(int argc, char** argv)
                     "Set the IP address of the interface to receive frame data on")
                 ("sharedbuf",    po::value<std::string>()->default_value(FrameReceiver::Defaults::default_shared_buffer_name),
                     "Set the name of the shared memory frame buffer")
+                ("sharedrings",  po::value<bool>()->default_value(FrameReceiver::Defaults::default_shared_frame_rings),
+                    "Pass frame ready and release notifications through rings in the shared memory frame buffer")
+                ("directnotify", po::value<bool>()->default_value(FrameReceiver::Defaults::default_direct_frame_notify),
+                    "Publish frame ready and receive frame release notifications directly in the RX thread")
+                ("hugepages",    po::value<bool>()->default_value(FrameReceiver::Defaults::default_huge_pages),
+                    "Back the shared memory frame buffer with huge pages")
+                ("hugepagedir",  po::value<std::string>()->default_value(FrameReceiver::Defaults::default_huge_page_dir),
+                    "Set the hugetlbfs mount directory in which to create the huge page frame buffer")
+                ("buffernuma",   po::value<std::string>()->default_value("default"),
+                    "Set the NUMA memory policy of the shared memory frame buffer (default, bind or interleave)")
+                ("buffernumanodes", po::value<std::string>()->default_value(FrameReceiver::Defaults::default_buffer_numa_node_list),
+                    "Set the comma-separated list of NUMA nodes for the shared memory frame buffer policy")
+                ("prefault",     po::value<bool>()->default_value(FrameReceiver::Defaults::default_prefault_buffers),
+                    "Prefault the pages of the shared memory frame buffer at startup")
+                ("prefaultthreads", po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_prefault_threads),
+                    "Set the number of threads to prefault the shared memory frame buffer with")
+                ("lockbuffers",  po::value<bool>()->default_value(FrameReceiver::Defaults::default_lock_buffers),
+                    "Prefault and lock the shared memory frame buffer into memory at startup")
+                ("spillfile",    po::value<std::string>()->default_value(FrameReceiver::Defaults::default_spill_file),
+                    "Set the path of a memory-mapped file holding frames when the shared memory frame buffer is full")
+                ("spillmem",     po::value<std::size_t>()->default_value(FrameReceiver::Defaults::default_spill_mem),
+                    "Set the size of the spill file in bytes")
+                ("notifyformat", po::value<std::string>()->default_value("json"),
+                    "Set the encoding of frame ready notifications sent to the frame ready channel (json or binary)")
+                ("consumers",    po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_frame_consumers),
+                    "Set the number of downstream consumers that must release each frame")
+                ("consumerlag",  po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_max_consumer_lag),
+                    "Set the number of unreleased frames at which a consumer is dropped (0 = no limit)")
                 ("frametimeout", po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_frame_timeout_ms),
                     "Set the incomplete frame timeout in ms")
+                ("reactor",      po::value<std::string>()->default_value(FrameReceiver::Defaults::default_reactor_backend_name),
+                    "Set the backend the event reactors wait for events with (poll or epoll)")
                 ("frames,f",     po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_frame_count),
                     "Set the number of frames to receive before terminating")
                 ("packetlog",    po::value<bool>()->default_value(FrameReceiver::Defaults::default_enable_packet_logging),
                     "Enable logging of packet diagnostics to file")
 				("rxbuffer",     po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_recv_buffer_size),
 					"Set UDP receive buffer size")
+				("rxbatch",      po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_batch_size),
+					"Set the maximum number of UDP packets to receive per socket read")
+				("rxthreads",    po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_threads),
+					"Set the number of RX threads to receive frame data with")
+				("rxreuseport",  po::value<bool>()->default_value(FrameReceiver::Defaults::default_rx_reuse_port),
+					"Bind all ports in every RX thread using SO_REUSEPORT instead of distributing ports between threads")
+				("rxcpus",       po::value<std::string>()->default_value(FrameReceiver::Defaults::default_rx_thread_cpu_list),
+					"Set the comma-separated list of CPU cores to pin RX threads to")
+				("rxnumanodes",  po::value<std::string>()->default_value(FrameReceiver::Defaults::default_rx_thread_numa_node_list),
+					"Set the comma-separated list of NUMA nodes to bind RX threads to")
+				("rxbackend",    po::value<std::string>()->default_value("socket"),
+					"Set the receive backend (socket, packetring or iouring)")
+				("rxinterface",  po::value<std::string>()->default_value(FrameReceiver::Defaults::default_rx_interface),
+					"Set the network interface to capture packets on with the packetring backend")
+				("rxringblocksize", po::value<std::size_t>()->default_value(FrameReceiver::Defaults::default_rx_ring_block_size),
+					"Set the packetring backend ring block size in bytes")
+				("rxringblocks", po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_ring_num_blocks),
+					"Set the number of blocks in the packetring backend ring")
+				("rxuringbuffers", po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_uring_num_buffers),
+					"Set the number of receive buffers for the iouring backend")
+				("rxuringbuffersize", po::value<std::size_t>()->default_value(FrameReceiver::Defaults::default_rx_uring_buffer_size),
+					"Set the iouring backend receive buffer size in bytes")
+				("rxbusypoll",   po::value<bool>()->default_value(FrameReceiver::Defaults::default_rx_busy_poll),
+					"Spin on non-blocking receives in the RX threads instead of polling for packets")
+				("rxbusypollinterval", po::value<unsigned int>()->default_value(FrameReceiver::Defaults::default_rx_busy_poll_interval),
+					"Set the number of busy-poll iterations between servicing the RX thread channel and timers")
+				("rxbusypollusecs", po::value<int>()->default_value(FrameReceiver::Defaults::default_rx_busy_poll_usecs),
+					"Set the SO_BUSY_POLL time in microseconds on receive sockets, 0 to leave unset")
+				("rxudpgro",     po::value<bool>()->default_value(FrameReceiver::Defaults::default_rx_udp_gro),
+					"Enable UDP GRO on receive sockets, receiving coalesced datagrams and splitting them into packets")
+				("rxpeek",       po::value<bool>()->default_value(FrameReceiver::Defaults::default_rx_force_header_peek),
+					"Force header peek packet receive even if the decoder supports speculative receive")
 				;
 
 		// Group the variables for parsing at the command line and/or from the configuration file
@@ -223,12 +284,129 @@ int FrameReceiverApp::parse_arguments(int argc, char** argv)
 		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting shared frame buffer name to " << config_.shared_buffer_name_);
 		}
 
+		if (vm.count("sharedrings"))
+		{
+		    config_.shared_frame_rings_ = vm["sharedrings"].as<bool>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Shared memory frame notification rings are " <<
+		            (config_.shared_frame_rings_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("directnotify"))
+		{
+		    config_.direct_frame_notify_ = vm["directnotify"].as<bool>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Direct frame notification from the RX thread is " <<
+		            (config_.direct_frame_notify_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("hugepages"))
+		{
+		    config_.huge_pages_ = vm["hugepages"].as<bool>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Huge page shared memory frame buffer is " <<
+		            (config_.huge_pages_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("hugepagedir"))
+		{
+		    config_.huge_page_dir_ = vm["hugepagedir"].as<std::string>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting huge page directory to " << config_.huge_page_dir_);
+		}
+
+		if (vm.count("buffernuma"))
+		{
+		    std::string policy_name = vm["buffernuma"].as<std::string>();
+		    config_.buffer_numa_policy_ = config_.map_numa_policy_name_to_type(policy_name);
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting frame buffer NUMA policy to " << policy_name << " (" << config_.buffer_numa_policy_ << ")");
+		    if (config_.buffer_numa_policy_ == Defaults::NumaPolicyIllegal)
+		    {
+		        throw FrameReceiverException("Illegal frame buffer NUMA policy specified: " + policy_name);
+		    }
+		}
+
+		if (vm.count("buffernumanodes"))
+		{
+		    config_.buffer_numa_nodes_.clear();
+		    config_.tokenize_cpu_list(config_.buffer_numa_nodes_, vm["buffernumanodes"].as<std::string>());
+
+		    std::stringstream ss;
+		    for (std::vector<int>::iterator itr = config_.buffer_numa_nodes_.begin(); itr != config_.buffer_numa_nodes_.end(); itr++)
+		    {
+		        ss << *itr << " ";
+		    }
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting frame buffer NUMA node(s) to " << ss.str());
+		}
+
+		if (vm.count("prefault"))
+		{
+		    config_.prefault_buffers_ = vm["prefault"].as<bool>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Frame buffer prefaulting is " <<
+		            (config_.prefault_buffers_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("prefaultthreads"))
+		{
+		    config_.prefault_threads_ = vm["prefaultthreads"].as<unsigned int>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting number of frame buffer prefault threads to " << config_.prefault_threads_);
+		}
+
+		if (vm.count("lockbuffers"))
+		{
+		    config_.lock_buffers_ = vm["lockbuffers"].as<bool>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Frame buffer locking is " <<
+		            (config_.lock_buffers_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("spillfile"))
+		{
+		    config_.spill_file_ = vm["spillfile"].as<std::string>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting frame buffer spill file to " << config_.spill_file_);
+		}
+
+		if (vm.count("spillmem"))
+		{
+		    config_.spill_mem_ = vm["spillmem"].as<std::size_t>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting frame buffer spill file size to " << config_.spill_mem_);
+		}
+
+		if (vm.count("notifyformat"))
+		{
+		    std::string format_name = vm["notifyformat"].as<std::string>();
+		    config_.frame_notify_format_ = config_.map_notify_format_name_to_type(format_name);
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting frame notification format to " << format_name << " (" << config_.frame_notify_format_ << ")");
+		    if (config_.frame_notify_format_ == Defaults::NotifyFormatIllegal)
+		    {
+		        throw FrameReceiverException("Illegal frame notification format specified: " + format_name);
+		    }
+		}
+
+		if (vm.count("consumers"))
+		{
+		    config_.frame_consumers_ = vm["consumers"].as<unsigned int>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting number of frame consumers to " << config_.frame_consumers_);
+		}
+
+		if (vm.count("consumerlag"))
+		{
+		    config_.max_consumer_lag_ = vm["consumerlag"].as<unsigned int>();
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting maximum frame consumer lag to " << config_.max_consumer_lag_);
+		}
+
 		if (vm.count("frametimeout"))
 		{
 		    config_.frame_timeout_ms_ = vm["frametimeout"].as<unsigned int>();
 		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting incomplete frame timeout to " << config_.frame_timeout_ms_);
 		}
 
+		if (vm.count("reactor"))
+		{
+		    std::string backend_name = vm["reactor"].as<std::string>();
+		    config_.reactor_backend_ = config_.map_reactor_backend_name_to_type(backend_name);
+		    LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting reactor backend to " << backend_name << " (" << config_.reactor_backend_ << ")");
+		    if (config_.reactor_backend_ == Defaults::ReactorBackendIllegal)
+		    {
+		        throw FrameReceiverException("Illegal reactor backend specified: " + backend_name);
+		    }
+		}
+
 		if (vm.count("frames"))
 		{
 		    config_.frame_count_ = vm["frames"].as<unsigned int>();
@@ -248,6 +426,128 @@ int FrameReceiverApp::parse_arguments(int argc, char** argv)
 			LOG4CXX_DEBUG_LEVEL(1, logger_, "RX receive buffer size is " << config_.rx_recv_buffer_size_);
 		}
 
+		if (vm.count("rxbatch"))
+		{
+			config_.rx_batch_size_ = vm["rxbatch"].as<unsigned int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "RX receive batch size is " << config_.rx_batch_size_);
+		}
+
+		if (vm.count("rxthreads"))
+		{
+			config_.rx_threads_ = vm["rxthreads"].as<unsigned int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Number of RX threads is " << config_.rx_threads_);
+		}
+
+		if (vm.count("rxreuseport"))
+		{
+			config_.rx_reuse_port_ = vm["rxreuseport"].as<bool>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "RX port reuse across threads is " <<
+			        (config_.rx_reuse_port_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("rxcpus"))
+		{
+			config_.rx_thread_cpus_.clear();
+			config_.tokenize_cpu_list(config_.rx_thread_cpus_, vm["rxcpus"].as<std::string>());
+
+			std::stringstream ss;
+			for (std::vector<int>::iterator itr = config_.rx_thread_cpus_.begin(); itr != config_.rx_thread_cpus_.end(); itr++)
+			{
+				ss << *itr << " ";
+			}
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX thread CPU(s) to " << ss.str());
+		}
+
+		if (vm.count("rxnumanodes"))
+		{
+			config_.rx_thread_numa_nodes_.clear();
+			config_.tokenize_cpu_list(config_.rx_thread_numa_nodes_, vm["rxnumanodes"].as<std::string>());
+
+			std::stringstream ss;
+			for (std::vector<int>::iterator itr = config_.rx_thread_numa_nodes_.begin(); itr != config_.rx_thread_numa_nodes_.end(); itr++)
+			{
+				ss << *itr << " ";
+			}
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX thread NUMA node(s) to " << ss.str());
+		}
+
+		if (vm.count("rxbackend"))
+		{
+			std::string backend_name = vm["rxbackend"].as<std::string>();
+			config_.rx_backend_ = config_.map_rx_backend_name_to_type(backend_name);
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX backend to " << backend_name << " (" << config_.rx_backend_ << ")");
+			if (config_.rx_backend_ == Defaults::RxBackendIllegal)
+			{
+				throw FrameReceiverException("Illegal RX backend specified: " + backend_name);
+			}
+		}
+
+		if (vm.count("rxinterface"))
+		{
+			config_.rx_interface_ = vm["rxinterface"].as<std::string>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX capture interface to " << config_.rx_interface_);
+		}
+
+		if (vm.count("rxringblocksize"))
+		{
+			config_.rx_ring_block_size_ = vm["rxringblocksize"].as<std::size_t>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX packet ring block size to " << config_.rx_ring_block_size_);
+		}
+
+		if (vm.count("rxringblocks"))
+		{
+			config_.rx_ring_num_blocks_ = vm["rxringblocks"].as<unsigned int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX packet ring number of blocks to " << config_.rx_ring_num_blocks_);
+		}
+
+		if (vm.count("rxuringbuffers"))
+		{
+			config_.rx_uring_num_buffers_ = vm["rxuringbuffers"].as<unsigned int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX io_uring number of receive buffers to " << config_.rx_uring_num_buffers_);
+		}
+
+		if (vm.count("rxuringbuffersize"))
+		{
+			config_.rx_uring_buffer_size_ = vm["rxuringbuffersize"].as<std::size_t>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX io_uring receive buffer size to " << config_.rx_uring_buffer_size_);
+		}
+
+		if (vm.count("rxbusypoll"))
+		{
+			config_.rx_busy_poll_ = vm["rxbusypoll"].as<bool>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX busy-poll mode to " << config_.rx_busy_poll_);
+		}
+
+		if (vm.count("rxbusypollinterval"))
+		{
+			config_.rx_busy_poll_interval_ = vm["rxbusypollinterval"].as<unsigned int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX busy-poll service interval to " << config_.rx_busy_poll_interval_);
+			if (config_.rx_busy_poll_interval_ == 0)
+			{
+				throw FrameReceiverException("Illegal RX busy-poll service interval specified: must be at least 1");
+			}
+		}
+
+		if (vm.count("rxbusypollusecs"))
+		{
+			config_.rx_busy_poll_usecs_ = vm["rxbusypollusecs"].as<int>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Setting RX socket SO_BUSY_POLL time to " << config_.rx_busy_poll_usecs_);
+		}
+
+		if (vm.count("rxudpgro"))
+		{
+			config_.rx_udp_gro_ = vm["rxudpgro"].as<bool>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "RX socket UDP GRO receive is " <<
+			        (config_.rx_udp_gro_ ? "enabled" : "disabled"));
+		}
+
+		if (vm.count("rxpeek"))
+		{
+			config_.rx_force_header_peek_ = vm["rxpeek"].as<bool>();
+			LOG4CXX_DEBUG_LEVEL(1, logger_, "Forced header peek packet receive is " <<
+			        (config_.rx_force_header_peek_ ? "enabled" : "disabled"));
+		}
+
 	}
 	catch (Exception &e)
 	{
@@ -277,12 +577,13 @@ void FrameReceiverApp::run(void)
 
     try {
 
-        // Initialise IPC channels
+        // Create the reactor with the configured backend and initialise IPC channels
+        reactor_.reset(new IpcReactor(config_.reactor_backend_));
         initialise_ipc_channels();
 
         // Add timers to the reactor
-        //int rxPingTimer = reactor_.add_timer(1000, 0, boost::bind(&FrameReceiverApp::rxPingTimerHandler, this));
-        //int timer2 = reactor_.add_timer(1500, 0, boost::bind(&FrameReceiverApp::timerHandler2, this));
+        //int rxPingTimer = reactor_->add_timer(1000, 0, boost::bind(&FrameReceiverApp::rxPingTimerHandler, this));
+        //int timer2 = reactor_->add_timer(1500, 0, boost::bind(&FrameReceiverApp::timerHandler2, this));
 
         // Create the appropriate frame decoder
         initialise_frame_decoder();
@@ -290,26 +591,51 @@ void FrameReceiverApp::run(void)
         // Initialise the frame buffer buffer manager
         initialise_buffer_manager();
 
-        // Create the RX thread object
-        rx_thread_.reset(new FrameReceiverRxThread( config_, logger_, buffer_manager_, frame_decoder_));
+        // Create the RX thread objects
+        initialise_rx_threads();
 
         // Pre-charge all frame buffers onto the RX thread queue ready for use
         precharge_buffers();
 
+        // Add a timer to count frame notifications passed through shared memory rings, which bypass this thread
+        int shared_ring_timer_id = -1;
+        if (buffer_manager_->has_frame_rings())
+        {
+            shared_ring_timer_id = reactor_->register_timer(Defaults::default_shared_ring_poll_ms, 0,
+                    boost::bind(&FrameReceiverApp::shared_ring_timer_handler, this));
+        }
+
+        // Add a timer to count frame notifications published directly by the RX thread, which bypass this thread
+        int direct_notify_timer_id = -1;
+        if (config_.direct_frame_notify_)
+        {
+            direct_notify_timer_id = reactor_->register_timer(Defaults::default_direct_notify_poll_ms, 0,
+                    boost::bind(&FrameReceiverApp::direct_notify_timer_handler, this));
+        }
+
         LOG4CXX_DEBUG_LEVEL(1, logger_, "Main thread entering reactor loop");
 
         // Run the reactor event loop
-        reactor_.run();
+        reactor_->run();
+
+        if (shared_ring_timer_id >= 0)
+        {
+            reactor_->remove_timer(shared_ring_timer_id);
+        }
+        if (direct_notify_timer_id >= 0)
+        {
+            reactor_->remove_timer(direct_notify_timer_id);
+        }
 
-        // Destroy the RX thread
-        rx_thread_.reset();
+        // Destroy the RX threads
+        rx_threads_.clear();
 
         // Clean up IPC channels
         cleanup_ipc_channels();
 
         // Remove timers and channels from the reactor
-        //reactor_.remove_timer(rxPingTimer);
-        //reactor_.remove_timer(timer2);
+        //reactor_->remove_timer(rxPingTimer);
+        //reactor_->remove_timer(timer2);
 
     }
     catch (FrameReceiverException& e)
@@ -332,8 +658,40 @@ void FrameReceiverApp::initialise_ipc_channels(void)
     // Bind the control channel
     ctrl_channel_.bind(config_.ctrl_channel_endpoint_);
 
-    // Bind the RX thread channel
-    rx_channel_.bind(config_.rx_channel_endpoint_);
+    // Bind a channel for each RX thread
+    if (config_.rx_threads_ == 0)
+    {
+        throw FrameReceiverException("Cannot initialise RX thread channels - at least one RX thread must be specified");
+    }
+    for (unsigned int thread_idx = 0; thread_idx < config_.rx_threads_; thread_idx++)
+    {
+        boost::shared_ptr<IpcChannel> rx_channel(new IpcChannel(ZMQ_PAIR));
+        std::string rx_channel_endpoint = config_.rx_thread_channel_endpoint(thread_idx);
+        rx_channel->bind(rx_channel_endpoint);
+        rx_channels_.push_back(rx_channel);
+    }
+
+    // Add IPC channels to the reactor
+    reactor_->register_channel(ctrl_channel_, boost::bind(&FrameReceiverApp::handle_ctrl_channel, this));
+    for (unsigned int thread_idx = 0; thread_idx < rx_channels_.size(); thread_idx++)
+    {
+        reactor_->register_channel(*rx_channels_[thread_idx], boost::bind(&FrameReceiverApp::handle_rx_channel, this, thread_idx));
+    }
+
+    // The frame ready and release channels are bound by the RX thread when notifying frames directly,
+    // which requires a single RX thread as only one thread can bind each endpoint
+    if (config_.direct_frame_notify_)
+    {
+        if (config_.rx_threads_ > 1)
+        {
+            throw FrameReceiverException("Direct frame notification from the RX thread requires a single RX thread");
+        }
+        if (config_.shared_frame_rings_)
+        {
+            throw FrameReceiverException("Direct frame notification from the RX thread is not supported with shared frame rings");
+        }
+        return;
+    }
 
     // Bind the frame ready and release channels
     frame_ready_channel_.bind(config_.frame_ready_endpoint_);
@@ -342,23 +700,30 @@ void FrameReceiverApp::initialise_ipc_channels(void)
     // Set default subscription on frame release channel
     frame_release_channel_.subscribe("");
 
-    // Add IPC channels to the reactor
-    reactor_.register_channel(ctrl_channel_, boost::bind(&FrameReceiverApp::handle_ctrl_channel, this));
-    reactor_.register_channel(rx_channel_, boost::bind(&FrameReceiverApp::handle_rx_channel, this));
-	reactor_.register_channel(frame_release_channel_, boost::bind(&FrameReceiverApp::handle_frame_release_channel, this));
+	reactor_->register_channel(frame_release_channel_, boost::bind(&FrameReceiverApp::handle_frame_release_channel, this));
 
 }
 
 void FrameReceiverApp::cleanup_ipc_channels(void)
 {
     // Remove IPC channels from the reactor
-    reactor_.remove_channel(ctrl_channel_);
-    reactor_.remove_channel(rx_channel_);
-    reactor_.remove_channel(frame_release_channel_);
+    reactor_->remove_channel(ctrl_channel_);
+    for (unsigned int thread_idx = 0; thread_idx < rx_channels_.size(); thread_idx++)
+    {
+        reactor_->remove_channel(*rx_channels_[thread_idx]);
+    }
+    if (!config_.direct_frame_notify_)
+    {
+        reactor_->remove_channel(frame_release_channel_);
+    }
 
     // Close all channels
     ctrl_channel_.close();
-    rx_channel_.close();
+    for (unsigned int thread_idx = 0; thread_idx < rx_channels_.size(); thread_idx++)
+    {
+        rx_channels_[thread_idx]->close();
+    }
+    rx_channels_.clear();
     frame_ready_channel_.close();
     frame_release_channel_.close();
 
@@ -366,10 +731,17 @@ void FrameReceiverApp::cleanup_ipc_channels(void)
 
 void FrameReceiverApp::initialise_frame_decoder(void)
 {
+    frame_decoder_ = create_frame_decoder();
+}
+
+FrameDecoderPtr FrameReceiverApp::create_frame_decoder(void)
+{
+    FrameDecoderPtr frame_decoder;
+
     switch (config_.sensor_type_)
     {
     case Defaults::SensorTypePercivalEmulator:
-        frame_decoder_.reset(new PercivalEmulatorFrameDecoder(logger_, config_.enable_packet_logging_, config_.frame_timeout_ms_));
+        frame_decoder.reset(new PercivalEmulatorFrameDecoder(logger_, config_.enable_packet_logging_, config_.frame_timeout_ms_));
         LOG4CXX_INFO(logger_, "Created PERCIVAL emulator frame decoder instance");
         break;
 
@@ -387,35 +759,138 @@ void FrameReceiverApp::initialise_frame_decoder(void)
         throw FrameReceiverException("Cannot initialize frame decoder - sensor type not recognised");
         break;
     }
+
+    return frame_decoder;
+}
+
+void FrameReceiverApp::initialise_rx_threads(void)
+{
+    if (!config_.rx_reuse_port_ && (config_.rx_threads_ > config_.rx_ports_.size()))
+    {
+        throw FrameReceiverException("Cannot initialise RX threads - more threads than ports specified without port reuse enabled");
+    }
+
+    for (unsigned int thread_idx = 0; thread_idx < config_.rx_threads_; thread_idx++)
+    {
+        // The first thread uses the primary frame decoder. Each subsequent thread gets its own decoder
+        // sharing the frame buffer pool of the primary, so that packets of a frame received on different
+        // threads are assembled in the same buffer
+        FrameDecoderPtr frame_decoder = frame_decoder_;
+        if (thread_idx > 0)
+        {
+            frame_decoder = create_frame_decoder();
+            frame_decoder->register_buffer_manager(buffer_manager_);
+            frame_decoder->register_buffer_pool(frame_decoder_->get_buffer_pool());
+        }
+
+        rx_threads_.push_back(boost::shared_ptr<FrameReceiverRxThread>(
+                new FrameReceiverRxThread(config_, logger_, buffer_manager_, frame_decoder, *reactor_,
+                        boost::bind(&FrameReceiverApp::handle_rx_frame_ready, this, thread_idx, _1, _2, _3, _4, _5),
+                        Defaults::default_rx_tick_period_ms, thread_idx)));
+    }
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Created " << rx_threads_.size() << " RX thread(s)");
 }
 
 
 void FrameReceiverApp::initialise_buffer_manager(void)
 {
-    // Create a shared buffer manager
+    // Create a shared buffer manager, with a frame ready ring for each RX thread if shared memory rings are enabled,
+    // backed by huge pages if enabled. The buffers are divided into a size class for each frame size produced
+    // by the decoder.
+    std::vector<size_t> frame_buffer_sizes;
+    frame_decoder_->get_frame_buffer_sizes(frame_buffer_sizes);
+    std::vector<size_t> size_class_buffer_sizes(frame_buffer_sizes.begin() + 1, frame_buffer_sizes.end());
     buffer_manager_.reset(new SharedBufferManager(config_.shared_buffer_name_, config_.max_buffer_mem_,
-            frame_decoder_->get_frame_buffer_size(), false));
+            frame_buffer_sizes[0], false, config_.shared_frame_rings_ ? config_.rx_threads_ : 0,
+            config_.huge_pages_ ? config_.huge_page_dir_ : "", size_class_buffer_sizes,
+            config_.spill_file_, config_.spill_mem_));
     LOG4CXX_DEBUG_LEVEL(1, logger_, "Initialised frame buffer manager of total size " << config_.max_buffer_mem_
-            << " with " << buffer_manager_->get_num_buffers() << " buffers");
+            << " with " << buffer_manager_->get_num_buffers() << " buffers"
+            << (buffer_manager_->has_frame_rings() ? " and shared memory frame rings" : ""));
+    for (unsigned int size_class = 0; size_class < buffer_manager_->get_num_size_classes(); size_class++)
+    {
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "Frame buffer size class " << size_class << " has "
+                << buffer_manager_->get_size_class_num_buffers(size_class) << " buffers of "
+                << buffer_manager_->get_size_class_buffer_size(size_class) << " bytes");
+    }
+    // Apply the NUMA memory policy to the buffer region before the buffers are first touched
+    if (config_.buffer_numa_policy_ != Defaults::NumaPolicyDefault)
+    {
+        buffer_manager_->bind_numa_policy(config_.buffer_numa_policy_, config_.buffer_numa_nodes_);
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "Applied NUMA policy " << config_.buffer_numa_policy_
+                << " to frame buffer across " << config_.buffer_numa_nodes_.size() << " node(s)");
+    }
+    // Prefault, and optionally lock, the buffer pages so the RX threads do not take page faults as frames first arrive
+    if (config_.prefault_buffers_ || config_.lock_buffers_)
+    {
+        struct timespec start_time, end_time;
+        gettime(&start_time, true);
+        buffer_manager_->prefault(config_.prefault_threads_, config_.lock_buffers_);
+        gettime(&end_time, true);
+        double prefault_ms = ((end_time.tv_sec - start_time.tv_sec) * 1000.0) +
+                ((end_time.tv_nsec - start_time.tv_nsec) / 1000000.0);
+        LOG4CXX_INFO(logger_, "Prefaulted " << (buffer_manager_->is_locked() ? "and locked " : "")
+                << "frame buffer pages in " << prefault_ms << "ms using " << config_.prefault_threads_ << " thread(s)");
+    }
+    LOG4CXX_INFO(logger_, "Frame buffer manager is using " << buffer_manager_->get_page_size() << " byte "
+            << (buffer_manager_->is_huge_page_backed() ? "huge pages" : "pages")
+            << " with a buffer stride of " << buffer_manager_->get_buffer_size() << " bytes");
 
     // Register buffer manager with the frame decoder
     frame_decoder_->register_buffer_manager(buffer_manager_);
 
+    // Queue the empty buffers of each size class separately in the frame buffer pool
+    if (buffer_manager_->get_num_size_classes() > 1)
+    {
+        std::vector<unsigned int> buffer_size_classes(buffer_manager_->get_num_buffers());
+        for (unsigned int buffer = 0; buffer < buffer_size_classes.size(); buffer++)
+        {
+            buffer_size_classes[buffer] = buffer_manager_->get_size_class(buffer);
+        }
+        frame_decoder_->get_buffer_pool()->register_size_classes(buffer_size_classes);
+    }
+
+    // Only assign spill buffers to frames once the buffers in memory run out
+    if (buffer_manager_->has_spill_buffers())
+    {
+        frame_decoder_->get_buffer_pool()->register_spill_buffers(
+                buffer_manager_->get_num_buffers() - buffer_manager_->get_num_spill_buffers());
+        LOG4CXX_INFO(logger_, "Frame buffer has " << buffer_manager_->get_num_spill_buffers()
+                << " spill buffers in file " << buffer_manager_->get_spill_file_path());
+    }
+
+    // Return buffers released through the shared memory ring directly to the frame buffer pool
+    if (buffer_manager_->has_frame_rings())
+    {
+        frame_decoder_->get_buffer_pool()->register_release_ring(buffer_manager_->get_release_ring(),
+                buffer_manager_);
+    }
+
+    // Track the release of frames notified on the frame ready channel by each downstream consumer. The
+    // shared memory rings have a single consumer.
+    if (config_.shared_frame_rings_ && (config_.frame_consumers_ > 1))
+    {
+        throw FrameReceiverException("Multiple frame consumers are not supported with shared frame rings");
+    }
+    consumer_tracker_.reset(new FrameConsumerTracker(buffer_manager_, config_.frame_consumers_,
+            config_.max_consumer_lag_));
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Frames must be released by " << config_.frame_consumers_ << " consumer(s)");
+
 }
 
 void FrameReceiverApp::precharge_buffers(void)
 {
-    // Push the IDs of all of the empty buffers onto the RX thread channel
-    // TODO if the number of buffers is so big that the RX thread channel would reach HWM (in either direction)
-    // before the reactor has time to start, we could consider putting this pre-charge into a timer handler
-    // that runs as soon as the reactor starts, but need to think about how this might block. Need non-blocking
-    // send on channels??
+    // Mark all buffers as free in the shared buffer descriptor table and push their IDs directly onto
+    // the frame buffer pool. The pool is shared by all RX threads so this makes the buffers available
+    // to every thread without sending a release message per buffer before the RX threads are running.
+    buffer_manager_->reset_buffer_descriptors();
+
+    FrameBufferPoolPtr buffer_pool = frame_decoder_->get_buffer_pool();
     for (int buf = 0; buf < buffer_manager_->get_num_buffers(); buf++)
     {
-        IpcMessage buf_msg(IpcMessage::MsgTypeNotify, IpcMessage::MsgValNotifyFrameRelease);
-        buf_msg.set_param("buffer_id", buf);
-        rx_channel_.send(buf_msg.encode());
+        buffer_pool->push_empty_buffer(buf);
     }
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Precharged frame buffer pool with " << buffer_manager_->get_num_buffers() << " buffers");
 }
 
 void FrameReceiverApp::handle_ctrl_channel(void)
@@ -455,21 +930,17 @@ void FrameReceiverApp::handle_ctrl_channel(void)
 
 }
 
-void FrameReceiverApp::handle_rx_channel(void)
+void FrameReceiverApp::handle_rx_channel(unsigned int thread_idx)
 {
-    std::string rx_reply_encoded = rx_channel_.recv();
+    std::string rx_reply_encoded = rx_channels_[thread_idx]->recv();
     try {
+        // Frame ready notifications are posted to the reactor by the RX threads, so only replies to
+        // control messages are expected on the channel
         IpcMessage rx_reply(rx_reply_encoded.c_str());
-        //LOG4CXX_DEBUG_LEVEL(1, logger_, "Got reply from RX thread : " << rx_reply_encoded);
 
-        if ((rx_reply.get_msg_type() == IpcMessage::MsgTypeNotify) &&
-            (rx_reply.get_msg_val() == IpcMessage::MsgValNotifyFrameReady))
+        if (rx_reply.get_msg_type() == IpcMessage::MsgTypeAck)
         {
-        	LOG4CXX_DEBUG_LEVEL(2, logger_, "Got frame ready notification from RX thread for frame " << rx_reply.get_param<int>("frame", -1)
-                    << " in buffer " << rx_reply.get_param<int>("buffer_id", -1));
-            frame_ready_channel_.send(rx_reply_encoded);
-
-            frames_received_++;
+            LOG4CXX_DEBUG_LEVEL(1, logger_, "Got reply from RX thread " << thread_idx << " : " << rx_reply_encoded);
         }
         else
         {
@@ -482,27 +953,53 @@ void FrameReceiverApp::handle_rx_channel(void)
     }
 }
 
+void FrameReceiverApp::handle_rx_frame_ready(unsigned int thread_idx, int buffer_id, int frame_number,
+        int frame_state, uint64_t frame_timestamp_ns, bool spilled)
+{
+    // Called in this thread through the reactor for each frame relayed by an RX thread, so the notification
+    // is only encoded here before it is forwarded to the downstream consumers
+    LOG4CXX_DEBUG_LEVEL(2, logger_, "Got frame ready notification from RX thread " << thread_idx << " for frame "
+            << frame_number << " in buffer " << buffer_id);
+    try {
+        frame_ready(buffer_id);
+        std::string ready_encoded = FrameNotifier::encode_frame_ready(buffer_id, frame_number, frame_state,
+                frame_timestamp_ns, spilled, config_.frame_notify_format_);
+        frame_ready_channel_.send(ready_encoded);
+        frames_received_++;
+    }
+    catch (FrameReceiverException& e)
+    {
+        LOG4CXX_ERROR(logger_, "Error handling frame ready notification from RX thread " << thread_idx << ": "
+                << e.what());
+    }
+}
+
 void FrameReceiverApp::handle_frame_release_channel(void)
 {
     std::string frame_release_encoded = frame_release_channel_.recv();
     try {
-        IpcMessage frame_release(frame_release_encoded.c_str());
-        //LOG4CXX_DEBUG(logger_, "Got message on frame release channel : " << frame_release_encoded);
-
-        if ((frame_release.get_msg_type() == IpcMessage::MsgTypeNotify) &&
-            (frame_release.get_msg_val() == IpcMessage::MsgValNotifyFrameRelease))
+        // Downstream processes reply in the format of the frame ready notification, so accept either format
+        int buffer_id = -1;
+        unsigned int consumer_id = 0;
+        int frame_number = -1;
+        bool release_is_valid = FrameNotifier::decode_frame_release(frame_release_encoded, buffer_id, consumer_id,
+                frame_number);
+
+        if (release_is_valid)
         {
-        	LOG4CXX_DEBUG_LEVEL(2, logger_, "Got frame release notification from processor from frame " << frame_release.get_param<int>("frame", -1)
-                    << " in buffer " << frame_release.get_param<int>("buffer_id", -1));
-            rx_channel_.send(frame_release_encoded);
-
-            frames_released_++;
+            LOG4CXX_DEBUG_LEVEL(2, logger_, "Got frame release notification from consumer " << consumer_id
+                    << " for frame " << frame_number << " in buffer " << buffer_id);
 
-            if (config_.frame_count_ && (frames_released_ >= config_.frame_count_))
+            // Return the buffer to the frame decoder once every consumer has released it
+            std::vector<int> free_buffers;
+            if (consumer_tracker_->frame_released(buffer_id, consumer_id, free_buffers))
+            {
+                free_frame_buffers(free_buffers);
+            }
+            else
             {
-                LOG4CXX_INFO(logger_, "Specified number of frames (" << config_.frame_count_ << ") received and released, terminating");
-                stop();
-                reactor_.stop();
+                LOG4CXX_WARN(logger_, "Ignoring release of buffer " << buffer_id << " by consumer " << consumer_id
+                        << ", which is unknown, dropped or does not hold the buffer");
             }
         }
         else
@@ -516,11 +1013,85 @@ void FrameReceiverApp::handle_frame_release_channel(void)
     }
 }
 
+void FrameReceiverApp::frame_ready(int buffer_id)
+{
+    // Set the number of consumers that must release the frame before it is notified, dropping any consumer
+    // that has fallen too far behind
+    std::vector<int> free_buffers;
+    unsigned int consumers_dropped = consumer_tracker_->frame_ready(buffer_id, free_buffers);
+    if (consumers_dropped)
+    {
+        for (unsigned int consumer_id = 0; consumer_id < consumer_tracker_->get_num_consumers(); consumer_id++)
+        {
+            LOG4CXX_DEBUG_LEVEL(1, logger_, "Frame consumer " << consumer_id << " is "
+                    << (consumer_tracker_->is_consumer_active(consumer_id) ? "active" : "dropped") << " with lag "
+                    << consumer_tracker_->get_consumer_lag(consumer_id) << " after "
+                    << consumer_tracker_->get_consumer_releases(consumer_id) << " releases");
+        }
+        LOG4CXX_WARN(logger_, "Dropped " << consumers_dropped << " frame consumer(s) exceeding the maximum lag of "
+                << config_.max_consumer_lag_ << " frames, " << consumer_tracker_->get_num_active_consumers()
+                << " consumer(s) remain active");
+    }
+    free_frame_buffers(free_buffers);
+}
+
+void FrameReceiverApp::free_frame_buffers(const std::vector<int>& free_buffers)
+{
+    // Post the buffers to the reactor of the first RX thread, which returns them to the frame buffer pool
+    // shared by all the RX threads
+    if (!free_buffers.empty())
+    {
+        rx_threads_[0]->release_buffers(free_buffers);
+        frames_released_ += free_buffers.size();
+    }
+
+    if (!free_buffers.empty() && config_.frame_count_ && (frames_released_ >= config_.frame_count_))
+    {
+        LOG4CXX_INFO(logger_, "Specified number of frames (" << config_.frame_count_ << ") received and released, terminating");
+        stop();
+        reactor_->stop();
+    }
+}
+
+void FrameReceiverApp::shared_ring_timer_handler(void)
+{
+    // Count frames notified through the shared memory rings from the ring indices, since the notifications
+    // themselves pass directly between the RX threads and the downstream processing task
+    unsigned int frames_received = 0;
+    for (unsigned int ring_idx = 0; ring_idx < buffer_manager_->get_num_ready_rings(); ring_idx++)
+    {
+        frames_received += buffer_manager_->get_ready_ring(ring_idx)->get_num_pushed();
+    }
+    frames_received_ = frames_received;
+    frames_released_ = buffer_manager_->get_release_ring()->get_num_pushed();
+
+    if (config_.frame_count_ && (frames_released_ >= config_.frame_count_))
+    {
+        LOG4CXX_INFO(logger_, "Specified number of frames (" << config_.frame_count_ << ") received and released, terminating");
+        stop();
+        reactor_->stop();
+    }
+}
+
+void FrameReceiverApp::direct_notify_timer_handler(void)
+{
+    // Count frames notified and released directly by the RX thread from its frame notifier counters
+    frames_received_ = rx_threads_[0]->get_frames_notified();
+    frames_released_ = rx_threads_[0]->get_frames_released();
+
+    if (config_.frame_count_ && (frames_released_ >= config_.frame_count_))
+    {
+        LOG4CXX_INFO(logger_, "Specified number of frames (" << config_.frame_count_ << ") received and released, terminating");
+        stop();
+        reactor_->stop();
+    }
+}
+
 void FrameReceiverApp::rx_ping_timer_handler(void)
 {
 
     IpcMessage rxPing(IpcMessage::MsgTypeCmd, IpcMessage::MsgValCmdStatus);
-    rx_channel_.send(rxPing.encode());
+    rx_channels_[0]->send(rxPing.encode());
 
 }
 
@@ -7,18 +7,50 @@
 
 #include "FrameReceiverRxThread.h"
 #include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <sched.h>
+#include <linux/sock_diag.h>
+#include <netinet/udp.h>
+#ifndef UDP_GRO
+#define UDP_GRO 104 // Defined by linux/udp.h, missing from older C library headers
+#endif
+#endif
 
 using namespace FrameReceiver;
 
+namespace
+{
+    // Largest datagram the kernel can deliver after coalescing packets with UDP GRO
+    const std::size_t max_gro_datagram_size = 65535;
+}
+
 FrameReceiverRxThread::FrameReceiverRxThread(FrameReceiverConfig& config, LoggerPtr& logger,
-        SharedBufferManagerPtr buffer_manager, FrameDecoderPtr frame_decoder, unsigned int tick_period_ms) :
+        SharedBufferManagerPtr buffer_manager, FrameDecoderPtr frame_decoder, IpcReactor& relay_reactor,
+        FrameRelayCallback relay_callback, unsigned int tick_period_ms, unsigned int thread_idx) :
    config_(config),
    logger_(logger),
    buffer_manager_(buffer_manager),
    frame_decoder_(frame_decoder),
+   thread_idx_(thread_idx),
    tick_period_ms_(tick_period_ms),
+   relay_reactor_(relay_reactor),
+   relay_callback_(relay_callback),
    rx_channel_(ZMQ_PAIR),
    recv_socket_(0),
+   reactor_(config.reactor_backend_),
+   busy_poll_iterations_(0),
+   use_udp_gro_(false),
+   gro_sockets_(0),
+   gro_datagrams_(0),
+   gro_segments_(0),
+   gro_truncated_(0),
+   frames_spilled_(0),
    run_thread_(true),
    thread_running_(false),
    thread_init_error_(false),
@@ -49,15 +81,35 @@ FrameReceiverRxThread::~FrameReceiverRxThread()
 
 void FrameReceiverRxThread::run_service(void)
 {
-    LOG4CXX_DEBUG_LEVEL(1, logger_, "Running RX thread service");
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Running RX thread " << thread_idx_ << " service");
+
+    // Bind the thread to the configured NUMA node, if any, before any per-thread memory is allocated.
+    // This is done before pinning to a CPU core so that the pinning takes precedence
+    if (thread_idx_ < config_.rx_thread_numa_nodes_.size())
+    {
+        if (!bind_thread_to_numa_node(config_.rx_thread_numa_nodes_[thread_idx_]))
+        {
+            return;
+        }
+    }
+
+    // Pin the thread to the configured CPU core, if any
+    if (thread_idx_ < config_.rx_thread_cpus_.size())
+    {
+        if (!bind_thread_to_cpu(config_.rx_thread_cpus_[thread_idx_]))
+        {
+            return;
+        }
+    }
 
     // Connect the message channel to the main thread
+    std::string rx_channel_endpoint = config_.rx_thread_channel_endpoint(thread_idx_);
     try {
-        rx_channel_.connect(config_.rx_channel_endpoint_);
+        rx_channel_.connect(rx_channel_endpoint);
     }
     catch (zmq::error_t& e) {
         std::stringstream ss;
-        ss << "RX channel connect to endpoint " << config_.rx_channel_endpoint_ << " failed: " << e.what();
+        ss << "RX channel connect to endpoint " << rx_channel_endpoint << " failed: " << e.what();
         thread_init_msg_ = ss.str();
         thread_init_error_ = true;
         return;
@@ -66,10 +118,148 @@ void FrameReceiverRxThread::run_service(void)
     // Add the RX channel to the reactor
     reactor_.register_channel(rx_channel_, boost::bind(&FrameReceiverRxThread::handle_rx_channel, this));
 
-    for (std::vector<uint16_t>::iterator rx_port_itr = config_.rx_ports_.begin(); rx_port_itr != config_.rx_ports_.end(); rx_port_itr++)
+    // Select the packet receive mode from the decoder capability, unless header peek is forced
+    packet_receive_mode_ = frame_decoder_->get_packet_receive_mode();
+    if (config_.rx_force_header_peek_)
     {
+        packet_receive_mode_ = FrameDecoder::PacketReceiveModeHeaderPeek;
+    }
 
-        uint16_t rx_port = *rx_port_itr;
+    use_batch_receive_ = false;
+    if (packet_receive_mode_ == FrameDecoder::PacketReceiveModeSpeculative)
+    {
+        frame_decoder_->init_batch_receive(std::max(config_.rx_batch_size_, 1U));
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread using speculative packet receive");
+
+        if (config_.rx_batch_size_ > 1)
+        {
+#ifdef __linux__
+            init_batch_receive();
+            use_batch_receive_ = true;
+            LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread using batched receive of up to " << config_.rx_batch_size_ << " packets");
+#else
+            LOG4CXX_WARN(logger_, "Batched receive is not supported on this platform, falling back to single packet receive");
+#endif
+        }
+    }
+    else
+    {
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread using header peek packet receive");
+        if (config_.rx_batch_size_ > 1)
+        {
+            LOG4CXX_WARN(logger_, "Batched receive requires speculative packet receive, falling back to single packet receive");
+        }
+    }
+
+    // UDP GRO splits coalesced datagrams received on the sockets of the socket backend, which other
+    // backends would deliver unsplit, so it is only enabled for that backend
+    if (config_.rx_udp_gro_)
+    {
+#ifdef __linux__
+        if (config_.rx_backend_ == Defaults::RxBackendSocket)
+        {
+            init_gro_receive();
+            use_udp_gro_ = true;
+        }
+        else
+        {
+            LOG4CXX_WARN(logger_, "UDP GRO receive is only supported by the socket receive backend, ignoring");
+        }
+#else
+        LOG4CXX_WARN(logger_, "UDP GRO receive is not supported on this platform, ignoring");
+#endif
+    }
+
+    // Create the receive backend: either a packet ring capturing on an interface or a UDP socket
+    // for each receive port, optionally received from through io_uring
+    if (config_.rx_backend_ == Defaults::RxBackendPacketRing)
+    {
+        if (!init_packet_ring()) return;
+    }
+    else
+    {
+        if (!init_receive_sockets()) return;
+        if (config_.rx_backend_ == Defaults::RxBackendIoUring)
+        {
+            if (!init_io_uring()) return;
+        }
+    }
+
+    // Create the notifier passing ready frames to downstream consumers
+    if (!init_frame_notifier()) return;
+
+    // Add the tick timer to the reactor
+    int tick_timer_id = reactor_.register_timer(tick_period_ms_, 0, boost::bind(&FrameReceiverRxThread::tick_timer, this));
+
+    // Add the frame expiry timer to the reactor, which releases incomplete frames as their timeouts expire
+    int frame_expiry_timer_id = reactor_.register_timer(Defaults::default_rx_frame_expiry_period_ms, 0,
+            boost::bind(&FrameReceiverRxThread::frame_expiry_timer, this));
+
+    // Add the buffer monitor timer to the reactor
+    int buffer_monitor_timer_id = reactor_.register_timer(3000, 0, boost::bind(&FrameReceiverRxThread::buffer_monitor_timer, this));
+
+    // Register the frame release callback with the decoder
+    frame_decoder_->register_frame_ready_callback(boost::bind(&FrameReceiverRxThread::frame_ready, this, _1, _2, _3, _4));
+
+    // Set thread state to running, allows constructor to return
+    thread_running_ = true;
+
+    // Run the reactor event loop, or spin on the receive handlers in busy-poll mode
+    if (config_.rx_busy_poll_)
+    {
+        run_busy_poll();
+    }
+    else
+    {
+        reactor_.run();
+    }
+
+    // Cleanup - remove channels, sockets and timers from the reactor and close the receive socket
+    reactor_.remove_channel(rx_channel_);
+    frame_notifier_->remove_channels(reactor_);
+    frame_notifier_.reset();
+    reactor_.remove_timer(tick_timer_id);
+    reactor_.remove_timer(frame_expiry_timer_id);
+    reactor_.remove_timer(buffer_monitor_timer_id);
+    busy_poll_handlers_.clear();
+
+    if (io_uring_)
+    {
+        reactor_.remove_socket(io_uring_->get_event_fd());
+        io_uring_.reset();
+    }
+
+    for (std::vector<int>::iterator recv_sock_it = recv_sockets_.begin(); recv_sock_it != recv_sockets_.end(); recv_sock_it++)
+    {
+        reactor_.remove_socket(*recv_sock_it);
+        close(*recv_sock_it);
+    }
+    recv_sockets_.clear();
+    recv_ports_.clear();
+
+    if (packet_ring_)
+    {
+        reactor_.remove_socket(packet_ring_->get_socket());
+        packet_ring_.reset();
+    }
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Terminating RX thread service");
+
+}
+
+bool FrameReceiverRxThread::init_receive_sockets(void)
+{
+    for (std::size_t port_idx = 0; port_idx < config_.rx_ports_.size(); port_idx++)
+    {
+
+        // Unless binding all ports in all threads with SO_REUSEPORT, distribute the ports
+        // round-robin across the RX threads
+        if (!config_.rx_reuse_port_ && ((port_idx % config_.rx_threads_) != thread_idx_))
+        {
+            continue;
+        }
+
+        uint16_t rx_port = config_.rx_ports_[port_idx];
 
         // Create the receive socket
         int recv_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -79,7 +269,7 @@ void FrameReceiverRxThread::run_service(void)
             ss << "RX channel failed to create receive socket for port " << rx_port << " : " << strerror(errno);
             thread_init_msg_ = ss.str();
             thread_init_error_ = true;
-            return;
+            return false;
         }
 
         // Set the socket receive buffer size
@@ -89,7 +279,45 @@ void FrameReceiverRxThread::run_service(void)
             ss << "RX channel failed to set receive socket buffer size for port " << rx_port << " : " << strerror(errno);
             thread_init_msg_ = ss.str();
             thread_init_error_ = true;
-            return;
+            return false;
+        }
+
+        // Allow several RX threads to bind the same port, sharing incoming packets between them
+        if (config_.rx_reuse_port_)
+        {
+#ifdef SO_REUSEPORT
+            int reuse_port = 1;
+            if (setsockopt(recv_socket, SOL_SOCKET, SO_REUSEPORT, &reuse_port, sizeof(reuse_port)) < 0)
+            {
+                std::stringstream ss;
+                ss << "RX channel failed to set SO_REUSEPORT on receive socket for port " << rx_port << " : " << strerror(errno);
+                thread_init_msg_ = ss.str();
+                thread_init_error_ = true;
+                return false;
+            }
+#else
+            thread_init_msg_ = "RX channel cannot share receive ports between threads: SO_REUSEPORT not supported on this platform";
+            thread_init_error_ = true;
+            return false;
+#endif
+        }
+
+        // Ask the kernel to busy poll the device queue for packets during receives
+        if (config_.rx_busy_poll_usecs_ > 0)
+        {
+#ifdef SO_BUSY_POLL
+            int busy_poll_usecs = config_.rx_busy_poll_usecs_;
+            if (setsockopt(recv_socket, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_usecs, sizeof(busy_poll_usecs)) < 0)
+            {
+                std::stringstream ss;
+                ss << "RX channel failed to set SO_BUSY_POLL on receive socket for port " << rx_port << " : " << strerror(errno);
+                thread_init_msg_ = ss.str();
+                thread_init_error_ = true;
+                return false;
+            }
+#else
+            LOG4CXX_WARN(logger_, "SO_BUSY_POLL is not supported on this platform, ignoring for port " << rx_port);
+#endif
         }
 
         // Read it back and display
@@ -112,7 +340,7 @@ void FrameReceiverRxThread::run_service(void)
              ss <<  "Illegal receive address specified: " << config_.rx_address_;
              thread_init_msg_ = ss.str();
              thread_init_error_ = true;
-             return;
+             return false;
         }
 
         if (bind(recv_socket, (struct sockaddr*)&recv_addr, sizeof(recv_addr)) == -1)
@@ -121,46 +349,245 @@ void FrameReceiverRxThread::run_service(void)
             ss <<  "RX channel failed to bind receive socket for address " << config_.rx_address_ << " port " << rx_port << " : " << strerror(errno);
             thread_init_msg_ = ss.str();
             thread_init_error_ = true;
-            return;
+            return false;
         }
 
         if (thread_init_error_) break;
 
+        recv_sockets_.push_back(recv_socket);
+        recv_ports_.push_back(rx_port);
+
+        // Sockets received from through io_uring are serviced by its completion eventfd instead
+        if (config_.rx_backend_ == Defaults::RxBackendIoUring) continue;
+
         // Add the receive socket to the reactor
-        reactor_.register_socket(recv_socket, boost::bind(&FrameReceiverRxThread::handle_receive_socket, this, recv_socket, (int)rx_port));
+#ifdef __linux__
+        if (use_udp_gro_ && enable_udp_gro(recv_socket, rx_port))
+        {
+            gro_sockets_++;
+            register_receive_handler(recv_socket, boost::bind(&FrameReceiverRxThread::handle_receive_socket_gro, this, recv_socket, (int)rx_port));
+        }
+        else if (use_batch_receive_)
+        {
+            register_receive_handler(recv_socket, boost::bind(&FrameReceiverRxThread::handle_receive_socket_batch, this, recv_socket, (int)rx_port));
+        }
+        else
+#endif
+        if (packet_receive_mode_ == FrameDecoder::PacketReceiveModeSpeculative)
+        {
+            register_receive_handler(recv_socket, boost::bind(&FrameReceiverRxThread::handle_receive_socket_speculative, this, recv_socket, (int)rx_port));
+        }
+        else
+        {
+            register_receive_handler(recv_socket, boost::bind(&FrameReceiverRxThread::handle_receive_socket, this, recv_socket, (int)rx_port));
+        }
+    }
 
-        recv_sockets_.push_back(recv_socket);
+    return true;
+}
+
+bool FrameReceiverRxThread::init_packet_ring(void)
+{
+    try {
+        packet_ring_.reset(new PacketRingReceiver(logger_, config_.rx_interface_, config_.rx_address_,
+                config_.rx_ports_, config_.rx_ring_block_size_, config_.rx_ring_num_blocks_,
+                Defaults::default_rx_ring_block_timeout_ms));
+
+        // Share packets between the rings of several RX threads capturing on the same interface
+        if (config_.rx_threads_ > 1)
+        {
+            packet_ring_->join_fanout_group(static_cast<uint16_t>(getpid() & 0xFFFF));
+        }
+    }
+    catch (FrameReceiverException& e)
+    {
+        thread_init_msg_ = e.what();
+        thread_init_error_ = true;
+        return false;
     }
 
-    // Add the tick timer to the reactor
-    int tick_timer_id = reactor_.register_timer(tick_period_ms_, 0, boost::bind(&FrameReceiverRxThread::tick_timer, this));
+    packet_ring_handler_ = boost::bind(&FrameReceiverRxThread::handle_ring_packet, this, _1, _2, _3, _4);
+    register_receive_handler(packet_ring_->get_socket(), boost::bind(&FrameReceiverRxThread::handle_packet_ring, this));
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " capturing packets on interface "
+            << config_.rx_interface_ << " with packet ring");
 
-    // Add the buffer monitor timer to the reactor
-    int buffer_monitor_timer_id = reactor_.register_timer(3000, 0, boost::bind(&FrameReceiverRxThread::buffer_monitor_timer, this));
+    return true;
+}
 
-    // Register the frame release callback with the decoder
-    frame_decoder_->register_frame_ready_callback(boost::bind(&FrameReceiverRxThread::frame_ready, this, _1, _2));
+bool FrameReceiverRxThread::init_io_uring(void)
+{
+    try {
+        io_uring_.reset(new IoUringReceiver(logger_, recv_sockets_, recv_ports_,
+                config_.rx_uring_num_buffers_, config_.rx_uring_buffer_size_));
+    }
+    catch (FrameReceiverException& e)
+    {
+        thread_init_msg_ = e.what();
+        thread_init_error_ = true;
+        return false;
+    }
 
-    // Set thread state to running, allows constructor to return
-    thread_running_ = true;
+    packet_ring_handler_ = boost::bind(&FrameReceiverRxThread::handle_ring_packet, this, _1, _2, _3, _4);
+    register_receive_handler(io_uring_->get_event_fd(), boost::bind(&FrameReceiverRxThread::handle_io_uring, this));
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " receiving packets on "
+            << recv_sockets_.size() << " sockets with io_uring");
 
-    // Run the reactor event loop
-    reactor_.run();
+    return true;
+}
 
-    // Cleanup - remove channels, sockets and timers from the reactor and close the receive socket
-    reactor_.remove_channel(rx_channel_);
-    reactor_.remove_timer(tick_timer_id);
-    reactor_.remove_timer(buffer_monitor_timer_id);
+bool FrameReceiverRxThread::init_frame_notifier(void)
+{
+    // Publish ready frames and receive releases directly on the frame ready and release channels if
+    // enabled, otherwise notify through this thread's ring in shared memory if enabled and present, or
+    // relay notifications through the main thread
+    try {
+        if (config_.direct_frame_notify_)
+        {
+            frame_notifier_.reset(new DirectFrameNotifier(logger_, config_.frame_ready_endpoint_,
+                    config_.frame_release_endpoint_, config_.frame_notify_format_, buffer_manager_, frame_decoder_,
+                    config_.frame_consumers_, config_.max_consumer_lag_));
+        }
+        else if (config_.shared_frame_rings_ && buffer_manager_->has_frame_rings())
+        {
+            frame_notifier_.reset(new SharedRingFrameNotifier(logger_, buffer_manager_->get_ready_ring(thread_idx_),
+                    buffer_manager_->get_ready_event(), frame_decoder_->get_buffer_pool()));
+        }
+        else
+        {
+            frame_notifier_.reset(new RelayFrameNotifier(logger_, relay_reactor_, relay_callback_));
+        }
+    }
+    catch (zmq::error_t& e)
+    {
+        std::stringstream ss;
+        ss << "RX thread " << thread_idx_ << " failed to bind frame notification channels: " << e.what();
+        thread_init_msg_ = ss.str();
+        thread_init_error_ = true;
+        return false;
+    }
+    catch (FrameReceiverException& e)
+    {
+        std::stringstream ss;
+        ss << "RX thread " << thread_idx_ << " failed to create frame notifier: " << e.what();
+        thread_init_msg_ = ss.str();
+        thread_init_error_ = true;
+        return false;
+    }
+
+    frame_notifier_->register_channels(reactor_);
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " notifying ready frames with "
+            << frame_notifier_->get_name() << " frame notifier");
+    return true;
+}
+
+void FrameReceiverRxThread::register_receive_handler(int fd, ReactorCallback callback)
+{
+    // In busy-poll mode the handler is called unconditionally on every iteration of the
+    // receive loop, so the descriptor is made non-blocking. Otherwise the handler is called
+    // by the reactor when the descriptor is readable.
+    if (config_.rx_busy_poll_)
+    {
+        int fd_flags = fcntl(fd, F_GETFL, 0);
+        if ((fd_flags < 0) || (fcntl(fd, F_SETFL, fd_flags | O_NONBLOCK) < 0))
+        {
+            LOG4CXX_WARN(logger_, "RX thread failed to set non-blocking mode for busy-poll : " << strerror(errno));
+        }
+        busy_poll_handlers_.push_back(callback);
+    }
+    else
+    {
+        reactor_.register_socket(fd, callback);
+    }
+}
+
+void FrameReceiverRxThread::run_busy_poll(void)
+{
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " busy-polling " << busy_poll_handlers_.size()
+            << " receive handlers, servicing reactor every " << config_.rx_busy_poll_interval_ << " iterations");
+
+    unsigned int poll_interval = std::max(config_.rx_busy_poll_interval_, 1U);
+    unsigned int iteration = 0;
 
+    // Spin on the receive handlers, servicing the RX channel and timers through a non-blocking
+    // iteration of the reactor every poll interval until the reactor is stopped
+    while (!reactor_.is_stopped())
+    {
+        for (std::vector<ReactorCallback>::iterator handler_it = busy_poll_handlers_.begin();
+                handler_it != busy_poll_handlers_.end(); ++handler_it)
+        {
+            (*handler_it)();
+        }
+        busy_poll_iterations_++;
+
+        if (++iteration >= poll_interval)
+        {
+            iteration = 0;
+            reactor_.run_once(0);
+        }
+    }
+}
+
+uint64_t FrameReceiverRxThread::get_socket_drops(void)
+{
+    uint64_t socket_drops = 0;
+
+#if defined(__linux__) && defined(SO_MEMINFO)
+    // Sum the packets dropped by each receive socket, e.g. due to a full receive buffer
     for (std::vector<int>::iterator recv_sock_it = recv_sockets_.begin(); recv_sock_it != recv_sockets_.end(); recv_sock_it++)
     {
-        reactor_.remove_socket(*recv_sock_it);
-        close(*recv_sock_it);
+        uint32_t mem_info[SK_MEMINFO_VARS];
+        socklen_t len = sizeof(mem_info);
+        if (getsockopt(*recv_sock_it, SOL_SOCKET, SO_MEMINFO, mem_info, &len) == 0)
+        {
+            socket_drops += mem_info[SK_MEMINFO_DROPS];
+        }
     }
-    recv_sockets_.clear();
+#endif
 
-    LOG4CXX_DEBUG_LEVEL(1, logger_, "Terminating RX thread service");
+    return socket_drops;
+}
+
+bool FrameReceiverRxThread::bind_thread_to_cpu(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
 
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (rc != 0)
+    {
+        std::stringstream ss;
+        ss << "RX thread " << thread_idx_ << " failed to bind to CPU " << cpu << " : " << strerror(rc);
+        thread_init_msg_ = ss.str();
+        thread_init_error_ = true;
+        return false;
+    }
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " bound to CPU " << cpu);
+#else
+    LOG4CXX_WARN(logger_, "Binding RX thread " << thread_idx_ << " to CPU " << cpu << " is not supported on this platform");
+#endif
+    return true;
+}
+
+bool FrameReceiverRxThread::bind_thread_to_numa_node(int node)
+{
+    // Only restrict the thread to the CPUs of the node if it is not also pinned to a single core
+    bool set_affinity = (thread_idx_ >= config_.rx_thread_cpus_.size());
+    try
+    {
+        NumaBinding::bind_thread(node, set_affinity);
+    }
+    catch (FrameReceiverException& e)
+    {
+        std::stringstream ss;
+        ss << "RX thread " << thread_idx_ << " failed to bind to NUMA node " << node << " : " << e.what();
+        thread_init_msg_ = ss.str();
+        thread_init_error_ = true;
+        return false;
+    }
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " bound to NUMA node " << node);
+    return true;
 }
 
 void FrameReceiverRxThread::handle_rx_channel(void)
@@ -171,6 +598,23 @@ void FrameReceiverRxThread::handle_rx_channel(void)
     // Parse and handle the message
     try {
 
+        // Handle binary frame release notifications, forwarded by the main thread as received
+        if (FrameNotification::is_binary(rx_msg_encoded))
+        {
+            FrameNotification release(rx_msg_encoded);
+            if (release.get_msg_val() == IpcMessage::MsgValNotifyFrameRelease)
+            {
+                frame_decoder_->push_empty_buffer(release.get_buffer_id());
+                LOG4CXX_DEBUG_LEVEL(3, logger_, "Added empty buffer ID " << release.get_buffer_id() << " to queue, length is now "
+                        << frame_decoder_->get_num_empty_buffers());
+            }
+            else
+            {
+                LOG4CXX_ERROR(logger_, "RX thread received unexpected binary frame notification");
+            }
+            return;
+        }
+
         IpcMessage rx_msg(rx_msg_encoded.c_str());
 
 		if ((rx_msg.get_msg_type() == IpcMessage::MsgTypeNotify) &&
@@ -200,6 +644,53 @@ void FrameReceiverRxThread::handle_rx_channel(void)
 			rx_reply.set_msg_val(IpcMessage::MsgValCmdStatus);
 			rx_reply.set_param("count", rx_msg.get_param<int>("count", -1));
 
+			if (packet_ring_)
+			{
+			    packet_ring_->update_statistics();
+			    rx_reply.set_param("packet_ring_captured", packet_ring_->get_packets_captured());
+			    rx_reply.set_param("packet_ring_dropped", packet_ring_->get_packets_dropped());
+			    rx_reply.set_param("packet_ring_received", packet_ring_->get_packets_received());
+			    rx_reply.set_param("packet_ring_ignored", packet_ring_->get_packets_ignored());
+			}
+
+			rx_reply.set_param("buffer_page_size", static_cast<uint64_t>(buffer_manager_->get_page_size()));
+			rx_reply.set_param("buffer_huge_pages", buffer_manager_->is_huge_page_backed());
+
+			std::vector<size_t> buffer_occupancy;
+			buffer_manager_->get_buffer_occupancy(buffer_occupancy);
+			rx_reply.set_param("buffers_free", static_cast<uint64_t>(buffer_occupancy[BufferStateFree]));
+			rx_reply.set_param("buffers_filling", static_cast<uint64_t>(buffer_occupancy[BufferStateFilling]));
+			rx_reply.set_param("buffers_ready", static_cast<uint64_t>(buffer_occupancy[BufferStateReady]));
+			rx_reply.set_param("buffers_in_use", static_cast<uint64_t>(buffer_occupancy[BufferStateInUse]));
+			if (buffer_manager_->has_spill_buffers())
+			{
+			    rx_reply.set_param("spill_buffers", static_cast<uint64_t>(buffer_manager_->get_num_spill_buffers()));
+			    rx_reply.set_param("frames_spilled", frames_spilled_);
+			}
+
+			frame_notifier_->get_status(rx_reply);
+
+			rx_reply.set_param("busy_poll", config_.rx_busy_poll_);
+			rx_reply.set_param("busy_poll_iterations", busy_poll_iterations_);
+			rx_reply.set_param("socket_drops", get_socket_drops());
+
+			// GRO is only reported as enabled if it was enabled on at least one socket
+			rx_reply.set_param("udp_gro", (gro_sockets_ > 0));
+			if (gro_sockets_ > 0)
+			{
+			    rx_reply.set_param("udp_gro_sockets", gro_sockets_);
+			    rx_reply.set_param("udp_gro_datagrams", gro_datagrams_);
+			    rx_reply.set_param("udp_gro_segments", gro_segments_);
+			    rx_reply.set_param("udp_gro_truncated", gro_truncated_);
+			}
+
+			if (io_uring_)
+			{
+			    rx_reply.set_param("io_uring_received", io_uring_->get_packets_received());
+			    rx_reply.set_param("io_uring_truncated", io_uring_->get_packets_truncated());
+			    rx_reply.set_param("io_uring_buffer_stalls", io_uring_->get_buffer_stalls());
+			}
+
 		    rx_channel_.send(rx_reply.encode());
 		}
 		else
@@ -225,16 +716,22 @@ void FrameReceiverRxThread::handle_rx_channel(void)
 void FrameReceiverRxThread::handle_receive_socket(int recv_socket, int recv_port)
 {
 
-	if (frame_decoder_->requires_header_peek())
+	size_t header_size = frame_decoder_->get_packet_header_size();
+	void*  header_buffer = frame_decoder_->get_packet_header_buffer();
+	struct sockaddr_in from_addr;
+	socklen_t from_len = sizeof(from_addr);
+	ssize_t header_bytes_received = recvfrom(recv_socket, header_buffer, header_size, MSG_PEEK, (struct sockaddr*)&from_addr, &from_len);
+	if (header_bytes_received < 0)
 	{
-		size_t header_size = frame_decoder_->get_packet_header_size();
-		void*  header_buffer = frame_decoder_->get_packet_header_buffer();
-		struct sockaddr_in from_addr;
-		socklen_t from_len = sizeof(from_addr);
-		size_t bytes_received = recvfrom(recv_socket, header_buffer, header_size, MSG_PEEK, (struct sockaddr*)&from_addr, &from_len);
-		LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << bytes_received << " header bytes on recv socket");
-		frame_decoder_->process_packet_header(bytes_received, recv_port, &from_addr);
+		// Non-blocking receives in busy-poll mode return without data when none is pending
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+		{
+			LOG4CXX_ERROR(logger_, "RX thread receive failed on port " << recv_port << " : " << strerror(errno));
+		}
+		return;
 	}
+	LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << header_bytes_received << " header bytes on recv socket");
+	frame_decoder_->process_packet_header(header_bytes_received, recv_port, &from_addr);
 
 	struct iovec io_vec[2];
 	io_vec[0].iov_base = frame_decoder_->get_packet_header_buffer();
@@ -255,6 +752,233 @@ void FrameReceiverRxThread::handle_receive_socket(int recv_socket, int recv_port
 	FrameDecoder::FrameReceiveState frame_receive_state = frame_decoder_->process_packet(bytes_received);
 }
 
+void FrameReceiverRxThread::handle_receive_socket_speculative(int recv_socket, int recv_port)
+{
+	// Receive header and payload in a single call into the destinations predicted by the
+	// decoder, which decodes the header afterwards and relocates the payload if necessary
+	frame_decoder_->prepare_batch_receive(1);
+
+	struct iovec io_vec[2];
+	io_vec[0].iov_base = frame_decoder_->get_batch_header_buffer(0);
+	io_vec[0].iov_len  = frame_decoder_->get_packet_header_size();
+	io_vec[1].iov_base = frame_decoder_->get_batch_payload_buffer(0);
+	io_vec[1].iov_len  = frame_decoder_->get_batch_payload_size(0);
+
+	struct sockaddr_in from_addr;
+	struct msghdr msg_hdr;
+	memset((void*)&msg_hdr,  0, sizeof(struct msghdr));
+	msg_hdr.msg_name = &from_addr;
+	msg_hdr.msg_namelen = sizeof(from_addr);
+	msg_hdr.msg_iov = io_vec;
+	msg_hdr.msg_iovlen = 2;
+
+	ssize_t bytes_received = recvmsg(recv_socket, &msg_hdr, 0);
+	if (bytes_received < 0)
+	{
+		// Non-blocking receives in busy-poll mode return without data when none is pending
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+		{
+			LOG4CXX_ERROR(logger_, "RX thread receive failed on port " << recv_port << " : " << strerror(errno));
+		}
+		return;
+	}
+	LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << bytes_received << " header/payload bytes on recv socket");
+
+	frame_decoder_->process_batch_packet(0, bytes_received, recv_port, &from_addr);
+}
+
+#ifdef __linux__
+void FrameReceiverRxThread::init_batch_receive(void)
+{
+    std::size_t batch_size = config_.rx_batch_size_;
+
+    // Preallocate the message headers, iovecs and source addresses used by recvmmsg. The
+    // iovec base addresses are filled in from the decoder before each receive call.
+    batch_msgs_.resize(batch_size);
+    batch_iovecs_.resize(batch_size * 2);
+    batch_addrs_.resize(batch_size);
+
+    for (std::size_t msg_idx = 0; msg_idx < batch_size; msg_idx++)
+    {
+        memset((void*)&batch_msgs_[msg_idx], 0, sizeof(struct mmsghdr));
+        batch_msgs_[msg_idx].msg_hdr.msg_iov = &batch_iovecs_[msg_idx * 2];
+        batch_msgs_[msg_idx].msg_hdr.msg_iovlen = 2;
+        batch_msgs_[msg_idx].msg_hdr.msg_name = &batch_addrs_[msg_idx];
+        batch_iovecs_[msg_idx * 2].iov_len = frame_decoder_->get_packet_header_size();
+    }
+}
+
+void FrameReceiverRxThread::handle_receive_socket_batch(int recv_socket, int recv_port)
+{
+    std::size_t batch_size = batch_msgs_.size();
+
+    // Ask the decoder for header and payload destinations for the whole batch
+    frame_decoder_->prepare_batch_receive(batch_size);
+
+    for (std::size_t msg_idx = 0; msg_idx < batch_size; msg_idx++)
+    {
+        batch_iovecs_[msg_idx * 2].iov_base     = frame_decoder_->get_batch_header_buffer(msg_idx);
+        batch_iovecs_[msg_idx * 2 + 1].iov_base = frame_decoder_->get_batch_payload_buffer(msg_idx);
+        batch_iovecs_[msg_idx * 2 + 1].iov_len  = frame_decoder_->get_batch_payload_size(msg_idx);
+        batch_msgs_[msg_idx].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    // Drain as many datagrams as are available, up to the batch size, in a single call
+    int packets_received = recvmmsg(recv_socket, &batch_msgs_[0], batch_size, MSG_DONTWAIT, 0);
+    if (packets_received < 0)
+    {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            LOG4CXX_ERROR(logger_, "RX thread batch receive failed on port " << recv_port << " : " << strerror(errno));
+        }
+        return;
+    }
+    LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received batch of " << packets_received << " packets on recv socket");
+
+    for (int msg_idx = 0; msg_idx < packets_received; msg_idx++)
+    {
+        frame_decoder_->process_batch_packet(msg_idx, batch_msgs_[msg_idx].msg_len, recv_port, &batch_addrs_[msg_idx]);
+    }
+}
+#endif
+
+#ifdef __linux__
+void FrameReceiverRxThread::init_gro_receive(void)
+{
+    std::size_t num_msgs = std::max(config_.rx_batch_size_, 1U);
+
+    // Preallocate a staging buffer large enough for the largest coalesced datagram, and space for
+    // the segment size control message, for each message received per call
+    gro_msgs_.resize(num_msgs);
+    gro_iovecs_.resize(num_msgs);
+    gro_addrs_.resize(num_msgs);
+    gro_buffers_.resize(num_msgs * max_gro_datagram_size);
+    gro_control_.resize(num_msgs * CMSG_SPACE(sizeof(int)));
+
+    for (std::size_t msg_idx = 0; msg_idx < num_msgs; msg_idx++)
+    {
+        memset((void*)&gro_msgs_[msg_idx], 0, sizeof(struct mmsghdr));
+        gro_iovecs_[msg_idx].iov_base = &gro_buffers_[msg_idx * max_gro_datagram_size];
+        gro_iovecs_[msg_idx].iov_len  = max_gro_datagram_size;
+        gro_msgs_[msg_idx].msg_hdr.msg_iov = &gro_iovecs_[msg_idx];
+        gro_msgs_[msg_idx].msg_hdr.msg_iovlen = 1;
+        gro_msgs_[msg_idx].msg_hdr.msg_name = &gro_addrs_[msg_idx];
+    }
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread using UDP GRO receive of up to " << num_msgs << " coalesced datagrams");
+}
+
+bool FrameReceiverRxThread::enable_udp_gro(int recv_socket, int recv_port)
+{
+    // Kernels older than 5.0 reject the option, in which case the socket uses the normal receive path
+    int enable_gro = 1;
+    if (setsockopt(recv_socket, SOL_UDP, UDP_GRO, &enable_gro, sizeof(enable_gro)) < 0)
+    {
+        LOG4CXX_WARN(logger_, "RX thread failed to enable UDP GRO on receive socket for port " << recv_port
+                << " : " << strerror(errno) << ", falling back to normal receive");
+        return false;
+    }
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread enabled UDP GRO on receive socket for port " << recv_port);
+    return true;
+}
+
+void FrameReceiverRxThread::handle_receive_socket_gro(int recv_socket, int recv_port)
+{
+    std::size_t num_msgs = gro_msgs_.size();
+    std::size_t control_size = CMSG_SPACE(sizeof(int));
+
+    for (std::size_t msg_idx = 0; msg_idx < num_msgs; msg_idx++)
+    {
+        gro_msgs_[msg_idx].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        gro_msgs_[msg_idx].msg_hdr.msg_control = &gro_control_[msg_idx * control_size];
+        gro_msgs_[msg_idx].msg_hdr.msg_controllen = control_size;
+        gro_msgs_[msg_idx].msg_hdr.msg_flags = 0;
+    }
+
+    int msgs_received = recvmmsg(recv_socket, &gro_msgs_[0], num_msgs, MSG_DONTWAIT, 0);
+    if (msgs_received < 0)
+    {
+        if ((errno != EAGAIN) && (errno != EWOULDBLOCK))
+        {
+            LOG4CXX_ERROR(logger_, "RX thread GRO receive failed on port " << recv_port << " : " << strerror(errno));
+        }
+        return;
+    }
+
+    for (int msg_idx = 0; msg_idx < msgs_received; msg_idx++)
+    {
+        struct msghdr& msg_hdr = gro_msgs_[msg_idx].msg_hdr;
+        std::size_t datagram_size = gro_msgs_[msg_idx].msg_len;
+        uint8_t* datagram = reinterpret_cast<uint8_t*>(gro_iovecs_[msg_idx].iov_base);
+
+        if (msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            gro_truncated_++;
+            LOG4CXX_DEBUG_LEVEL(2, logger_, "RX thread received truncated coalesced datagram on port " << recv_port);
+        }
+
+        // A datagram that was not coalesced has no segment size control message and is a single packet
+        std::size_t segment_size = datagram_size;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg_hdr); cmsg != 0; cmsg = CMSG_NXTHDR(&msg_hdr, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO))
+            {
+                int gso_size;
+                memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                if (gso_size > 0)
+                {
+                    segment_size = gso_size;
+                }
+            }
+        }
+
+        LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << datagram_size << " byte datagram with segment size "
+                << segment_size << " on recv socket");
+        gro_datagrams_++;
+
+        // Dispatch each segment to the decoder, the last of which may be shorter than the others
+        for (std::size_t offset = 0; offset < datagram_size; offset += segment_size)
+        {
+            handle_ring_packet(datagram + offset, std::min(segment_size, datagram_size - offset), recv_port, &gro_addrs_[msg_idx]);
+            gro_segments_++;
+        }
+    }
+}
+#endif
+
+void FrameReceiverRxThread::handle_packet_ring(void)
+{
+    size_t packets_received = packet_ring_->process_blocks(packet_ring_handler_);
+    LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << packets_received << " packets from packet ring");
+}
+
+void FrameReceiverRxThread::handle_io_uring(void)
+{
+    size_t packets_received = io_uring_->process_completions(packet_ring_handler_);
+    LOG4CXX_DEBUG_LEVEL(3, logger_, "RX thread received " << packets_received << " packets from io_uring");
+}
+
+void FrameReceiverRxThread::handle_ring_packet(uint8_t* packet, size_t packet_size, int recv_port, struct sockaddr_in* from_addr)
+{
+    // Packets captured in the ring, or split from a coalesced GRO datagram, are copied into the
+    // decoder buffers following the same header then payload sequence as the header peek socket
+    // receive path
+    size_t header_size = frame_decoder_->get_packet_header_size();
+    if (packet_size < header_size)
+    {
+        LOG4CXX_DEBUG_LEVEL(2, logger_, "RX thread ignoring short packet of " << packet_size << " bytes");
+        return;
+    }
+
+    memcpy(frame_decoder_->get_packet_header_buffer(), packet, header_size);
+    frame_decoder_->process_packet_header(packet_size, recv_port, from_addr);
+
+    size_t payload_size = std::min(packet_size - header_size, frame_decoder_->get_next_payload_size());
+    memcpy(frame_decoder_->get_next_payload_buffer(), packet + header_size, payload_size);
+    frame_decoder_->process_packet(packet_size);
+}
+
 void FrameReceiverRxThread::tick_timer(void)
 {
 	//LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread tick timer fired");
@@ -265,19 +989,92 @@ void FrameReceiverRxThread::tick_timer(void)
 	}
 }
 
+void FrameReceiverRxThread::frame_expiry_timer(void)
+{
+    frame_decoder_->expire_frames();
+
+    // Return any buffers released through the frame notifier to the empty buffer queue
+    frame_notifier_->service_releases();
+}
+
 void FrameReceiverRxThread::buffer_monitor_timer(void)
 {
     frame_decoder_->monitor_buffers();
+
+    if (packet_ring_)
+    {
+        packet_ring_->update_statistics();
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " packet ring captured "
+                << packet_ring_->get_packets_captured() << " packets, dropped "
+                << packet_ring_->get_packets_dropped() << ", received "
+                << packet_ring_->get_packets_received() << ", ignored "
+                << packet_ring_->get_packets_ignored());
+    }
+
+    if (use_udp_gro_)
+    {
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " UDP GRO received "
+                << gro_datagrams_ << " datagrams containing " << gro_segments_ << " packets, truncated "
+                << gro_truncated_);
+    }
+
+    if (io_uring_)
+    {
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " io_uring received "
+                << io_uring_->get_packets_received() << " packets, truncated "
+                << io_uring_->get_packets_truncated() << ", buffer stalls "
+                << io_uring_->get_buffer_stalls());
+    }
+
+    if (!recv_sockets_.empty())
+    {
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " receive sockets dropped "
+                << get_socket_drops() << " packets" << (config_.rx_busy_poll_ ? " in busy-poll mode" : ""));
+    }
 }
 
-void FrameReceiverRxThread::frame_ready(int buffer_id, int frame_number)
+void FrameReceiverRxThread::frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns)
 {
     LOG4CXX_DEBUG_LEVEL(2, logger_, "Releasing frame " << frame_number << " in buffer " << buffer_id);
 
-    IpcMessage ready_msg(IpcMessage::MsgTypeNotify, IpcMessage::MsgValNotifyFrameReady);
-    ready_msg.set_param("frame", frame_number);
-    ready_msg.set_param("buffer_id", buffer_id);
+    buffer_manager_->set_buffer_state(buffer_id, BufferStateReady, frame_number);
+
+    // Frames in spill buffers are marked so that consumers know they are being read from the spill file
+    bool spilled = buffer_manager_->is_spill_buffer(buffer_id);
+    if (spilled)
+    {
+        frames_spilled_++;
+        LOG4CXX_DEBUG_LEVEL(1, logger_, "RX thread " << thread_idx_ << " frame " << frame_number
+                << " spilled to buffer " << buffer_id);
+    }
+
+    frame_notifier_->notify_frame_ready(buffer_id, frame_number, frame_state, frame_timestamp_ns, spilled);
+}
+
+void FrameReceiverRxThread::release_buffers(const std::vector<int>& buffer_ids)
+{
+    // Called from another thread, so post the buffers to the reactor of this thread to return them to
+    // the empty buffer queue from its own loop
+    reactor_.post(boost::bind(&FrameReceiverRxThread::push_empty_buffers, this, buffer_ids));
+}
 
-    rx_channel_.send(ready_msg.encode());
+void FrameReceiverRxThread::push_empty_buffers(const std::vector<int>& buffer_ids)
+{
+    for (std::vector<int>::const_iterator buffer_itr = buffer_ids.begin(); buffer_itr != buffer_ids.end();
+            buffer_itr++)
+    {
+        frame_decoder_->push_empty_buffer(*buffer_itr);
+    }
+    LOG4CXX_DEBUG_LEVEL(3, logger_, "Added " << buffer_ids.size() << " empty buffer(s) to queue, length is now "
+            << frame_decoder_->get_num_empty_buffers());
+}
 
+const uint64_t FrameReceiverRxThread::get_frames_notified(void) const
+{
+    return frame_notifier_->get_frames_notified();
+}
+
+const uint64_t FrameReceiverRxThread::get_frames_released(void) const
+{
+    return frame_notifier_->get_frames_released();
 }
@@ -0,0 +1,190 @@
+/*!
+ * FrameTimerWheel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "FrameTimerWheel.h"
+
+using namespace FrameReceiver;
+
+//! Constructor for FrameTimerWheel class.
+//!
+//! The number of slots is rounded up to a power of two so that the slot for a tick can be
+//! found by masking. Choosing at least as many slots as the frame timeout in milliseconds
+//! ensures that every timeout is visited only once, when it expires.
+//!
+//! \param num_slots - minimum number of one millisecond slots in the wheel
+
+FrameTimerWheel::FrameTimerWheel(size_t num_slots) :
+    num_scheduled_(0),
+    current_ms_(0),
+    started_(false)
+{
+    size_t wheel_size = 1;
+    while (wheel_size < num_slots)
+    {
+        wheel_size <<= 1;
+    }
+    slots_.assign(wheel_size, -1);
+    slot_mask_ = wheel_size - 1;
+}
+
+//! Schedule the timeout of the frame being filled in a buffer.
+//!
+//! Any timeout already scheduled for the buffer is replaced.
+//!
+//! \param buffer_id - ID of the buffer assigned to the frame
+//! \param frame_number - number of the frame
+//! \param expiry_ms - time at which the frame times out, in milliseconds
+
+void FrameTimerWheel::schedule(int buffer_id, uint32_t frame_number, uint64_t expiry_ms)
+{
+    if (static_cast<size_t>(buffer_id) >= entries_.size())
+    {
+        TimerEntry empty_entry = {0, 0, -1, -1, false};
+        entries_.resize(buffer_id + 1, empty_entry);
+    }
+
+    if (entries_[buffer_id].active)
+    {
+        unlink(buffer_id);
+    }
+
+    // A timeout which is already due is placed in the next slot to be visited
+    if (started_ && (expiry_ms <= current_ms_))
+    {
+        expiry_ms = current_ms_ + 1;
+    }
+
+    TimerEntry& entry = entries_[buffer_id];
+    entry.frame_number = frame_number;
+    entry.expiry_ms = expiry_ms;
+    entry.active = true;
+
+    int& slot_head = slots_[expiry_ms & slot_mask_];
+    entry.prev = -1;
+    entry.next = slot_head;
+    if (slot_head >= 0)
+    {
+        entries_[slot_head].prev = buffer_id;
+    }
+    slot_head = buffer_id;
+    num_scheduled_++;
+}
+
+//! Cancel the timeout of the frame in a buffer, e.g. when the frame is complete.
+//!
+//! \param buffer_id - ID of the buffer
+//! \return true if a timeout was scheduled for the buffer
+
+bool FrameTimerWheel::cancel(int buffer_id)
+{
+    if ((buffer_id < 0) || (static_cast<size_t>(buffer_id) >= entries_.size()) || !entries_[buffer_id].active)
+    {
+        return false;
+    }
+
+    unlink(buffer_id);
+    return true;
+}
+
+//! Advance the wheel to the current time, collecting expired timeouts.
+//!
+//! The slots for each tick since the last advance are visited in turn. Expired timeouts are
+//! removed from the wheel and appended to the expired vector, which the caller can reuse
+//! between calls to avoid allocation.
+//!
+//! \param now_ms - current time in milliseconds
+//! \param expired - vector to append expired timeouts to
+//! \return number of timeouts expired
+
+size_t FrameTimerWheel::advance(uint64_t now_ms, std::vector<FrameTimerExpiry>& expired)
+{
+    if (!started_)
+    {
+        // Visit any slots holding timeouts scheduled before the first advance
+        current_ms_ = (now_ms > slot_mask_) ? (now_ms - slot_mask_ - 1) : 0;
+        started_ = true;
+    }
+
+    if (now_ms <= current_ms_)
+    {
+        return 0;
+    }
+
+    // Once the wheel has turned fully there is no need to visit any slot more than once
+    uint64_t first_ms = current_ms_ + 1;
+    if ((now_ms - current_ms_) > slots_.size())
+    {
+        first_ms = now_ms - slot_mask_;
+    }
+    current_ms_ = now_ms;
+
+    size_t num_expired = 0;
+    for (uint64_t tick_ms = first_ms; (tick_ms <= now_ms) && (num_scheduled_ > 0); tick_ms++)
+    {
+        int buffer_id = slots_[tick_ms & slot_mask_];
+        while (buffer_id >= 0)
+        {
+            TimerEntry& entry = entries_[buffer_id];
+            int next_id = entry.next;
+            if (entry.expiry_ms <= now_ms)
+            {
+                FrameTimerExpiry expiry = {buffer_id, entry.frame_number};
+                expired.push_back(expiry);
+                unlink(buffer_id);
+                num_expired++;
+            }
+            buffer_id = next_id;
+        }
+    }
+
+    return num_expired;
+}
+
+//! Return the number of slots in the wheel.
+//!
+//! \return number of slots
+
+const size_t FrameTimerWheel::get_num_slots(void) const
+{
+    return slots_.size();
+}
+
+//! Return the number of timeouts currently scheduled.
+//!
+//! \return number of scheduled timeouts
+
+const size_t FrameTimerWheel::get_num_scheduled(void) const
+{
+    return num_scheduled_;
+}
+
+//! Remove a scheduled timeout from its slot list.
+//!
+//! \param buffer_id - ID of the buffer whose timeout is removed
+
+void FrameTimerWheel::unlink(int buffer_id)
+{
+    TimerEntry& entry = entries_[buffer_id];
+
+    if (entry.prev >= 0)
+    {
+        entries_[entry.prev].next = entry.next;
+    }
+    else
+    {
+        slots_[entry.expiry_ms & slot_mask_] = entry.next;
+    }
+    if (entry.next >= 0)
+    {
+        entries_[entry.next].prev = entry.prev;
+    }
+
+    entry.prev = -1;
+    entry.next = -1;
+    entry.active = false;
+    num_scheduled_--;
+}
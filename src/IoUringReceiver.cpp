@@ -0,0 +1,555 @@
+/*!
+ * IoUringReceiver.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "IoUringReceiver.h"
+
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+#endif
+
+using namespace FrameReceiver;
+
+#ifdef HAVE_IO_URING
+namespace
+{
+    // Buffer group ID of the provided buffer ring
+    const uint16_t recv_buffer_group = 0;
+
+    // Maximum number of entries in a provided buffer ring
+    const unsigned int max_buffer_ring_entries = 32768;
+
+    int io_uring_setup(unsigned int entries, struct io_uring_params* params)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int io_uring_enter(int ring_fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0));
+    }
+
+    int io_uring_register(int ring_fd, unsigned int opcode, void* arg, unsigned int nr_args)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+    }
+}
+#endif
+
+//! Constructor for IoUringReceiver class.
+//!
+//! This constructor creates an io_uring instance with an eventfd registered for completion
+//! notification, registers a ring of num_buffers provided receive buffers of buffer_size bytes
+//! and arms a multishot receive on each of the sockets. Each buffer holds the received message
+//! header and source address as well as the packet, so must be somewhat larger than the
+//! largest packet expected.
+//!
+//! \param logger - logger instance
+//! \param sockets - bound UDP sockets to receive on
+//! \param ports - receive port of each socket, passed to the handler
+//! \param num_buffers - number of provided receive buffers, must be a power of two
+//! \param buffer_size - size of each receive buffer in bytes
+
+IoUringReceiver::IoUringReceiver(LoggerPtr& logger, const std::vector<int>& sockets,
+        const std::vector<int>& ports, unsigned int num_buffers, size_t buffer_size) :
+    logger_(logger),
+    sockets_(sockets),
+    ports_(ports),
+    num_buffers_(num_buffers),
+    buffer_size_(buffer_size),
+    ring_fd_(-1),
+    event_fd_(-1),
+    sq_ring_(0),
+    sq_ring_size_(0),
+    cq_ring_(0),
+    cq_ring_size_(0),
+    sqes_(0),
+    sqes_size_(0),
+    sq_head_(0),
+    sq_tail_(0),
+    sq_array_(0),
+    sq_mask_(0),
+    sq_entries_(0),
+    sq_pending_(0),
+    cq_head_(0),
+    cq_tail_(0),
+    cq_mask_(0),
+    cqes_(0),
+    buf_ring_(0),
+    buf_ring_size_(0),
+    buf_ring_tail_(0),
+    buffers_(0),
+    packets_received_(0),
+    packets_truncated_(0),
+    buffer_stalls_(0)
+{
+#ifdef HAVE_IO_URING
+    if ((num_buffers_ == 0) || (num_buffers_ > max_buffer_ring_entries) || (num_buffers_ & (num_buffers_ - 1)))
+    {
+        std::stringstream ss;
+        ss << "Illegal io_uring receive buffer count of " << num_buffers_
+           << ", must be a power of two no greater than " << max_buffer_ring_entries;
+        throw IoUringReceiverException(ss.str());
+    }
+
+    if ((sockets_.size() == 0) || (sockets_.size() != ports_.size()))
+    {
+        throw IoUringReceiverException("Illegal io_uring receive socket configuration");
+    }
+
+    // Received messages are laid out in each buffer as a header, the source address, then the packet
+    size_t min_buffer_size = sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in) + 1;
+    if ((buffer_size_ < min_buffer_size) || (buffer_size_ > 0xFFFFFFFFUL))
+    {
+        std::stringstream ss;
+        ss << "Illegal io_uring receive buffer size of " << buffer_size_ << " bytes";
+        throw IoUringReceiverException(ss.str());
+    }
+
+    try {
+
+        unsigned int sq_entries = 8;
+        while (sq_entries < sockets_.size())
+        {
+            sq_entries <<= 1;
+        }
+
+        // Size the completion queue so that it can hold a completion for every receive buffer
+        // as well as the multishot terminations, avoiding completion queue overflow
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = num_buffers_ * 2;
+
+        ring_fd_ = io_uring_setup(sq_entries, &params);
+        if (ring_fd_ < 0)
+        {
+            std::stringstream ss;
+            ss << "io_uring receiver failed to create ring : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+
+        // Map the submission and completion queue rings and the submission queue entries
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+        if (single_mmap)
+        {
+            sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+            cq_ring_size_ = 0;
+        }
+
+        void* map_addr = mmap(0, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring_fd_, IORING_OFF_SQ_RING);
+        if (map_addr == MAP_FAILED)
+        {
+            sq_ring_size_ = 0;
+            std::stringstream ss;
+            ss << "io_uring receiver failed to map submission queue : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        sq_ring_ = reinterpret_cast<uint8_t*>(map_addr);
+
+        if (single_mmap)
+        {
+            cq_ring_ = sq_ring_;
+        }
+        else
+        {
+            map_addr = mmap(0, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd_, IORING_OFF_CQ_RING);
+            if (map_addr == MAP_FAILED)
+            {
+                cq_ring_size_ = 0;
+                std::stringstream ss;
+                ss << "io_uring receiver failed to map completion queue : " << strerror(errno);
+                throw IoUringReceiverException(ss.str());
+            }
+            cq_ring_ = reinterpret_cast<uint8_t*>(map_addr);
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        map_addr = mmap(0, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring_fd_, IORING_OFF_SQES);
+        if (map_addr == MAP_FAILED)
+        {
+            sqes_size_ = 0;
+            std::stringstream ss;
+            ss << "io_uring receiver failed to map submission queue entries : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        sqes_ = reinterpret_cast<struct io_uring_sqe*>(map_addr);
+
+        sq_head_    = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.head);
+        sq_tail_    = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.tail);
+        sq_array_   = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.array);
+        sq_mask_    = *reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        cq_head_    = reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.head);
+        cq_tail_    = reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.tail);
+        cq_mask_    = *reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.ring_mask);
+        cqes_       = reinterpret_cast<struct io_uring_cqe*>(cq_ring_ + params.cq_off.cqes);
+
+        // Register an eventfd to be signalled when completions are posted
+        event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd_ < 0)
+        {
+            std::stringstream ss;
+            ss << "io_uring receiver failed to create eventfd : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        if (io_uring_register(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0)
+        {
+            std::stringstream ss;
+            ss << "io_uring receiver failed to register eventfd : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+
+        // Allocate the receive buffers and the provided buffer ring describing them
+        map_addr = mmap(0, num_buffers_ * buffer_size_, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (map_addr == MAP_FAILED)
+        {
+            std::stringstream ss;
+            ss << "io_uring receiver failed to allocate " << num_buffers_ << " receive buffers of "
+               << buffer_size_ << " bytes : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        buffers_ = reinterpret_cast<uint8_t*>(map_addr);
+
+        buf_ring_size_ = num_buffers_ * sizeof(struct io_uring_buf);
+        map_addr = mmap(0, buf_ring_size_, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (map_addr == MAP_FAILED)
+        {
+            buf_ring_size_ = 0;
+            std::stringstream ss;
+            ss << "io_uring receiver failed to allocate provided buffer ring : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        buf_ring_ = reinterpret_cast<struct io_uring_buf_ring*>(map_addr);
+
+        struct io_uring_buf_reg buf_reg;
+        memset(&buf_reg, 0, sizeof(buf_reg));
+        buf_reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+        buf_reg.ring_entries = num_buffers_;
+        buf_reg.bgid = recv_buffer_group;
+        if (io_uring_register(ring_fd_, IORING_REGISTER_PBUF_RING, &buf_reg, 1) < 0)
+        {
+            std::stringstream ss;
+            ss << "io_uring receiver failed to register provided buffer ring : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+
+        for (unsigned int buffer_id = 0; buffer_id < num_buffers_; buffer_id++)
+        {
+            recycle_buffer(static_cast<uint16_t>(buffer_id));
+        }
+        __atomic_store_n(&buf_ring_->tail, buf_ring_tail_, __ATOMIC_RELEASE);
+
+        // Arm a multishot receive on each socket. Only the source address is requested in
+        // addition to the packet, the message header template being read by the kernel when
+        // each receive is armed
+        memset(&recv_msg_, 0, sizeof(recv_msg_));
+        recv_msg_.msg_namelen = sizeof(struct sockaddr_in);
+
+        for (unsigned int socket_idx = 0; socket_idx < sockets_.size(); socket_idx++)
+        {
+            arm_receive(socket_idx);
+        }
+        submit();
+    }
+    catch (IoUringReceiverException& e)
+    {
+        cleanup();
+        throw;
+    }
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Created io_uring receiver on " << sockets_.size() << " sockets with "
+            << num_buffers_ << " receive buffers of " << buffer_size_ << " bytes");
+#else
+    throw IoUringReceiverException("io_uring receive is not supported on this platform");
+#endif
+}
+
+//! Destructor for IoUringReceiver class.
+//!
+//! This destructor closes the ring, cancelling the outstanding receives, and releases the
+//! buffers. The sockets remain owned by the caller.
+
+IoUringReceiver::~IoUringReceiver()
+{
+    cleanup();
+}
+
+//! Determine if io_uring receive is supported.
+//!
+//! io_uring may be unavailable at run time even if supported at build time, e.g. when disabled
+//! by the io_uring_disabled sysctl or a seccomp policy.
+//!
+//! \return true if an io_uring instance can be created
+
+bool IoUringReceiver::is_supported(void)
+{
+#ifdef HAVE_IO_URING
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = io_uring_setup(1, &params);
+    if (ring_fd < 0)
+    {
+        return false;
+    }
+    close(ring_fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+//! Return the completion eventfd.
+//!
+//! The eventfd becomes readable when completions are posted, and so can be registered with
+//! an IpcReactor.
+//!
+//! \return eventfd file descriptor
+
+int IoUringReceiver::get_event_fd(void) const
+{
+    return event_fd_;
+}
+
+//! Process all posted completions.
+//!
+//! This method passes the payload of every packet received to the handler, returning each
+//! buffer to the provided buffer ring once handled. A multishot receive terminates if the
+//! kernel runs out of provided buffers, in which case it is re-armed once the buffers have
+//! been recycled; packets arriving meanwhile are queued in the socket receive buffer.
+//!
+//! \param handler - callback to pass UDP payloads to
+//! \return number of packets passed to the handler
+
+size_t IoUringReceiver::process_completions(const PacketRingHandler& handler)
+{
+    size_t packets_handled = 0;
+
+#ifdef HAVE_IO_URING
+    // Clear the eventfd before reading the completion queue so that no completion is missed
+    uint64_t event_count;
+    if (read(event_fd_, &event_count, sizeof(event_count)) < 0 && errno != EAGAIN)
+    {
+        LOG4CXX_WARN(logger_, "io_uring receiver failed to read eventfd : " << strerror(errno));
+    }
+
+    std::vector<bool> rearm(sockets_.size(), false);
+
+    unsigned int cq_head = *cq_head_;
+    unsigned int cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    while (cq_head != cq_tail)
+    {
+        struct io_uring_cqe* cqe = &cqes_[cq_head & cq_mask_];
+        unsigned int socket_idx = static_cast<unsigned int>(cqe->user_data);
+
+        if (cqe->res >= 0 && (cqe->flags & IORING_CQE_F_BUFFER))
+        {
+            uint16_t buffer_id = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+            uint8_t* buffer = buffers_ + (buffer_id * buffer_size_);
+
+            struct io_uring_recvmsg_out* msg_out = reinterpret_cast<struct io_uring_recvmsg_out*>(buffer);
+            size_t payload_offset = sizeof(struct io_uring_recvmsg_out) + recv_msg_.msg_namelen + recv_msg_.msg_controllen;
+            size_t payload_size = msg_out->payloadlen;
+            if ((msg_out->flags & MSG_TRUNC) || (payload_offset + payload_size > static_cast<size_t>(cqe->res)))
+            {
+                payload_size = static_cast<size_t>(cqe->res) > payload_offset ? cqe->res - payload_offset : 0;
+                packets_truncated_++;
+            }
+
+            struct sockaddr_in from_addr;
+            memset(&from_addr, 0, sizeof(from_addr));
+            memcpy(&from_addr, buffer + sizeof(struct io_uring_recvmsg_out),
+                    std::min(static_cast<size_t>(msg_out->namelen), sizeof(from_addr)));
+
+            handler(buffer + payload_offset, payload_size, ports_[socket_idx], &from_addr);
+            packets_handled++;
+
+            recycle_buffer(buffer_id);
+        }
+        else if (cqe->res == -ENOBUFS)
+        {
+            buffer_stalls_++;
+        }
+        else if (cqe->res < 0)
+        {
+            LOG4CXX_ERROR(logger_, "io_uring receive failed on port " << ports_[socket_idx]
+                    << " : " << strerror(-cqe->res));
+        }
+
+        // Re-arm receives that have terminated, unless they failed for a reason other than
+        // buffer exhaustion which would only fail again
+        if (!(cqe->flags & IORING_CQE_F_MORE) && ((cqe->res >= 0) || (cqe->res == -ENOBUFS)))
+        {
+            rearm[socket_idx] = true;
+        }
+
+        cq_head++;
+    }
+
+    // Return the recycled buffers to the kernel and release the completion queue entries
+    __atomic_store_n(&buf_ring_->tail, buf_ring_tail_, __ATOMIC_RELEASE);
+    __atomic_store_n(cq_head_, cq_head, __ATOMIC_RELEASE);
+
+    for (unsigned int socket_idx = 0; socket_idx < sockets_.size(); socket_idx++)
+    {
+        if (rearm[socket_idx])
+        {
+            LOG4CXX_DEBUG_LEVEL(2, logger_, "io_uring receiver re-arming receive on port " << ports_[socket_idx]);
+            arm_receive(socket_idx);
+        }
+    }
+    submit();
+#endif
+
+    packets_received_ += packets_handled;
+    return packets_handled;
+}
+
+//! Return the number of packets passed to the handler.
+//!
+//! \return number of packets received
+
+const uint64_t IoUringReceiver::get_packets_received(void) const
+{
+    return packets_received_;
+}
+
+//! Return the number of packets truncated because they did not fit in a receive buffer.
+//!
+//! \return number of packets truncated
+
+const uint64_t IoUringReceiver::get_packets_truncated(void) const
+{
+    return packets_truncated_;
+}
+
+//! Return the number of times a receive stalled because all receive buffers were in use.
+//!
+//! \return number of buffer stalls
+
+const uint64_t IoUringReceiver::get_buffer_stalls(void) const
+{
+    return buffer_stalls_;
+}
+
+void IoUringReceiver::arm_receive(unsigned int socket_idx)
+{
+#ifdef HAVE_IO_URING
+    unsigned int sq_tail = *sq_tail_;
+    if (sq_tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+    {
+        submit();
+    }
+
+    unsigned int sq_idx = sq_tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[sq_idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode    = IORING_OP_RECVMSG;
+    sqe->fd        = sockets_[socket_idx];
+    sqe->addr      = reinterpret_cast<uint64_t>(&recv_msg_);
+    sqe->len       = 1;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->buf_group = recv_buffer_group;
+    sqe->user_data = socket_idx;
+
+    sq_array_[sq_idx] = sq_idx;
+    __atomic_store_n(sq_tail_, sq_tail + 1, __ATOMIC_RELEASE);
+    sq_pending_++;
+#endif
+}
+
+void IoUringReceiver::submit(void)
+{
+#ifdef HAVE_IO_URING
+    while (sq_pending_ > 0)
+    {
+        int submitted = io_uring_enter(ring_fd_, sq_pending_, 0, 0);
+        if (submitted < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            {
+                continue;
+            }
+            std::stringstream ss;
+            ss << "io_uring receiver failed to submit receive : " << strerror(errno);
+            throw IoUringReceiverException(ss.str());
+        }
+        sq_pending_ -= std::min(static_cast<unsigned int>(submitted), sq_pending_);
+    }
+#endif
+}
+
+void IoUringReceiver::recycle_buffer(uint16_t buffer_id)
+{
+#ifdef HAVE_IO_URING
+    // The ring entries are addressed directly rather than through the bufs member, which is
+    // a flexible array that C++ compilers place after the empty structure preceding it
+    struct io_uring_buf* buf = reinterpret_cast<struct io_uring_buf*>(buf_ring_) + (buf_ring_tail_ & (num_buffers_ - 1));
+    buf->addr = reinterpret_cast<uint64_t>(buffers_ + (buffer_id * buffer_size_));
+    buf->len  = static_cast<uint32_t>(buffer_size_);
+    buf->bid  = buffer_id;
+    buf_ring_tail_++;
+#endif
+}
+
+void IoUringReceiver::cleanup(void)
+{
+#ifdef HAVE_IO_URING
+    if (ring_fd_ >= 0)
+    {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    if (event_fd_ >= 0)
+    {
+        close(event_fd_);
+        event_fd_ = -1;
+    }
+    if (buf_ring_)
+    {
+        munmap(buf_ring_, buf_ring_size_);
+        buf_ring_ = 0;
+    }
+    if (buffers_)
+    {
+        munmap(buffers_, num_buffers_ * buffer_size_);
+        buffers_ = 0;
+    }
+    if (sqes_)
+    {
+        munmap(sqes_, sqes_size_);
+        sqes_ = 0;
+    }
+    if (cq_ring_ && (cq_ring_ != sq_ring_))
+    {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = 0;
+    if (sq_ring_)
+    {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = 0;
+    }
+#endif
+}
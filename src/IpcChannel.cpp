@@ -26,6 +26,38 @@ IpcContext::IpcContext(int io_threads) :
     // std::cout << "IpcContext constructor" << std::endl;
 }
 
+IpcMessagePart::IpcMessagePart() :
+    more_(false)
+{
+}
+
+//! Return the data of the part, valid while the part holds the message.
+//!
+//! \return pointer to the data
+
+const void* IpcMessagePart::data(void) const
+{
+    return msg_.data();
+}
+
+//! Return the size of the part.
+//!
+//! \return size of the data in bytes
+
+size_t IpcMessagePart::size(void) const
+{
+    return msg_.size();
+}
+
+//! Indicate if further parts of the message follow this one.
+//!
+//! \return true if there are more parts to receive
+
+bool IpcMessagePart::more(void) const
+{
+    return more_;
+}
+
 IpcChannel::IpcChannel(int type) :
     context_(IpcContext::Instance()),
     socket_(context_.get(), type)
@@ -63,23 +95,50 @@ void IpcChannel::subscribe(const char* topic)
     socket_.setsockopt(ZMQ_SUBSCRIBE, topic, strlen(topic));
 }
 
-void IpcChannel::send(std::string& message_str)
+//! Send a string message, or a part of a multipart message.
+//!
+//! The string is copied into the message with its terminating null character.
+//!
+//! \param message_str - string to send
+//! \param more - further parts of the message follow
+
+void IpcChannel::send(std::string& message_str, bool more)
 {
     size_t msg_size = message_str.size() + 1;
     zmq::message_t msg(msg_size);
-    memcpy(msg.data(), message_str.data(), msg_size);
-    socket_.send(msg);
+    memcpy(msg.data(), message_str.c_str(), msg_size);
+    socket_.send(msg, more ? ZMQ_SNDMORE : 0);
 }
 
-void IpcChannel::send(const char* message)
+void IpcChannel::send(const char* message, bool more)
 {
     size_t msg_size = strlen(message) + 1;
     zmq::message_t msg(msg_size);
     memcpy(msg.data(), message, msg_size);
-    socket_.send(msg);
+    socket_.send(msg, more ? ZMQ_SNDMORE : 0);
 
 }
 
+//! Send a message part without copying the data.
+//!
+//! The memory remains owned by the caller until ZeroMQ has finished with it, when the free
+//! function is called with the data and hint, possibly from a ZeroMQ I/O thread. The data must
+//! not be modified or freed before then. Unlike strings, the data are sent exactly as given, so
+//! should be received with recv(IpcMessagePart&). A header can be sent ahead of the data as a
+//! string part with more set.
+//!
+//! \param data - data to send
+//! \param size - size of the data in bytes
+//! \param free_fn - function called to free the data once sent
+//! \param hint - hint passed to the free function
+//! \param more - further parts of the message follow
+
+void IpcChannel::send(void* data, size_t size, IpcFreeFunction* free_fn, void* hint, bool more)
+{
+    zmq::message_t msg(data, size, free_fn, hint);
+    socket_.send(msg, more ? ZMQ_SNDMORE : 0);
+}
+
 const std::string IpcChannel::recv(void)
 {
     std::size_t msg_size;
@@ -91,6 +150,31 @@ const std::string IpcChannel::recv(void)
     return std::string(reinterpret_cast<char*>(msg.data()), msg_size-1);
 }
 
+//! Receive a message part without copying the data.
+//!
+//! The data remain owned by the part, which indicates if further parts of the message follow.
+//!
+//! \param part - part to receive into, releasing any message it held
+
+void IpcChannel::recv(IpcMessagePart& part)
+{
+    socket_.recv(&part.msg_);
+    part.more_ = part.msg_.more();
+}
+
+//! Indicate if further parts of the last message received follow.
+//!
+//! \return true if there are more parts to receive
+
+bool IpcChannel::recv_more(void)
+{
+    int more = 0;
+    size_t more_size = sizeof(more);
+    socket_.getsockopt(ZMQ_RCVMORE, &more, &more_size);
+
+    return more;
+}
+
 bool IpcChannel::poll(long timeout_ms)
 {
     zmq::pollitem_t pollitems[] = {{socket_, 0, ZMQ_POLLIN, 0}};
@@ -7,6 +7,10 @@
 
 #include "IpcMessage.h"
 
+#include <new>
+#include <stdio.h>
+#include <string.h>
+
 
 namespace FrameReceiver {
 
@@ -23,17 +27,13 @@ namespace FrameReceiver {
 
     IpcMessage::IpcMessage(MsgType msg_type, MsgVal msg_val, bool strict_validation) :
         strict_validation_(strict_validation),
-        msg_type_(msg_type),
-        msg_val_(msg_val),
-        msg_timestamp_(boost::posix_time::microsec_clock::local_time())
+        allocator_(allocator_buffer_, sizeof(allocator_buffer_)),
+        doc_(&allocator_),
+        msg_timestamp_deferred_(false),
+        encode_writer_(encode_buffer_)
     {
-        // Intialise empty JSON document
-        doc_.SetObject();
-
-        // Create the required params block
-        rapidjson::Value params;
-        params.SetObject();
-        doc_.AddMember("params", params, doc_.GetAllocator());
+        // Intialise empty JSON document with the required params block
+        reset(msg_type, msg_val);
     };
 
     //! Constructor taking JSON-formatted text message as argument.
@@ -46,56 +46,17 @@ namespace FrameReceiver {
     //! \param json_msg          - JSON-formatted string containing the message to parse
     //! \param strict_validation - Enforces strict validation of the message contents during subsequent
     //!                            setter calls (default: True)
+    //! \param defer_timestamp   - Defers parsing and validation of the timestamp until it is first
+    //!                            accessed (default: False)
 
-    IpcMessage::IpcMessage(const char* json_msg, bool strict_validation) :
-        strict_validation_(strict_validation)
+    IpcMessage::IpcMessage(const char* json_msg, bool strict_validation, bool defer_timestamp) :
+        strict_validation_(strict_validation),
+        allocator_(allocator_buffer_, sizeof(allocator_buffer_)),
+        doc_(&allocator_),
+        msg_timestamp_deferred_(false),
+        encode_writer_(encode_buffer_)
     {
-
-        // Parse the message, catching any unexpected exceptions from rapidjson
-        try {
-            doc_.Parse(json_msg);
-        }
-        catch (...)
-        {
-            throw FrameReceiver::IpcMessageException("Unknown exception caught during parsing message");
-        }
-
-        // Test if the message parsed correctly, otherwise throw an exception
-        if (doc_.HasParseError())
-        {
-            std::stringstream ss;
-            ss << "JSON parse error creating message from string at offset " << doc_.GetErrorOffset() ;
-            ss << " : " << rapidjson::GetParseError_En(doc_.GetParseError());
-            throw FrameReceiver::IpcMessageException(ss.str());
-        }
-
-        // Extract required valid attributes from message. If strict validation is enabled, throw an
-        // exception if any are illegal
-        msg_type_ = valid_msg_type(get_attribute<std::string>("msg_type", "none"));
-        if (strict_validation_ && (msg_type_ == MsgTypeIllegal))
-        {
-            throw FrameReceiver::IpcMessageException("Illegal or missing msg_type attribute in message");
-        }
-
-        msg_val_  = valid_msg_val(get_attribute<std::string>("msg_val", "none"));
-        if (strict_validation_ && (msg_val_ == MsgValIllegal))
-        {
-            throw FrameReceiver::IpcMessageException("Illegal or missing msg_val attribute in message");
-        }
-
-        msg_timestamp_ = valid_msg_timestamp(get_attribute<std::string>("timestamp", "none"));
-        if (strict_validation_ && (msg_timestamp_ == boost::posix_time::not_a_date_time))
-        {
-            throw FrameReceiver::IpcMessageException("Illegal or missing timestamp attribute in message");
-        }
-
-        // Check if a params block is present. If strict validation is enabled, thrown an exception if
-        // absent.
-        if (strict_validation && !has_params())
-        {
-            throw FrameReceiver::IpcMessageException("Missing params block in message");
-        }
-
+        parse_message(json_msg, defer_timestamp);
     }
 
     //! Constructor taking rapidJSON value as argument.
@@ -114,9 +75,13 @@ namespace FrameReceiver {
                            MsgVal msg_val,
                            bool strict_validation) :
       strict_validation_(strict_validation),
+      allocator_(allocator_buffer_, sizeof(allocator_buffer_)),
+      doc_(&allocator_),
       msg_type_(msg_type),
       msg_val_(msg_val),
-      msg_timestamp_(boost::posix_time::microsec_clock::local_time())
+      msg_timestamp_(current_timestamp()),
+      msg_timestamp_deferred_(false),
+      encode_writer_(encode_buffer_)
     {
       // Intialise empty JSON document
       doc_.SetObject();
@@ -166,9 +131,21 @@ namespace FrameReceiver {
 
     bool IpcMessage::is_valid(void)
     {
+        // A deferred timestamp is resolved here, which throws under strict validation if it is
+        // illegal, so that the message is simply reported as invalid
+        bool timestamp_valid = false;
+        try
+        {
+            timestamp_valid = (resolve_msg_timestamp() != boost::posix_time::not_a_date_time);
+        }
+        catch (FrameReceiver::IpcMessageException& e)
+        {
+            timestamp_valid = false;
+        }
+
         return ((msg_type_ != MsgTypeIllegal) &
                 (msg_val_ != MsgValIllegal) &
-                (msg_timestamp_ != boost::posix_time::not_a_date_time) &
+                timestamp_valid &
                 has_params());
     }
 
@@ -204,7 +181,9 @@ namespace FrameReceiver {
 
     const std::string IpcMessage::get_msg_timestamp(void) const
     {
-        return boost::posix_time::to_iso_extended_string(msg_timestamp_);
+        char timestamp_text[timestamp_buffer_size];
+        size_t timestamp_len = format_msg_timestamp(resolve_msg_timestamp(), timestamp_text);
+        return std::string(timestamp_text, timestamp_len);
     }
 
     //! Returns message timstamp as tm structure.
@@ -214,7 +193,7 @@ namespace FrameReceiver {
     //! \return tm struct containing the message timestamp
     const struct tm IpcMessage::get_msg_datetime(void) const
     {
-        return boost::posix_time::to_tm(msg_timestamp_);
+        return boost::posix_time::to_tm(resolve_msg_timestamp());
     }
 
 
@@ -248,7 +227,9 @@ namespace FrameReceiver {
     //! Returns a JSON-encoded string of the message.
     //!
     //! This method returns a JSON-encoded string version of the message, intended for
-    //! transmission across an IPC message channel.
+    //! transmission across an IPC message channel. The encoding buffer and writer are
+    //! reused by successive calls. If parsing of the timestamp of a decoded message was
+    //! deferred and has not happened yet, the timestamp is encoded as it was received.
     //!
     //! \return JSON encoded message as a null-terminated, string character array
 
@@ -258,20 +239,112 @@ namespace FrameReceiver {
         // Copy the validated attributes into the JSON document ready for encoding
         set_attribute("msg_type", valid_msg_type(msg_type_));
         set_attribute("msg_val", valid_msg_val(msg_val_));
-        set_attribute("timestamp", valid_msg_timestamp(msg_timestamp_));
+        if (!msg_timestamp_deferred_)
+        {
+            char timestamp_text[timestamp_buffer_size];
+            format_msg_timestamp(msg_timestamp_, timestamp_text);
+            const char* timestamp_value = timestamp_text;
+            set_attribute("timestamp", timestamp_value);
+        }
 
         // Clear the encoded output buffer otherwise successive encode() calls append
         // the message to the buffer
         encode_buffer_.Clear();
 
-        // Create a writer and associate with the document
-        rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<> > writer(encode_buffer_);
-        doc_.Accept(writer);
+        // Reset the writer onto the buffer and encode the document
+        encode_writer_.Reset(encode_buffer_);
+        doc_.Accept(encode_writer_);
 
         // Return the encoded buffer string
         return encode_buffer_.GetString();
     }
 
+    //! Resets the message to an empty message of the given type and value.
+    //!
+    //! This method allows a message object to be reused to send successive messages at a high
+    //! rate. The parameters are removed, all memory used by the document is returned to its
+    //! allocator and the message is timestamped afresh, while the allocator buffer, the encoding
+    //! buffer and the writer are kept for the next message.
+    //!
+    //! \param msg_type - MsgType enumerated message type (default: MsgTypeIllegal)
+    //! \param msg_val  - MsgVal enumerated message value (default: MsgValIllegal)
+
+    void IpcMessage::reset(MsgType msg_type, MsgVal msg_val)
+    {
+        clear_document();
+
+        msg_type_ = msg_type;
+        msg_val_ = msg_val;
+        msg_timestamp_ = current_timestamp();
+        msg_timestamp_deferred_ = false;
+
+        // Intialise empty JSON document
+        doc_.SetObject();
+
+        // Create the required params block
+        rapidjson::Value params;
+        params.SetObject();
+        doc_.AddMember("params", params, doc_.GetAllocator());
+    }
+
+    //! Decodes a JSON-formatted string into the message.
+    //!
+    //! This method allows a message object to be reused to receive successive messages at a
+    //! high rate, replacing the current contents with those parsed from the string. The string is
+    //! copied into a buffer kept by the message and parsed in place, so that string attributes
+    //! and parameters refer to the buffer rather than being copied. Errors are handled as by the
+    //! constructor taking a JSON-formatted string, using the strict validation setting of the
+    //! message.
+    //!
+    //! \param json_msg        - JSON-formatted string containing the message to parse
+    //! \param defer_timestamp - Defers parsing and validation of the timestamp until it is first
+    //!                          accessed (default: False)
+
+    void IpcMessage::decode(const char* json_msg, bool defer_timestamp)
+    {
+        parse_message(json_msg, defer_timestamp);
+    }
+
+    //! Returns the current local time as used to timestamp new messages.
+    //!
+    //! This static method returns the current local time with microsecond resolution. The
+    //! offset of local time from UTC is cached for each quarter hour, which is the granularity
+    //! at which it can change, so that messages can be timestamped at a high rate without the
+    //! time zone conversion done by boost::posix_time::microsec_clock::local_time on every call.
+    //! The cache packs the quarter hour and offset into a single word so that it is shared
+    //! between threads without locking.
+    //!
+    //! \return boost::posix_time::ptime current local time
+
+    boost::posix_time::ptime IpcMessage::current_timestamp(void)
+    {
+        static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+        static int64_t utc_offset_cache = 0;
+        const time_t utc_offset_period = 15 * 60;
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+
+        int64_t period = now.tv_sec / utc_offset_period;
+        int64_t cached = __atomic_load_n(&utc_offset_cache, __ATOMIC_RELAXED);
+        int32_t utc_offset;
+        if ((cached >> 32) == period)
+        {
+            utc_offset = static_cast<int32_t>(cached & 0xFFFFFFFF);
+        }
+        else
+        {
+            struct tm local_tm;
+            time_t now_secs = now.tv_sec;
+            localtime_r(&now_secs, &local_tm);
+            utc_offset = static_cast<int32_t>(local_tm.tm_gmtoff);
+            __atomic_store_n(&utc_offset_cache, (period << 32) | static_cast<uint32_t>(utc_offset), __ATOMIC_RELAXED);
+        }
+
+        return epoch + boost::posix_time::seconds(static_cast<long>(now.tv_sec + utc_offset)) +
+                boost::posix_time::microseconds(now.tv_nsec / 1000);
+    }
+
     //! Overloaded equality relational operator.
     //!
     //! This function overloads the equality relational operator, allowing two
@@ -289,7 +362,7 @@ namespace FrameReceiver {
         // Test equality of message attributes
         areEqual &= (lhs_msg.msg_type_ == rhs_msg.msg_type_);
         areEqual &= (lhs_msg.msg_val_  == rhs_msg.msg_val_);
-        areEqual &= (lhs_msg.msg_timestamp_ == rhs_msg.msg_timestamp_);
+        areEqual &= (lhs_msg.resolve_msg_timestamp() == rhs_msg.resolve_msg_timestamp());
 
         // Check both messages have a params block
         areEqual &= (lhs_msg.has_params() == rhs_msg.has_params());
@@ -488,11 +561,93 @@ namespace FrameReceiver {
 
     boost::posix_time::ptime IpcMessage::valid_msg_timestamp(std::string msg_timestamp_text)
     {
+        return parse_msg_timestamp(msg_timestamp_text.c_str());
+    }
+
+    //! Maps an internal message timestamp representation to an ISO8601 extended format string.
+    //!
+    //! This private method maps the internal boost::posix_time::ptime timestamp representation
+    //! to an ISO8601 extended format string, as used in the encoded JSON message.
+    //!
+    //! \param msg_timestamp - internal boost::posix_time::ptime timestamp representation
+    //! return ISO8601 extended format timestamp string
+
+    std::string IpcMessage::valid_msg_timestamp(boost::posix_time::ptime msg_timestamp)
+    {
+        // Return message timestamp as string in ISO8601 extended format
+        char timestamp_text[timestamp_buffer_size];
+        size_t timestamp_len = format_msg_timestamp(msg_timestamp, timestamp_text);
+        return std::string(timestamp_text, timestamp_len);
+    }
+
+    //! Parses a message timestamp string.
+    //!
+    //! This private static method parses an ISO8601 extended format timestamp string. Timestamps
+    //! in the format produced by encode() are parsed directly from the characters, falling back
+    //! to boost::date_time::parse_delimited_time for any other format. If the string is not
+    //! valid, boost::posix::not_a_date_time is returned.
+    //!
+    //! \param msg_timestamp_text - message timestamp string in ISO8601 extended format
+    //! \return boost::posix::ptime internal timestamp representation
+
+    boost::posix_time::ptime IpcMessage::parse_msg_timestamp(const char* msg_timestamp_text)
+    {
+        static const char format[] = "dddd-dd-ddTdd:dd:dd";
+        const char* c = msg_timestamp_text;
+
+        // Check the date and time fields have the expected digits and delimiters
+        bool fast_format = true;
+        for (const char* f = format; fast_format && *f; f++, c++)
+        {
+            fast_format = (*f == 'd') ? ((*c >= '0') && (*c <= '9')) : (*c == *f);
+        }
+
+        if (fast_format)
+        {
+            const char* t = msg_timestamp_text;
+            int year    = (t[0] - '0') * 1000 + (t[1] - '0') * 100 + (t[2] - '0') * 10 + (t[3] - '0');
+            int month   = (t[5] - '0') * 10 + (t[6] - '0');
+            int day     = (t[8] - '0') * 10 + (t[9] - '0');
+            int hours   = (t[11] - '0') * 10 + (t[12] - '0');
+            int minutes = (t[14] - '0') * 10 + (t[15] - '0');
+            int seconds = (t[17] - '0') * 10 + (t[18] - '0');
+
+            // Parse the optional fractional seconds, scaling them to the time resolution
+            int64_t fraction = 0;
+            int fraction_digits = 0;
+            if (*c == '.')
+            {
+                for (c++; (*c >= '0') && (*c <= '9'); c++, fraction_digits++)
+                {
+                    fraction = (fraction * 10) + (*c - '0');
+                }
+                fast_format = (fraction_digits > 0);
+            }
+            fast_format = fast_format && (*c == '\0') &&
+                    (fraction_digits <= boost::posix_time::time_duration::num_fractional_digits()) &&
+                    (hours < 24) && (minutes < 60) && (seconds < 60);
+
+            if (fast_format)
+            {
+                for (; fraction_digits < boost::posix_time::time_duration::num_fractional_digits(); fraction_digits++)
+                {
+                    fraction *= 10;
+                }
+                try {
+                    return boost::posix_time::ptime(boost::gregorian::date(year, month, day),
+                            boost::posix_time::time_duration(hours, minutes, seconds, fraction));
+                }
+                catch (...)
+                {
+                    return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
+                }
+            }
+        }
 
         boost::posix_time::ptime pt(boost::posix_time::not_a_date_time);
 
         try {
-            pt = boost::date_time::parse_delimited_time<boost::posix_time::ptime>(msg_timestamp_text, 'T');
+            pt = boost::date_time::parse_delimited_time<boost::posix_time::ptime>(std::string(msg_timestamp_text), 'T');
         }
         catch (...)
         {
@@ -501,18 +656,144 @@ namespace FrameReceiver {
         return pt;
     }
 
-    //! Maps an internal message timestamp representation to an ISO8601 extended format string.
+    //! Formats a message timestamp as an ISO8601 extended format string.
     //!
-    //! This private method maps the internal boost::posix_time::ptime timestamp representation
-    //! to an ISO8601 extended format string, as used in the encoded JSON message.
+    //! This private static method formats a timestamp into a buffer of at least timestamp_buffer_size
+    //! characters, giving the same string as boost::posix_time::to_iso_extended_string without
+    //! building it through a stream.
     //!
     //! \param msg_timestamp - internal boost::posix_time::ptime timestamp representation
-    //! return ISO8601 extended format timestamp string
+    //! \param buffer        - buffer to format the null-terminated string into
+    //! \return length of the formatted string
 
-    std::string IpcMessage::valid_msg_timestamp(boost::posix_time::ptime msg_timestamp)
+    size_t IpcMessage::format_msg_timestamp(boost::posix_time::ptime const& msg_timestamp, char* buffer)
     {
-        // Return message timestamp as string in ISO8601 extended format
-        return boost::posix_time::to_iso_extended_string(msg_timestamp_);
+        int len;
+        if (msg_timestamp.is_special())
+        {
+            len = snprintf(buffer, timestamp_buffer_size, "%s",
+                    boost::posix_time::to_iso_extended_string(msg_timestamp).c_str());
+        }
+        else
+        {
+            boost::gregorian::date::ymd_type ymd = msg_timestamp.date().year_month_day();
+            boost::posix_time::time_duration time_of_day = msg_timestamp.time_of_day();
+            len = snprintf(buffer, timestamp_buffer_size, "%04d-%02d-%02dT%02d:%02d:%02d",
+                    static_cast<int>(ymd.year), static_cast<int>(ymd.month), static_cast<int>(ymd.day),
+                    static_cast<int>(time_of_day.hours()), static_cast<int>(time_of_day.minutes()),
+                    static_cast<int>(time_of_day.seconds()));
+            if (time_of_day.fractional_seconds() != 0)
+            {
+                len += snprintf(buffer + len, timestamp_buffer_size - len, ".%0*ld",
+                        static_cast<int>(boost::posix_time::time_duration::num_fractional_digits()),
+                        static_cast<long>(time_of_day.fractional_seconds()));
+            }
+        }
+        return std::min(static_cast<size_t>(len), timestamp_buffer_size - 1);
+    }
+
+    //! Returns the message timestamp, parsing it first if parsing was deferred.
+    //!
+    //! This private method parses the timestamp attribute of a decoded message the first time
+    //! the timestamp is needed when parsing was deferred. If strict validation is enabled, an
+    //! IpcMessageException is thrown if the timestamp is missing or illegal.
+    //!
+    //! \return reference to the internal timestamp representation
+
+    const boost::posix_time::ptime& IpcMessage::resolve_msg_timestamp(void) const
+    {
+        if (msg_timestamp_deferred_)
+        {
+            msg_timestamp_deferred_ = false;
+
+            rapidjson::Value::ConstMemberIterator itr = doc_.FindMember("timestamp");
+            msg_timestamp_ = (itr == doc_.MemberEnd()) ?
+                    boost::posix_time::ptime(boost::posix_time::not_a_date_time) :
+                    parse_msg_timestamp(itr->value.GetString());
+
+            if (strict_validation_ && (msg_timestamp_ == boost::posix_time::not_a_date_time))
+            {
+                throw FrameReceiver::IpcMessageException("Illegal or missing timestamp attribute in message");
+            }
+        }
+        return msg_timestamp_;
+    }
+
+    //! Parses a JSON-formatted string in place into the message document.
+    //!
+    //! This private method copies a JSON-formatted string into the parse buffer of the message
+    //! and parses it in place, extracting and validating the required attributes. If the string
+    //! is not valid JSON syntax, or strict validation is enabled and any attributes are illegal,
+    //! an IpcMessageException is thrown.
+    //!
+    //! \param json_msg        - JSON-formatted string containing the message to parse
+    //! \param defer_timestamp - Defers parsing and validation of the timestamp until it is first accessed
+
+    void IpcMessage::parse_message(const char* json_msg, bool defer_timestamp)
+    {
+        clear_document();
+
+        // Copy the message into the parse buffer, which keeps its capacity between messages
+        parse_buffer_.assign(json_msg, json_msg + strlen(json_msg) + 1);
+
+        // Parse the message, catching any unexpected exceptions from rapidjson
+        try {
+            doc_.ParseInsitu(&parse_buffer_[0]);
+        }
+        catch (...)
+        {
+            throw FrameReceiver::IpcMessageException("Unknown exception caught during parsing message");
+        }
+
+        // Test if the message parsed correctly, otherwise throw an exception
+        if (doc_.HasParseError())
+        {
+            std::stringstream ss;
+            ss << "JSON parse error creating message from string at offset " << doc_.GetErrorOffset() ;
+            ss << " : " << rapidjson::GetParseError_En(doc_.GetParseError());
+            throw FrameReceiver::IpcMessageException(ss.str());
+        }
+
+        // Extract required valid attributes from message. If strict validation is enabled, throw an
+        // exception if any are illegal
+        msg_type_ = valid_msg_type(get_attribute<std::string>("msg_type", "none"));
+        if (strict_validation_ && (msg_type_ == MsgTypeIllegal))
+        {
+            throw FrameReceiver::IpcMessageException("Illegal or missing msg_type attribute in message");
+        }
+
+        msg_val_  = valid_msg_val(get_attribute<std::string>("msg_val", "none"));
+        if (strict_validation_ && (msg_val_ == MsgValIllegal))
+        {
+            throw FrameReceiver::IpcMessageException("Illegal or missing msg_val attribute in message");
+        }
+
+        // Parse the timestamp now unless deferred until it is first accessed
+        msg_timestamp_deferred_ = true;
+        if (!defer_timestamp)
+        {
+            resolve_msg_timestamp();
+        }
+
+        // Check if a params block is present. If strict validation is enabled, thrown an exception if
+        // absent.
+        if (strict_validation_ && !has_params())
+        {
+            throw FrameReceiver::IpcMessageException("Missing params block in message");
+        }
+    }
+
+    //! Empties the message document and returns all its memory to the document allocator.
+    //!
+    //! The memory pool allocator only releases memory when cleared, and this version of RapidJSON
+    //! does not make the buffer supplied to it reusable when cleared, so the allocator is
+    //! reconstructed in place on the buffer. The document keeps its pointer to the allocator.
+
+    void IpcMessage::clear_document(void)
+    {
+        doc_.SetNull();
+        allocator_.~MemoryPoolAllocator();
+        new (&allocator_) rapidjson::MemoryPoolAllocator<>(allocator_buffer_, sizeof(allocator_buffer_));
     }
 
     //! Indicates if the message has a params block.
@@ -675,6 +956,19 @@ namespace FrameReceiver {
         value_obj.SetString(value.c_str(), doc_.GetAllocator());
     }
 
+    //! Sets the value of a message attribute.
+    //!
+    //! This explicit specialisation of the private template method sets the value of a
+    //! message attribute referenced by the RapidJSON value object passed as an argument.
+    //!
+    //! \param value_obj - RapidJSON value object to set value of
+    //! \param value - null-terminated string value to set
+
+    template<> void IpcMessage::set_value(rapidjson::Value& value_obj, const char* const& value)
+    {
+        value_obj.SetString(value, doc_.GetAllocator());
+    }
+
     //! Sets the value of a message attribute.
     //!
     //! This explicit specialisation of the private template method sets the value of a
@@ -8,6 +8,12 @@
 #include "IpcReactor.h"
 #include "gettime.h"
 
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
 using namespace FrameReceiver;
 
 //! Constructor - instantiates an IpcReactorTimer object
@@ -17,16 +23,16 @@ using namespace FrameReceiver;
 //! being performed by the IpcReactor event loop. The timer runs periodiocally, either
 //! forever or for a fixed number of times.
 //!
-//! \param delay_ms Timer delay in milliseconds for
+//! \param delay_us Timer delay in microseconds
 //! \param times    Number of times the timer should fire, a value of 0 indicates forever
 //! \param callback Callback function signature to be called when the timer fires
 
-IpcReactorTimer::IpcReactorTimer(size_t delay_ms, size_t times, TimerCallback callback) :
+IpcReactorTimer::IpcReactorTimer(TimeUs delay_us, size_t times, TimerCallback callback) :
         timer_id_(last_timer_id_++),
-        delay_ms_(delay_ms),
+        delay_us_(delay_us),
         times_(times),
         callback_(callback),
-        when_(clock_mono_ms() + delay_ms),
+        when_(clock_mono_us() + delay_us),
         expired_(false)
 {
 }
@@ -68,7 +74,7 @@ void IpcReactorTimer::do_callback(void)
     }
     else
     {
-        when_ += delay_ms_;
+        when_ += delay_us_;
     }
 }
 
@@ -81,7 +87,19 @@ void IpcReactorTimer::do_callback(void)
 
 bool IpcReactorTimer::has_fired(void)
 {
-    return (clock_mono_ms() >= when_);
+    return has_fired(clock_mono_us());
+}
+
+//! Indicates if the timer has fired at the specified time
+//!
+//! This allows a caller handling several timers to read the clock only once.
+//!
+//! \param now_us current monotonic time in microseconds
+//! \return boolean value, true if timer has fired
+
+bool IpcReactorTimer::has_fired(TimeUs now_us)
+{
+    return (now_us >= when_);
 }
 
 //! Indicates if the timer has expired, i.e. reached its maximum times fired
@@ -99,11 +117,11 @@ bool IpcReactorTimer::has_expired(void)
 //! Indicates when (in absolute monotonic time) the timer is due to fire
 //!
 //! this method indicates when a timer is next due to fire, in absolute
-//! monotonic time in milliseconds
+//! monotonic time in microseconds
 //!
-//! \return TimeMs value indicating when the timer is next due to fire
+//! \return TimeUs value indicating when the timer is next due to fire
 
-TimeMs IpcReactorTimer::when(void)
+TimeUs IpcReactorTimer::when(void)
 {
     return when_;
 }
@@ -124,30 +142,146 @@ TimeMs IpcReactorTimer::clock_mono_ms(void)
     return (TimeMs)((TimeMs) ts.tv_sec * 1000 + (TimeMs) ts.tv_nsec / 1000000);
 }
 
+//! Returns the current monotonic clock time in microseconds (static method)
+//!
+//! \return TimeUs value of the current monotonic time in microseconds
+
+TimeUs IpcReactorTimer::clock_mono_us(void)
+{
+    struct timespec ts;
+    gettime(&ts, true);
+
+    return (TimeUs)((TimeUs) ts.tv_sec * 1000000 + (TimeUs) ts.tv_nsec / 1000);
+}
+
 // Initialise static class variable holding last unique timer ID assigned
 int IpcReactorTimer::last_timer_id_ = 0;
 
 //! Constructor
 //!
-//! This constructs an IpcReactor object ready for use
+//! This constructs an IpcReactor object ready for use, waiting for events with the specified
+//! backend. With the epoll backend a timerfd, armed for the next timer due to fire, is added to
+//! the epoll instance. An eventfd, or a non-blocking pipe on platforms without one, is created to
+//! wake the reactor for posted callbacks. An IpcReactorException is thrown if the backend is not
+//! supported on this platform or any of these descriptors cannot be created.
+//!
+//! \param backend backend used to wait for events
 
-IpcReactor::IpcReactor() :
+IpcReactor::IpcReactor(Defaults::ReactorBackend backend) :
     terminate_reactor_(false),
     pollitems_(0),
     callbacks_(0),
     pollsize_(0),
-    needs_rebuild_(true)
+    needs_rebuild_(true),
+    backend_(backend),
+    epoll_fd_(-1),
+    channels_pending_(false),
+    recheck_channels_(false),
+    timer_fd_(-1),
+    timer_fd_when_(0),
+    post_head_(new PostedTask),
+    post_tail_(post_head_),
+    post_fd_(-1),
+    post_wake_fd_(-1),
+    post_wake_pending_(false)
 {
+    post_head_->next = 0;
+
+#ifdef __linux__
+    post_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    post_wake_fd_ = post_fd_;
+#else
+    int pipe_fds[2];
+    if (pipe(pipe_fds) == 0)
+    {
+        fcntl(pipe_fds[0], F_SETFL, fcntl(pipe_fds[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(pipe_fds[1], F_SETFL, fcntl(pipe_fds[1], F_GETFL, 0) | O_NONBLOCK);
+        post_fd_ = pipe_fds[0];
+        post_wake_fd_ = pipe_fds[1];
+    }
+#endif
+    if (post_fd_ < 0)
+    {
+        std::stringstream ss;
+        ss << "IpcReactor failed to create posted task wake-up descriptor: " << strerror(errno);
+        delete post_head_;
+        throw IpcReactorException(ss.str());
+    }
+
+    if (backend_ == Defaults::ReactorBackendEpoll)
+    {
+#ifdef __linux__
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0)
+        {
+            std::stringstream ss;
+            ss << "IpcReactor failed to create epoll instance: " << strerror(errno);
+            close(post_fd_);
+            delete post_head_;
+            throw IpcReactorException(ss.str());
+        }
+
+        timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timer_fd_ < 0)
+        {
+            std::stringstream ss;
+            ss << "IpcReactor failed to create timerfd: " << strerror(errno);
+            close(epoll_fd_);
+            close(post_fd_);
+            delete post_head_;
+            throw IpcReactorException(ss.str());
+        }
+        epoll_add(timer_fd_, false);
+        epoll_add(post_fd_, false);
+#else
+        close(post_fd_);
+        close(post_wake_fd_);
+        delete post_head_;
+        throw IpcReactorException("IpcReactor epoll backend is not supported on this platform");
+#endif
+    }
+    else if (backend_ != Defaults::ReactorBackendPoll)
+    {
+        close(post_fd_);
+        if (post_wake_fd_ != post_fd_)
+        {
+            close(post_wake_fd_);
+        }
+        delete post_head_;
+        throw IpcReactorException("IpcReactor illegal backend specified");
+    }
 }
 
 //! Destructor
 //!
-//! This destroys an IpcReactor object
+//! This destroys an IpcReactor object. Any posted callbacks that have not been called are
+//! discarded.
 
 IpcReactor::~IpcReactor()
 {
     delete[] pollitems_;
     delete[] callbacks_;
+
+    while (post_tail_)
+    {
+        PostedTask* next = post_tail_->next;
+        delete post_tail_;
+        post_tail_ = next;
+    }
+    if (post_wake_fd_ != post_fd_)
+    {
+        close(post_wake_fd_);
+    }
+    close(post_fd_);
+
+    if (timer_fd_ >= 0)
+    {
+        close(timer_fd_);
+    }
+    if (epoll_fd_ >= 0)
+    {
+        close(epoll_fd_);
+    }
 }
 
 //! Adds an IPC channel and associated callback to the reactor
@@ -163,6 +297,16 @@ void IpcReactor::register_channel(IpcChannel& channel, ReactorCallback callback)
     // Add channel to channel map
     channels_[&(channel.socket_)] = callback;
 
+    // Add the channel notification file descriptor to the epoll instance, if used
+    if (epoll_fd_ >= 0)
+    {
+        int channel_fd = -1;
+        size_t fd_size = sizeof(channel_fd);
+        channel.socket_.getsockopt(ZMQ_FD, &channel_fd, &fd_size);
+        epoll_add(channel_fd, true);
+        channel_fds_[&(channel.socket_)] = channel_fd;
+    }
+
     // Signal a rebuild is required
     needs_rebuild_ = true;
 }
@@ -179,20 +323,48 @@ void IpcReactor::remove_channel(IpcChannel& channel)
     // Erase the channel from the map
     channels_.erase(&(channel.socket_));
 
+    // Remove the channel notification file descriptor from the epoll instance, if used
+    ChannelFdMap::iterator fd_itr = channel_fds_.find(&(channel.socket_));
+    if (fd_itr != channel_fds_.end())
+    {
+        epoll_remove(fd_itr->second);
+        channel_fds_.erase(fd_itr);
+    }
+
     // Signal a rebuild is required
     needs_rebuild_ = true;
 }
 
+//! Adds a raw socket, or other file descriptor, and associated callback to the reactor
+//!
+//! The callback is called whenever the descriptor is readable. With the epoll backend the
+//! descriptor is level-triggered, so a handler need not drain it completely on each call.
+//!
+//! \param socket_fd file descriptor to add to the reactor
+//! \param callback function reference to callback method
+
 void IpcReactor::register_socket(int socket_fd, ReactorCallback callback)
 {
 	sockets_[socket_fd] = callback;
 
+	if (epoll_fd_ >= 0)
+	{
+	    epoll_add(socket_fd, false);
+	}
+
 	needs_rebuild_ = true;
 }
 
+//! Removes a raw socket from the reactor
+//!
+//! \param socket_fd file descriptor to remove from the reactor
+
 void IpcReactor::remove_socket(int socket_fd)
 {
-	sockets_.erase(socket_fd);
+	if (sockets_.erase(socket_fd) && (epoll_fd_ >= 0))
+	{
+	    epoll_remove(socket_fd);
+	}
 
 	needs_rebuild_ = true;
 }
@@ -209,26 +381,75 @@ void IpcReactor::remove_socket(int socket_fd)
 //! \return integer unique timer ID, which can be used by the caller to delete it subsequently
 
 int IpcReactor::register_timer(size_t delay_ms, size_t times, TimerCallback callback)
+{
+    return register_timer_us(delay_ms * 1000, times, callback);
+}
+
+//! Adds a timer with a delay in microseconds to the reactor
+//!
+//! This method adds a timer to the reactor as register_timer() does, with the periodic delay
+//! specified in microseconds.
+//!
+//! \param delay_us periodic timer delay in microseconds
+//! \param times number of times the timer should fire (0=indefinite)
+//! \param callback function reference to callback method
+//! \return integer unique timer ID, which can be used by the caller to delete it subsequently
+
+int IpcReactor::register_timer_us(size_t delay_us, size_t times, TimerCallback callback)
 {
 
     // Create a smart pointer to a new timer object
-    boost::shared_ptr<IpcReactorTimer> timer(new IpcReactorTimer(delay_ms, times, callback));
+    boost::shared_ptr<IpcReactorTimer> timer(new IpcReactorTimer(delay_us, times, callback));
 
-    // Add the timer to the timer map
+    // Add the timer to the timer map and push when it is due onto the timer heap
     timers_[timer->get_id()] = timer;
 
+    TimerHeapEntry entry = {timer->when(), timer->get_id()};
+    timer_heap_.push_back(entry);
+    std::push_heap(timer_heap_.begin(), timer_heap_.end());
+
     // Return the unique ID
     return timer->get_id();
 }
 
 //! Removes a timer from the reactor
 //!
-//! This method removes a timer from the reactor, based on the timer ID
+//! This method removes a timer from the reactor, based on the timer ID. The entry of the
+//! timer in the timer heap is discarded when it reaches the top of the heap, or when the heap
+//! is compacted once entries of removed timers outnumber those of the timers remaining.
 //
 //! \param timer_id integer unique timer ID that was returned by the add_timer() method
 void IpcReactor::remove_timer(int timer_id)
 {
     timers_.erase(timer_id);
+
+    if ((timer_heap_.size() - std::min(timer_heap_.size(), timers_.size())) > timers_.size())
+    {
+        compact_timer_heap();
+    }
+}
+
+//! Posts a callback to be called from the reactor loop, from any thread
+//!
+//! This method allows other threads to hand work to the thread running the reactor, without
+//! serialising it into a message on a channel. The callback is appended to a lock-free queue
+//! and the reactor is woken, if it has not already been, to call it on its next iteration.
+//! Callbacks are called in the order posted by each thread. Note that posting does not keep
+//! run() looping if no channels, sockets or timers remain registered.
+//!
+//! \param callback function reference to callback method
+
+void IpcReactor::post(ReactorCallback callback)
+{
+    PostedTask* task = new PostedTask;
+    task->callback = callback;
+    task->next = 0;
+
+    // Append the task by exchanging the head of the queue and then linking the previous head to it
+    PostedTask* prev = __atomic_exchange_n(&post_head_, task, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, task, __ATOMIC_RELEASE);
+
+    wake_posted();
 }
 
 //! Runs the reactor polling loop
@@ -261,75 +482,457 @@ int IpcReactor::run(void)
             break;
         }
 
-        try
+        // Run an iteration of the loop, using the tickless timeout based on the next pending timer
+        rc = run_iteration(calculate_timeout());
+    }
+
+    return rc;
+}
+
+//! Runs a single iteration of the reactor polling loop
+//!
+//! This method polls the registered channels and sockets once with the specified timeout,
+//! handling any callbacks to those ready and to timers that have fired. This allows the
+//! reactor to be serviced from a caller's own event loop, e.g. a busy-polling receive loop
+//! calling it with a zero timeout.
+//!
+//! \param timeout_ms poll timeout in milliseconds, 0 = return immediately, -1 = wait indefinitely
+//! \return integer return code, 0 = OK, -1 = error
+
+int IpcReactor::run_once(long timeout_ms)
+{
+    // The caller may have used any channel since the last iteration
+    recheck_channels_ = true;
+    return run_iteration(timeout_ms);
+}
+
+//! Runs a single iteration of the reactor polling loop, called from the loop itself
+//!
+//! \param timeout_ms poll timeout in milliseconds, 0 = return immediately, -1 = wait indefinitely
+//! \return integer return code, 0 = OK, -1 = error
+
+int IpcReactor::run_iteration(long timeout_ms)
+{
+    int rc = 0;
+
+    // If the poll items list needs rebuilding, do it now
+    if (needs_rebuild_)
+    {
+        rebuild_pollitems();
+    }
+
+    try
+    {
+        // Wait for and handle any channels and sockets ready to read with the selected backend
+        if (epoll_fd_ >= 0)
+        {
+            rc = dispatch_epoll(timeout_ms);
+        }
+        else
         {
+            rc = dispatch_poll(timeout_ms);
+        }
 
-            // Poll the registered channels, using the tickless timeout based
-            // on the next pending timer
-            int pollrc = zmq::poll(pollitems_, pollsize_, calculate_timeout());
+        // Handle any timers that have now fired
+        dispatch_timers();
+    }
+    catch ( zmq::error_t& e)
+    {
+        // If the exception was thrown with errno EINTR, i.e. interrupted system call, this is
+        // because we have installed a custom signal handler, so terminate the reactor gracefully
+        if (e.num() == EINTR) {
+            rc = -1;
+            terminate_reactor_ = true;
+        }
+        // Otherwise propogate the exception upwards
+        else {
+            std::stringstream ss;
+            ss << "IpcReactor error while polling: " << e.what();
+            throw IpcReactorException(ss.str());
+        }
+    }
 
-            if (pollrc > 0)
-            {
-                // If there were any channels ready to read, execute their callbacks
-                for (size_t item = 0; item < pollsize_; ++item)
-                {
-                    // TODO handle error flag on pollitems
-                    if (pollitems_[item].revents & ZMQ_POLLIN)
-                    {
-                        callbacks_[item]();
-                    }
-                }
-            }
-            else if (pollrc == 0)
-            {
-                // Poll timed out, do nothing as we handle timers firing unconditionally below
-            }
-            else
-            {
-                // An error occurred, terminate the reactor loop
-                rc = -1;
-                terminate_reactor_ = true;
-            }
+    return rc;
+}
+
+//! Polls the channels and sockets with zmq::poll and calls the handlers of those ready
+//!
+//! \param timeout_ms poll timeout in milliseconds, 0 = return immediately
+//! \return integer return code, 0 = OK, -1 = error
+
+int IpcReactor::dispatch_poll(long timeout_ms)
+{
+    int rc = 0;
+
+    // Poll the registered channels, and the posted task wake-up descriptor following them, with the
+    // specified timeout
+    int pollrc = zmq::poll(pollitems_, pollsize_ + 1, timeout_ms);
 
-            // Handle any timers that have now fired, calling their callbacks. Erase any timers
-            // that have now expired
-            TimerMap::iterator it = timers_.begin();
-            while (it != timers_.end())
+    if (pollrc > 0)
+    {
+        // If there were any channels ready to read, execute their callbacks
+        for (size_t item = 0; item <= pollsize_; ++item)
+        {
+            // TODO handle error flag on pollitems
+            if (pollitems_[item].revents & ZMQ_POLLIN)
             {
-                if ((it->second)->has_fired())
-                {
-                    (it->second)->do_callback();
-                }
-                if ((it->second)->has_expired())
-                {
-                   timers_.erase(it++);
-                }
-                else
-                {
-                	++it;
-                }
+                callbacks_[item]();
             }
         }
-        catch ( zmq::error_t& e)
+    }
+    else if (pollrc == 0)
+    {
+        // Poll timed out, do nothing as timers are handled unconditionally by the caller
+    }
+    else
+    {
+        // An error occurred, terminate the reactor loop
+        rc = -1;
+        terminate_reactor_ = true;
+    }
+
+    return rc;
+}
+
+//! Waits for events with epoll and calls the handlers of the channels and sockets ready
+//!
+//! The timerfd is first armed for the next timer due to fire, so that the wait returns when it
+//! fires even if the timeout is longer. Sockets are dispatched as their events are returned; the
+//! timerfd is simply read to clear it, as timers are dispatched by the caller. A channel is dispatched if its
+//! notification descriptor has signalled, or it still had messages when last checked, and ZMQ_EVENTS
+//! shows a message is ready. As the notification descriptors are edge-triggered, and may be reset
+//! by sending on or receiving from a channel, the channels that were marked or dispatched on the
+//! last iteration are checked for remaining messages before waiting again; the wait does not block
+//! if any remain. Handlers of channels are taken to use only their own channel, so other channels
+//! are only checked after a socket handler, timer or posted task, which may use any channel.
+//!
+//! \param timeout_ms wait timeout in milliseconds, 0 = return immediately
+//! \return integer return code, 0 = OK, -1 = error
+
+int IpcReactor::dispatch_epoll(long timeout_ms)
+{
+    int rc = 0;
+
+#ifdef __linux__
+    // Check the channels marked or dispatched on the last iteration, or every channel if other callbacks
+    // have been called since, for messages remaining
+    channels_pending_ = false;
+    for (size_t item = 0; item < item_channels_.size(); item++)
+    {
+        if (recheck_channels_ || channel_pending_[item])
+        {
+            channel_pending_[item] = channel_has_message(item_channels_[item]);
+            channels_pending_ |= channel_pending_[item];
+        }
+    }
+    recheck_channels_ = false;
+
+    if (channels_pending_)
+    {
+        timeout_ms = 0;
+    }
+    arm_timer_fd();
+
+    int num_events = epoll_wait(epoll_fd_, &epoll_events_[0], epoll_events_.size(), timeout_ms);
+    if (num_events < 0)
+    {
+        // An interrupted wait, due to a custom signal handler, terminates the reactor gracefully
+        if (errno == EINTR)
         {
-            // If the exception was thrown with errno EINTR, i.e. interrupted system call, this is
-            // because we have installed a custom signal handler, so terminate the reactor gracefully
-            if (e.num() == EINTR) {
-                rc = -1;
-                terminate_reactor_ = true;
-            }
-            // Otherwise propogate the exception upwards
-            else {
-                std::stringstream ss;
-                ss << "IpcReactor error while polling: " << e.what();
-                throw IpcReactorException(ss.str());
-            }
+            rc = -1;
+            terminate_reactor_ = true;
+            return rc;
         }
+        std::stringstream ss;
+        ss << "IpcReactor error while polling: " << strerror(errno);
+        throw IpcReactorException(ss.str());
     }
 
+    // Call the handlers of ready sockets and mark channels whose descriptor has signalled
+    for (int event = 0; event < num_events; event++)
+    {
+        int fd = epoll_events_[event].data.fd;
+        if (fd == post_fd_)
+        {
+            dispatch_posted();
+            recheck_channels_ = true;
+            continue;
+        }
+        if (fd == timer_fd_)
+        {
+            // Read the timerfd to clear it, leaving it to be re-armed for the next timer
+            uint64_t expirations;
+            ssize_t bytes = read(timer_fd_, &expirations, sizeof(expirations));
+            (void)bytes;
+            timer_fd_when_ = 0;
+            continue;
+        }
+        if ((fd < 0) || (static_cast<size_t>(fd) >= fd_items_.size()) || (fd_items_[fd] < 0))
+        {
+            continue;
+        }
+
+        size_t item = fd_items_[fd];
+        if (item < item_channels_.size())
+        {
+            channel_pending_[item] = true;
+        }
+        else
+        {
+            callbacks_[item]();
+            recheck_channels_ = true;
+        }
+    }
+
+    // Call the handlers of marked channels with a message ready, skipping any channel removed
+    // by a handler during this iteration
+    for (size_t item = 0; item < item_channels_.size(); item++)
+    {
+        if (channel_pending_[item] && (!needs_rebuild_ || channels_.count(item_channels_[item])) &&
+                channel_has_message(item_channels_[item]))
+        {
+            callbacks_[item]();
+        }
+    }
+#endif
+
     return rc;
 }
 
+//! Calls the handlers of timers that have fired, removing those that have expired
+//!
+//! The clock is read once and every timer due by then is popped from the timer heap before any
+//! handler is called, so each timer fires at most once per iteration, even if it is overdue by
+//! several periods or has a zero delay. Timers that have not expired are pushed back onto the
+//! heap at the time they are next due. A handler may remove any timer, including its own.
+
+void IpcReactor::dispatch_timers(void)
+{
+    TimeUs now_us = IpcReactorTimer::clock_mono_us();
+    TimeUs when_us;
+
+    fired_timers_.clear();
+    while (next_timer_due(when_us) && (when_us <= now_us))
+    {
+        fired_timers_.push_back(timer_heap_.front());
+        std::pop_heap(timer_heap_.begin(), timer_heap_.end());
+        timer_heap_.pop_back();
+    }
+
+    for (std::vector<TimerHeapEntry>::iterator fired = fired_timers_.begin(); fired != fired_timers_.end(); ++fired)
+    {
+        TimerMap::iterator it = timers_.find(fired->timer_id);
+        if (it == timers_.end())
+        {
+            continue;
+        }
+
+        // Hold a reference to the timer, which a handler may remove from the map
+        boost::shared_ptr<IpcReactorTimer> timer = it->second;
+        timer->do_callback();
+        recheck_channels_ = true;
+
+        it = timers_.find(fired->timer_id);
+        if (it == timers_.end())
+        {
+            continue;
+        }
+        if (timer->has_expired())
+        {
+            timers_.erase(it);
+        }
+        else
+        {
+            TimerHeapEntry entry = {timer->when(), timer->get_id()};
+            timer_heap_.push_back(entry);
+            std::push_heap(timer_heap_.begin(), timer_heap_.end());
+        }
+    }
+}
+
+//! Calls the callbacks posted to the reactor
+//!
+//! The wake-up descriptor is cleared and the pending flag reset before the queue is drained, so
+//! that a task posted during draining either is seen here or wakes the reactor again. Only the
+//! tasks posted before draining started are called, so that a callback posting another task
+//! cannot starve the rest of the reactor; the reactor is woken again for any that remain.
+
+void IpcReactor::dispatch_posted(void)
+{
+    uint64_t wake_count;
+    ssize_t bytes = read(post_fd_, &wake_count, sizeof(wake_count));
+    (void)bytes;
+    __atomic_store_n(&post_wake_pending_, false, __ATOMIC_SEQ_CST);
+
+    PostedTask* last = __atomic_load_n(&post_head_, __ATOMIC_ACQUIRE);
+    while (post_tail_ != last)
+    {
+        // A task being posted may have been exchanged as the head but not yet linked, in which case
+        // its poster will wake the reactor again
+        PostedTask* next = __atomic_load_n(&post_tail_->next, __ATOMIC_ACQUIRE);
+        if (!next)
+        {
+            break;
+        }
+
+        // The called task becomes the new tail of the queue, so the old one can be freed before
+        // calling it, leaving the queue consistent if the callback throws
+        delete post_tail_;
+        post_tail_ = next;
+
+        ReactorCallback callback;
+        callback.swap(next->callback);
+        callback();
+    }
+
+    if (post_tail_ != __atomic_load_n(&post_head_, __ATOMIC_ACQUIRE))
+    {
+        wake_posted();
+    }
+}
+
+//! Wakes the reactor to call posted callbacks, unless a wake-up is already pending
+
+void IpcReactor::wake_posted(void)
+{
+    if (!__atomic_exchange_n(&post_wake_pending_, true, __ATOMIC_SEQ_CST))
+    {
+        uint64_t wake_count = 1;
+        ssize_t bytes = write(post_wake_fd_, &wake_count, sizeof(wake_count));
+        (void)bytes;
+    }
+}
+
+//! Returns when the next timer is due to fire, discarding heap entries of removed timers
+//!
+//! \param when_us set to the monotonic time in microseconds the next timer is due to fire
+//! \return boolean value, true if there is a timer active
+
+bool IpcReactor::next_timer_due(TimeUs& when_us)
+{
+    while (!timer_heap_.empty())
+    {
+        const TimerHeapEntry& next = timer_heap_.front();
+        TimerMap::iterator it = timers_.find(next.timer_id);
+        if ((it != timers_.end()) && ((it->second)->when() == next.when_us))
+        {
+            when_us = next.when_us;
+            return true;
+        }
+        std::pop_heap(timer_heap_.begin(), timer_heap_.end());
+        timer_heap_.pop_back();
+    }
+    return false;
+}
+
+//! Discards the heap entries of removed timers and rebuilds the heap from those remaining
+//!
+//! Entries are only otherwise discarded as they reach the top of the heap, so this bounds the
+//! heap when timers are removed long before they are due.
+
+void IpcReactor::compact_timer_heap(void)
+{
+    std::vector<TimerHeapEntry>::iterator live_end = timer_heap_.begin();
+    for (std::vector<TimerHeapEntry>::iterator entry = timer_heap_.begin(); entry != timer_heap_.end(); ++entry)
+    {
+        TimerMap::iterator it = timers_.find(entry->timer_id);
+        if ((it != timers_.end()) && ((it->second)->when() == entry->when_us))
+        {
+            *live_end++ = *entry;
+        }
+    }
+    timer_heap_.erase(live_end, timer_heap_.end());
+    std::make_heap(timer_heap_.begin(), timer_heap_.end());
+}
+
+//! Arms the timerfd of the epoll backend for the next timer due to fire
+//!
+//! The timerfd is armed with the absolute monotonic time the timer is due, which fires
+//! immediately if that has passed, and is disarmed if there are no timers. It is only
+//! updated when the next time due changes.
+
+void IpcReactor::arm_timer_fd(void)
+{
+#ifdef __linux__
+    if (timer_fd_ < 0)
+    {
+        return;
+    }
+
+    TimeUs when_us = 0;
+    next_timer_due(when_us);
+    if (when_us == timer_fd_when_)
+    {
+        return;
+    }
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = when_us / 1000000;
+    spec.it_value.tv_nsec = (when_us % 1000000) * 1000;
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, 0) < 0)
+    {
+        std::stringstream ss;
+        ss << "IpcReactor failed to arm timerfd: " << strerror(errno);
+        throw IpcReactorException(ss.str());
+    }
+    timer_fd_when_ = when_us;
+#endif
+}
+
+//! Adds a file descriptor to the epoll instance, or updates it if already present
+//!
+//! \param fd file descriptor
+//! \param edge_triggered report readiness on edges rather than while the descriptor is readable
+
+void IpcReactor::epoll_add(int fd, bool edge_triggered)
+{
+#ifdef __linux__
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | (edge_triggered ? EPOLLET : 0);
+    event.data.fd = fd;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        if ((errno != EEXIST) || (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) < 0))
+        {
+            std::stringstream ss;
+            ss << "IpcReactor failed to add file descriptor " << fd << " to epoll instance: " << strerror(errno);
+            throw IpcReactorException(ss.str());
+        }
+    }
+#endif
+}
+
+//! Removes a file descriptor from the epoll instance
+//!
+//! Errors are ignored, since the descriptor may already have been closed, which removes it.
+//!
+//! \param fd file descriptor
+
+void IpcReactor::epoll_remove(int fd)
+{
+#ifdef __linux__
+    struct epoll_event event;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+#endif
+}
+
+//! Indicates if a channel socket has a message to receive
+//!
+//! \param socket channel socket
+//! \return boolean value, true if a message can be received without blocking
+
+bool IpcReactor::channel_has_message(SocketPtr socket)
+{
+    int events = 0;
+    size_t events_size = sizeof(events);
+    socket->getsockopt(ZMQ_EVENTS, &events, &events_size);
+
+    return (events & ZMQ_POLLIN);
+}
+
 //! Signals that the reactor polling loop should stop gracefully
 //!
 //! This method is used to signal that the reactor polling loop should stop gracefully.
@@ -339,6 +942,27 @@ void IpcReactor::stop(void)
     terminate_reactor_ = true;
 }
 
+//! Indicates if the reactor has been signalled to stop
+//!
+//! This method indicates if the reactor has been signalled to stop, either by a call to
+//! stop() or due to an error while polling.
+//!
+//! \return boolean value, true if the reactor has been signalled to stop
+
+bool IpcReactor::is_stopped(void) const
+{
+    return terminate_reactor_;
+}
+
+//! Returns the backend used to wait for events
+//!
+//! \return backend of the reactor
+
+Defaults::ReactorBackend IpcReactor::get_backend(void) const
+{
+    return backend_;
+}
+
 //! Rebuilds the internal list of polling item
 //!
 //! This private method rebuilds the internal list of items to poll in the reactor
@@ -363,65 +987,117 @@ void IpcReactor::rebuild_pollitems(void)
     // Set the number of items to poll to the number of channels registered
     pollsize_ = channels_.size() + sockets_.size();
 
-    // If the numer of items to poll is non-zero, craete new pollitems and callback
-    // arrays and populate them
+    // Create new pollitems and callback arrays and populate them, with a final item for the
+    // posted task wake-up descriptor
+    pollitems_ = new zmq::pollitem_t[pollsize_ + 1];
+    callbacks_ = new ReactorCallback[pollsize_ + 1];
 
-    if (pollsize_) {
+    // Iterate over the channel map and build the pollitems and callback arrays. These have
+    // a one-to-one correspondence, allowing the reactor loop to easy associate an active
+    // channel socket with the appropriate callback
+    unsigned int item = 0;
+    for (ChannelMap::iterator it = channels_.begin(); it != channels_.end(); ++item, ++it)
+    {
+        zmq::pollitem_t pollitem = {*(it->first), 0, ZMQ_POLLIN, 0};
+        pollitems_[item] = pollitem;
+        callbacks_[item] = it->second;
+    }
 
-        pollitems_ = new zmq::pollitem_t[pollsize_];
-        callbacks_ = new ReactorCallback[pollsize_];
+    for (SocketMap::iterator it = sockets_.begin(); it != sockets_.end(); ++item, ++it)
+    {
+        zmq::pollitem_t pollitem = {0, it->first, ZMQ_POLLIN, 0};
+        pollitems_[item] = pollitem;
+        callbacks_[item] = it->second;
+    }
 
-        // Iterate over the channel map and build the pollitems and callback arrays. These have
-        // a one-to-one correspondence, allowing the reactor loop to easy associate an active
-        // channel socket with the appropriate callback
-        unsigned int item = 0;
-        for (ChannelMap::iterator it = channels_.begin(); it != channels_.end(); ++item, ++it)
+    zmq::pollitem_t post_pollitem = {0, post_fd_, ZMQ_POLLIN, 0};
+    pollitems_[item] = post_pollitem;
+    callbacks_[item] = boost::bind(&IpcReactor::dispatch_posted, this);
+
+    // With the epoll backend, build the map from each registered file descriptor to its item, and
+    // the channel of each channel item, so that events can be matched to callbacks without a search
+    if (epoll_fd_ >= 0)
+    {
+        item_channels_.clear();
+        fd_items_.clear();
+        for (ChannelMap::iterator it = channels_.begin(); it != channels_.end(); ++it)
         {
-            zmq::pollitem_t pollitem = {*(it->first), 0, ZMQ_POLLIN, 0};
-            pollitems_[item] = pollitem;
-            callbacks_[item] = it->second;
+            set_fd_item(channel_fds_[it->first], item_channels_.size());
+            item_channels_.push_back(it->first);
         }
-
+        item = item_channels_.size();
         for (SocketMap::iterator it = sockets_.begin(); it != sockets_.end(); ++item, ++it)
         {
-        	zmq::pollitem_t pollitem = {0, it->first, ZMQ_POLLIN, 0};
-            pollitems_[item] = pollitem;
-            callbacks_[item] = it->second;
+            set_fd_item(it->first, item);
         }
+
+        // Channels are checked for messages on the first iteration after a rebuild
+        channel_pending_.assign(item_channels_.size(), true);
+        channels_pending_ = !item_channels_.empty();
+#ifdef __linux__
+        // Allow for the timerfd and posted task wake-up descriptor as well as the items
+        epoll_events_.resize(pollsize_ + 2);
+#endif
     }
+
+    needs_rebuild_ = false;
+}
+
+//! Maps a file descriptor to its item in the callback array for the epoll backend
+//!
+//! \param fd file descriptor
+//! \param item index of the item
+
+void IpcReactor::set_fd_item(int fd, size_t item)
+{
+    if (fd < 0)
+    {
+        return;
+    }
+    if (static_cast<size_t>(fd) >= fd_items_.size())
+    {
+        fd_items_.resize(fd + 1, -1);
+    }
+    fd_items_[fd] = static_cast<int>(item);
 }
 
 //! Calculates the next poll timeout based on the tickless pattern
 //!
 //! This private method calculates the next reactor poll timeout based on the
 //! 'tickless' idiom in the CZMQ zloop implementation. The timeout is set
-//! to match the next timer due to fire.
+//! to match the next timer due to fire, up to one hour. With the epoll backend
+//! the timerfd wakes the reactor when a timer fires, so the full hour is used.
 //!
 //! \return long timeout value in milliseconds
 
 long IpcReactor::calculate_timeout(void)
 {
+    const long max_timeout = 1000 * 3600;
 
-    // Calculate shortest timeout up to one hour (!!), looping through
-    // current timers to see which fires first
-    TimeMs tickless = IpcReactorTimer::clock_mono_ms() + (1000 * 3600);
-    for (TimerMap::iterator it = timers_.begin(); it != timers_.end(); ++it)
+    TimeUs when_us;
+    if ((timer_fd_ >= 0) || !next_timer_due(when_us))
     {
-        if (tickless > (it->second)->when())
-        {
-            tickless = (it->second)->when();
-        }
+        return max_timeout;
     }
 
-    // Calculate current timeout based on that, set to zero (don't wait) if
-    // there is no timers pending
-    long timeout = (long)(tickless - IpcReactorTimer::clock_mono_ms());
-    if (timeout < 0)
+    return std::min(timeout_until(when_us, IpcReactorTimer::clock_mono_us()), max_timeout);
+}
+
+//! Converts the time until a timer is due into a poll timeout, rounded up to milliseconds
+//!
+//! The timeout is rounded up so that the reactor does not wake before the timer has fired.
+//!
+//! \param when_us monotonic time in microseconds the timer is due to fire
+//! \param now_us current monotonic time in microseconds
+//! \return long timeout value in milliseconds, zero if the timer is already due
+
+long IpcReactor::timeout_until(TimeUs when_us, TimeUs now_us)
+{
+    if (when_us <= now_us)
     {
-        timeout = 0;
+        return 0;
     }
-
-    return timeout;
+    return (long)((when_us - now_us + 999) / 1000);
 }
 
 
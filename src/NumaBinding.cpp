@@ -0,0 +1,207 @@
+/*!
+ * NumaBinding.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "NumaBinding.h"
+#include "FrameReceiverException.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+using namespace FrameReceiver;
+
+namespace
+{
+    // Maximum NUMA node number that can be specified
+    const int max_numa_node = 1023;
+
+    const size_t bits_per_mask_word = 8 * sizeof(unsigned long);
+}
+
+//! Bind a memory region to NUMA nodes.
+//!
+//! The region is bound to, or interleaved across, the specified nodes. Any pages of the region
+//! already touched by this process are moved to conform to the policy, so this should be called
+//! as soon as the region is mapped, before it is filled. The region is extended to whole pages.
+//!
+//! \param addr - start address of the region
+//! \param length - length of the region in bytes
+//! \param policy - memory policy to apply, the default policy leaves the region unchanged
+//! \param nodes - nodes to bind or interleave the region across
+
+void NumaBinding::bind_memory(void* addr, size_t length, Defaults::NumaPolicy policy,
+        const std::vector<int>& nodes)
+{
+    if (policy == Defaults::NumaPolicyDefault)
+    {
+        return;
+    }
+
+    if ((policy == Defaults::NumaPolicyIllegal) || nodes.empty())
+    {
+        throw FrameReceiverException("NUMA memory binding requires a legal policy and at least one node");
+    }
+
+#ifdef __linux__
+    std::vector<unsigned long> node_mask;
+    build_node_mask(nodes, node_mask);
+
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t offset = reinterpret_cast<size_t>(addr) & (page_size - 1);
+    char* page_addr = reinterpret_cast<char*>(addr) - offset;
+    length += offset;
+
+    int mode = (policy == Defaults::NumaPolicyInterleave) ? MPOL_INTERLEAVE : MPOL_BIND;
+    if (syscall(SYS_mbind, page_addr, length, mode, &node_mask[0], node_mask.size() * bits_per_mask_word + 1,
+            MPOL_MF_MOVE) != 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to apply NUMA policy to memory region of " << length << " bytes: " << strerror(errno);
+        throw FrameReceiverException(ss.str());
+    }
+#else
+    throw FrameReceiverException("NUMA memory binding is not supported on this platform");
+#endif
+}
+
+//! Bind the calling thread to a NUMA node.
+//!
+//! Memory subsequently allocated by the thread prefers the node, falling back to other nodes
+//! only if it is exhausted. The thread is also restricted to the CPUs of the node unless it is
+//! to be pinned to a particular CPU separately.
+//!
+//! \param node - NUMA node to bind to
+//! \param set_affinity - restrict the thread to the CPUs of the node
+
+void NumaBinding::bind_thread(int node, bool set_affinity)
+{
+#ifdef __linux__
+    std::vector<int> cpus;
+    get_node_cpus(node, cpus);
+
+    std::vector<unsigned long> node_mask;
+    build_node_mask(std::vector<int>(1, node), node_mask);
+
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask[0], node_mask.size() * bits_per_mask_word + 1) != 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to set thread memory policy to prefer NUMA node " << node << ": " << strerror(errno);
+        throw FrameReceiverException(ss.str());
+    }
+
+    if (set_affinity)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (std::vector<int>::iterator cpu_itr = cpus.begin(); cpu_itr != cpus.end(); cpu_itr++)
+        {
+            CPU_SET(*cpu_itr, &cpu_set);
+        }
+
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (rc != 0)
+        {
+            std::stringstream ss;
+            ss << "Failed to bind thread to the CPUs of NUMA node " << node << ": " << strerror(rc);
+            throw FrameReceiverException(ss.str());
+        }
+    }
+#else
+    throw FrameReceiverException("NUMA thread binding is not supported on this platform");
+#endif
+}
+
+//! Get the CPUs of a NUMA node.
+//!
+//! \param node - NUMA node
+//! \param cpus - vector to fill with the CPU numbers of the node
+
+void NumaBinding::get_node_cpus(int node, std::vector<int>& cpus)
+{
+    if ((node < 0) || (node > max_numa_node))
+    {
+        std::stringstream ss;
+        ss << "Illegal NUMA node specified: " << node;
+        throw FrameReceiverException(ss.str());
+    }
+
+    std::stringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream cpulist_file(path.str().c_str());
+    std::string cpu_list_str;
+    if (!std::getline(cpulist_file, cpu_list_str))
+    {
+        std::stringstream ss;
+        ss << "NUMA node " << node << " does not exist";
+        throw FrameReceiverException(ss.str());
+    }
+
+    cpus.clear();
+    parse_cpu_list(cpu_list_str, cpus);
+    if (cpus.empty())
+    {
+        std::stringstream ss;
+        ss << "NUMA node " << node << " has no CPUs";
+        throw FrameReceiverException(ss.str());
+    }
+}
+
+//! Parse a kernel CPU list, e.g. "0-3,8,10-11", into CPU numbers.
+//!
+//! \param cpu_list_str - CPU list string
+//! \param cpus - vector to append the CPU numbers to
+
+void NumaBinding::parse_cpu_list(const std::string& cpu_list_str, std::vector<int>& cpus)
+{
+    std::stringstream list_stream(cpu_list_str);
+    std::string range;
+    while (std::getline(list_stream, range, ','))
+    {
+        if (range.find_first_of("0123456789") == std::string::npos)
+        {
+            continue;
+        }
+
+        char* range_end = 0;
+        int first = static_cast<int>(strtol(range.c_str(), &range_end, 10));
+        int last = (*range_end == '-') ? static_cast<int>(strtol(range_end + 1, NULL, 10)) : first;
+        for (int cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+}
+
+//! Build a node mask, as used by the memory policy system calls, from a list of nodes.
+//!
+//! \param nodes - list of nodes
+//! \param node_mask - vector to fill with the mask words
+
+void NumaBinding::build_node_mask(const std::vector<int>& nodes, std::vector<unsigned long>& node_mask)
+{
+    node_mask.assign((max_numa_node / bits_per_mask_word) + 1, 0);
+    for (std::vector<int>::const_iterator node_itr = nodes.begin(); node_itr != nodes.end(); node_itr++)
+    {
+        if ((*node_itr < 0) || (*node_itr > max_numa_node))
+        {
+            std::stringstream ss;
+            ss << "Illegal NUMA node specified: " << *node_itr;
+            throw FrameReceiverException(ss.str());
+        }
+        node_mask[*node_itr / bits_per_mask_word] |= (1UL << (*node_itr % bits_per_mask_word));
+    }
+}
@@ -0,0 +1,389 @@
+/*!
+ * PacketRingReceiver.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "PacketRingReceiver.h"
+
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <net/if.h>
+#include <net/ethernet.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <linux/if_packet.h>
+#endif
+
+using namespace FrameReceiver;
+
+//! Constructor for PacketRingReceiver class.
+//!
+//! This constructor creates an AF_PACKET socket bound to the specified interface and maps a
+//! TPACKET_V3 receive ring of num_blocks blocks of block_size bytes. Blocks are handed to user
+//! space when full or after block_timeout_ms, whichever is sooner.
+//!
+//! \param logger - logger instance
+//! \param interface - name of network interface to capture on
+//! \param address - destination IP address to accept packets for, 0.0.0.0 accepts any
+//! \param ports - destination UDP ports to accept packets for
+//! \param block_size - size of each ring block in bytes, must be a multiple of the page size
+//! \param num_blocks - number of blocks in the ring
+//! \param block_timeout_ms - timeout in ms after which partially filled blocks are retired
+
+PacketRingReceiver::PacketRingReceiver(LoggerPtr& logger, const std::string& interface,
+        const std::string& address, const std::vector<uint16_t>& ports, size_t block_size,
+        unsigned int num_blocks, unsigned int block_timeout_ms) :
+    logger_(logger),
+    interface_(interface),
+    address_(inet_addr(address.c_str())),
+    ports_(ports),
+    socket_(-1),
+    ring_(0),
+    ring_size_(block_size * num_blocks),
+    block_size_(block_size),
+    num_blocks_(num_blocks),
+    current_block_(0),
+    packets_captured_(0),
+    packets_dropped_(0),
+    packets_received_(0),
+    packets_ignored_(0)
+{
+#ifdef __linux__
+    if (address_ == INADDR_NONE)
+    {
+        throw PacketRingReceiverException("Illegal packet ring receive address specified: " + address);
+    }
+
+    if ((num_blocks_ == 0) || (block_size_ == 0) || (block_size_ % getpagesize() != 0))
+    {
+        std::stringstream ss;
+        ss << "Illegal packet ring geometry of " << num_blocks_ << " blocks of " << block_size_
+           << " bytes, block size must be a multiple of the page size";
+        throw PacketRingReceiverException(ss.str());
+    }
+
+    unsigned int if_index = if_nametoindex(interface_.c_str());
+    if (if_index == 0)
+    {
+        std::stringstream ss;
+        ss << "Packet ring failed to find interface " << interface_ << " : " << strerror(errno);
+        throw PacketRingReceiverException(ss.str());
+    }
+
+    socket_ = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
+    if (socket_ < 0)
+    {
+        std::stringstream ss;
+        ss << "Packet ring failed to create capture socket : " << strerror(errno);
+        throw PacketRingReceiverException(ss.str());
+    }
+
+    try {
+
+        int version = TPACKET_V3;
+        if (setsockopt(socket_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+        {
+            std::stringstream ss;
+            ss << "Packet ring failed to select TPACKET_V3 : " << strerror(errno);
+            throw PacketRingReceiverException(ss.str());
+        }
+
+        // Request the block ring. Frame size is nominal for TPACKET_V3, where packets are packed
+        // into blocks at variable offsets, but must still divide the block size
+        struct tpacket_req3 ring_req;
+        memset(&ring_req, 0, sizeof(ring_req));
+        ring_req.tp_block_size = block_size_;
+        ring_req.tp_block_nr = num_blocks_;
+        ring_req.tp_frame_size = TPACKET_ALIGNMENT << 7;
+        ring_req.tp_frame_nr = (block_size_ / ring_req.tp_frame_size) * num_blocks_;
+        ring_req.tp_retire_blk_tov = block_timeout_ms;
+
+        if (setsockopt(socket_, SOL_PACKET, PACKET_RX_RING, &ring_req, sizeof(ring_req)) < 0)
+        {
+            std::stringstream ss;
+            ss << "Packet ring failed to create receive ring of " << num_blocks_ << " blocks of "
+               << block_size_ << " bytes : " << strerror(errno);
+            throw PacketRingReceiverException(ss.str());
+        }
+
+        void* ring_addr = mmap(0, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED, socket_, 0);
+        if (ring_addr == MAP_FAILED)
+        {
+            std::stringstream ss;
+            ss << "Packet ring failed to map receive ring : " << strerror(errno);
+            throw PacketRingReceiverException(ss.str());
+        }
+        ring_ = reinterpret_cast<uint8_t*>(ring_addr);
+
+        struct sockaddr_ll link_addr;
+        memset(&link_addr, 0, sizeof(link_addr));
+        link_addr.sll_family = AF_PACKET;
+        link_addr.sll_protocol = htons(ETH_P_IP);
+        link_addr.sll_ifindex = if_index;
+
+        if (bind(socket_, reinterpret_cast<struct sockaddr*>(&link_addr), sizeof(link_addr)) < 0)
+        {
+            std::stringstream ss;
+            ss << "Packet ring failed to bind to interface " << interface_ << " : " << strerror(errno);
+            throw PacketRingReceiverException(ss.str());
+        }
+    }
+    catch (PacketRingReceiverException& e)
+    {
+        if (ring_)
+        {
+            munmap(ring_, ring_size_);
+        }
+        close(socket_);
+        throw;
+    }
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Created packet ring on interface " << interface_ << " with "
+            << num_blocks_ << " blocks of " << block_size_ << " bytes");
+#else
+    throw PacketRingReceiverException("Packet ring capture is not supported on this platform");
+#endif
+}
+
+//! Destructor for PacketRingReceiver class.
+//!
+//! This destructor unmaps the receive ring and closes the capture socket.
+
+PacketRingReceiver::~PacketRingReceiver()
+{
+#ifdef __linux__
+    if (ring_)
+    {
+        munmap(ring_, ring_size_);
+    }
+    if (socket_ >= 0)
+    {
+        close(socket_);
+    }
+#endif
+}
+
+//! Join a packet fanout group.
+//!
+//! This allows several receivers capturing on the same interface, e.g. in different RX threads,
+//! to share the incoming packets between them rather than each seeing every packet. Packets are
+//! distributed by flow hash, so all packets of a flow are delivered to the same receiver.
+//!
+//! \param group_id - ID of the fanout group to join
+
+void PacketRingReceiver::join_fanout_group(uint16_t group_id)
+{
+#ifdef __linux__
+    int fanout_arg = group_id | (PACKET_FANOUT_HASH << 16);
+    if (setsockopt(socket_, SOL_PACKET, PACKET_FANOUT, &fanout_arg, sizeof(fanout_arg)) < 0)
+    {
+        std::stringstream ss;
+        ss << "Packet ring failed to join fanout group " << group_id << " : " << strerror(errno);
+        throw PacketRingReceiverException(ss.str());
+    }
+#endif
+}
+
+//! Return the capture socket file descriptor.
+//!
+//! The socket becomes readable when a ring block is ready for user space, and so can be
+//! registered with an IpcReactor.
+//!
+//! \return capture socket file descriptor
+
+int PacketRingReceiver::get_socket(void) const
+{
+    return socket_;
+}
+
+//! Process all ring blocks ready for user space.
+//!
+//! This method walks the ring from the current block, passing the UDP payload of every packet
+//! addressed to a receive port to the handler and returning each block to the kernel once all
+//! its packets have been processed.
+//!
+//! \param handler - callback to pass UDP payloads to
+//! \return number of packets passed to the handler
+
+size_t PacketRingReceiver::process_blocks(const PacketRingHandler& handler)
+{
+    size_t packets_handled = 0;
+
+#ifdef __linux__
+    while (true)
+    {
+        struct tpacket_block_desc* block_desc =
+                reinterpret_cast<struct tpacket_block_desc*>(ring_ + (current_block_ * block_size_));
+
+        if ((block_desc->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+        {
+            break;
+        }
+        __sync_synchronize();
+
+        uint32_t num_packets = block_desc->hdr.bh1.num_pkts;
+        uint8_t* packet_ptr = reinterpret_cast<uint8_t*>(block_desc) + block_desc->hdr.bh1.offset_to_first_pkt;
+
+        for (uint32_t packet = 0; packet < num_packets; packet++)
+        {
+            struct tpacket3_hdr* packet_hdr = reinterpret_cast<struct tpacket3_hdr*>(packet_ptr);
+            packet_ptr += packet_hdr->tp_next_offset;
+
+            // Ignore packets sent from this host, which are also seen on loopback
+            struct sockaddr_ll* link_addr = reinterpret_cast<struct sockaddr_ll*>(
+                    reinterpret_cast<uint8_t*>(packet_hdr) + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+            if (link_addr->sll_pkttype == PACKET_OUTGOING)
+            {
+                continue;
+            }
+
+            uint8_t* frame_ptr = reinterpret_cast<uint8_t*>(packet_hdr) + packet_hdr->tp_mac;
+            size_t   frame_len = packet_hdr->tp_snaplen;
+
+            // Parse the Ethernet header
+            if (frame_len < sizeof(struct ether_header))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            struct ether_header* eth_hdr = reinterpret_cast<struct ether_header*>(frame_ptr);
+            if (ntohs(eth_hdr->ether_type) != ETHERTYPE_IP)
+            {
+                packets_ignored_++;
+                continue;
+            }
+            size_t offset = sizeof(struct ether_header);
+
+            // Parse the IP header, ignoring malformed headers, non-UDP packets and fragments
+            if (frame_len < offset + sizeof(struct iphdr))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            struct iphdr* ip_hdr = reinterpret_cast<struct iphdr*>(frame_ptr + offset);
+            size_t ip_hdr_len = ip_hdr->ihl * 4;
+            if ((ip_hdr_len < sizeof(struct iphdr)) || (frame_len < offset + ip_hdr_len))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            if ((ip_hdr->version != 4) || (ip_hdr->protocol != IPPROTO_UDP) ||
+                (ip_hdr->frag_off & htons(IP_MF | IP_OFFMASK)) ||
+                ((address_ != INADDR_ANY) && (ip_hdr->daddr != address_)))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            offset += ip_hdr_len;
+
+            // Parse the UDP header and check the destination port
+            if (frame_len < offset + sizeof(struct udphdr))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            struct udphdr* udp_hdr = reinterpret_cast<struct udphdr*>(frame_ptr + offset);
+            uint16_t dest_port = ntohs(udp_hdr->dest);
+            if (!is_receive_port(dest_port))
+            {
+                packets_ignored_++;
+                continue;
+            }
+            offset += sizeof(struct udphdr);
+
+            size_t udp_len = ntohs(udp_hdr->len);
+            size_t payload_len = (udp_len > sizeof(struct udphdr)) ? udp_len - sizeof(struct udphdr) : 0;
+            payload_len = std::min(payload_len, frame_len - offset);
+
+            struct sockaddr_in from_addr;
+            memset(&from_addr, 0, sizeof(from_addr));
+            from_addr.sin_family = AF_INET;
+            from_addr.sin_addr.s_addr = ip_hdr->saddr;
+            from_addr.sin_port = udp_hdr->source;
+
+            handler(frame_ptr + offset, payload_len, dest_port, &from_addr);
+            packets_handled++;
+        }
+
+        // Return the block to the kernel and move on to the next
+        __sync_synchronize();
+        block_desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        current_block_ = (current_block_ + 1) % num_blocks_;
+    }
+#endif
+
+    packets_received_ += packets_handled;
+    return packets_handled;
+}
+
+//! Update the capture statistics from the kernel.
+//!
+//! Reading the kernel statistics resets them, so they are accumulated into running totals here.
+
+void PacketRingReceiver::update_statistics(void)
+{
+#ifdef __linux__
+    struct tpacket_stats_v3 ring_stats;
+    socklen_t len = sizeof(ring_stats);
+    if (getsockopt(socket_, SOL_PACKET, PACKET_STATISTICS, &ring_stats, &len) == 0)
+    {
+        packets_captured_ += ring_stats.tp_packets;
+        packets_dropped_ += ring_stats.tp_drops;
+    }
+    else
+    {
+        LOG4CXX_WARN(logger_, "Packet ring failed to read capture statistics : " << strerror(errno));
+    }
+#endif
+}
+
+//! Return the number of packets captured into the ring by the kernel.
+//!
+//! \return number of packets captured
+
+const uint64_t PacketRingReceiver::get_packets_captured(void) const
+{
+    return packets_captured_;
+}
+
+//! Return the number of packets dropped by the kernel because the ring was full (tp_drops).
+//!
+//! \return number of packets dropped
+
+const uint64_t PacketRingReceiver::get_packets_dropped(void) const
+{
+    return packets_dropped_;
+}
+
+//! Return the number of packets passed to the handler.
+//!
+//! \return number of packets received
+
+const uint64_t PacketRingReceiver::get_packets_received(void) const
+{
+    return packets_received_;
+}
+
+//! Return the number of captured packets ignored as not addressed to a receive port.
+//!
+//! \return number of packets ignored
+
+const uint64_t PacketRingReceiver::get_packets_ignored(void) const
+{
+    return packets_ignored_;
+}
+
+bool PacketRingReceiver::is_receive_port(uint16_t port) const
+{
+    return (std::find(ports_.begin(), ports_.end(), port) != ports_.end());
+}
@@ -9,8 +9,10 @@
 #include "gettime.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <sstream>
 #include <arpa/inet.h>
+#include <boost/bind.hpp>
 
 using namespace FrameReceiver;
 
@@ -21,13 +23,31 @@ PercivalEmulatorFrameDecoder::PercivalEmulatorFrameDecoder(LoggerPtr& logger,
 		current_frame_buffer_id_(-1),
 		current_frame_buffer_(0),
 		current_frame_header_(0),
+		current_packet_index_(-1),
 		dropping_frame_data_(false),
+		frame_cache_next_(0),
 		frame_timeout_ms_(frame_timeout_ms),
-		frames_timedout_(0)
+		frame_timer_wheel_(frame_timeout_ms + 1),
+		frames_timedout_(0),
+		frames_timedout_reported_(0),
+		current_packet_duplicate_(false),
+		packets_duplicated_(0),
+		batch_capacity_(0),
+		batch_size_(0),
+		batch_packets_relocated_(0)
 {
     current_packet_header_.reset(new uint8_t[sizeof(PercivalEmulator::PacketHeader)]);
+    packet_header_ = reinterpret_cast<uint8_t*>(current_packet_header_.get());
     dropped_frame_buffer_.reset(new uint8_t[PercivalEmulator::total_frame_size]);
 
+    frame_buffer_initialiser_ = boost::bind(&PercivalEmulatorFrameDecoder::initialise_frame_buffer, this, _1);
+
+    for (unsigned int cache_idx = 0; cache_idx < frame_cache_size; cache_idx++)
+    {
+        frame_cache_[cache_idx].buffer_id = -1;
+        frame_cache_[cache_idx].frame_header = 0;
+    }
+
     if (enable_packet_logging_) {
         LOG4CXX_INFO(packet_logger_, "PktHdr: SourceAddress");
         LOG4CXX_INFO(packet_logger_, "PktHdr: |               SourcePort");
@@ -66,6 +86,13 @@ void* PercivalEmulatorFrameDecoder::get_packet_header_buffer(void)
 }
 
 void PercivalEmulatorFrameDecoder::process_packet_header(size_t bytes_received, int port, struct sockaddr_in* from_addr)
+{
+    // Decode from the single packet header buffer, which may have been redirected by batch receive
+    packet_header_ = reinterpret_cast<uint8_t*>(current_packet_header_.get());
+    decode_packet_header(bytes_received, port, from_addr);
+}
+
+void PercivalEmulatorFrameDecoder::decode_packet_header(size_t bytes_received, int port, struct sockaddr_in* from_addr)
 {
     //TODO validate header size and content, handle incoming new packet buffer allocation etc
 
@@ -108,63 +135,146 @@ void PercivalEmulatorFrameDecoder::process_packet_header(size_t bytes_received,
             << " packet: "   << packet_number    << " frame: "    << frame
     );
 
-    if (frame != current_frame_seen_)
+    // If another decoder sharing the buffer pool has completed or timed out the current frame, its
+    // buffer may have been released, so force the frame buffer to be looked up again
+    if ((frame == current_frame_seen_) && !dropping_frame_data_ && (current_frame_header_ != 0) &&
+        ((current_frame_header_->frame_number != frame) ||
+         (current_frame_header_->frame_state != FrameDecoder::FrameReceiveStateIncomplete)))
+    {
+        current_frame_seen_ = -1;
+    }
+
+    if ((frame != current_frame_seen_) && !lookup_frame_cache(frame))
     {
         current_frame_seen_ = frame;
 
-    	if (frame_buffer_map_.count(current_frame_seen_) == 0)
-    	{
-    	    if (empty_buffer_queue_.empty())
+        // Look up the buffer assigned to this frame. If this is the first packet of the frame seen by
+        // any decoder sharing the pool, an empty buffer is assigned and its header initialised.
+        void* frame_header = 0;
+        current_frame_buffer_id_ = buffer_pool_->get_frame_buffer(current_frame_seen_, frame_buffer_initialiser_, &frame_header);
+
+        if (current_frame_buffer_id_ < 0)
+        {
+            current_frame_buffer_ = dropped_frame_buffer_.get();
+
+            if (!dropping_frame_data_)
             {
-                current_frame_buffer_ = dropped_frame_buffer_.get();
+                LOG4CXX_ERROR(logger_, "First packet from frame " << current_frame_seen_ << " detected but no free buffers available. Dropping packet data for this frame");
+                dropping_frame_data_ = true;
+            }
 
-    	        if (!dropping_frame_data_)
-                {
-                    LOG4CXX_ERROR(logger_, "First packet from frame " << current_frame_seen_ << " detected but no free buffers available. Dropping packet data for this frame");
-                    dropping_frame_data_ = true;
-                }
+            initialise_frame_header(reinterpret_cast<PercivalEmulator::FrameHeader*>(current_frame_buffer_));
+        }
+        else
+        {
+            current_frame_buffer_ = frame_header;
+            update_frame_cache(current_frame_seen_, current_frame_buffer_id_, frame_header);
+
+            if (dropping_frame_data_)
+            {
+                dropping_frame_data_ = false;
+                LOG4CXX_DEBUG_LEVEL(2, logger_, "Free buffer now available for frame " << current_frame_seen_ << ", allocating frame buffer ID " << current_frame_buffer_id_);
             }
-    	    else
-    	    {
+        }
 
-                current_frame_buffer_id_ = empty_buffer_queue_.front();
-                empty_buffer_queue_.pop();
-                frame_buffer_map_[current_frame_seen_] = current_frame_buffer_id_;
-                current_frame_buffer_ = buffer_manager_->get_buffer_address(current_frame_buffer_id_);
+        current_frame_header_ = reinterpret_cast<PercivalEmulator::FrameHeader*>(current_frame_buffer_);
+    }
 
-                if (!dropping_frame_data_)
-                {
-                    LOG4CXX_DEBUG_LEVEL(2, logger_, "First packet from frame " << current_frame_seen_ << " detected, allocating frame buffer ID " << current_frame_buffer_id_);
-                }
-                else
-                {
-                    dropping_frame_data_ = false;
-                    LOG4CXX_DEBUG_LEVEL(2, logger_, "Free buffer now available for frame " << current_frame_seen_ << ", allocating frame buffer ID " << current_frame_buffer_id_);
-                }
-    	    }
-
-    	    // Initialise frame header
-            current_frame_header_ = reinterpret_cast<PercivalEmulator::FrameHeader*>(current_frame_buffer_);
-            current_frame_header_->frame_number = current_frame_seen_;
-            current_frame_header_->frame_state = FrameDecoder::FrameReceiveStateIncomplete;
-            current_frame_header_->packets_received = 0;
-            memset(current_frame_header_->packet_state, 0, PercivalEmulator::num_frame_packets);
-            memcpy(current_frame_header_->frame_info, get_frame_info(), PercivalEmulator::frame_info_size);
-            gettime(reinterpret_cast<struct timespec*>(&(current_frame_header_->frame_start_time)));
-
-    	}
-    	else
-    	{
-    		current_frame_buffer_id_ = frame_buffer_map_[current_frame_seen_];
-        	current_frame_buffer_ = buffer_manager_->get_buffer_address(current_frame_buffer_id_);
-        	current_frame_header_ = reinterpret_cast<PercivalEmulator::FrameHeader*>(current_frame_buffer_);
-    	}
+    // Record the linear index of this packet in the frame, used to predict batch receive destinations
+    current_packet_index_ = PercivalEmulator::packet_state_index(type, subframe, packet_number);
 
+    // Update packet state bitmap in frame header, detecting packets that have already been received
+    current_packet_duplicate_ = PercivalEmulator::test_and_set_packet_state(current_frame_header_, current_packet_index_);
+    if (current_packet_duplicate_)
+    {
+        packets_duplicated_++;
+        LOG4CXX_DEBUG_LEVEL(2, logger_, "Duplicate packet " << packet_number << " of subframe " << (int)subframe
+                << " type " << (int)type << " received for frame " << frame);
     }
 
-    // Update packet_number state map in frame header
-    current_frame_header_->packet_state[type][subframe][packet_number] = 1;
+}
+
+void* PercivalEmulatorFrameDecoder::initialise_frame_buffer(int buffer_id)
+{
+    LOG4CXX_DEBUG_LEVEL(2, logger_, "First packet from frame " << current_frame_seen_ << " detected, allocating frame buffer ID " << buffer_id);
+
+    buffer_manager_->set_buffer_state(buffer_id, BufferStateFilling, current_frame_seen_);
+
+    void* frame_header = buffer_manager_->get_buffer_address(buffer_id);
+    initialise_frame_header(reinterpret_cast<PercivalEmulator::FrameHeader*>(frame_header));
+
+    // Schedule the timeout of the new frame, recording its start time so that the timeout can be
+    // matched against the frame in the buffer when it expires
+    if (static_cast<size_t>(buffer_id) >= frame_start_times_.size())
+    {
+        frame_start_times_.resize(buffer_id + 1);
+    }
+    frame_start_times_[buffer_id] = reinterpret_cast<PercivalEmulator::FrameHeader*>(frame_header)->frame_start_time;
+
+    struct timespec current_time;
+    gettime(&current_time, true);
+    frame_timer_wheel_.schedule(buffer_id, current_frame_seen_, timespec_to_ms(current_time) + frame_timeout_ms_);
 
+    return frame_header;
+}
+
+bool PercivalEmulatorFrameDecoder::lookup_frame_cache(uint32_t frame_number)
+{
+    // Switch to a recently seen frame without a pool lookup, provided its buffer is still being
+    // filled for that frame, i.e. it has not been completed or timed out and its buffer reused
+    for (unsigned int cache_idx = 0; cache_idx < frame_cache_size; cache_idx++)
+    {
+        FrameBufferSlot& slot = frame_cache_[cache_idx];
+        if ((slot.buffer_id >= 0) && (slot.frame_number == frame_number))
+        {
+            PercivalEmulator::FrameHeader* frame_header = reinterpret_cast<PercivalEmulator::FrameHeader*>(slot.frame_header);
+            if ((frame_header->frame_number != frame_number) ||
+                (frame_header->frame_state != FrameDecoder::FrameReceiveStateIncomplete))
+            {
+                slot.buffer_id = -1;
+                return false;
+            }
+
+            current_frame_seen_ = frame_number;
+            current_frame_buffer_id_ = slot.buffer_id;
+            current_frame_buffer_ = slot.frame_header;
+            current_frame_header_ = frame_header;
+            dropping_frame_data_ = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void PercivalEmulatorFrameDecoder::update_frame_cache(uint32_t frame_number, int buffer_id, void* frame_header)
+{
+    FrameBufferSlot& slot = frame_cache_[frame_cache_next_];
+    slot.frame_number = frame_number;
+    slot.buffer_id = buffer_id;
+    slot.frame_header = frame_header;
+    frame_cache_next_ = (frame_cache_next_ + 1) % frame_cache_size;
+}
+
+void PercivalEmulatorFrameDecoder::evict_frame_cache(uint32_t frame_number)
+{
+    for (unsigned int cache_idx = 0; cache_idx < frame_cache_size; cache_idx++)
+    {
+        if (frame_cache_[cache_idx].frame_number == frame_number)
+        {
+            frame_cache_[cache_idx].buffer_id = -1;
+        }
+    }
+}
+
+void PercivalEmulatorFrameDecoder::initialise_frame_header(PercivalEmulator::FrameHeader* header_ptr)
+{
+    header_ptr->header_magic = PercivalEmulator::frame_header_magic;
+    header_ptr->header_version = PercivalEmulator::frame_header_version;
+    header_ptr->frame_number = current_frame_seen_;
+    header_ptr->frame_state = FrameDecoder::FrameReceiveStateIncomplete;
+    memset(header_ptr->packet_state, 0, sizeof(header_ptr->packet_state));
+    memcpy(header_ptr->frame_info, get_frame_info(), PercivalEmulator::frame_info_size);
+    gettime(reinterpret_cast<struct timespec*>(&(header_ptr->frame_start_time)));
 }
 
 void* PercivalEmulatorFrameDecoder::get_next_payload_buffer(void) const
@@ -201,24 +311,41 @@ FrameDecoder::FrameReceiveState PercivalEmulatorFrameDecoder::process_packet(siz
 
     FrameDecoder::FrameReceiveState frame_state = FrameDecoder::FrameReceiveStateIncomplete;
 
-	current_frame_header_->packets_received++;
+    // A duplicate packet overwrites the payload already received, so must not count towards completion
+    if (current_packet_duplicate_)
+    {
+        return frame_state;
+    }
+
+	// Packets of a frame may be received by decoders in several threads, so count them from the
+	// packet state bitmap, which is updated atomically. More than one decoder may then see the
+	// frame complete, but only the first to release it from the buffer pool notifies it.
+	size_t packets_received = PercivalEmulator::count_packet_state(current_frame_header_);
 
-	if (current_frame_header_->packets_received == PercivalEmulator::num_frame_packets)
+	if (packets_received == PercivalEmulator::num_frame_packets)
 	{
 
 	    // Set frame state accordingly
 		frame_state = FrameDecoder::FrameReceiveStateComplete;
 
-		// Complete frame header
-		current_frame_header_->frame_state = frame_state;
-
-		if (!dropping_frame_data_)
+		if (dropping_frame_data_)
 		{
-			// Erase frame from buffer map
-			frame_buffer_map_.erase(current_frame_seen_);
-
-			// Notify main thread that frame is ready
-			ready_callback_(current_frame_buffer_id_, current_frame_seen_);
+			current_frame_header_->frame_state = frame_state;
+		}
+		else
+		{
+			// Release frame from buffer pool, unless it has already been timed out by another decoder
+			evict_frame_cache(current_frame_seen_);
+			frame_timer_wheel_.cancel(current_frame_buffer_id_);
+			if (buffer_pool_->release_frame_buffer(current_frame_seen_))
+			{
+				// Complete frame header
+				current_frame_header_->frame_state = frame_state;
+
+				// Notify main thread that frame is ready
+				ready_callback_(current_frame_buffer_id_, current_frame_seen_, frame_state,
+				        frame_start_time_ns(current_frame_header_));
+			}
 
 			// Reset current frame seen ID so that if next frame has same number (e.g. repeated
 			// sends of single frame 0), it is detected properly
@@ -229,49 +356,229 @@ FrameDecoder::FrameReceiveState PercivalEmulatorFrameDecoder::process_packet(siz
 	return frame_state;
 }
 
-void PercivalEmulatorFrameDecoder::monitor_buffers(void)
+void PercivalEmulatorFrameDecoder::init_batch_receive(size_t max_batch_packets)
 {
+    // Allocate header slots, scratch payload slots and the payload pointer table for a
+    // batch of the requested size. Scratch slots are sized for the largest packet payload.
+    batch_capacity_ = max_batch_packets;
+    batch_size_ = 0;
+    batch_headers_.assign(batch_capacity_ * sizeof(PercivalEmulator::PacketHeader), 0);
+    batch_scratch_.assign(batch_capacity_ * PercivalEmulator::primary_packet_size, 0);
+    batch_swap_.assign(PercivalEmulator::primary_packet_size, 0);
+    batch_payload_buffers_.assign(batch_capacity_, 0);
+
+    LOG4CXX_DEBUG_LEVEL(1, logger_, "Initialised batch receive for up to " << batch_capacity_ << " packets");
+}
+
+void PercivalEmulatorFrameDecoder::prepare_batch_receive(size_t num_packets)
+{
+    if (num_packets > batch_capacity_)
+    {
+        std::stringstream ss;
+        ss << "Requested batch of " << num_packets << " packets exceeds initialised capacity of " << batch_capacity_;
+        throw FrameDecoderException(ss.str());
+    }
 
-    int frames_timedout = 0;
+    // Predict that packets arrive in order into the current frame, so that payloads for
+    // a well-behaved stream land directly in the frame buffer. Slots that cannot be
+    // predicted receive into scratch and are relocated once the header has been decoded.
+    batch_size_ = num_packets;
+    for (size_t packet_idx = 0; packet_idx < batch_size_; packet_idx++)
+    {
+        uint8_t* payload_buffer = speculate_payload_buffer(packet_idx);
+        if (payload_buffer == 0)
+        {
+            payload_buffer = &batch_scratch_[packet_idx * PercivalEmulator::primary_packet_size];
+        }
+        batch_payload_buffers_[packet_idx] = payload_buffer;
+    }
+}
+
+void* PercivalEmulatorFrameDecoder::get_batch_header_buffer(size_t packet_idx)
+{
+    return reinterpret_cast<void*>(&batch_headers_[packet_idx * sizeof(PercivalEmulator::PacketHeader)]);
+}
+
+void* PercivalEmulatorFrameDecoder::get_batch_payload_buffer(size_t packet_idx)
+{
+    return reinterpret_cast<void*>(batch_payload_buffers_[packet_idx]);
+}
+
+size_t PercivalEmulatorFrameDecoder::get_batch_payload_size(size_t packet_idx) const
+{
+    return PercivalEmulator::primary_packet_size;
+}
+
+FrameDecoder::FrameReceiveState PercivalEmulatorFrameDecoder::process_batch_packet(size_t packet_idx,
+        size_t bytes_received, int port, struct sockaddr_in* from_addr)
+{
+    // Decode the header directly from the batch slot it was received into
+    packet_header_ = &batch_headers_[packet_idx * sizeof(PercivalEmulator::PacketHeader)];
+    decode_packet_header(bytes_received, port, from_addr);
+
+    // Move the payload to its decoded location if the prediction was wrong
+    if (batch_payload_buffers_[packet_idx] != get_next_payload_buffer())
+    {
+        relocate_batch_payload(packet_idx, bytes_received);
+    }
+
+    return process_packet(bytes_received);
+}
+
+uint8_t* PercivalEmulatorFrameDecoder::speculate_payload_buffer(size_t packet_idx) const
+{
+    // Only predict into a frame buffer that is currently being filled, and which is not shared with
+    // decoders in other threads that could be receiving into the predicted slot concurrently. A frame
+    // that has timed out has had its buffer handed to consumers, so must never be predicted into
+    if (dropping_frame_data_ || (current_frame_header_ == 0) || buffer_pool_->is_shared() ||
+        (current_frame_seen_ == static_cast<uint32_t>(-1)) || (current_packet_index_ < 0) ||
+        (current_frame_header_->frame_state != FrameReceiveStateIncomplete))
+    {
+        return 0;
+    }
+
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+    size_t next_index = current_packet_index_ + 1 + packet_idx;
+    if (next_index >= PercivalEmulator::num_frame_packets)
+    {
+        return 0;
+    }
+
+    size_t packet_number = next_index % packets_per_subframe;
+    size_t subframe = (next_index / packets_per_subframe) % PercivalEmulator::num_subframes;
+    size_t type = next_index / (packets_per_subframe * PercivalEmulator::num_subframes);
+
+    // Never predict into tail packet slots, or slots that have already been filled
+    if ((packet_number >= PercivalEmulator::num_primary_packets) ||
+        PercivalEmulator::test_packet_state(current_frame_header_, next_index))
+    {
+        return 0;
+    }
+
+    return reinterpret_cast<uint8_t*>(current_frame_buffer_) +
+            get_frame_header_size() +
+            (PercivalEmulator::data_type_size * type) +
+            (PercivalEmulator::subframe_size * subframe) +
+            (PercivalEmulator::primary_packet_size * packet_number);
+}
+
+void PercivalEmulatorFrameDecoder::relocate_batch_payload(size_t packet_idx, size_t bytes_received)
+{
+    uint8_t* payload_src  = batch_payload_buffers_[packet_idx];
+    uint8_t* payload_dest = reinterpret_cast<uint8_t*>(get_next_payload_buffer());
+
+    size_t payload_bytes = 0;
+    if (bytes_received > sizeof(PercivalEmulator::PacketHeader))
+    {
+        payload_bytes = std::min(bytes_received - sizeof(PercivalEmulator::PacketHeader), get_next_payload_size());
+    }
+
+    // If a later packet in the batch was received into the destination slot, swap the two
+    // payloads and redirect that packet to where this one was received
+    for (size_t later_idx = packet_idx + 1; later_idx < batch_size_; later_idx++)
+    {
+        if (batch_payload_buffers_[later_idx] == payload_dest)
+        {
+            memcpy(&batch_swap_[0], payload_dest, PercivalEmulator::primary_packet_size);
+            memcpy(payload_dest, payload_src, payload_bytes);
+            memcpy(payload_src, &batch_swap_[0], PercivalEmulator::primary_packet_size);
+            batch_payload_buffers_[later_idx] = payload_src;
+            batch_packets_relocated_++;
+            return;
+        }
+    }
+
+    memcpy(payload_dest, payload_src, payload_bytes);
+    batch_packets_relocated_++;
+}
+
+void PercivalEmulatorFrameDecoder::expire_frames(void)
+{
     struct timespec current_time;
+    gettime(&current_time, true);
 
-    gettime(&current_time);
+    // Collect frames whose timeout has expired from the timer wheel. The vector is reused between
+    // calls so that no allocation occurs once it has grown
+    expired_frames_.clear();
+    if (frame_timer_wheel_.advance(timespec_to_ms(current_time), expired_frames_) == 0)
+    {
+        return;
+    }
 
-    // Loop over frame buffers currently in map and check their state
-    std::map<uint32_t, int>::iterator buffer_map_iter = frame_buffer_map_.begin();
-    while (buffer_map_iter != frame_buffer_map_.end())
+    for (std::vector<FrameTimerExpiry>::iterator expiry_iter = expired_frames_.begin();
+            expiry_iter != expired_frames_.end(); expiry_iter++)
     {
-        uint32_t frame_num = buffer_map_iter->first;
-        int      buffer_id = buffer_map_iter->second;
+        uint32_t frame_num = expiry_iter->frame_number;
+        int      buffer_id = expiry_iter->buffer_id;
         void*    buffer_addr = buffer_manager_->get_buffer_address(buffer_id);
         PercivalEmulator::FrameHeader* frame_header = reinterpret_cast<PercivalEmulator::FrameHeader*>(buffer_addr);
 
-        if (elapsed_ms(frame_header->frame_start_time, current_time) > frame_timeout_ms_)
+        // If the pool is shared, the frame may have been completed by another decoder and the buffer
+        // reused, so check that the buffer still holds the incomplete frame this timeout was scheduled for
+        if ((frame_header->frame_number != frame_num) ||
+            (frame_header->frame_state != FrameReceiveStateIncomplete) ||
+            (frame_header->frame_start_time.tv_sec != frame_start_times_[buffer_id].tv_sec) ||
+            (frame_header->frame_start_time.tv_nsec != frame_start_times_[buffer_id].tv_nsec))
+        {
+            continue;
+        }
+
+        // Release timed out frames from the pool, unless already completed by another decoder
+        evict_frame_cache(frame_num);
+        if (buffer_pool_->release_frame_buffer(frame_num))
         {
             LOG4CXX_DEBUG_LEVEL(1, logger_, "Frame " << frame_num << " in buffer " << buffer_id
                     << " addr 0x" << std::hex << buffer_addr << std::dec
-                    << " timed out with " << frame_header->packets_received << " packets received");
+                    << " timed out with " << PercivalEmulator::count_packet_state(frame_header) << " packets received");
+
+            // Only extract the missing packet list when it will be logged
+            if (debug_level >= 2)
+            {
+                missing_packets_.clear();
+                PercivalEmulator::get_missing_packets(frame_header, missing_packets_);
+                std::stringstream ss;
+                for (size_t missing_idx = 0; missing_idx < std::min(missing_packets_.size(), static_cast<size_t>(16)); missing_idx++)
+                {
+                    ss << " " << missing_packets_[missing_idx];
+                }
+                LOG4CXX_DEBUG_LEVEL(2, logger_, "Frame " << frame_num << " is missing " << missing_packets_.size()
+                        << " packets, first missing packet indices:" << ss.str());
+            }
 
             frame_header->frame_state = FrameReceiveStateTimedout;
-            ready_callback_(buffer_id, frame_num);
-            frames_timedout++;
+            ready_callback_(buffer_id, frame_num, FrameReceiveStateTimedout, frame_start_time_ns(frame_header));
+            frames_timedout_++;
 
-            frame_buffer_map_.erase(buffer_map_iter++);
-        }
-        else
-        {
-            buffer_map_iter++;
+            // Forget the buffer if it held the current frame, so that late packets of the frame
+            // are given a new buffer rather than written into one now owned by consumers
+            if ((frame_num == current_frame_seen_) && (buffer_id == current_frame_buffer_id_))
+            {
+                current_frame_seen_ = -1;
+                current_frame_buffer_id_ = -1;
+                current_frame_buffer_ = 0;
+                current_frame_header_ = 0;
+                current_packet_index_ = -1;
+            }
         }
     }
+}
+
+void PercivalEmulatorFrameDecoder::monitor_buffers(void)
+{
+    // Incomplete frames are timed out as they expire, so only report how many since the last call
+    unsigned int frames_timedout = frames_timedout_ - frames_timedout_reported_;
     if (frames_timedout)
     {
         LOG4CXX_WARN(logger_, "Released " << frames_timedout << " timed out incomplete frames");
     }
-    frames_timedout_ += frames_timedout;
+    frames_timedout_reported_ = frames_timedout_;
 
     LOG4CXX_DEBUG_LEVEL(2, logger_, get_num_mapped_buffers() << " frame buffers in use, "
             << get_num_empty_buffers() << " empty buffers available, "
-            << frames_timedout_ << " incomplete frames timed out");
+            << frame_timer_wheel_.get_num_scheduled() << " frame timeouts scheduled, "
+            << frames_timedout_ << " incomplete frames timed out, "
+            << batch_packets_relocated_ << " batch packets relocated, "
+            << packets_duplicated_ << " duplicate packets received");
 
 }
 
@@ -316,17 +623,24 @@ uint8_t* PercivalEmulatorFrameDecoder::get_frame_info(void) const
     return (reinterpret_cast<uint8_t*>(raw_packet_header()+PercivalEmulator::frame_info_offset));
 }
 
+const uint64_t PercivalEmulatorFrameDecoder::get_packets_duplicated(void) const
+{
+    return packets_duplicated_;
+}
+
 uint8_t* PercivalEmulatorFrameDecoder::raw_packet_header(void) const
 {
-    return reinterpret_cast<uint8_t*>(current_packet_header_.get());
+    return packet_header_;
 }
 
 
-unsigned int PercivalEmulatorFrameDecoder::elapsed_ms(struct timespec& start, struct timespec& end)
+uint64_t PercivalEmulatorFrameDecoder::timespec_to_ms(const struct timespec& time)
 {
+    return (static_cast<uint64_t>(time.tv_sec) * 1000) + (time.tv_nsec / 1000000);
+}
 
-    double start_ns = ((double)start.tv_sec * 1000000000) + start.tv_nsec;
-    double end_ns   = ((double)  end.tv_sec * 1000000000) +   end.tv_nsec;
-
-    return (unsigned int)((end_ns - start_ns)/1000000);
+uint64_t PercivalEmulatorFrameDecoder::frame_start_time_ns(const PercivalEmulator::FrameHeader* frame_header)
+{
+    return (static_cast<uint64_t>(frame_header->frame_start_time.tv_sec) * 1000000000) +
+            frame_header->frame_start_time.tv_nsec;
 }
@@ -6,41 +6,244 @@
  */
 
 #include "SharedBufferManager.h"
+#include "NumaBinding.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <sstream>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#endif
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 using namespace FrameReceiver;
 using namespace boost::interprocess;
 
+namespace
+{
+    const uint64_t descriptor_table_magic = 0x4353444655424644ULL; // "DFBUFDSC"
+    const uint64_t ring_area_magic = 0x53474e4952524644ULL; // "DFRRINGS"
+    const size_t   area_alignment = 64;
+    const size_t   min_ring_capacity = 2;
+
+    size_t align_area(size_t offset)
+    {
+        return (offset + area_alignment - 1) & ~(area_alignment - 1);
+    }
+}
+
 SharedBufferManager::SharedBufferManager(const std::string& shared_mem_name, const size_t shared_mem_size,
-        const size_t buffer_size, bool remove_when_deleted) try :
+        const size_t buffer_size, bool remove_when_deleted, unsigned int num_ready_rings,
+        const std::string& huge_page_dir, const std::vector<size_t>& size_class_buffer_sizes,
+        const std::string& spill_file_path, const size_t spill_file_size) try :
     shared_mem_name_(shared_mem_name),
     shared_mem_size_(shared_mem_size),
     remove_when_deleted_(remove_when_deleted),
-    shared_mem_(open_or_create, shared_mem_name_.c_str(), read_write),
-    manager_hdr_(0)
+    huge_page_region_(0),
+    region_addr_(0),
+    region_size_(0),
+    page_size_(sysconf(_SC_PAGESIZE)),
+    locked_(false),
+    num_buffers_(0),
+    spill_file_path_(spill_file_path),
+    spill_region_addr_(0),
+    spill_region_size_(0),
+    num_spill_buffers_(0),
+    manager_hdr_(0),
+    descriptor_table_hdr_(0),
+    descriptors_(0),
+    ring_area_hdr_(0)
 {
 
-    // Set the size of the shared memory object
-    shared_mem_.truncate(sizeof(Header) + shared_mem_size_);
+    // Open the huge page file if requested, which determines the page size and so the buffer stride
+    int huge_page_fd = -1;
+    if (!huge_page_dir.empty())
+    {
+        huge_page_path_ = huge_page_dir + "/" + shared_mem_name_;
+        huge_page_fd = open_huge_page_file(O_RDWR | O_CREAT);
 
-    // Map the whole shared memory region into this process
-    shared_mem_region_ = mapped_region(shared_mem_, read_write);
+        // Remove any shared memory object of the same name, which would otherwise be mapped by clients in
+        // preference to the huge page file
+        shared_memory_object::remove(shared_mem_name_.c_str());
+    }
 
-    // Determine how many buffers of the requested size fit into the shared memory region
-    size_t num_buffers = shared_mem_size_ / buffer_size;
-    if (!num_buffers)
+    // Determine the buffer stride of each size class, largest first, and how many buffers of each fit into
+    // an equal share of the shared memory region
+    std::vector<size_t> buffer_sizes(1, buffer_size);
+    for (std::vector<size_t>::const_iterator size_itr = size_class_buffer_sizes.begin();
+            size_itr != size_class_buffer_sizes.end(); size_itr++)
     {
-        throw SharedBufferManagerException("Buffer size requested exceeds size of shared memory");
+        if ((*size_itr > 0) && (*size_itr < buffer_size))
+        {
+            buffer_sizes.push_back(*size_itr);
+        }
     }
+    std::sort(buffer_sizes.begin() + 1, buffer_sizes.end(), std::greater<size_t>());
 
-    // Initialise the buffer manager header
-    manager_hdr_ = reinterpret_cast<Header*>(shared_mem_region_.get_address());
-    manager_hdr_->manager_id = last_manager_id++;
-    manager_hdr_->num_buffers = num_buffers;
-    manager_hdr_->buffer_size = buffer_size;
+    std::vector<size_t> buffer_strides;
+    for (std::vector<size_t>::iterator size_itr = buffer_sizes.begin(); size_itr != buffer_sizes.end(); size_itr++)
+    {
+        size_t buffer_stride = (huge_page_fd >= 0) ? get_huge_page_buffer_stride(*size_itr, page_size_) : *size_itr;
+        if (buffer_strides.empty() || (buffer_stride < buffer_strides.back()))
+        {
+            buffer_strides.push_back(buffer_stride);
+        }
+    }
+
+    size_t size_class_mem_size = shared_mem_size_ / buffer_strides.size();
+    for (std::vector<size_t>::iterator stride_itr = buffer_strides.begin(); stride_itr != buffer_strides.end();
+            stride_itr++)
+    {
+        SizeClass size_class;
+        size_class.buffer_size = *stride_itr;
+        size_class.num_buffers = size_class_mem_size / *stride_itr;
+        size_class.first_buffer = num_buffers_;
+        size_class.offset = sizeof(Header);
+        if (!size_class.num_buffers)
+        {
+            discard_huge_page_file(huge_page_fd);
+            throw SharedBufferManagerException("Buffer size requested exceeds size of shared memory");
+        }
+        size_classes_.push_back(size_class);
+        num_buffers_ += size_class.num_buffers;
+    }
+
+    // Create and map the spill file, if requested, holding full size buffers following those in memory
+    if (!spill_file_path_.empty())
+    {
+        num_spill_buffers_ = spill_file_size / size_classes_[0].buffer_size;
+        if (!num_spill_buffers_ || (spill_file_path_.size() >= sizeof(SpillFileEntry().path)))
+        {
+            discard_huge_page_file(huge_page_fd);
+            throw SharedBufferManagerException(num_spill_buffers_ ? "Spill file path is too long" :
+                    "Spill file size requested is smaller than a frame buffer");
+        }
+        try
+        {
+            map_spill_file(true);
+        }
+        catch (SharedBufferManagerException& e)
+        {
+            discard_huge_page_file(huge_page_fd);
+            throw;
+        }
+        num_buffers_ += num_spill_buffers_;
+    }
+
+    // Size the buffer descriptor and size class tables to follow the buffers of the first size class, and the
+    // ring area, if requested, to follow the tables. Each ring can hold a descriptor for every buffer so that
+    // producers never find a ring full. The buffers of any further size classes follow the ring area.
+    size_t descriptor_table_offset = align_area(sizeof(Header) +
+            (size_classes_[0].num_buffers * size_classes_[0].buffer_size));
+    size_t descriptor_table_size = get_descriptor_table_size(num_buffers_, size_classes_.size(), num_spill_buffers_ > 0);
+    size_t ring_area_offset = align_area(descriptor_table_offset + descriptor_table_size);
+    size_t ring_capacity = min_ring_capacity;
+    while (ring_capacity < num_buffers_)
+    {
+        ring_capacity <<= 1;
+    }
+    size_t region_size = ring_area_offset + (num_ready_rings ?
+            get_ring_area_size(num_ready_rings, ring_capacity) : sizeof(RingAreaHeader));
+    for (size_t class_idx = 1; class_idx < size_classes_.size(); class_idx++)
+    {
+        size_classes_[class_idx].offset = ((region_size + page_size_ - 1) / page_size_) * page_size_;
+        region_size = size_classes_[class_idx].offset +
+                (size_classes_[class_idx].num_buffers * size_classes_[class_idx].buffer_size);
+    }
+    region_size = std::max(sizeof(Header) + shared_mem_size_, region_size);
 
+    // Map and initialise the region. The destructor is not called for a partly constructed manager, so
+    // the region, huge page file and spill file are released here if any step fails.
+    try
+    {
+        if (huge_page_fd >= 0)
+        {
+            // Size and map the huge page file, which must be a whole number of pages
+            map_huge_page_file(huge_page_fd, ((region_size + page_size_ - 1) / page_size_) * page_size_);
+        }
+        else
+        {
+            // Create the shared memory object and set its size
+            shared_memory_object shared_mem(open_or_create, shared_mem_name_.c_str(), read_write);
+            shared_mem_.swap(shared_mem);
+            shared_mem_.truncate(region_size);
+
+            // Map the whole shared memory region into this process
+            shared_mem_region_ = mapped_region(shared_mem_, read_write);
+            region_addr_ = reinterpret_cast<char*>(shared_mem_region_.get_address());
+            region_size_ = shared_mem_region_.get_size();
+        }
+
+        // Initialise the buffer manager header, which describes the buffers of the first size class so that
+        // clients unaware of size classes address those buffers as for any other segment
+        manager_hdr_ = reinterpret_cast<Header*>(region_addr_);
+        manager_hdr_->manager_id = last_manager_id++;
+        manager_hdr_->num_buffers = size_classes_[0].num_buffers;
+        manager_hdr_->buffer_size = size_classes_[0].buffer_size;
+
+        // Initialise the buffer descriptor table with every buffer free, followed by the size class table
+        descriptor_table_hdr_ = reinterpret_cast<DescriptorTableHeader*>(region_addr_ + descriptor_table_offset);
+        memset(descriptor_table_hdr_, 0, descriptor_table_size);
+        descriptor_table_hdr_->num_descriptors = num_buffers_;
+        descriptor_table_hdr_->num_size_classes = size_classes_.size();
+        descriptor_table_hdr_->num_spill_buffers = num_spill_buffers_;
+        descriptors_ = reinterpret_cast<BufferDescriptor*>(descriptor_table_hdr_ + 1);
+        SizeClassEntry* size_class_table = reinterpret_cast<SizeClassEntry*>(descriptors_ + num_buffers_);
+        for (size_t class_idx = 0; class_idx < size_classes_.size(); class_idx++)
+        {
+            const SizeClass& size_class = size_classes_[class_idx];
+            size_class_table[class_idx].buffer_size = size_class.buffer_size;
+            size_class_table[class_idx].num_buffers = size_class.num_buffers;
+            size_class_table[class_idx].first_buffer = size_class.first_buffer;
+            size_class_table[class_idx].offset = size_class.offset;
+            for (size_t buffer = size_class.first_buffer; buffer < size_class.first_buffer + size_class.num_buffers; buffer++)
+            {
+                descriptors_[buffer].size_class = class_idx;
+            }
+        }
+        if (num_spill_buffers_)
+        {
+            SpillFileEntry* spill_file_entry =
+                    reinterpret_cast<SpillFileEntry*>(size_class_table + size_classes_.size());
+            spill_file_entry->buffer_size = size_classes_[0].buffer_size;
+            spill_file_entry->num_buffers = num_spill_buffers_;
+            strncpy(spill_file_entry->path, spill_file_path_.c_str(), sizeof(spill_file_entry->path) - 1);
+        }
+        __atomic_store_n(&(descriptor_table_hdr_->magic), descriptor_table_magic, __ATOMIC_RELEASE);
+
+        // Initialise the ring area, or clear any stale ring area left in a reused shared memory object
+        if (region_size_ >= ring_area_offset + sizeof(RingAreaHeader))
+        {
+            ring_area_hdr_ = reinterpret_cast<RingAreaHeader*>(region_addr_ + ring_area_offset);
+            memset(ring_area_hdr_, 0, sizeof(RingAreaHeader));
+            if (num_ready_rings)
+            {
+                ring_area_hdr_->num_ready_rings = num_ready_rings;
+                ring_area_hdr_->ring_capacity = ring_capacity;
+                map_frame_rings(true);
+                ring_area_hdr_->magic = ring_area_magic;
+            }
+            else
+            {
+                ring_area_hdr_ = 0;
+            }
+        }
+    }
+    catch (...)
+    {
+        release_region();
+        throw;
+    }
 }
 catch (interprocess_exception& e)
 {
@@ -50,36 +253,140 @@ catch (interprocess_exception& e)
     throw (SharedBufferManagerException(ss.str()));
 }
 
-SharedBufferManager::SharedBufferManager(const std::string& shared_mem_name) try :
+//! Constructor mapping an existing shared buffer manager segment.
+//!
+//! The segment is first looked for as a shared memory object. If that does not exist, it is
+//! looked for as a huge page file, either at the path given as the name or with the specified
+//! name in the huge page directory.
+//!
+//! \param shared_mem_name - name of the segment, or path of a huge page file
+//! \param huge_page_dir - hugetlbfs mount directory to look for the segment in
+
+SharedBufferManager::SharedBufferManager(const std::string& shared_mem_name, const std::string& huge_page_dir) :
     shared_mem_name_(shared_mem_name),
     remove_when_deleted_(false),
-    shared_mem_(open_only, shared_mem_name_.c_str(), read_write)
+    huge_page_region_(0),
+    region_addr_(0),
+    region_size_(0),
+    page_size_(sysconf(_SC_PAGESIZE)),
+    locked_(false),
+    num_buffers_(0),
+    spill_region_addr_(0),
+    spill_region_size_(0),
+    num_spill_buffers_(0),
+    descriptor_table_hdr_(0),
+    descriptors_(0),
+    ring_area_hdr_(0)
 {
 
-    // Map the whole shared memory region into this process
-    shared_mem_region_ = mapped_region(shared_mem_, read_write);
+    try
+    {
+        // Map the whole shared memory region into this process
+        shared_memory_object shared_mem(open_only, shared_mem_name_.c_str(), read_write);
+        shared_mem_.swap(shared_mem);
+        shared_mem_region_ = mapped_region(shared_mem_, read_write);
+        region_addr_ = reinterpret_cast<char*>(shared_mem_region_.get_address());
+        region_size_ = shared_mem_region_.get_size();
+    }
+    catch (interprocess_exception& e)
+    {
+        // Fall back to a huge page file, reporting the original error if that does not exist either
+        huge_page_path_ = (shared_mem_name_.find('/') != std::string::npos) ?
+                shared_mem_name_ : (huge_page_dir + "/" + shared_mem_name_);
+        if (access(huge_page_path_.c_str(), F_OK) != 0)
+        {
+            std::stringstream ss;
+            ss << "Failed to map existing shared buffer manager: " << e.what();
+            throw (SharedBufferManagerException(ss.str()));
+        }
+
+        int huge_page_fd = open_huge_page_file(O_RDWR);
+        struct stat huge_page_stat;
+        if (fstat(huge_page_fd, &huge_page_stat) != 0)
+        {
+            int stat_errno = errno;
+            close(huge_page_fd);
+            std::stringstream ss;
+            ss << "Failed to stat huge page file " << huge_page_path_ << ": " << strerror(stat_errno);
+            throw SharedBufferManagerException(ss.str());
+        }
+        map_huge_page_file(huge_page_fd, huge_page_stat.st_size);
+    }
 
     // Determine how big the region is
-    shared_mem_size_ = shared_mem_region_.get_size();
+    shared_mem_size_ = region_size_;
 
     // Map the buffer manager header
-    manager_hdr_ = reinterpret_cast<Header*>(shared_mem_region_.get_address());
+    manager_hdr_ = reinterpret_cast<Header*>(region_addr_);
+
+    // Map the buffer descriptor table if the region has a valid table following the buffers. Without one
+    // the region holds a single size class of buffers as described by the header.
+    SizeClass size_class;
+    size_class.buffer_size = manager_hdr_->buffer_size;
+    size_class.num_buffers = manager_hdr_->num_buffers;
+    size_class.first_buffer = 0;
+    size_class.offset = sizeof(Header);
+    size_classes_.push_back(size_class);
+    num_buffers_ = manager_hdr_->num_buffers;
+
+    size_t descriptor_table_offset = get_descriptor_table_offset();
+    if (shared_mem_size_ >= descriptor_table_offset + sizeof(DescriptorTableHeader))
+    {
+        DescriptorTableHeader* descriptor_table_hdr =
+                reinterpret_cast<DescriptorTableHeader*>(region_addr_ + descriptor_table_offset);
+        if ((descriptor_table_hdr->magic == descriptor_table_magic) &&
+            ((descriptor_table_hdr->num_descriptors ==
+                    manager_hdr_->num_buffers + descriptor_table_hdr->num_spill_buffers) ||
+             (descriptor_table_hdr->num_size_classes > 1)) &&
+            (shared_mem_size_ >= descriptor_table_offset + get_descriptor_table_size(
+                    descriptor_table_hdr->num_descriptors, descriptor_table_hdr->num_size_classes,
+                    descriptor_table_hdr->num_spill_buffers > 0)))
+        {
+            descriptor_table_hdr_ = descriptor_table_hdr;
+            descriptors_ = reinterpret_cast<BufferDescriptor*>(descriptor_table_hdr_ + 1);
+            map_size_classes();
+
+            // Map the spill file recorded after the size class table
+            if (descriptor_table_hdr_->num_spill_buffers)
+            {
+                SpillFileEntry* spill_file_entry = reinterpret_cast<SpillFileEntry*>(
+                        reinterpret_cast<SizeClassEntry*>(descriptors_ + descriptor_table_hdr_->num_descriptors) +
+                        descriptor_table_hdr_->num_size_classes);
+                if (spill_file_entry->buffer_size != size_classes_[0].buffer_size)
+                {
+                    throw SharedBufferManagerException("Shared buffer manager has an invalid spill file entry");
+                }
+                spill_file_path_ = std::string(spill_file_entry->path,
+                        strnlen(spill_file_entry->path, sizeof(spill_file_entry->path)));
+                num_spill_buffers_ = spill_file_entry->num_buffers;
+                map_spill_file(false);
+                num_buffers_ += num_spill_buffers_;
+            }
+        }
+    }
+
+    // Map the frame rings if the region has a valid ring area following the buffers and descriptor table
+    size_t ring_area_offset = get_ring_area_offset();
+    if (shared_mem_size_ >= ring_area_offset + sizeof(RingAreaHeader))
+    {
+        RingAreaHeader* ring_area_hdr = reinterpret_cast<RingAreaHeader*>(region_addr_ + ring_area_offset);
+        if ((ring_area_hdr->magic == ring_area_magic) && (shared_mem_size_ >= ring_area_offset +
+                get_ring_area_size(ring_area_hdr->num_ready_rings, ring_area_hdr->ring_capacity)))
+        {
+            ring_area_hdr_ = ring_area_hdr;
+            map_frame_rings(false);
+        }
+    }
 
-}
-catch (interprocess_exception& e)
-{
-    // Catch, transform and rethrow any exceptions thrown during the member initializer list
-    std::stringstream ss;
-    ss << "Failed to map existing shared buffer manager: " << e.what();
-    throw (SharedBufferManagerException(ss.str()));
 }
 
 SharedBufferManager::~SharedBufferManager()
 {
-    if (remove_when_deleted_)
+    if (locked_)
     {
-        shared_memory_object::remove(shared_mem_name_.c_str());
+        munlock(region_addr_, region_size_);
     }
+    release_region();
 }
 
 const size_t SharedBufferManager::get_manager_id(void) const
@@ -88,7 +395,7 @@ const size_t SharedBufferManager::get_manager_id(void) const
 }
 const size_t SharedBufferManager::get_num_buffers(void) const
 {
-    return manager_hdr_->num_buffers;
+    return num_buffers_;
 }
 
 const size_t SharedBufferManager::get_buffer_size(void) const
@@ -96,15 +403,800 @@ const size_t SharedBufferManager::get_buffer_size(void) const
     return manager_hdr_->buffer_size;
 }
 
+//! Return the size of a buffer, which depends on its size class.
+//!
+//! \param buffer - index of the buffer
+//! \return buffer size in bytes
+
+const size_t SharedBufferManager::get_buffer_size(const unsigned int buffer) const
+{
+    return size_classes_[get_size_class(buffer)].buffer_size;
+}
+
 void* SharedBufferManager::get_buffer_address(const unsigned int buffer) const
 {
-    if (buffer >= manager_hdr_->num_buffers)
+    if (is_spill_buffer(buffer))
+    {
+        return reinterpret_cast<void *>(spill_region_addr_ +
+                (buffer - (num_buffers_ - num_spill_buffers_)) * size_classes_[0].buffer_size);
+    }
+
+    const SizeClass& size_class = size_classes_[get_size_class(buffer)];
+    return reinterpret_cast<void *>(region_addr_ + size_class.offset +
+            (buffer - size_class.first_buffer) * size_class.buffer_size);
+}
+
+//! Return the number of buffer size classes in the region.
+//!
+//! \return number of size classes, one if all buffers are the same size
+
+const unsigned int SharedBufferManager::get_num_size_classes(void) const
+{
+    return size_classes_.size();
+}
+
+//! Return the size class of a buffer.
+//!
+//! Spill buffers are full size and so belong to the first class.
+//!
+//! \param buffer - index of the buffer
+//! \return size class index, zero being the largest buffers
+
+const unsigned int SharedBufferManager::get_size_class(const unsigned int buffer) const
+{
+    if (buffer >= num_buffers_)
     {
         std::stringstream ss;
         ss << "Illegal buffer index specified: " << buffer;
         throw SharedBufferManagerException(ss.str());
     }
-    return reinterpret_cast<void *>(((char*)shared_mem_region_.get_address() + sizeof(Header)) + buffer * manager_hdr_->buffer_size);
+    if (buffer >= num_buffers_ - num_spill_buffers_)
+    {
+        return 0;
+    }
+
+    unsigned int class_idx = 0;
+    while (buffer >= size_classes_[class_idx].first_buffer + size_classes_[class_idx].num_buffers)
+    {
+        class_idx++;
+    }
+    return class_idx;
+}
+
+//! Return the size of the buffers in a size class.
+//!
+//! \param size_class - size class index
+//! \return buffer size in bytes
+
+const size_t SharedBufferManager::get_size_class_buffer_size(const unsigned int size_class) const
+{
+    if (size_class >= size_classes_.size())
+    {
+        std::stringstream ss;
+        ss << "Illegal buffer size class specified: " << size_class;
+        throw SharedBufferManagerException(ss.str());
+    }
+    return size_classes_[size_class].buffer_size;
+}
+
+//! Return the number of buffers in a size class.
+//!
+//! \param size_class - size class index
+//! \return number of buffers
+
+const size_t SharedBufferManager::get_size_class_num_buffers(const unsigned int size_class) const
+{
+    if (size_class >= size_classes_.size())
+    {
+        std::stringstream ss;
+        ss << "Illegal buffer size class specified: " << size_class;
+        throw SharedBufferManagerException(ss.str());
+    }
+    return size_classes_[size_class].num_buffers;
+}
+
+//! Find the size class with the smallest buffers able to hold a frame.
+//!
+//! \param frame_size - size of the frame in bytes
+//! \return size class index
+
+const unsigned int SharedBufferManager::find_size_class(const size_t frame_size) const
+{
+    if (frame_size > size_classes_[0].buffer_size)
+    {
+        std::stringstream ss;
+        ss << "Frame size " << frame_size << " exceeds the largest buffer size of " << size_classes_[0].buffer_size;
+        throw SharedBufferManagerException(ss.str());
+    }
+
+    unsigned int class_idx = size_classes_.size() - 1;
+    while (size_classes_[class_idx].buffer_size < frame_size)
+    {
+        class_idx--;
+    }
+    return class_idx;
+}
+
+//! Return the page size of the memory backing the shared memory region.
+//!
+//! \return page size in bytes
+
+const size_t SharedBufferManager::get_page_size(void) const
+{
+    return page_size_;
+}
+
+//! Indicate if the region has spill buffers in a memory-mapped file.
+//!
+//! \return true if there are spill buffers
+
+const bool SharedBufferManager::has_spill_buffers(void) const
+{
+    return (num_spill_buffers_ > 0);
+}
+
+//! Return the number of spill buffers, which are included in the total number of buffers.
+//!
+//! \return number of spill buffers
+
+const size_t SharedBufferManager::get_num_spill_buffers(void) const
+{
+    return num_spill_buffers_;
+}
+
+//! Indicate if a buffer is a spill buffer rather than in memory.
+//!
+//! \param buffer - index of the buffer
+//! \return true if the buffer is in the spill file
+
+const bool SharedBufferManager::is_spill_buffer(const unsigned int buffer) const
+{
+    return (buffer >= num_buffers_ - num_spill_buffers_) && (buffer < num_buffers_);
+}
+
+//! Return the path of the spill file.
+//!
+//! \return spill file path, empty if there are no spill buffers
+
+const std::string& SharedBufferManager::get_spill_file_path(void) const
+{
+    return spill_file_path_;
+}
+
+//! Indicate if the shared memory region is backed by huge pages.
+//!
+//! \return true if the region is a huge page file
+
+const bool SharedBufferManager::is_huge_page_backed(void) const
+{
+    return (huge_page_region_ != 0);
+}
+
+//! Return the stride of buffers in a huge page backed region.
+//!
+//! Buffers larger than a page are padded to a whole number of pages. Smaller buffers are padded
+//! to the next power of two, which divides the page size, so that no buffer spans more pages
+//! than necessary.
+//!
+//! \param buffer_size - requested buffer size in bytes
+//! \param page_size - huge page size in bytes
+//! \return buffer stride in bytes
+
+size_t SharedBufferManager::get_huge_page_buffer_stride(size_t buffer_size, size_t page_size)
+{
+    if (buffer_size >= page_size)
+    {
+        return ((buffer_size + page_size - 1) / page_size) * page_size;
+    }
+
+    size_t buffer_stride = 1;
+    while (buffer_stride < buffer_size)
+    {
+        buffer_stride <<= 1;
+    }
+    return buffer_stride;
+}
+
+//! Apply a NUMA memory policy to the shared memory region.
+//!
+//! The whole region, including the frame rings, is bound to or interleaved across the specified
+//! nodes. Pages already touched by this process are moved to conform to the policy.
+//!
+//! \param policy - NUMA memory policy
+//! \param nodes - NUMA nodes to apply the policy across
+
+void SharedBufferManager::bind_numa_policy(Defaults::NumaPolicy policy, const std::vector<int>& nodes)
+{
+    try
+    {
+        NumaBinding::bind_memory(region_addr_, region_size_, policy, nodes);
+    }
+    catch (FrameReceiverException& e)
+    {
+        throw SharedBufferManagerException(e.what());
+    }
+}
+
+//! Prefault the pages of the shared memory region, optionally locking them into memory.
+//!
+//! Every page of the region is touched, so that page faults are taken at startup rather than
+//! by the receive path as frames first arrive. The region is divided between the specified
+//! number of threads, which touch their pages in parallel. Pages are touched with an atomic
+//! no-op so that the contents of the region, e.g. the frame rings, are preserved. Any NUMA
+//! policy should be applied before prefaulting, so that pages are placed accordingly.
+//!
+//! \param num_threads - number of threads to touch pages with
+//! \param lock - lock the region into memory so its pages cannot be swapped out
+
+void SharedBufferManager::prefault(unsigned int num_threads, bool lock)
+{
+    size_t num_pages = (region_size_ + page_size_ - 1) / page_size_;
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+    if (num_threads > num_pages)
+    {
+        num_threads = num_pages;
+    }
+
+    // Touch the pages in parallel, each thread taking a contiguous range of pages
+    boost::thread_group prefault_threads;
+    size_t pages_per_thread = num_pages / num_threads;
+    size_t extra_pages = num_pages % num_threads;
+    char* start = region_addr_;
+    for (unsigned int thread_idx = 0; thread_idx < num_threads; thread_idx++)
+    {
+        size_t thread_pages = pages_per_thread + ((thread_idx < extra_pages) ? 1 : 0);
+        char* end = std::min(start + (thread_pages * page_size_), region_addr_ + region_size_);
+        prefault_threads.create_thread(boost::bind(&SharedBufferManager::prefault_pages, start, end, page_size_));
+        start = end;
+    }
+    prefault_threads.join_all();
+
+    if (lock && !locked_)
+    {
+        if (mlock(region_addr_, region_size_) != 0)
+        {
+            std::stringstream ss;
+            ss << "Failed to lock " << region_size_ << " bytes of shared memory: " << strerror(errno)
+                    << " (is RLIMIT_MEMLOCK large enough?)";
+            throw SharedBufferManagerException(ss.str());
+        }
+        locked_ = true;
+    }
+}
+
+//! Indicate if the shared memory region is locked into memory.
+//!
+//! \return true if the region has been locked by prefault()
+
+const bool SharedBufferManager::is_locked(void) const
+{
+    return locked_;
+}
+
+//! Indicate if the shared memory region holds a buffer descriptor table.
+//!
+//! Regions created by other clients, e.g. the Python tools, may not.
+//!
+//! \return true if the descriptor table is present
+
+const bool SharedBufferManager::has_buffer_descriptors(void) const
+{
+    return (descriptors_ != 0);
+}
+
+//! Reset every buffer descriptor to free.
+//!
+//! This is used to precharge the region, marking all buffers as available to the frame decoders.
+//! The generation counters and size classes are preserved.
+
+void SharedBufferManager::reset_buffer_descriptors(void)
+{
+    if (!descriptors_)
+    {
+        return;
+    }
+    for (size_t buffer = 0; buffer < num_buffers_; buffer++)
+    {
+        descriptors_[buffer].frame_number = 0;
+        descriptors_[buffer].owner = 0;
+        __atomic_store_n(&(descriptors_[buffer].ref_count), 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&(descriptors_[buffer].state), static_cast<uint32_t>(BufferStateFree), __ATOMIC_RELEASE);
+    }
+}
+
+//! Set the state of a buffer, recording the calling process as its owner.
+//!
+//! A buffer entering the filling state has its generation counter incremented, so that stale
+//! references to an earlier frame in the buffer can be detected. This does nothing if the region
+//! has no descriptor table.
+//!
+//! \param buffer - index of the buffer
+//! \param state - new state of the buffer
+//! \param frame_number - number of the frame held in the buffer
+
+void SharedBufferManager::set_buffer_state(const unsigned int buffer, BufferState state, uint32_t frame_number)
+{
+    if (!descriptors_)
+    {
+        return;
+    }
+    BufferDescriptor* descriptor = get_descriptor(buffer);
+    descriptor->frame_number = frame_number;
+    descriptor->owner = (state == BufferStateFree) ? 0 : static_cast<uint32_t>(getpid());
+    if (state == BufferStateFilling)
+    {
+        descriptor->generation++;
+    }
+    __atomic_store_n(&(descriptor->state), static_cast<uint32_t>(state), __ATOMIC_RELEASE);
+}
+
+//! Atomically claim a buffer by changing its state, if it is in the expected state.
+//!
+//! This allows several processes to arbitrate for buffers, e.g. consumers claiming ready buffers.
+//! The calling process is recorded as the owner of a claimed buffer.
+//!
+//! \param buffer - index of the buffer
+//! \param from_state - state the buffer must be in to be claimed
+//! \param to_state - new state of the claimed buffer
+//! \return true if the buffer was claimed, false if not in the expected state or there is no descriptor table
+
+bool SharedBufferManager::claim_buffer(const unsigned int buffer, BufferState from_state, BufferState to_state)
+{
+    if (!descriptors_)
+    {
+        return false;
+    }
+    BufferDescriptor* descriptor = get_descriptor(buffer);
+    uint32_t expected = from_state;
+    if (!__atomic_compare_exchange_n(&(descriptor->state), &expected, static_cast<uint32_t>(to_state), false,
+            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+    descriptor->owner = (to_state == BufferStateFree) ? 0 : static_cast<uint32_t>(getpid());
+    return true;
+}
+
+//! Take a snapshot of a buffer descriptor.
+//!
+//! \param buffer - index of the buffer
+//! \param descriptor - set to a copy of the descriptor
+//! \return true if the descriptor was copied, false if the region has no descriptor table
+
+bool SharedBufferManager::get_buffer_descriptor(const unsigned int buffer, BufferDescriptor& descriptor) const
+{
+    if (!descriptors_)
+    {
+        return false;
+    }
+    BufferDescriptor* shared_descriptor = get_descriptor(buffer);
+    descriptor.state = __atomic_load_n(&(shared_descriptor->state), __ATOMIC_ACQUIRE);
+    descriptor.frame_number = shared_descriptor->frame_number;
+    descriptor.owner = shared_descriptor->owner;
+    descriptor.generation = shared_descriptor->generation;
+    descriptor.ref_count = __atomic_load_n(&(shared_descriptor->ref_count), __ATOMIC_ACQUIRE);
+    descriptor.size_class = shared_descriptor->size_class;
+    return true;
+}
+
+//! Take a snapshot of the number of buffers in each state.
+//!
+//! \param state_counts - filled with the number of buffers in each state, indexed by BufferState,
+//!                        all zero if the region has no descriptor table
+
+void SharedBufferManager::get_buffer_occupancy(std::vector<size_t>& state_counts) const
+{
+    state_counts.assign(NumBufferStates, 0);
+    if (!descriptors_)
+    {
+        return;
+    }
+    for (size_t buffer = 0; buffer < num_buffers_; buffer++)
+    {
+        uint32_t state = __atomic_load_n(&(descriptors_[buffer].state), __ATOMIC_ACQUIRE);
+        if (state < NumBufferStates)
+        {
+            state_counts[state]++;
+        }
+    }
+}
+
+//! Set the number of references held on the frame in a buffer.
+//!
+//! This is called when a frame becomes ready, with the number of consumers it is notified to, so
+//! that the buffer is only freed once every consumer has released it. This does nothing if the
+//! region has no descriptor table.
+//!
+//! \param buffer - index of the buffer
+//! \param references - number of consumers holding the frame
+
+void SharedBufferManager::set_buffer_references(const unsigned int buffer, uint32_t references)
+{
+    if (!descriptors_)
+    {
+        return;
+    }
+    __atomic_store_n(&(get_descriptor(buffer)->ref_count), references, __ATOMIC_RELEASE);
+}
+
+//! Release a reference held on the frame in a buffer.
+//!
+//! The reference count is decremented atomically, so references may be released by any process
+//! mapping the region. A buffer with no references is left unchanged.
+//!
+//! \param buffer - index of the buffer
+//! \return number of references remaining, zero when the buffer can be freed or if the region
+//!          has no descriptor table
+
+uint32_t SharedBufferManager::release_buffer_reference(const unsigned int buffer)
+{
+    if (!descriptors_)
+    {
+        return 0;
+    }
+    uint32_t* ref_count = &(get_descriptor(buffer)->ref_count);
+    uint32_t references = __atomic_load_n(ref_count, __ATOMIC_ACQUIRE);
+    while (references > 0)
+    {
+        if (__atomic_compare_exchange_n(ref_count, &references, references - 1, false,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            return references - 1;
+        }
+    }
+    return 0;
+}
+
+//! Indicate if the shared memory region holds frame rings.
+//!
+//! \return true if the frame rings are present
+
+const bool SharedBufferManager::has_frame_rings(void) const
+{
+    return (ring_area_hdr_ != 0);
+}
+
+//! Return the number of frame ready rings in the shared memory region.
+//!
+//! \return number of ready rings, zero if the region has no frame rings
+
+const unsigned int SharedBufferManager::get_num_ready_rings(void) const
+{
+    return ready_rings_.size();
+}
+
+//! Return a frame ready ring, onto which a producer pushes descriptors of frames ready for processing.
+//!
+//! \param ring_idx - index of the ready ring
+//! \return pointer to the ready ring
+
+SharedFrameRingPtr SharedBufferManager::get_ready_ring(const unsigned int ring_idx) const
+{
+    if (ring_idx >= ready_rings_.size())
+    {
+        std::stringstream ss;
+        ss << "Illegal frame ready ring index specified: " << ring_idx;
+        throw SharedBufferManagerException(ss.str());
+    }
+    return ready_rings_[ring_idx];
+}
+
+//! Return the frame release ring, onto which the consumer pushes descriptors of released buffers.
+//!
+//! \return pointer to the release ring, empty if the region has no frame rings
+
+SharedFrameRingPtr SharedBufferManager::get_release_ring(void) const
+{
+    return release_ring_;
+}
+
+//! Return the event signalled by producers after pushing onto a ready ring.
+//!
+//! \return pointer to the ready event, empty if the region has no frame rings
+
+SharedFrameEventPtr SharedBufferManager::get_ready_event(void) const
+{
+    return ready_event_;
+}
+
+//! Return the offset of the buffer descriptor table from the start of the shared memory region.
+//!
+//! \return offset in bytes
+
+const size_t SharedBufferManager::get_descriptor_table_offset(void) const
+{
+    return align_area(sizeof(Header) + (manager_hdr_->num_buffers * manager_hdr_->buffer_size));
+}
+
+//! Return the size of the buffer descriptor table, including the size class table and spill file
+//! entry following it.
+//!
+//! \param num_buffers - number of buffers in the region, including spill buffers
+//! \param num_size_classes - number of buffer size classes in the region
+//! \param spill_file - the region has a spill file
+//! \return size in bytes
+
+size_t SharedBufferManager::get_descriptor_table_size(size_t num_buffers, size_t num_size_classes, bool spill_file)
+{
+    return sizeof(DescriptorTableHeader) + (num_buffers * sizeof(BufferDescriptor)) +
+            (num_size_classes * sizeof(SizeClassEntry)) + (spill_file ? sizeof(SpillFileEntry) : 0);
+}
+
+//! Map the size classes recorded in the size class table following the buffer descriptors.
+//!
+//! Regions with a single size class are left as described by the header.
+
+void SharedBufferManager::map_size_classes(void)
+{
+    if (descriptor_table_hdr_->num_size_classes <= 1)
+    {
+        return;
+    }
+
+    SizeClassEntry* size_class_table =
+            reinterpret_cast<SizeClassEntry*>(descriptors_ + descriptor_table_hdr_->num_descriptors);
+    std::vector<SizeClass> size_classes;
+    size_t num_buffers = 0;
+    for (size_t class_idx = 0; class_idx < descriptor_table_hdr_->num_size_classes; class_idx++)
+    {
+        SizeClass size_class;
+        size_class.buffer_size = size_class_table[class_idx].buffer_size;
+        size_class.num_buffers = size_class_table[class_idx].num_buffers;
+        size_class.first_buffer = size_class_table[class_idx].first_buffer;
+        size_class.offset = size_class_table[class_idx].offset;
+        if ((size_class.first_buffer != num_buffers) ||
+            (size_class.offset + (size_class.num_buffers * size_class.buffer_size) > shared_mem_size_))
+        {
+            throw SharedBufferManagerException("Shared buffer manager has an invalid size class table");
+        }
+        size_classes.push_back(size_class);
+        num_buffers += size_class.num_buffers;
+    }
+    if (num_buffers + descriptor_table_hdr_->num_spill_buffers != descriptor_table_hdr_->num_descriptors)
+    {
+        throw SharedBufferManagerException("Shared buffer manager has an invalid size class table");
+    }
+
+    size_classes_.swap(size_classes);
+    num_buffers_ = num_buffers;
+}
+
+//! Return the descriptor of a buffer.
+//!
+//! \param buffer - index of the buffer
+//! \return pointer to the descriptor
+
+BufferDescriptor* SharedBufferManager::get_descriptor(const unsigned int buffer) const
+{
+    if (buffer >= num_buffers_)
+    {
+        std::stringstream ss;
+        ss << "Illegal buffer index specified: " << buffer;
+        throw SharedBufferManagerException(ss.str());
+    }
+    return &descriptors_[buffer];
+}
+
+//! Return the offset of the frame ring area from the start of the shared memory region.
+//!
+//! The ring area follows the buffer descriptor table if present, otherwise the buffers.
+//!
+//! \return offset in bytes
+
+const size_t SharedBufferManager::get_ring_area_offset(void) const
+{
+    size_t descriptor_table_offset = get_descriptor_table_offset();
+    if (descriptor_table_hdr_)
+    {
+        return align_area(descriptor_table_offset + get_descriptor_table_size(
+                descriptor_table_hdr_->num_descriptors, descriptor_table_hdr_->num_size_classes,
+                descriptor_table_hdr_->num_spill_buffers > 0));
+    }
+    return descriptor_table_offset;
+}
+
+//! Return the size of the frame ring area.
+//!
+//! The area comprises the ring area header, the ready event and the ready and release rings.
+//!
+//! \param num_ready_rings - number of ready rings
+//! \param ring_capacity - capacity of each ring
+//! \return size in bytes
+
+size_t SharedBufferManager::get_ring_area_size(unsigned int num_ready_rings, size_t ring_capacity)
+{
+    return sizeof(RingAreaHeader) + align_area(SharedFrameEvent::get_required_size()) +
+            ((num_ready_rings + 1) * align_area(SharedFrameRing::get_required_size(ring_capacity)));
+}
+
+//! Map the ready event and frame rings onto the ring area.
+//!
+//! \param initialise - initialise the event and rings, as done by the creator of the region
+
+void SharedBufferManager::map_frame_rings(bool initialise)
+{
+    char* addr = reinterpret_cast<char*>(ring_area_hdr_) + sizeof(RingAreaHeader);
+    size_t ring_capacity = ring_area_hdr_->ring_capacity;
+    size_t ring_size = align_area(SharedFrameRing::get_required_size(ring_capacity));
+
+    ready_event_.reset(new SharedFrameEvent(addr, initialise));
+    addr += align_area(SharedFrameEvent::get_required_size());
+
+    for (unsigned int ring_idx = 0; ring_idx < ring_area_hdr_->num_ready_rings; ring_idx++)
+    {
+        ready_rings_.push_back(SharedFrameRingPtr(new SharedFrameRing(addr, ring_capacity, initialise)));
+        addr += ring_size;
+    }
+
+    release_ring_.reset(new SharedFrameRing(addr, ring_capacity, initialise));
+}
+
+//! Open the huge page file backing the shared memory region.
+//!
+//! The file must be in a hugetlbfs mount, whose block size gives the huge page size.
+//!
+//! \param flags - open flags
+//! \return file descriptor of the huge page file
+
+int SharedBufferManager::open_huge_page_file(int flags)
+{
+    bool created = (flags & O_CREAT) && (access(huge_page_path_.c_str(), F_OK) != 0);
+    int huge_page_fd = open(huge_page_path_.c_str(), flags, 0666);
+    if (huge_page_fd < 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to open huge page file " << huge_page_path_ << ": " << strerror(errno);
+        throw SharedBufferManagerException(ss.str());
+    }
+
+#ifdef __linux__
+    struct statfs huge_page_fs;
+    if ((fstatfs(huge_page_fd, &huge_page_fs) != 0) || (huge_page_fs.f_type != HUGETLBFS_MAGIC))
+    {
+        close(huge_page_fd);
+        if (created)
+        {
+            unlink(huge_page_path_.c_str());
+        }
+        std::stringstream ss;
+        ss << "Huge page file " << huge_page_path_ << " is not in a hugetlbfs mount";
+        throw SharedBufferManagerException(ss.str());
+    }
+    page_size_ = huge_page_fs.f_bsize;
+#endif
+
+    return huge_page_fd;
+}
+
+//! Map the huge page file backing the shared memory region, closing the file descriptor.
+//!
+//! \param fd - file descriptor of the huge page file
+//! \param region_size - size of the region to map, which must be a multiple of the page size
+
+void SharedBufferManager::map_huge_page_file(int fd, size_t region_size)
+{
+    if ((ftruncate(fd, region_size) != 0) ||
+        ((huge_page_region_ = mmap(0, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED))
+    {
+        huge_page_region_ = 0;
+        int map_errno = errno;
+        close(fd);
+        std::stringstream ss;
+        ss << "Failed to map " << region_size << " bytes of huge page file " << huge_page_path_ << ": "
+                << strerror(map_errno) << " (are enough huge pages reserved?)";
+        throw SharedBufferManagerException(ss.str());
+    }
+    close(fd);
+
+    region_addr_ = reinterpret_cast<char*>(huge_page_region_);
+    region_size_ = region_size;
+}
+
+//! Remove the huge page file backing the shared memory region if the manager owns it.
+
+void SharedBufferManager::remove_huge_page_file(void)
+{
+    if (remove_when_deleted_ && !huge_page_path_.empty())
+    {
+        unlink(huge_page_path_.c_str());
+    }
+}
+
+//! Unmap the region and any spill file, removing the files or shared memory object if the manager owns them.
+
+void SharedBufferManager::release_region(void)
+{
+    if (spill_region_addr_)
+    {
+        munmap(spill_region_addr_, spill_region_size_);
+        spill_region_addr_ = 0;
+        if (remove_when_deleted_)
+        {
+            unlink(spill_file_path_.c_str());
+        }
+    }
+    if (huge_page_region_)
+    {
+        munmap(huge_page_region_, region_size_);
+        huge_page_region_ = 0;
+    }
+    if (!huge_page_path_.empty())
+    {
+        remove_huge_page_file();
+    }
+    else if (remove_when_deleted_)
+    {
+        shared_memory_object::remove(shared_mem_name_.c_str());
+    }
+}
+
+//! Close the huge page file descriptor of a region being created, if open, and remove the file.
+//!
+//! This is used to clean up when creating the region fails before the file is mapped.
+//!
+//! \param fd - file descriptor of the huge page file, or -1 if no file is open
+
+void SharedBufferManager::discard_huge_page_file(int fd)
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        remove_huge_page_file();
+    }
+}
+
+//! Map the spill file holding the spill buffers.
+//!
+//! \param create - create the file, or resize an existing one, rather than map an existing file
+
+void SharedBufferManager::map_spill_file(bool create)
+{
+    spill_region_size_ = num_spill_buffers_ * size_classes_[0].buffer_size;
+
+    int spill_fd = open(spill_file_path_.c_str(), create ? (O_RDWR | O_CREAT) : O_RDWR, 0666);
+    if (spill_fd < 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to open spill file " << spill_file_path_ << ": " << strerror(errno);
+        throw SharedBufferManagerException(ss.str());
+    }
+
+    struct stat spill_stat;
+    void* spill_region = MAP_FAILED;
+    if ((!create || (ftruncate(spill_fd, spill_region_size_) == 0)) && (fstat(spill_fd, &spill_stat) == 0) &&
+        (static_cast<size_t>(spill_stat.st_size) >= spill_region_size_))
+    {
+        spill_region = mmap(0, spill_region_size_, PROT_READ | PROT_WRITE, MAP_SHARED, spill_fd, 0);
+    }
+    if (spill_region == MAP_FAILED)
+    {
+        int map_errno = errno;
+        close(spill_fd);
+        std::stringstream ss;
+        ss << "Failed to map " << spill_region_size_ << " bytes of spill file " << spill_file_path_ << ": "
+                << strerror(map_errno);
+        throw SharedBufferManagerException(ss.str());
+    }
+    close(spill_fd);
+
+    spill_region_addr_ = reinterpret_cast<char*>(spill_region);
+}
+
+//! Touch each page of part of the shared memory region, taking any page fault.
+//!
+//! \param start - start address of the part of the region
+//! \param end - end address of the part of the region
+//! \param page_size - page size of the region
+
+void SharedBufferManager::prefault_pages(char* start, char* end, size_t page_size)
+{
+    for (char* page = start; page < end; page += page_size)
+    {
+        __atomic_fetch_or(page, 0, __ATOMIC_RELAXED);
+    }
 }
 
 size_t SharedBufferManager::last_manager_id = 0;
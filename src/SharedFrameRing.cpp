@@ -0,0 +1,221 @@
+/*!
+ * SharedFrameRing.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include "SharedFrameRing.h"
+#include "FrameReceiverException.h"
+
+#include <sstream>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace FrameReceiver;
+
+//! Constructor for SharedFrameRing class.
+//!
+//! The ring is mapped onto memory of at least get_required_size(capacity) bytes, which should be
+//! cache-line aligned. The creator of the memory initialises the ring, while processes attaching
+//! to an existing ring must not.
+//!
+//! \param ring_address - address of the memory holding the ring
+//! \param capacity - number of descriptors in the ring, which must be a power of two
+//! \param initialise - initialise the ring indices and capacity
+
+SharedFrameRing::SharedFrameRing(void* ring_address, size_t capacity, bool initialise) :
+    header_(reinterpret_cast<RingHeader*>(ring_address)),
+    descriptors_(reinterpret_cast<FrameDescriptor*>(reinterpret_cast<uint8_t*>(ring_address) + sizeof(RingHeader))),
+    mask_(capacity - 1)
+{
+    if ((capacity == 0) || (capacity & (capacity - 1)))
+    {
+        std::stringstream ss;
+        ss << "Shared frame ring capacity must be a non-zero power of two: " << capacity;
+        throw FrameReceiverException(ss.str());
+    }
+
+    if (initialise)
+    {
+        memset(header_, 0, sizeof(RingHeader));
+        header_->capacity = capacity;
+    }
+    else if (header_->capacity != capacity)
+    {
+        std::stringstream ss;
+        ss << "Shared frame ring capacity " << header_->capacity << " does not match expected capacity " << capacity;
+        throw FrameReceiverException(ss.str());
+    }
+}
+
+//! Return the size of memory required for a ring of the specified capacity.
+//!
+//! \param capacity - number of descriptors in the ring
+//! \return size in bytes
+
+size_t SharedFrameRing::get_required_size(size_t capacity)
+{
+    return sizeof(RingHeader) + (capacity * sizeof(FrameDescriptor));
+}
+
+//! Push a descriptor onto the ring. Must only be called by the producer.
+//!
+//! \param descriptor - descriptor to push
+//! \return true if the descriptor was pushed, false if the ring is full
+
+bool SharedFrameRing::push(const FrameDescriptor& descriptor)
+{
+    uint64_t head = header_->head;
+    uint64_t tail = __atomic_load_n(&(header_->tail), __ATOMIC_ACQUIRE);
+    if ((head - tail) > mask_)
+    {
+        return false;
+    }
+
+    descriptors_[head & mask_] = descriptor;
+    __atomic_store_n(&(header_->head), head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+//! Pop a descriptor from the ring. Must only be called by the consumer.
+//!
+//! \param descriptor - set to the descriptor popped
+//! \return true if a descriptor was popped, false if the ring is empty
+
+bool SharedFrameRing::pop(FrameDescriptor& descriptor)
+{
+    uint64_t tail = header_->tail;
+    uint64_t head = __atomic_load_n(&(header_->head), __ATOMIC_ACQUIRE);
+    if (head == tail)
+    {
+        return false;
+    }
+
+    descriptor = descriptors_[tail & mask_];
+    __atomic_store_n(&(header_->tail), tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+//! Return the number of descriptors the ring can hold.
+//!
+//! \return ring capacity
+
+const size_t SharedFrameRing::get_capacity(void) const
+{
+    return mask_ + 1;
+}
+
+//! Return the number of descriptors currently in the ring.
+//!
+//! \return number of descriptors
+
+const size_t SharedFrameRing::get_size(void) const
+{
+    return __atomic_load_n(&(header_->head), __ATOMIC_ACQUIRE) - __atomic_load_n(&(header_->tail), __ATOMIC_ACQUIRE);
+}
+
+//! Return the total number of descriptors pushed onto the ring since it was created.
+//!
+//! \return number of descriptors pushed
+
+const uint64_t SharedFrameRing::get_num_pushed(void) const
+{
+    return __atomic_load_n(&(header_->head), __ATOMIC_ACQUIRE);
+}
+
+//! Return the total number of descriptors popped from the ring since it was created.
+//!
+//! \return number of descriptors popped
+
+const uint64_t SharedFrameRing::get_num_popped(void) const
+{
+    return __atomic_load_n(&(header_->tail), __ATOMIC_ACQUIRE);
+}
+
+//! Constructor for SharedFrameEvent class.
+//!
+//! \param event_address - address of the memory holding the event
+//! \param initialise - initialise the event sequence and waiter count
+
+SharedFrameEvent::SharedFrameEvent(void* event_address, bool initialise) :
+    header_(reinterpret_cast<EventHeader*>(event_address))
+{
+    if (initialise)
+    {
+        memset(header_, 0, sizeof(EventHeader));
+    }
+}
+
+//! Return the size of memory required for an event.
+//!
+//! \return size in bytes
+
+size_t SharedFrameEvent::get_required_size(void)
+{
+    return sizeof(EventHeader);
+}
+
+//! Signal the event, waking any waiting consumer.
+//!
+//! This is called by producers after pushing descriptors. The system call to wake the consumer
+//! is only made if a consumer is waiting.
+
+void SharedFrameEvent::signal(void)
+{
+    __atomic_add_fetch(&(header_->sequence), 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&(header_->waiters), __ATOMIC_SEQ_CST) > 0)
+    {
+#ifdef __linux__
+        syscall(SYS_futex, &(header_->sequence), FUTEX_WAKE, INT_MAX, 0, 0, 0);
+#endif
+    }
+}
+
+//! Return the current event sequence number.
+//!
+//! Consumers read the sequence number before checking their rings, and pass it to wait() if the
+//! rings were empty, so that a signal between the check and the wait is not missed.
+//!
+//! \return sequence number
+
+const uint32_t SharedFrameEvent::get_sequence(void) const
+{
+    return __atomic_load_n(&(header_->sequence), __ATOMIC_SEQ_CST);
+}
+
+//! Wait for the event to be signalled.
+//!
+//! \param sequence - sequence number read before the consumer last checked its rings
+//! \param timeout_ms - maximum time to wait in milliseconds
+//! \return true if the event has been signalled since the sequence number was read
+
+bool SharedFrameEvent::wait(uint32_t sequence, unsigned int timeout_ms)
+{
+    __atomic_add_fetch(&(header_->waiters), 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&(header_->sequence), __ATOMIC_SEQ_CST) == sequence)
+    {
+#ifdef __linux__
+        struct timespec timeout;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+        syscall(SYS_futex, &(header_->sequence), FUTEX_WAIT, sequence, &timeout, 0, 0);
+#else
+        usleep(1000);
+#endif
+    }
+
+    __atomic_sub_fetch(&(header_->waiters), 1, __ATOMIC_SEQ_CST);
+
+    return (__atomic_load_n(&(header_->sequence), __ATOMIC_SEQ_CST) != sequence);
+}
@@ -0,0 +1,275 @@
+/*
+ * FrameBufferPoolUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <vector>
+
+#include "FrameBufferPool.h"
+#include "FrameReceiverException.h"
+
+class FrameBufferPoolTestFixture
+{
+public:
+    FrameBufferPoolTestFixture() :
+        initialise_count(0)
+    {
+        initialiser = boost::bind(&FrameBufferPoolTestFixture::initialise_buffer, this, _1);
+    }
+
+    void* initialise_buffer(int buffer_id)
+    {
+        initialised_buffers.push_back(buffer_id);
+        __atomic_add_fetch(&initialise_count, 1, __ATOMIC_SEQ_CST);
+        return buffer_header(buffer_id);
+    }
+
+    // Dummy frame header address for a buffer, recorded in the frame table by the pool
+    void* buffer_header(int buffer_id)
+    {
+        return reinterpret_cast<void*>(0x1000 + (buffer_id * 0x100));
+    }
+
+    void assign_frames(std::vector<int>* assigned_buffers, uint32_t num_frames)
+    {
+        for (uint32_t frame = 0; frame < num_frames; frame++)
+        {
+            assigned_buffers->push_back(pool.get_frame_buffer(frame, initialiser));
+        }
+    }
+
+    FrameReceiver::FrameBufferPool pool;
+    FrameReceiver::FrameBufferInitialiser initialiser;
+    std::vector<int> initialised_buffers;
+    int initialise_count;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FrameBufferPoolUnitTest, FrameBufferPoolTestFixture);
+
+BOOST_AUTO_TEST_CASE( FrameBufferAssignment )
+{
+    pool.push_empty_buffer(3);
+    pool.push_empty_buffer(7);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 2);
+
+    // First lookup of a frame assigns and initialises the next empty buffer, subsequent
+    // lookups return the same buffer without initialising it again
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(100, initialiser), 3);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(100, initialiser), 3);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(101, initialiser), 7);
+    BOOST_CHECK_EQUAL(initialise_count, 2);
+    BOOST_CHECK_EQUAL(pool.get_num_mapped_buffers(), 2);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 0);
+
+    // No empty buffers left for a new frame
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(102, initialiser), -1);
+
+    std::vector<FrameReceiver::FrameBufferSlot> mapped_frames;
+    pool.get_mapped_frames(mapped_frames);
+    BOOST_CHECK_EQUAL(mapped_frames.size(), 2);
+
+    // The frame header address returned by the initialiser is recorded with the frame
+    void* frame_header = 0;
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(101, initialiser, &frame_header), 7);
+    BOOST_CHECK_EQUAL(frame_header, buffer_header(7));
+}
+
+BOOST_AUTO_TEST_CASE( FrameTableCollisions )
+{
+    for (int buffer = 0; buffer < 8; buffer++)
+    {
+        pool.push_empty_buffer(buffer);
+    }
+    uint32_t capacity = pool.get_frame_table_capacity();
+
+    // Frames whose numbers differ by the table capacity map to the same home slot, so are
+    // resolved by probing. Releasing one must not hide the others from subsequent lookups.
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1, initialiser), 0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1 + capacity, initialiser), 1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(2, initialiser), 2);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1 + (2 * capacity), initialiser), 3);
+
+    BOOST_CHECK(pool.release_frame_buffer(1));
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1 + capacity, initialiser), 1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(2, initialiser), 2);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1 + (2 * capacity), initialiser), 3);
+
+    BOOST_CHECK(pool.release_frame_buffer(1 + capacity));
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(2, initialiser), 2);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1 + (2 * capacity), initialiser), 3);
+    BOOST_CHECK_EQUAL(pool.get_num_mapped_buffers(), 2);
+    BOOST_CHECK_EQUAL(initialise_count, 4);
+}
+
+BOOST_AUTO_TEST_CASE( FrameTableSizing )
+{
+    // The table is sized once to at least twice the number of buffers
+    const int num_buffers = 1000;
+    pool.size_frame_table(num_buffers);
+    size_t capacity = pool.get_frame_table_capacity();
+    BOOST_CHECK(capacity >= (2 * num_buffers));
+    BOOST_CHECK_EQUAL((capacity & (capacity - 1)), 0);
+
+    // Adding and recycling buffers does not change the table
+    for (int buffer = 0; buffer < num_buffers; buffer++)
+    {
+        pool.push_empty_buffer(buffer);
+    }
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(42, initialiser), 0);
+    BOOST_CHECK(pool.release_frame_buffer(42));
+    pool.push_empty_buffer(0);
+    BOOST_CHECK_EQUAL(pool.get_frame_table_capacity(), capacity);
+
+    // The table cannot be resized while frames are in flight
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(43, initialiser), 1);
+    BOOST_CHECK_THROW(pool.size_frame_table(4 * num_buffers), FrameReceiver::FrameReceiverException);
+}
+
+BOOST_AUTO_TEST_CASE( FrameTableFull )
+{
+    // With more buffers than the default table holds, assignment stops short of filling the table
+    size_t capacity = pool.get_frame_table_capacity();
+    for (size_t buffer = 0; buffer < capacity; buffer++)
+    {
+        pool.push_empty_buffer(buffer);
+    }
+    for (uint32_t frame = 0; frame < (capacity - 1); frame++)
+    {
+        BOOST_CHECK_EQUAL(pool.get_frame_buffer(frame, initialiser), static_cast<int>(frame));
+    }
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(capacity, initialiser), -1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(0, initialiser), 0);
+}
+
+BOOST_AUTO_TEST_CASE( FrameBufferReleaseArbitration )
+{
+    pool.push_empty_buffer(0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(5, initialiser), 0);
+
+    // Only the first release of a frame succeeds
+    BOOST_CHECK(pool.release_frame_buffer(5));
+    BOOST_CHECK(!pool.release_frame_buffer(5));
+    BOOST_CHECK_EQUAL(pool.get_num_mapped_buffers(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( FrameBufferPoolSharing )
+{
+    BOOST_CHECK(!pool.is_shared());
+    pool.register_decoder();
+    BOOST_CHECK(!pool.is_shared());
+    pool.register_decoder();
+    BOOST_CHECK(pool.is_shared());
+}
+
+BOOST_AUTO_TEST_CASE( ConcurrentFrameBufferAssignment )
+{
+    const uint32_t num_frames = 1000;
+    for (uint32_t buffer = 0; buffer < num_frames; buffer++)
+    {
+        pool.push_empty_buffer(buffer);
+    }
+
+    // Two threads looking up the same frames must be given the same buffers, with each
+    // buffer initialised exactly once
+    std::vector<int> buffers_a, buffers_b;
+    boost::thread thread_a(boost::bind(&FrameBufferPoolTestFixture::assign_frames, this, &buffers_a, num_frames));
+    boost::thread thread_b(boost::bind(&FrameBufferPoolTestFixture::assign_frames, this, &buffers_b, num_frames));
+    thread_a.join();
+    thread_b.join();
+
+    BOOST_CHECK_EQUAL(initialise_count, num_frames);
+    BOOST_CHECK_EQUAL(pool.get_num_mapped_buffers(), num_frames);
+    BOOST_CHECK(buffers_a == buffers_b);
+}
+
+BOOST_AUTO_TEST_CASE( FrameBufferReleaseRing )
+{
+    std::vector<uint64_t> ring_memory(FrameReceiver::SharedFrameRing::get_required_size(4) / sizeof(uint64_t));
+    FrameReceiver::SharedFrameRingPtr release_ring(new FrameReceiver::SharedFrameRing(&ring_memory[0], 4, true));
+    pool.register_release_ring(release_ring);
+
+    pool.push_empty_buffer(0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(10, initialiser), 0);
+    BOOST_CHECK(pool.release_frame_buffer(10));
+
+    // With the queue empty, buffers released through the ring are drained when a frame needs one
+    FrameReceiver::FrameDescriptor descriptor = {};
+    descriptor.buffer_id = 0;
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(11, initialiser), -1);
+    BOOST_CHECK(release_ring->push(descriptor));
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(11, initialiser), 0);
+    BOOST_CHECK_EQUAL(release_ring->get_size(), 0);
+
+    // Released buffers can also be drained explicitly
+    descriptor.buffer_id = 1;
+    release_ring->push(descriptor);
+    descriptor.buffer_id = 2;
+    release_ring->push(descriptor);
+    BOOST_CHECK_EQUAL(pool.drain_release_ring(), 2);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 2);
+    BOOST_CHECK_EQUAL(pool.drain_release_ring(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( FrameBufferSizeClasses )
+{
+    // Buffers queued before the classes are registered are moved to the queue of their class
+    pool.push_empty_buffer(0);
+    pool.push_empty_buffer(2);
+    BOOST_CHECK_EQUAL(pool.get_num_size_classes(), 1);
+
+    std::vector<unsigned int> buffer_size_classes;
+    buffer_size_classes.push_back(0);
+    buffer_size_classes.push_back(0);
+    buffer_size_classes.push_back(1);
+    buffer_size_classes.push_back(1);
+    pool.register_size_classes(buffer_size_classes);
+    BOOST_REQUIRE_EQUAL(pool.get_num_size_classes(), 2);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(0), 1);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(1), 1);
+
+    pool.push_empty_buffer(1);
+    pool.push_empty_buffer(3);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 4);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(0), 2);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(1), 2);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(2), 0);
+
+    // Frames get buffers of the requested class, falling back to larger buffers but never smaller
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1, initialiser, 0, 1), 2);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(2, initialiser, 0, 1), 3);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(3, initialiser, 0, 1), 0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(4, initialiser, 0, 0), 1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(5, initialiser, 0, 0), -1);
+    BOOST_CHECK(pool.release_frame_buffer(2));
+    pool.push_empty_buffer(3);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(5, initialiser, 0, 0), -1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(5, initialiser, 0, 1), 3);
+}
+
+BOOST_AUTO_TEST_CASE( FrameBufferSpill )
+{
+    pool.push_empty_buffer(0);
+    pool.push_empty_buffer(4);
+    pool.register_spill_buffers(4);
+    pool.push_empty_buffer(5);
+    pool.push_empty_buffer(1);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 4);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_spill_buffers(), 2);
+
+    // Spill buffers are only assigned once the buffers in memory run out
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(1, initialiser), 0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(2, initialiser), 1);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(3, initialiser), 4);
+    pool.push_empty_buffer(0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(4, initialiser), 0);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(5, initialiser), 5);
+    BOOST_CHECK_EQUAL(pool.get_frame_buffer(6, initialiser), -1);
+    BOOST_CHECK_EQUAL(pool.get_num_empty_buffers(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
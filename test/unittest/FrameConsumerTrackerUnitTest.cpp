@@ -0,0 +1,123 @@
+/*
+ * FrameConsumerTrackerUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "FrameConsumerTracker.h"
+#include "FrameReceiverException.h"
+
+class FrameConsumerTrackerTestFixture
+{
+public:
+    FrameConsumerTrackerTestFixture() :
+        buffer_manager(new FrameReceiver::SharedBufferManager("TestConsumerTrackerBuffer", 1000, 100, true))
+    {
+    }
+
+    FrameReceiver::SharedBufferManagerPtr buffer_manager;
+    std::vector<int> free_buffers;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FrameConsumerTrackerUnitTest, FrameConsumerTrackerTestFixture);
+
+BOOST_AUTO_TEST_CASE( SingleConsumer )
+{
+    FrameReceiver::FrameConsumerTracker tracker(buffer_manager, 1);
+    BOOST_CHECK_EQUAL(tracker.get_num_consumers(), 1);
+
+    BOOST_CHECK_EQUAL(tracker.frame_ready(3, free_buffers), 0);
+    BOOST_CHECK(free_buffers.empty());
+    BOOST_CHECK_EQUAL(tracker.get_consumer_lag(0), 1);
+
+    // Releases of buffers not held, or from unknown consumers, are ignored
+    BOOST_CHECK(!tracker.frame_released(4, 0, free_buffers));
+    BOOST_CHECK(!tracker.frame_released(3, 1, free_buffers));
+    BOOST_CHECK(free_buffers.empty());
+
+    BOOST_CHECK(tracker.frame_released(3, 0, free_buffers));
+    BOOST_REQUIRE_EQUAL(free_buffers.size(), 1);
+    BOOST_CHECK_EQUAL(free_buffers[0], 3);
+    BOOST_CHECK_EQUAL(tracker.get_consumer_lag(0), 0);
+    BOOST_CHECK_EQUAL(tracker.get_consumer_releases(0), 1);
+    BOOST_CHECK(!tracker.frame_released(3, 0, free_buffers));
+}
+
+BOOST_AUTO_TEST_CASE( BufferFreedByLastConsumer )
+{
+    FrameReceiver::FrameConsumerTracker tracker(buffer_manager, 3);
+    tracker.frame_ready(5, free_buffers);
+
+    FrameReceiver::BufferDescriptor descriptor;
+    BOOST_REQUIRE(buffer_manager->get_buffer_descriptor(5, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.ref_count, 3);
+
+    BOOST_CHECK(tracker.frame_released(5, 2, free_buffers));
+    BOOST_CHECK(tracker.frame_released(5, 0, free_buffers));
+    BOOST_CHECK(free_buffers.empty());
+    BOOST_REQUIRE(buffer_manager->get_buffer_descriptor(5, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.ref_count, 1);
+
+    BOOST_CHECK(tracker.frame_released(5, 1, free_buffers));
+    BOOST_REQUIRE_EQUAL(free_buffers.size(), 1);
+    BOOST_CHECK_EQUAL(free_buffers[0], 5);
+}
+
+BOOST_AUTO_TEST_CASE( SlowConsumerDropped )
+{
+    FrameReceiver::FrameConsumerTracker tracker(buffer_manager, 2, 2);
+
+    // Consumer 0 keeps up while consumer 1 releases nothing
+    for (int buffer_id = 0; buffer_id < 2; buffer_id++)
+    {
+        BOOST_CHECK_EQUAL(tracker.frame_ready(buffer_id, free_buffers), 0);
+        BOOST_CHECK(tracker.frame_released(buffer_id, 0, free_buffers));
+    }
+    BOOST_CHECK(free_buffers.empty());
+    BOOST_CHECK_EQUAL(tracker.get_consumer_lag(1), 2);
+
+    // Exceeding the maximum lag drops consumer 1, freeing the buffers only it held
+    BOOST_CHECK_EQUAL(tracker.frame_ready(2, free_buffers), 1);
+    BOOST_CHECK(!tracker.is_consumer_active(1));
+    BOOST_CHECK_EQUAL(tracker.get_num_active_consumers(), 1);
+    BOOST_REQUIRE_EQUAL(free_buffers.size(), 2);
+    BOOST_CHECK_EQUAL(free_buffers[0], 0);
+    BOOST_CHECK_EQUAL(free_buffers[1], 1);
+
+    // Buffer 2 is still held by consumer 0 and late releases from consumer 1 are ignored
+    free_buffers.clear();
+    BOOST_CHECK(!tracker.frame_released(2, 1, free_buffers));
+    BOOST_CHECK(tracker.frame_released(2, 0, free_buffers));
+    BOOST_REQUIRE_EQUAL(free_buffers.size(), 1);
+    BOOST_CHECK_EQUAL(free_buffers[0], 2);
+
+    // Subsequent frames only wait for the active consumer
+    free_buffers.clear();
+    tracker.frame_ready(3, free_buffers);
+    BOOST_CHECK(tracker.frame_released(3, 0, free_buffers));
+    BOOST_CHECK_EQUAL(free_buffers.size(), 1);
+
+    // Once all consumers are dropped buffers are freed as soon as they are ready
+    free_buffers.clear();
+    tracker.drop_consumer(0, free_buffers);
+    BOOST_CHECK_EQUAL(tracker.get_num_active_consumers(), 0);
+    tracker.frame_ready(4, free_buffers);
+    BOOST_REQUIRE_EQUAL(free_buffers.size(), 1);
+    BOOST_CHECK_EQUAL(free_buffers[0], 4);
+}
+
+BOOST_AUTO_TEST_CASE( IllegalConsumerTracking )
+{
+    BOOST_CHECK_THROW(FrameReceiver::FrameConsumerTracker tracker(buffer_manager, 0),
+            FrameReceiver::FrameReceiverException);
+
+    FrameReceiver::FrameConsumerTracker tracker(buffer_manager, 2);
+    BOOST_CHECK_THROW(tracker.frame_ready(10, free_buffers), FrameReceiver::FrameReceiverException);
+    BOOST_CHECK_THROW(tracker.get_consumer_lag(2), FrameReceiver::FrameReceiverException);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
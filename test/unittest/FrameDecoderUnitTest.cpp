@@ -13,7 +13,13 @@
 #include <log4cxx/basicconfigurator.h>
 #include <log4cxx/simplelayout.h>
 
+#include <boost/bind.hpp>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
 #include "PercivalEmulatorFrameDecoder.h"
+#include "SharedBufferManager.h"
 
 class FrameDecoderTestFixture
 {
@@ -23,7 +29,40 @@ public:
     {
 
     }
+
+    void frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns)
+    {
+        ready_buffers.push_back(buffer_id);
+        ready_frames.push_back(frame_number);
+        ready_states.push_back(frame_state);
+        ready_timestamps.push_back(frame_timestamp_ns);
+    }
+
+    // Fill a packet header and payload with a pattern identifying the packet
+    void build_packet(uint8_t* hdr_raw, uint8_t* payload, uint8_t type, uint8_t subframe,
+            uint32_t frame_number, uint16_t packet_number)
+    {
+        hdr_raw[0] = type;
+        hdr_raw[1] = subframe;
+        hdr_raw[2] = static_cast<uint8_t>((frame_number >> 24) & 0xFF);
+        hdr_raw[3] = static_cast<uint8_t>((frame_number >> 16) & 0xFF);
+        hdr_raw[4] = static_cast<uint8_t>((frame_number >>  8) & 0xFF);
+        hdr_raw[5] = static_cast<uint8_t>((frame_number >>  0) & 0xFF);
+        hdr_raw[6] = static_cast<uint8_t>((packet_number >> 8) & 0xFF);
+        hdr_raw[7] = static_cast<uint8_t>((packet_number >> 0) & 0xFF);
+        memset(payload, packet_pattern(type, subframe, packet_number), PercivalEmulator::primary_packet_size);
+    }
+
+    uint8_t packet_pattern(uint8_t type, uint8_t subframe, uint16_t packet_number)
+    {
+        return static_cast<uint8_t>((packet_number + (subframe * 3) + (type * 7)) & 0xFF);
+    }
+
     log4cxx::LoggerPtr logger;
+    std::vector<int> ready_buffers;
+    std::vector<int> ready_frames;
+    std::vector<int> ready_states;
+    std::vector<uint64_t> ready_timestamps;
 };
 BOOST_FIXTURE_TEST_SUITE(FrameDecoderUnitTest, FrameDecoderTestFixture);
 
@@ -64,5 +103,393 @@ BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderTest )
 
 }
 
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderBatchReceiveTest )
+{
+    const size_t num_buffers = 2;
+    const size_t batch_size = 16;
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+
+    FrameReceiver::PercivalEmulatorFrameDecoder decoder(logger);
+    BOOST_CHECK_EQUAL(decoder.get_packet_receive_mode(), FrameReceiver::FrameDecoder::PacketReceiveModeSpeculative);
+
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderBatchTestBuffer", num_buffers * decoder.get_frame_buffer_size(), decoder.get_frame_buffer_size()));
+    decoder.register_buffer_manager(buffer_manager);
+    decoder.register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+    for (size_t buffer = 0; buffer < num_buffers; buffer++)
+    {
+        decoder.push_empty_buffer(buffer);
+    }
+
+    decoder.init_batch_receive(batch_size);
+    BOOST_CHECK_THROW(decoder.prepare_batch_receive(batch_size + 1), FrameReceiver::FrameDecoderException);
+
+    // Build the packet order for two frames. The first arrives in order, the second has each
+    // batch reversed so that every predicted payload destination is wrong
+    std::vector<size_t> packet_order;
+    for (size_t frame = 0; frame < 2; frame++)
+    {
+        for (size_t batch_start = 0; batch_start < PercivalEmulator::num_frame_packets; batch_start += batch_size)
+        {
+            size_t batch_end = std::min(batch_start + batch_size, PercivalEmulator::num_frame_packets);
+            std::vector<size_t> batch;
+            for (size_t idx = batch_start; idx < batch_end; idx++)
+            {
+                batch.push_back(idx);
+            }
+            if (frame == 1)
+            {
+                std::reverse(batch.begin(), batch.end());
+            }
+            packet_order.insert(packet_order.end(), batch.begin(), batch.end());
+        }
+    }
+
+    size_t packets_sent = 0;
+    while (packets_sent < packet_order.size())
+    {
+        size_t num_packets = std::min(batch_size, packet_order.size() - packets_sent);
+        decoder.prepare_batch_receive(num_packets);
+
+        for (size_t packet_idx = 0; packet_idx < num_packets; packet_idx++)
+        {
+            size_t frame = (packets_sent + packet_idx) / PercivalEmulator::num_frame_packets;
+            size_t linear_idx = packet_order[packets_sent + packet_idx];
+            BOOST_REQUIRE_EQUAL(decoder.get_batch_payload_size(packet_idx), PercivalEmulator::primary_packet_size);
+            build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(packet_idx)),
+                    reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(packet_idx)),
+                    linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                    (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                    frame, linear_idx % packets_per_subframe);
+        }
+        for (size_t packet_idx = 0; packet_idx < num_packets; packet_idx++)
+        {
+            decoder.process_batch_packet(packet_idx,
+                    decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+        }
+        packets_sent += num_packets;
+    }
+
+    // Both frames should be complete, with every payload at its decoded location
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 2);
+    for (size_t frame = 0; frame < 2; frame++)
+    {
+        BOOST_CHECK_EQUAL(ready_frames[frame], frame);
+        uint8_t* frame_buffer = reinterpret_cast<uint8_t*>(buffer_manager->get_buffer_address(ready_buffers[frame]));
+        PercivalEmulator::FrameHeader* frame_header = reinterpret_cast<PercivalEmulator::FrameHeader*>(frame_buffer);
+        BOOST_CHECK_EQUAL(frame_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+        BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), PercivalEmulator::num_frame_packets);
+
+        size_t mismatches = 0;
+        for (size_t linear_idx = 0; linear_idx < PercivalEmulator::num_frame_packets; linear_idx++)
+        {
+            uint8_t type = linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes);
+            uint8_t subframe = (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes;
+            uint16_t packet_number = linear_idx % packets_per_subframe;
+            uint8_t* payload = frame_buffer + decoder.get_frame_header_size() +
+                    (PercivalEmulator::data_type_size * type) + (PercivalEmulator::subframe_size * subframe) +
+                    (PercivalEmulator::primary_packet_size * packet_number);
+            uint8_t pattern = packet_pattern(type, subframe, packet_number);
+            if ((payload[0] != pattern) || (payload[PercivalEmulator::primary_packet_size - 1] != pattern))
+            {
+                mismatches++;
+            }
+        }
+        BOOST_CHECK_EQUAL(mismatches, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderSharedPoolTest )
+{
+    const size_t num_decoders = 2;
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+
+    std::vector<boost::shared_ptr<FrameReceiver::PercivalEmulatorFrameDecoder> > decoders;
+    for (size_t idx = 0; idx < num_decoders; idx++)
+    {
+        decoders.push_back(boost::shared_ptr<FrameReceiver::PercivalEmulatorFrameDecoder>(
+                new FrameReceiver::PercivalEmulatorFrameDecoder(logger)));
+    }
+
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderSharedPoolTestBuffer", decoders[0]->get_frame_buffer_size(), decoders[0]->get_frame_buffer_size()));
+
+    for (size_t idx = 0; idx < num_decoders; idx++)
+    {
+        decoders[idx]->register_buffer_manager(buffer_manager);
+        decoders[idx]->register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+        if (idx > 0)
+        {
+            decoders[idx]->register_buffer_pool(decoders[0]->get_buffer_pool());
+        }
+        decoders[idx]->init_batch_receive(1);
+    }
+    decoders[0]->push_empty_buffer(0);
+    BOOST_CHECK_EQUAL(decoders[1]->get_num_empty_buffers(), 1);
+
+    // Distribute the packets of one frame across the decoders, as if received by several RX threads
+    for (size_t linear_idx = 0; linear_idx < PercivalEmulator::num_frame_packets; linear_idx++)
+    {
+        FrameReceiver::PercivalEmulatorFrameDecoder& decoder = *decoders[linear_idx % num_decoders];
+        decoder.prepare_batch_receive(1);
+        build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(0)),
+                reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(0)),
+                linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                0, linear_idx % packets_per_subframe);
+        decoder.process_batch_packet(0, decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+    }
+
+    // The frame should be assembled in the single buffer and notified exactly once
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 1);
+    BOOST_CHECK_EQUAL(ready_buffers[0], 0);
+    BOOST_CHECK_EQUAL(decoders[0]->get_num_mapped_buffers(), 0);
+
+    PercivalEmulator::FrameHeader* frame_header =
+            reinterpret_cast<PercivalEmulator::FrameHeader*>(buffer_manager->get_buffer_address(0));
+    BOOST_CHECK_EQUAL(frame_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+    BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), PercivalEmulator::num_frame_packets);
+}
+
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderInterleavedFramesTest )
+{
+    const uint32_t num_frames = 3;
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+
+    FrameReceiver::PercivalEmulatorFrameDecoder decoder(logger);
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderInterleavedTestBuffer", decoder.get_frame_buffer_size() * num_frames, decoder.get_frame_buffer_size()));
+    decoder.register_buffer_manager(buffer_manager);
+    decoder.register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+    decoder.init_batch_receive(1);
+    for (uint32_t buffer = 0; buffer < num_frames; buffer++)
+    {
+        decoder.push_empty_buffer(buffer);
+    }
+
+    // Interleave the packets of several frames in flight, so that every packet switches frame
+    for (size_t linear_idx = 0; linear_idx < PercivalEmulator::num_frame_packets; linear_idx++)
+    {
+        for (uint32_t frame = 0; frame < num_frames; frame++)
+        {
+            decoder.prepare_batch_receive(1);
+            build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(0)),
+                    reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(0)),
+                    linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                    (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                    frame + 1, linear_idx % packets_per_subframe);
+            decoder.process_batch_packet(0, decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+        }
+    }
+
+    // Each frame should be assembled completely in its own buffer
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), num_frames);
+    BOOST_CHECK_EQUAL(decoder.get_num_mapped_buffers(), 0);
+    for (uint32_t frame = 0; frame < num_frames; frame++)
+    {
+        BOOST_CHECK_EQUAL(ready_frames[frame], frame + 1);
+        BOOST_CHECK_EQUAL(ready_buffers[frame], frame);
+
+        PercivalEmulator::FrameHeader* frame_header =
+                reinterpret_cast<PercivalEmulator::FrameHeader*>(buffer_manager->get_buffer_address(frame));
+        BOOST_CHECK_EQUAL(frame_header->frame_number, frame + 1);
+        BOOST_CHECK_EQUAL(frame_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+        BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), PercivalEmulator::num_frame_packets);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderPacketStateTest )
+{
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+    const size_t num_missing = 3;
+
+    FrameReceiver::PercivalEmulatorFrameDecoder decoder(logger);
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderPacketStateTestBuffer", decoder.get_frame_buffer_size(), decoder.get_frame_buffer_size()));
+    decoder.register_buffer_manager(buffer_manager);
+    decoder.register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+    decoder.init_batch_receive(1);
+    decoder.push_empty_buffer(0);
+
+    PercivalEmulator::FrameHeader* frame_header =
+            reinterpret_cast<PercivalEmulator::FrameHeader*>(buffer_manager->get_buffer_address(0));
+
+    // Send all but the last few packets of the frame twice, which must not complete the frame
+    for (size_t repeat = 0; repeat < 2; repeat++)
+    {
+        for (size_t linear_idx = 0; linear_idx < PercivalEmulator::num_frame_packets - num_missing; linear_idx++)
+        {
+            decoder.prepare_batch_receive(1);
+            build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(0)),
+                    reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(0)),
+                    linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                    (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                    1, linear_idx % packets_per_subframe);
+            decoder.process_batch_packet(0, decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(ready_frames.size(), 0);
+    BOOST_CHECK_EQUAL(frame_header->header_magic, PercivalEmulator::frame_header_magic);
+    BOOST_CHECK_EQUAL(frame_header->header_version, PercivalEmulator::frame_header_version);
+    BOOST_CHECK(PercivalEmulator::is_supported_header(frame_header));
+    BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), PercivalEmulator::num_frame_packets - num_missing);
+    BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), PercivalEmulator::num_frame_packets - num_missing);
+    BOOST_CHECK_EQUAL(decoder.get_packets_duplicated(), PercivalEmulator::num_frame_packets - num_missing);
+
+    std::vector<size_t> missing_packets;
+    BOOST_REQUIRE_EQUAL(PercivalEmulator::get_missing_packets(frame_header, missing_packets), num_missing);
+    for (size_t missing_idx = 0; missing_idx < num_missing; missing_idx++)
+    {
+        BOOST_CHECK_EQUAL(missing_packets[missing_idx], PercivalEmulator::num_frame_packets - num_missing + missing_idx);
+        BOOST_CHECK(!PercivalEmulator::test_packet_state(frame_header, missing_packets[missing_idx]));
+    }
+
+    // Completing the missing packets then completes the frame
+    for (size_t linear_idx = PercivalEmulator::num_frame_packets - num_missing; linear_idx < PercivalEmulator::num_frame_packets; linear_idx++)
+    {
+        decoder.prepare_batch_receive(1);
+        build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(0)),
+                reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(0)),
+                linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                1, linear_idx % packets_per_subframe);
+        decoder.process_batch_packet(0, decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+    }
+
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 1);
+    BOOST_CHECK_EQUAL(frame_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+    missing_packets.clear();
+    BOOST_CHECK_EQUAL(PercivalEmulator::get_missing_packets(frame_header, missing_packets), 0);
+}
+
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderFrameTimeoutTest )
+{
+    const unsigned int frame_timeout_ms = 10;
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+
+    FrameReceiver::PercivalEmulatorFrameDecoder decoder(logger, false, frame_timeout_ms);
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderTimeoutTestBuffer", decoder.get_frame_buffer_size() * 2, decoder.get_frame_buffer_size()));
+    decoder.register_buffer_manager(buffer_manager);
+    decoder.register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+    decoder.init_batch_receive(1);
+    decoder.push_empty_buffer(0);
+    decoder.push_empty_buffer(1);
+
+    // Send the first few packets of frame 1 and all packets of frame 2, which completes and
+    // cancels its timeout
+    for (uint32_t frame = 1; frame <= 2; frame++)
+    {
+        size_t num_packets = (frame == 1) ? 10 : PercivalEmulator::num_frame_packets;
+        for (size_t linear_idx = 0; linear_idx < num_packets; linear_idx++)
+        {
+            decoder.prepare_batch_receive(1);
+            build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(0)),
+                    reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(0)),
+                    linear_idx / (packets_per_subframe * PercivalEmulator::num_subframes),
+                    (linear_idx / packets_per_subframe) % PercivalEmulator::num_subframes,
+                    frame, linear_idx % packets_per_subframe);
+            decoder.process_batch_packet(0, decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 1);
+    BOOST_CHECK_EQUAL(ready_frames[0], 2);
+    BOOST_CHECK_EQUAL(ready_states[0], FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+
+    // The incomplete frame is not released before its timeout
+    decoder.expire_frames();
+    BOOST_CHECK_EQUAL(ready_frames.size(), 1);
+    BOOST_CHECK_EQUAL(decoder.get_num_mapped_buffers(), 1);
+
+    // Once the timeout has passed, only the incomplete frame is released
+    usleep((frame_timeout_ms * 3) * 1000);
+    decoder.expire_frames();
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 2);
+    BOOST_CHECK_EQUAL(ready_frames[1], 1);
+    BOOST_CHECK_EQUAL(ready_buffers[1], 0);
+    BOOST_CHECK_EQUAL(ready_states[1], FrameReceiver::FrameDecoder::FrameReceiveStateTimedout);
+    BOOST_CHECK_EQUAL(decoder.get_num_mapped_buffers(), 0);
+
+    PercivalEmulator::FrameHeader* frame_header =
+            reinterpret_cast<PercivalEmulator::FrameHeader*>(buffer_manager->get_buffer_address(0));
+    BOOST_CHECK_EQUAL(frame_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateTimedout);
+    BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(frame_header), 10);
+    BOOST_CHECK_EQUAL(ready_timestamps[1], (static_cast<uint64_t>(frame_header->frame_start_time.tv_sec) * 1000000000) +
+            frame_header->frame_start_time.tv_nsec);
+
+    decoder.expire_frames();
+    BOOST_CHECK_EQUAL(ready_frames.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE( PercivalEmulatorDecoderBatchReceiveAfterTimeoutTest )
+{
+    const unsigned int frame_timeout_ms = 10;
+    const size_t batch_size = 4;
+    const size_t packets_per_subframe = PercivalEmulator::num_primary_packets + PercivalEmulator::num_tail_packets;
+
+    FrameReceiver::PercivalEmulatorFrameDecoder decoder(logger, false, frame_timeout_ms);
+    FrameReceiver::SharedBufferManagerPtr buffer_manager(new FrameReceiver::SharedBufferManager(
+            "FrameDecoderBatchTimeoutTestBuffer", decoder.get_frame_buffer_size() * 2, decoder.get_frame_buffer_size()));
+    decoder.register_buffer_manager(buffer_manager);
+    decoder.register_frame_ready_callback(boost::bind(&FrameDecoderTestFixture::frame_ready, this, _1, _2, _3, _4));
+    decoder.init_batch_receive(batch_size);
+    decoder.push_empty_buffer(0);
+    decoder.push_empty_buffer(1);
+
+    // Receive the first packets of a frame in order, so that the following packets are predicted
+    // to land directly in its buffer
+    size_t linear_idx = 0;
+    for (size_t batch = 0; batch < 2; batch++)
+    {
+        decoder.prepare_batch_receive(batch_size);
+        for (size_t packet_idx = 0; packet_idx < batch_size; packet_idx++, linear_idx++)
+        {
+            build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(packet_idx)),
+                    reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(packet_idx)),
+                    0, linear_idx / packets_per_subframe, 1, linear_idx % packets_per_subframe);
+        }
+        for (size_t packet_idx = 0; packet_idx < batch_size; packet_idx++)
+        {
+            decoder.process_batch_packet(packet_idx,
+                    decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+        }
+    }
+
+    // Time out the frame, which hands its buffer to consumers
+    usleep((frame_timeout_ms * 3) * 1000);
+    decoder.expire_frames();
+    BOOST_REQUIRE_EQUAL(ready_frames.size(), 1);
+    BOOST_CHECK_EQUAL(ready_frames[0], 1);
+    int expired_buffer = ready_buffers[0];
+    uint8_t* expired_start = reinterpret_cast<uint8_t*>(buffer_manager->get_buffer_address(expired_buffer));
+    uint8_t* expired_end = expired_start + decoder.get_frame_buffer_size();
+
+    // No payload of the next batch may be received into the buffer of the timed out frame
+    decoder.prepare_batch_receive(batch_size);
+    for (size_t packet_idx = 0; packet_idx < batch_size; packet_idx++)
+    {
+        uint8_t* payload = reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(packet_idx));
+        BOOST_CHECK((payload < expired_start) || (payload >= expired_end));
+    }
+
+    // Late packets of the timed out frame are received into a new buffer, leaving the released one untouched
+    PercivalEmulator::FrameHeader* expired_header = reinterpret_cast<PercivalEmulator::FrameHeader*>(expired_start);
+    for (size_t packet_idx = 0; packet_idx < batch_size; packet_idx++, linear_idx++)
+    {
+        build_packet(reinterpret_cast<uint8_t*>(decoder.get_batch_header_buffer(packet_idx)),
+                reinterpret_cast<uint8_t*>(decoder.get_batch_payload_buffer(packet_idx)),
+                0, linear_idx / packets_per_subframe, 1, linear_idx % packets_per_subframe);
+    }
+    for (size_t packet_idx = 0; packet_idx < batch_size; packet_idx++)
+    {
+        decoder.process_batch_packet(packet_idx,
+                decoder.get_packet_header_size() + PercivalEmulator::primary_packet_size, 8989, 0);
+    }
+    BOOST_CHECK_EQUAL(expired_header->frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateTimedout);
+    BOOST_CHECK_EQUAL(PercivalEmulator::count_packet_state(expired_header), 2 * batch_size);
+    BOOST_CHECK_EQUAL(decoder.get_num_mapped_buffers(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
@@ -0,0 +1,75 @@
+/*
+ * FrameNotificationUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "FrameNotification.h"
+
+BOOST_AUTO_TEST_SUITE(FrameNotificationUnitTest);
+
+BOOST_AUTO_TEST_CASE( FrameNotificationRoundTrip )
+{
+    FrameReceiver::FrameNotification ready(FrameReceiver::IpcMessage::MsgValNotifyFrameReady, 1234, 7, 1, 1000);
+    std::string encoded = ready.encode();
+
+    // Encoded notifications are fixed size and distinguishable from JSON messages
+    BOOST_CHECK_EQUAL(encoded.size(), sizeof(FrameReceiver::FrameNotification::Encoded));
+    BOOST_CHECK_EQUAL(encoded.size(), 40);
+    BOOST_CHECK(FrameReceiver::FrameNotification::is_binary(encoded));
+
+    FrameReceiver::IpcMessage json_msg(FrameReceiver::IpcMessage::MsgTypeNotify,
+            FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+    json_msg.set_param("frame", 1234);
+    json_msg.set_param("buffer_id", 7);
+    BOOST_CHECK(!FrameReceiver::FrameNotification::is_binary(json_msg.encode()));
+
+    FrameReceiver::FrameNotification decoded(encoded);
+    BOOST_CHECK_EQUAL(decoded.get_msg_val(), FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+    BOOST_CHECK_EQUAL(decoded.get_frame_number(), 1234);
+    BOOST_CHECK_EQUAL(decoded.get_buffer_id(), 7);
+    BOOST_CHECK_EQUAL(decoded.get_frame_state(), 1);
+    BOOST_CHECK_EQUAL(decoded.get_frame_timestamp_ns(), 1000);
+    BOOST_CHECK_EQUAL(decoded.get_notify_timestamp_ns(), ready.get_notify_timestamp_ns());
+    BOOST_CHECK_GT(decoded.get_notify_timestamp_ns(), 0);
+    BOOST_CHECK_EQUAL(decoded.get_consumer_id(), 0);
+    BOOST_CHECK(!decoded.is_spilled());
+
+    // Releases identify the consumer releasing the frame
+    FrameReceiver::FrameNotification release(FrameReceiver::IpcMessage::MsgValNotifyFrameRelease, 1234, 7, 1, 1000, 3);
+    BOOST_CHECK_EQUAL(FrameReceiver::FrameNotification(release.encode()).get_consumer_id(), 3);
+
+    // Frames in spill buffers are flagged in the frame state
+    FrameReceiver::FrameNotification spilled(FrameReceiver::IpcMessage::MsgValNotifyFrameReady, 1235, 8,
+            FrameReceiver::FrameNotification::frame_state_spilled);
+    BOOST_CHECK(FrameReceiver::FrameNotification(spilled.encode()).is_spilled());
+}
+
+BOOST_AUTO_TEST_CASE( FrameNotificationIllegal )
+{
+    // Only frame ready and release notifications can be encoded
+    BOOST_CHECK_THROW(FrameReceiver::FrameNotification(FrameReceiver::IpcMessage::MsgValCmdStatus, 0, 0),
+            FrameReceiver::IpcMessageException);
+
+    // Truncated, corrupted or unsupported notifications are rejected
+    std::string encoded = FrameReceiver::FrameNotification(FrameReceiver::IpcMessage::MsgValNotifyFrameRelease, 1, 2).encode();
+    BOOST_CHECK_THROW(FrameReceiver::FrameNotification notification(encoded.substr(1)), FrameReceiver::IpcMessageException);
+
+    std::string bad_magic(encoded);
+    bad_magic[0] = '{';
+    BOOST_CHECK(!FrameReceiver::FrameNotification::is_binary(bad_magic));
+    BOOST_CHECK_THROW(FrameReceiver::FrameNotification notification(bad_magic), FrameReceiver::IpcMessageException);
+
+    std::string bad_version(encoded);
+    bad_version[4] = 99;
+    BOOST_CHECK_THROW(FrameReceiver::FrameNotification notification(bad_version), FrameReceiver::IpcMessageException);
+
+    std::string bad_value(encoded);
+    bad_value[6] = FrameReceiver::IpcMessage::MsgValCmdReset;
+    BOOST_CHECK_THROW(FrameReceiver::FrameNotification notification(bad_value), FrameReceiver::IpcMessageException);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
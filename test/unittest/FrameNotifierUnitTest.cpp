@@ -0,0 +1,214 @@
+/*
+ * FrameNotifierUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "FrameNotifier.h"
+#include "FrameNotification.h"
+#include "PercivalEmulatorFrameDecoder.h"
+
+class FrameNotifierTestFixture
+{
+public:
+    FrameNotifierTestFixture() :
+        logger(log4cxx::Logger::getLogger("FrameNotifierUnitTest")),
+        buffer_manager(new FrameReceiver::SharedBufferManager("TestFrameNotifierBuffer", 1000, 100, true, 1)),
+        frame_decoder(new FrameReceiver::PercivalEmulatorFrameDecoder(logger)),
+        relayed_buffer_id(-1),
+        relayed_frame_number(-1),
+        relayed_frame_state(-1),
+        relayed_frame_timestamp_ns(0),
+        relayed_spilled(false)
+    {
+        frame_decoder->register_buffer_manager(buffer_manager);
+    }
+
+    void relay_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns, bool spilled)
+    {
+        relayed_buffer_id = buffer_id;
+        relayed_frame_number = frame_number;
+        relayed_frame_state = frame_state;
+        relayed_frame_timestamp_ns = frame_timestamp_ns;
+        relayed_spilled = spilled;
+    }
+
+    log4cxx::LoggerPtr logger;
+    FrameReceiver::SharedBufferManagerPtr buffer_manager;
+    FrameReceiver::FrameDecoderPtr frame_decoder;
+    int relayed_buffer_id;
+    int relayed_frame_number;
+    int relayed_frame_state;
+    uint64_t relayed_frame_timestamp_ns;
+    bool relayed_spilled;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FrameNotifierUnitTest, FrameNotifierTestFixture);
+
+BOOST_AUTO_TEST_CASE( DecodeFrameRelease )
+{
+    int buffer_id = -1;
+    unsigned int consumer_id = 0;
+    int frame_number = -1;
+
+    FrameReceiver::FrameNotification binary_release(FrameReceiver::IpcMessage::MsgValNotifyFrameRelease, 12, 3, 0, 0, 2);
+    BOOST_CHECK(FrameReceiver::FrameNotifier::decode_frame_release(binary_release.encode(), buffer_id, consumer_id,
+            frame_number));
+    BOOST_CHECK_EQUAL(buffer_id, 3);
+    BOOST_CHECK_EQUAL(consumer_id, 2);
+    BOOST_CHECK_EQUAL(frame_number, 12);
+
+    FrameReceiver::IpcMessage json_release(FrameReceiver::IpcMessage::MsgTypeNotify,
+            FrameReceiver::IpcMessage::MsgValNotifyFrameRelease);
+    json_release.set_param("frame", 13);
+    json_release.set_param("buffer_id", 4);
+    BOOST_CHECK(FrameReceiver::FrameNotifier::decode_frame_release(json_release.encode(), buffer_id, consumer_id,
+            frame_number));
+    BOOST_CHECK_EQUAL(buffer_id, 4);
+    BOOST_CHECK_EQUAL(consumer_id, 0);
+    BOOST_CHECK_EQUAL(frame_number, 13);
+
+    // Frame ready notifications in either format are not releases
+    BOOST_CHECK(!FrameReceiver::FrameNotifier::decode_frame_release(FrameReceiver::FrameNotifier::encode_frame_ready(
+            5, 14, FrameReceiver::FrameDecoder::FrameReceiveStateComplete, 0, false,
+            FrameReceiver::Defaults::NotifyFormatBinary), buffer_id, consumer_id, frame_number));
+    BOOST_CHECK(!FrameReceiver::FrameNotifier::decode_frame_release(FrameReceiver::FrameNotifier::encode_frame_ready(
+            5, 14, FrameReceiver::FrameDecoder::FrameReceiveStateComplete, 0, true,
+            FrameReceiver::Defaults::NotifyFormatJson), buffer_id, consumer_id, frame_number));
+}
+
+BOOST_AUTO_TEST_CASE( EncodeBinaryFrameReady )
+{
+    // The frame state, spilled flag and frame start time are carried in binary notifications
+    FrameReceiver::FrameNotification ready(FrameReceiver::FrameNotifier::encode_frame_ready(6, 15,
+            FrameReceiver::FrameDecoder::FrameReceiveStateTimedout, 1234567890123456789ULL, true,
+            FrameReceiver::Defaults::NotifyFormatBinary));
+    BOOST_CHECK_EQUAL(ready.get_msg_val(), FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+    BOOST_CHECK_EQUAL(ready.get_buffer_id(), 6);
+    BOOST_CHECK_EQUAL(ready.get_frame_number(), 15);
+    BOOST_CHECK(ready.is_spilled());
+    BOOST_CHECK_EQUAL(ready.get_frame_state() & ~FrameReceiver::FrameNotification::frame_state_spilled,
+            static_cast<uint32_t>(FrameReceiver::FrameDecoder::FrameReceiveStateTimedout));
+    BOOST_CHECK_EQUAL(ready.get_frame_timestamp_ns(), 1234567890123456789ULL);
+}
+
+BOOST_AUTO_TEST_CASE( RelayFrameNotifier )
+{
+    FrameReceiver::IpcReactor reactor;
+    FrameReceiver::RelayFrameNotifier notifier(logger, reactor,
+            boost::bind(&FrameNotifierTestFixture::relay_frame_ready, this, _1, _2, _3, _4, _5));
+    BOOST_CHECK_EQUAL(notifier.get_name(), "relay");
+
+    // Ready frames are handled when the reactor of the main thread next runs
+    notifier.notify_frame_ready(4, 300, FrameReceiver::FrameDecoder::FrameReceiveStateComplete, 5000, true);
+    BOOST_CHECK_EQUAL(notifier.get_frames_notified(), 1);
+    BOOST_CHECK_EQUAL(relayed_buffer_id, -1);
+
+    BOOST_CHECK_EQUAL(reactor.run_once(0), 0);
+    BOOST_CHECK_EQUAL(relayed_buffer_id, 4);
+    BOOST_CHECK_EQUAL(relayed_frame_number, 300);
+    BOOST_CHECK_EQUAL(relayed_frame_state, FrameReceiver::FrameDecoder::FrameReceiveStateComplete);
+    BOOST_CHECK_EQUAL(relayed_frame_timestamp_ns, 5000);
+    BOOST_CHECK(relayed_spilled);
+    BOOST_CHECK_EQUAL(notifier.get_frames_released(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( SharedRingFrameNotifier )
+{
+    FrameReceiver::FrameBufferPoolPtr buffer_pool = frame_decoder->get_buffer_pool();
+    buffer_pool->register_release_ring(buffer_manager->get_release_ring(), buffer_manager);
+
+    FrameReceiver::SharedRingFrameNotifier notifier(logger, buffer_manager->get_ready_ring(0),
+            buffer_manager->get_ready_event(), buffer_pool);
+    BOOST_CHECK_EQUAL(notifier.get_name(), "sharedring");
+
+    buffer_manager->set_buffer_state(6, FrameReceiver::BufferStateReady, 100);
+    notifier.notify_frame_ready(6, 100, FrameReceiver::FrameDecoder::FrameReceiveStateTimedout, 9000, true);
+    BOOST_CHECK_EQUAL(notifier.get_frames_notified(), 1);
+
+    // The descriptor carries the frame state, start time and spill flag
+    FrameReceiver::FrameDescriptor descriptor;
+    BOOST_REQUIRE(buffer_manager->get_ready_ring(0)->pop(descriptor));
+    BOOST_CHECK_EQUAL(descriptor.buffer_id, 6);
+    BOOST_CHECK_EQUAL(descriptor.frame_number, 100);
+    BOOST_CHECK_EQUAL(descriptor.timestamp_ns, 9000);
+    BOOST_CHECK_EQUAL(descriptor.reserved[FrameReceiver::frame_descriptor_state_idx],
+            FrameReceiver::FrameDecoder::FrameReceiveStateTimedout);
+    BOOST_CHECK_EQUAL(descriptor.reserved[FrameReceiver::frame_descriptor_flags_idx],
+            FrameReceiver::frame_descriptor_flag_spilled);
+
+    // Buffers released through the ring are returned to the pool and marked free when releases are serviced
+    FrameReceiver::BufferDescriptor buffer_descriptor;
+    BOOST_REQUIRE(buffer_manager->get_release_ring()->push(descriptor));
+    BOOST_REQUIRE(buffer_manager->get_buffer_descriptor(6, buffer_descriptor));
+    BOOST_CHECK_EQUAL(buffer_descriptor.state, FrameReceiver::BufferStateReady);
+    notifier.service_releases();
+    BOOST_CHECK_EQUAL(notifier.get_frames_released(), 1);
+    BOOST_CHECK_EQUAL(buffer_pool->get_num_empty_buffers(), 1);
+    BOOST_REQUIRE(buffer_manager->get_buffer_descriptor(6, buffer_descriptor));
+    BOOST_CHECK_EQUAL(buffer_descriptor.state, FrameReceiver::BufferStateFree);
+}
+
+BOOST_AUTO_TEST_CASE( DirectFrameNotifier )
+{
+    std::string frame_ready_endpoint("tcp://127.0.0.1:5101");
+    std::string frame_release_endpoint("tcp://127.0.0.1:5102");
+
+    FrameReceiver::DirectFrameNotifier notifier(logger, frame_ready_endpoint, frame_release_endpoint,
+            FrameReceiver::Defaults::NotifyFormatBinary, buffer_manager, frame_decoder, 1, 0);
+    BOOST_CHECK_EQUAL(notifier.get_name(), "direct");
+
+    FrameReceiver::IpcReactor reactor;
+    notifier.register_channels(reactor);
+
+    FrameReceiver::IpcChannel ready_channel(ZMQ_SUB);
+    ready_channel.connect(frame_ready_endpoint);
+    ready_channel.subscribe("");
+    FrameReceiver::IpcChannel release_channel(ZMQ_PUB);
+    release_channel.connect(frame_release_endpoint);
+
+    // Allow the subscriptions to propagate before publishing. The release channel is bound by the notifier,
+    // so only sends its subscription to the publisher once the reactor has serviced it after the connection
+    for (int iteration = 0; iteration < 10; iteration++)
+    {
+        reactor.run_once(10);
+    }
+
+    notifier.notify_frame_ready(2, 200, FrameReceiver::FrameDecoder::FrameReceiveStateComplete, 7000, false);
+    BOOST_CHECK_EQUAL(notifier.get_frames_notified(), 1);
+    BOOST_REQUIRE(ready_channel.poll(1000));
+    FrameReceiver::FrameNotification ready(ready_channel.recv());
+    BOOST_CHECK_EQUAL(ready.get_msg_val(), FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+    BOOST_CHECK_EQUAL(ready.get_buffer_id(), 2);
+    BOOST_CHECK_EQUAL(ready.get_frame_number(), 200);
+    BOOST_CHECK_EQUAL(ready.get_frame_state(), static_cast<uint32_t>(FrameReceiver::FrameDecoder::FrameReceiveStateComplete));
+    BOOST_CHECK_EQUAL(ready.get_frame_timestamp_ns(), 7000);
+
+    // The status reports the lag of the consumer, which holds the frame until it is released
+    FrameReceiver::IpcMessage status;
+    notifier.get_status(status);
+    BOOST_CHECK_EQUAL(status.get_param<unsigned int>("consumers_active"), 1);
+    const rapidjson::Value& consumers = status.get_param<const rapidjson::Value&>("consumers");
+    BOOST_REQUIRE(consumers["lag"].IsArray());
+    BOOST_REQUIRE_EQUAL(consumers["lag"].Size(), 1);
+    BOOST_CHECK_EQUAL(consumers["lag"][0u].GetUint(), 1);
+    BOOST_CHECK(consumers["active"][0u].GetBool());
+
+    // Releases are handled through the reactor of the owning thread, returning the buffer to the decoder
+    FrameReceiver::FrameNotification release(FrameReceiver::IpcMessage::MsgValNotifyFrameRelease, 200, 2);
+    std::string release_encoded = release.encode();
+    release_channel.send(release_encoded);
+    for (int attempt = 0; (attempt < 10) && (notifier.get_frames_released() == 0); attempt++)
+    {
+        reactor.run_once(100);
+    }
+    BOOST_CHECK_EQUAL(notifier.get_frames_released(), 1);
+    BOOST_CHECK_EQUAL(frame_decoder->get_num_empty_buffers(), 1);
+
+    notifier.remove_channels(reactor);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -65,6 +65,44 @@ BOOST_AUTO_TEST_CASE( ValidSensorNameToTypeMapping )
     BOOST_CHECK_EQUAL(theConfig.map_sensor_name_to_type(badName), FrameReceiver::Defaults::SensorTypeIllegal);
 }
 
+BOOST_AUTO_TEST_CASE( ValidNotifyFormatNameToTypeMapping )
+{
+    FrameReceiver::FrameReceiverConfig theConfig;
+    std::string jsonName   = "json";
+    std::string binaryName = "binary";
+    std::string badName    = "xml";
+
+    BOOST_CHECK_EQUAL(theConfig.map_notify_format_name_to_type(jsonName), FrameReceiver::Defaults::NotifyFormatJson);
+    BOOST_CHECK_EQUAL(theConfig.map_notify_format_name_to_type(binaryName), FrameReceiver::Defaults::NotifyFormatBinary);
+    BOOST_CHECK_EQUAL(theConfig.map_notify_format_name_to_type(badName), FrameReceiver::Defaults::NotifyFormatIllegal);
+}
+
+BOOST_AUTO_TEST_CASE( ValidReactorBackendNameToTypeMapping )
+{
+    FrameReceiver::FrameReceiverConfig theConfig;
+    std::string pollName  = "poll";
+    std::string epollName = "epoll";
+    std::string badName   = "select";
+
+    BOOST_CHECK_EQUAL(theConfig.map_reactor_backend_name_to_type(pollName), FrameReceiver::Defaults::ReactorBackendPoll);
+    BOOST_CHECK_EQUAL(theConfig.map_reactor_backend_name_to_type(epollName), FrameReceiver::Defaults::ReactorBackendEpoll);
+    BOOST_CHECK_EQUAL(theConfig.map_reactor_backend_name_to_type(badName), FrameReceiver::Defaults::ReactorBackendIllegal);
+}
+
+BOOST_AUTO_TEST_CASE( ValidNumaPolicyNameToTypeMapping )
+{
+    FrameReceiver::FrameReceiverConfig theConfig;
+    std::string defaultName    = "default";
+    std::string bindName       = "bind";
+    std::string interleaveName = "interleave";
+    std::string badName        = "local";
+
+    BOOST_CHECK_EQUAL(theConfig.map_numa_policy_name_to_type(defaultName), FrameReceiver::Defaults::NumaPolicyDefault);
+    BOOST_CHECK_EQUAL(theConfig.map_numa_policy_name_to_type(bindName), FrameReceiver::Defaults::NumaPolicyBind);
+    BOOST_CHECK_EQUAL(theConfig.map_numa_policy_name_to_type(interleaveName), FrameReceiver::Defaults::NumaPolicyInterleave);
+    BOOST_CHECK_EQUAL(theConfig.map_numa_policy_name_to_type(badName), FrameReceiver::Defaults::NumaPolicyIllegal);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 
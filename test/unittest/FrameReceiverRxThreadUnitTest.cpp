@@ -18,6 +18,10 @@
 #include <log4cxx/basicconfigurator.h>
 #include <log4cxx/simplelayout.h>
 
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/udp.h>
+
 namespace FrameReceiver
 {
     class FrameReceiverRxThreadTestProxy
@@ -37,6 +41,27 @@ namespace FrameReceiver
         {
             return config_.rx_channel_endpoint_;
         }
+
+        void set_busy_poll(bool busy_poll, unsigned int busy_poll_interval)
+        {
+            config_.rx_busy_poll_ = busy_poll;
+            config_.rx_busy_poll_interval_ = busy_poll_interval;
+        }
+
+        void set_udp_gro(bool udp_gro)
+        {
+            config_.rx_udp_gro_ = udp_gro;
+        }
+
+        uint16_t get_rx_port(void)
+        {
+            return config_.rx_ports_[0];
+        }
+
+        unsigned int get_num_rx_ports(void)
+        {
+            return config_.rx_ports_.size();
+        }
     private:
         FrameReceiver::FrameReceiverConfig& config_;
     };
@@ -70,12 +95,17 @@ public:
         BOOST_TEST_MESSAGE("Tear down test fixture");
     }
 
+    void relay_frame_ready(int buffer_id, int frame_number, int frame_state, uint64_t frame_timestamp_ns, bool spilled)
+    {
+    }
+
     FrameReceiver::IpcChannel rx_channel;
     FrameReceiver::FrameReceiverConfig config;
     log4cxx::LoggerPtr logger;
     FrameReceiver::FrameReceiverRxThreadTestProxy proxy;
     FrameReceiver::FrameDecoderPtr frame_decoder;
     FrameReceiver::SharedBufferManagerPtr buffer_manager;
+    FrameReceiver::IpcReactor relay_reactor;
 };
 
 BOOST_FIXTURE_TEST_SUITE(FrameReceiverRxThreadUnitTest, FrameReceiverRxThreadTestFixture);
@@ -86,7 +116,8 @@ BOOST_AUTO_TEST_CASE( CreateAndPingRxThread )
     bool initOK = true;
 
     try {
-        FrameReceiver::FrameReceiverRxThread rxThread(config, logger, buffer_manager, frame_decoder, 1);
+        FrameReceiver::FrameReceiverRxThread rxThread(config, logger, buffer_manager, frame_decoder, relay_reactor,
+                boost::bind(&FrameReceiverRxThreadTestFixture::relay_frame_ready, this, _1, _2, _3, _4, _5), 1);
 
         FrameReceiver::IpcMessage::MsgType msg_type = FrameReceiver::IpcMessage::MsgTypeCmd;
         FrameReceiver::IpcMessage::MsgVal  msg_val =  FrameReceiver::IpcMessage::MsgValCmdStatus;
@@ -135,6 +166,107 @@ BOOST_AUTO_TEST_CASE( CreateAndPingRxThread )
 
 }
 
+BOOST_AUTO_TEST_CASE( BusyPollRxThreadStatus )
+{
+    proxy.set_busy_poll(true, 100);
+
+    bool initOK = true;
+
+    try {
+        FrameReceiver::FrameReceiverRxThread rxThread(config, logger, buffer_manager, frame_decoder, relay_reactor,
+                boost::bind(&FrameReceiverRxThreadTestFixture::relay_frame_ready, this, _1, _2, _3, _4, _5), 1);
+
+        FrameReceiver::IpcMessage message(FrameReceiver::IpcMessage::MsgTypeCmd, FrameReceiver::IpcMessage::MsgValCmdStatus);
+        message.set_param<int>("count", 0);
+        rx_channel.send(message.encode());
+
+        // The RX channel is serviced from the busy-poll loop rather than the reactor poll
+        BOOST_REQUIRE(rx_channel.poll(1000));
+        std::string reply = rx_channel.recv();
+
+        FrameReceiver::IpcMessage response(reply.c_str());
+        BOOST_CHECK_EQUAL(response.get_msg_type(), FrameReceiver::IpcMessage::MsgTypeAck);
+        BOOST_CHECK_EQUAL(response.get_param<int>("count", -1), 0);
+        BOOST_CHECK_EQUAL(response.get_param<bool>("busy_poll", false), true);
+        BOOST_CHECK(response.get_param<uint64_t>("busy_poll_iterations", 0) > 0);
+        BOOST_CHECK_EQUAL(response.get_param<uint64_t>("socket_drops", 1), 0);
+    }
+    catch (FrameReceiver::FrameReceiverException& e)
+    {
+        initOK = false;
+        BOOST_TEST_MESSAGE("Creation of FrameReceiverRxThread failed: " << e.what());
+    }
+    BOOST_REQUIRE_EQUAL(initOK, true);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE( UdpGroRxThreadReceive )
+{
+    proxy.set_udp_gro(true);
+
+    bool initOK = true;
+
+    try {
+        FrameReceiver::FrameReceiverRxThread rxThread(config, logger, buffer_manager, frame_decoder, relay_reactor,
+                boost::bind(&FrameReceiverRxThreadTestFixture::relay_frame_ready, this, _1, _2, _3, _4, _5), 1);
+
+        // Send several full size packets as a single segmented datagram, which is delivered to a
+        // socket with UDP GRO enabled still coalesced, so that the RX thread must split it
+        const size_t num_packets = 8;
+        const size_t packet_size = PercivalEmulator::packet_header_size + PercivalEmulator::primary_packet_size;
+        std::vector<uint8_t> datagram(num_packets * packet_size, 0);
+
+        int send_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        int segment_size = packet_size;
+        bool segmented = (setsockopt(send_socket, SOL_UDP, 103 /* UDP_SEGMENT */, &segment_size, sizeof(segment_size)) == 0);
+
+        struct sockaddr_in dest_addr;
+        memset(&dest_addr, 0, sizeof(dest_addr));
+        dest_addr.sin_family = AF_INET;
+        dest_addr.sin_port = htons(proxy.get_rx_port());
+        dest_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (segmented)
+        {
+            sendto(send_socket, &datagram[0], datagram.size(), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+        }
+        else
+        {
+            for (size_t packet = 0; packet < num_packets; packet++)
+            {
+                sendto(send_socket, &datagram[packet * packet_size], packet_size, 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+            }
+        }
+        close(send_socket);
+
+        // Poll the RX thread status until all packets have been received
+        uint64_t segments_received = 0;
+        for (int attempt = 0; (attempt < 10) && (segments_received < num_packets); attempt++)
+        {
+            FrameReceiver::IpcMessage message(FrameReceiver::IpcMessage::MsgTypeCmd, FrameReceiver::IpcMessage::MsgValCmdStatus);
+            message.set_param<int>("count", attempt);
+            rx_channel.send(message.encode());
+
+            BOOST_REQUIRE(rx_channel.poll(1000));
+            FrameReceiver::IpcMessage response(rx_channel.recv().c_str());
+            BOOST_CHECK_EQUAL(response.get_param<bool>("udp_gro", false), true);
+            BOOST_CHECK_EQUAL(response.get_param<unsigned int>("udp_gro_sockets", 0), proxy.get_num_rx_ports());
+            segments_received = response.get_param<uint64_t>("udp_gro_segments", 0);
+            if (segments_received < num_packets)
+            {
+                usleep(10000);
+            }
+        }
+        BOOST_CHECK_EQUAL(segments_received, num_packets);
+    }
+    catch (FrameReceiver::FrameReceiverException& e)
+    {
+        initOK = false;
+        BOOST_TEST_MESSAGE("Creation of FrameReceiverRxThread failed: " << e.what());
+    }
+    BOOST_REQUIRE_EQUAL(initOK, true);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
 
 
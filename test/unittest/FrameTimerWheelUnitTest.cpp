@@ -0,0 +1,115 @@
+/*
+ * FrameTimerWheelUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+#include "FrameTimerWheel.h"
+
+class FrameTimerWheelTestFixture
+{
+public:
+    FrameTimerWheelTestFixture() :
+        wheel(16),
+        start_ms(1000000)
+    {
+        // Start the wheel turning before any timeouts are scheduled
+        wheel.advance(start_ms, expired);
+    }
+
+    FrameReceiver::FrameTimerWheel wheel;
+    uint64_t start_ms;
+    std::vector<FrameReceiver::FrameTimerExpiry> expired;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FrameTimerWheelUnitTest, FrameTimerWheelTestFixture);
+
+BOOST_AUTO_TEST_CASE( TimerWheelSize )
+{
+    BOOST_CHECK_EQUAL(wheel.get_num_slots(), 16);
+    BOOST_CHECK_EQUAL(FrameReceiver::FrameTimerWheel(1001).get_num_slots(), 1024);
+    BOOST_CHECK_EQUAL(FrameReceiver::FrameTimerWheel(1).get_num_slots(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( TimerExpiryOrder )
+{
+    wheel.schedule(0, 100, start_ms + 5);
+    wheel.schedule(1, 101, start_ms + 3);
+    wheel.schedule(2, 102, start_ms + 5);
+    BOOST_CHECK_EQUAL(wheel.get_num_scheduled(), 3);
+
+    // Timeouts expire on the millisecond they are due and not before
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 2, expired), 0);
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 3, expired), 1);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 1);
+    BOOST_CHECK_EQUAL(expired[0].frame_number, 101);
+
+    expired.clear();
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 5, expired), 2);
+    BOOST_CHECK_EQUAL(expired.size(), 2);
+    BOOST_CHECK_EQUAL(wheel.get_num_scheduled(), 0);
+
+    // Advancing again, or backwards, expires nothing
+    expired.clear();
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 5, expired), 0);
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 1, expired), 0);
+    BOOST_CHECK_EQUAL(expired.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( TimerCancelAndReschedule )
+{
+    wheel.schedule(0, 100, start_ms + 4);
+    wheel.schedule(1, 101, start_ms + 4);
+    wheel.schedule(2, 102, start_ms + 4);
+
+    // Cancel a timeout from the middle of a slot list, and one that is not scheduled
+    BOOST_CHECK(wheel.cancel(1));
+    BOOST_CHECK(!wheel.cancel(1));
+    BOOST_CHECK(!wheel.cancel(7));
+    BOOST_CHECK_EQUAL(wheel.get_num_scheduled(), 2);
+
+    // Rescheduling a buffer replaces its existing timeout
+    wheel.schedule(2, 103, start_ms + 8);
+    BOOST_CHECK_EQUAL(wheel.get_num_scheduled(), 2);
+
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 4, expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 0);
+    expired.clear();
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 8, expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 2);
+    BOOST_CHECK_EQUAL(expired[0].frame_number, 103);
+
+    // A timeout that is already due expires on the next advance
+    expired.clear();
+    wheel.schedule(3, 104, start_ms);
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 9, expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 3);
+}
+
+BOOST_AUTO_TEST_CASE( TimerWheelRounds )
+{
+    // Timeouts further ahead than the wheel size share slots with earlier ones and must only
+    // expire once the wheel has turned enough times
+    wheel.schedule(0, 100, start_ms + 2);
+    wheel.schedule(1, 101, start_ms + 2 + wheel.get_num_slots());
+    wheel.schedule(2, 102, start_ms + 2 + (3 * wheel.get_num_slots()));
+
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 2, expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 0);
+    expired.clear();
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 2 + wheel.get_num_slots(), expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 1);
+
+    // Jumping forward by more than a full turn still expires the remaining timeout
+    expired.clear();
+    BOOST_CHECK_EQUAL(wheel.advance(start_ms + 1000, expired), 1);
+    BOOST_CHECK_EQUAL(expired[0].buffer_id, 2);
+    BOOST_CHECK_EQUAL(wheel.get_num_scheduled(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
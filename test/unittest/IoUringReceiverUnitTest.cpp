@@ -0,0 +1,190 @@
+/*
+ * IoUringReceiverUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <string>
+
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "IoUringReceiver.h"
+#include "gettime.h"
+
+#ifdef HAVE_IO_URING
+
+const uint16_t uring_test_port = 9125;
+
+class IoUringReceiverTestFixture
+{
+public:
+    IoUringReceiverTestFixture() :
+        logger(log4cxx::Logger::getLogger("IoUringReceiverUnitTest"))
+    {
+        handler = boost::bind(&IoUringReceiverTestFixture::handle_packet, this, _1, _2, _3, _4);
+
+        recv_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        struct sockaddr_in recv_addr;
+        memset(&recv_addr, 0, sizeof(recv_addr));
+        recv_addr.sin_family = AF_INET;
+        recv_addr.sin_port = htons(uring_test_port);
+        recv_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        BOOST_REQUIRE_EQUAL(bind(recv_socket, (struct sockaddr*)&recv_addr, sizeof(recv_addr)), 0);
+
+        sockets.push_back(recv_socket);
+        ports.push_back(uring_test_port);
+    }
+
+    ~IoUringReceiverTestFixture()
+    {
+        close(recv_socket);
+    }
+
+    void handle_packet(uint8_t* payload, size_t payload_size, int port, struct sockaddr_in* from_addr)
+    {
+        received_payloads.push_back(std::string(reinterpret_cast<char*>(payload), payload_size));
+        received_ports.push_back(port);
+        received_addrs.push_back(from_addr->sin_addr.s_addr);
+    }
+
+    // io_uring may be disabled at run time, so allow tests to be skipped without it
+    bool can_receive(void)
+    {
+        if (!FrameReceiver::IoUringReceiver::is_supported())
+        {
+            BOOST_TEST_MESSAGE("Skipping io_uring receiver test, io_uring is not available");
+            return false;
+        }
+        return true;
+    }
+
+    void send_packet(uint16_t port, const std::string& payload)
+    {
+        int send_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        struct sockaddr_in dest_addr;
+        memset(&dest_addr, 0, sizeof(dest_addr));
+        dest_addr.sin_family = AF_INET;
+        dest_addr.sin_port = htons(port);
+        dest_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        sendto(send_socket, payload.c_str(), payload.size(), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+        close(send_socket);
+    }
+
+    void receive_packets(FrameReceiver::IoUringReceiver& receiver, size_t num_packets)
+    {
+        struct timespec start_time, now;
+        gettime(&start_time);
+        while (received_payloads.size() < num_packets)
+        {
+            struct pollfd poll_fd;
+            poll_fd.fd = receiver.get_event_fd();
+            poll_fd.events = POLLIN;
+            poll(&poll_fd, 1, 100);
+            receiver.process_completions(handler);
+
+            gettime(&now);
+            if (now.tv_sec - start_time.tv_sec > 2) break;
+        }
+    }
+
+    log4cxx::LoggerPtr logger;
+    int recv_socket;
+    std::vector<int> sockets;
+    std::vector<int> ports;
+    FrameReceiver::PacketRingHandler handler;
+    std::vector<std::string> received_payloads;
+    std::vector<int> received_ports;
+    std::vector<in_addr_t> received_addrs;
+};
+
+BOOST_FIXTURE_TEST_SUITE(IoUringReceiverUnitTest, IoUringReceiverTestFixture);
+
+BOOST_AUTO_TEST_CASE( IllegalIoUringConfiguration )
+{
+    if (!can_receive()) return;
+
+    BOOST_CHECK_THROW(FrameReceiver::IoUringReceiver(logger, sockets, ports, 0, 2048),
+            FrameReceiver::IoUringReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::IoUringReceiver(logger, sockets, ports, 100, 2048),
+            FrameReceiver::IoUringReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::IoUringReceiver(logger, sockets, ports, 64, 16),
+            FrameReceiver::IoUringReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::IoUringReceiver(logger, sockets, std::vector<int>(), 64, 2048),
+            FrameReceiver::IoUringReceiverException);
+}
+
+BOOST_AUTO_TEST_CASE( LoopbackIoUringReceive )
+{
+    if (!can_receive()) return;
+
+    FrameReceiver::IoUringReceiver receiver(logger, sockets, ports, 64, 2048);
+
+    const size_t num_packets = 10;
+    for (size_t packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        send_packet(uring_test_port, ss.str());
+    }
+
+    receive_packets(receiver, num_packets);
+
+    BOOST_REQUIRE_EQUAL(received_payloads.size(), num_packets);
+    for (size_t packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        BOOST_CHECK_EQUAL(received_payloads[packet], ss.str());
+        BOOST_CHECK_EQUAL(received_ports[packet], uring_test_port);
+        BOOST_CHECK_EQUAL(received_addrs[packet], inet_addr("127.0.0.1"));
+    }
+    BOOST_CHECK_EQUAL(receiver.get_packets_received(), num_packets);
+    BOOST_CHECK_EQUAL(receiver.get_packets_truncated(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( IoUringReceiveBufferRecycling )
+{
+    if (!can_receive()) return;
+
+    // Send more packets than there are receive buffers before processing any completions, so
+    // that the multishot receive stalls and must be re-armed once the buffers are recycled
+    const unsigned int num_buffers = 8;
+    FrameReceiver::IoUringReceiver receiver(logger, sockets, ports, num_buffers, 256);
+
+    const size_t num_packets = 40;
+    for (size_t packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        send_packet(uring_test_port, ss.str());
+    }
+
+    receive_packets(receiver, num_packets);
+
+    BOOST_REQUIRE_EQUAL(received_payloads.size(), num_packets);
+    for (size_t packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        BOOST_CHECK_EQUAL(received_payloads[packet], ss.str());
+    }
+    BOOST_CHECK(receiver.get_buffer_stalls() > 0);
+
+    // A packet larger than a receive buffer is truncated
+    send_packet(uring_test_port, std::string(512, 'x'));
+    receive_packets(receiver, num_packets + 1);
+    BOOST_REQUIRE_EQUAL(received_payloads.size(), num_packets + 1);
+    BOOST_CHECK(received_payloads.back().size() < 512);
+    BOOST_CHECK_EQUAL(receiver.get_packets_truncated(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+#endif
@@ -9,6 +9,15 @@
 
 #include "IpcChannel.h"
 
+#include <sstream>
+#include <vector>
+#include <string.h>
+
+static void free_test_data(void* data, void* hint)
+{
+    *(static_cast<bool*>(hint)) = true;
+}
+
 struct TestFixture
 {
     TestFixture() :
@@ -30,6 +39,27 @@ struct TestFixture
     FrameReceiver::IpcChannel recv_channel;
 };
 
+struct MessagePartTestFixture
+{
+    MessagePartTestFixture() :
+        send_channel(ZMQ_PAIR),
+        recv_channel(ZMQ_PAIR)
+    {
+        // Use a different endpoint for each test, as an inproc endpoint may not be released as soon as
+        // the channel bound to it is closed
+        static int endpoint_id = 0;
+        std::stringstream ss;
+        ss << "inproc://message_part_channel_" << endpoint_id++;
+        std::string endpoint = ss.str();
+
+        send_channel.bind(endpoint);
+        recv_channel.connect(endpoint);
+    }
+
+    FrameReceiver::IpcChannel send_channel;
+    FrameReceiver::IpcChannel recv_channel;
+};
+
 BOOST_FIXTURE_TEST_SUITE( IpcChannelUnitTest , TestFixture);
 
 BOOST_AUTO_TEST_CASE( InprocBasicSendReceive )
@@ -55,5 +85,45 @@ BOOST_AUTO_TEST_CASE( BasicSendReceiveWithPoll )
 
 }
 
+BOOST_FIXTURE_TEST_CASE( MultipartZeroCopySendReceive, MessagePartTestFixture )
+{
+    std::string header("Multipart header");
+    std::vector<char> data(1024);
+    for (size_t idx = 0; idx < data.size(); idx++)
+    {
+        data[idx] = static_cast<char>(idx);
+    }
+    bool data_freed = false;
+
+    send_channel.send(header, true);
+    send_channel.send(&data[0], data.size(), free_test_data, &data_freed);
+
+    BOOST_CHECK_EQUAL(recv_channel.recv(), header);
+    BOOST_CHECK(recv_channel.recv_more());
+    {
+        FrameReceiver::IpcMessagePart part;
+        recv_channel.recv(part);
+        BOOST_CHECK(!part.more());
+        BOOST_CHECK(!recv_channel.recv_more());
+        BOOST_REQUIRE_EQUAL(part.size(), data.size());
+        BOOST_CHECK_EQUAL(memcmp(part.data(), &data[0], data.size()), 0);
+    }
+
+    // The data are freed once the part holding them is released
+    BOOST_CHECK(data_freed);
+}
+
+BOOST_FIXTURE_TEST_CASE( MessagePartReceivesString, MessagePartTestFixture )
+{
+    std::string testMessage("Message part test message");
+    send_channel.send(testMessage);
+
+    FrameReceiver::IpcMessagePart part;
+    recv_channel.recv(part);
+    BOOST_CHECK(!part.more());
+    BOOST_REQUIRE_EQUAL(part.size(), testMessage.size() + 1);
+    BOOST_CHECK_EQUAL(std::string(static_cast<const char*>(part.data())), testMessage);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
@@ -256,6 +256,90 @@ BOOST_AUTO_TEST_CASE( MissingParamsIpcMessageFromStringStrictValidation )
 			FrameReceiver::IpcMessageException);
 }
 
+BOOST_AUTO_TEST_CASE( DecodeIntoReusedIpcMessage )
+{
+	// Decode successive messages into the same message object, which should replace the contents each time
+	FrameReceiver::IpcMessage theMsg;
+
+	theMsg.decode("{\"msg_type\":\"cmd\", \"msg_val\":\"status\", \"timestamp\" : \"2015-01-27T15:26:01.123456\", "
+			"\"params\" : { \"paramInt\" : 1234, \"paramStr\" : \"testParam\" } }");
+	BOOST_CHECK_EQUAL(theMsg.is_valid(), true);
+	BOOST_CHECK_EQUAL(theMsg.get_msg_val(), FrameReceiver::IpcMessage::MsgValCmdStatus);
+	BOOST_CHECK_EQUAL(theMsg.get_param<int>("paramInt"), 1234);
+	BOOST_CHECK_EQUAL(theMsg.get_param<std::string>("paramStr"), "testParam");
+
+	theMsg.decode("{\"msg_type\":\"notify\", \"msg_val\":\"frame_release\", \"timestamp\" : \"2015-01-27T15:26:02.5\", "
+			"\"params\" : { \"frame\" : 12 } }");
+	BOOST_CHECK_EQUAL(theMsg.get_msg_type(), FrameReceiver::IpcMessage::MsgTypeNotify);
+	BOOST_CHECK_EQUAL(theMsg.get_msg_val(), FrameReceiver::IpcMessage::MsgValNotifyFrameRelease);
+	BOOST_CHECK_EQUAL(theMsg.get_msg_timestamp(), "2015-01-27T15:26:02.500000");
+	BOOST_CHECK_EQUAL(theMsg.get_param<int>("frame"), 12);
+	BOOST_CHECK_EQUAL(theMsg.has_param("paramInt"), false);
+
+	// Parameters set on a decoded message should be encoded along with those parsed
+	theMsg.set_param("paramStr", std::string("addedParam"));
+	FrameReceiver::IpcMessage msgFromEncoded(theMsg.encode());
+	BOOST_CHECK_EQUAL((msgFromEncoded == theMsg), true);
+
+	// Reset the message for sending, which should remove the parameters and timestamp it afresh
+	theMsg.reset(FrameReceiver::IpcMessage::MsgTypeAck, FrameReceiver::IpcMessage::MsgValCmdConfigure);
+	BOOST_CHECK_EQUAL(theMsg.is_valid(), true);
+	BOOST_CHECK_EQUAL(theMsg.get_msg_type(), FrameReceiver::IpcMessage::MsgTypeAck);
+	BOOST_CHECK_EQUAL(theMsg.has_param("frame"), false);
+	BOOST_CHECK(theMsg.get_msg_timestamp() != "2015-01-27T15:26:02.500000");
+
+	// An illegal message should still be rejected when decoded with strict validation
+	BOOST_CHECK_THROW(theMsg.decode("{\"msg_type\":\"wrong\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"2015-01-27T15:26:01.123456\", \"params\" : {} }"), FrameReceiver::IpcMessageException);
+}
+
+BOOST_AUTO_TEST_CASE( DeferredTimestampIpcMessageFromString )
+{
+	const char* illegalTimestampMsg = "{\"msg_type\":\"cmd\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"1 Jan 1970 00:00:00\", \"params\" : {} }";
+
+	// With the timestamp deferred, an illegal timestamp is only rejected when first accessed
+	FrameReceiver::IpcMessage deferredMsg(illegalTimestampMsg, true, true);
+	BOOST_CHECK_EQUAL(deferredMsg.get_msg_val(), FrameReceiver::IpcMessage::MsgValCmdStatus);
+	BOOST_CHECK_THROW(deferredMsg.get_msg_timestamp(), FrameReceiver::IpcMessageException);
+
+	// Validating a message with an illegal deferred timestamp should report it invalid, not throw
+	FrameReceiver::IpcMessage unvalidatedMsg(illegalTimestampMsg, true, true);
+	BOOST_CHECK_NO_THROW(unvalidatedMsg.is_valid());
+	BOOST_CHECK_EQUAL(unvalidatedMsg.is_valid(), false);
+
+	// A deferred timestamp that has not been accessed should be encoded as received
+	FrameReceiver::IpcMessage relayedMsg("{\"msg_type\":\"cmd\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"2015-01-27T15:26:01.123456\", \"params\" : {} }", true, true);
+	FrameReceiver::IpcMessage msgFromEncoded(relayedMsg.encode());
+	BOOST_CHECK_EQUAL(msgFromEncoded.get_msg_timestamp(), "2015-01-27T15:26:01.123456");
+	BOOST_CHECK_EQUAL(relayedMsg.get_msg_timestamp(), "2015-01-27T15:26:01.123456");
+	BOOST_CHECK_EQUAL((msgFromEncoded == relayedMsg), true);
+}
+
+BOOST_AUTO_TEST_CASE( IpcMessageTimestampFormats )
+{
+	// The cached timestamp source should agree with the local time given by boost
+	boost::posix_time::ptime before = boost::posix_time::microsec_clock::local_time();
+	boost::posix_time::ptime now = FrameReceiver::IpcMessage::current_timestamp();
+	boost::posix_time::ptime after = boost::posix_time::microsec_clock::local_time();
+	BOOST_CHECK(now >= before);
+	BOOST_CHECK(now <= after);
+
+	// Timestamps without fractional seconds, or in other formats accepted by boost, should parse
+	FrameReceiver::IpcMessage wholeSecondsMsg("{\"msg_type\":\"cmd\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"2015-01-27T15:26:01\", \"params\" : {} }");
+	BOOST_CHECK_EQUAL(wholeSecondsMsg.get_msg_timestamp(), "2015-01-27T15:26:01");
+
+	FrameReceiver::IpcMessage basicFormatMsg("{\"msg_type\":\"cmd\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"2015-Jan-27T15:26:01.000010\", \"params\" : {} }");
+	BOOST_CHECK_EQUAL(basicFormatMsg.get_msg_timestamp(), "2015-01-27T15:26:01.000010");
+
+	// Dates that do not exist should be illegal
+	BOOST_CHECK_THROW(FrameReceiver::IpcMessage illegalDateMsg("{\"msg_type\":\"cmd\", \"msg_val\":\"status\", "
+			"\"timestamp\" : \"2015-02-30T15:26:01.123456\", \"params\" : {} }"), FrameReceiver::IpcMessageException);
+}
+
 // Calculate the difference, in seconds, between two timespecs
 #define NANOSECONDS_PER_SECOND 1000000000
 double timeDiff(struct timespec* start, struct timespec* end)
@@ -315,4 +399,67 @@ BOOST_AUTO_TEST_CASE( TestIpcMessageCreationSpeed )
 
 }
 
+BOOST_AUTO_TEST_CASE( TestIpcMessageReuseSpeed )
+{
+	int numLoops = 100000;
+	struct timespec start, end;
+	double rate;
+	const char* encodedMsg = "{\"msg_type\":\"notify\", \"msg_val\":\"frame_release\", "
+			"\"timestamp\" : \"2015-01-27T15:26:01.123456\", "
+			"\"params\" : { \"frame\" : 1234, \"buffer_id\" : 5, \"consumer\" : 1 } }";
+
+	// Encode with a new message object for every message
+	gettime(&start);
+	for (int i = 0; i < numLoops; i++)
+	{
+		FrameReceiver::IpcMessage newMessage(FrameReceiver::IpcMessage::MsgTypeNotify,
+				FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+		newMessage.set_param<int>("frame", i);
+		newMessage.set_param<int>("buffer_id", 5);
+		newMessage.encode();
+	}
+	gettime(&end);
+	rate = (double)numLoops / timeDiff(&start, &end);
+	BOOST_TEST_MESSAGE("Encoded " << numLoops << " IPC messages with a new message each time at " << rate << " messages/sec");
+
+	// Encode with a single message object reset for every message
+	FrameReceiver::IpcMessage reusedMessage;
+	gettime(&start);
+	for (int i = 0; i < numLoops; i++)
+	{
+		reusedMessage.reset(FrameReceiver::IpcMessage::MsgTypeNotify, FrameReceiver::IpcMessage::MsgValNotifyFrameReady);
+		reusedMessage.set_param<int>("frame", i);
+		reusedMessage.set_param<int>("buffer_id", 5);
+		reusedMessage.encode();
+	}
+	gettime(&end);
+	rate = (double)numLoops / timeDiff(&start, &end);
+	BOOST_TEST_MESSAGE("Encoded " << numLoops << " IPC messages reusing one message at " << rate << " messages/sec");
+
+	// Decode into a new message object for every message
+	int frameSum = 0;
+	gettime(&start);
+	for (int i = 0; i < numLoops; i++)
+	{
+		FrameReceiver::IpcMessage newMessage(encodedMsg);
+		frameSum += newMessage.get_param<int>("frame");
+	}
+	gettime(&end);
+	rate = (double)numLoops / timeDiff(&start, &end);
+	BOOST_TEST_MESSAGE("Decoded " << numLoops << " IPC messages into a new message each time at " << rate << " messages/sec");
+
+	// Decode into a single message object, deferring parsing of the timestamp which is never accessed
+	gettime(&start);
+	for (int i = 0; i < numLoops; i++)
+	{
+		reusedMessage.decode(encodedMsg, true);
+		frameSum -= reusedMessage.get_param<int>("frame");
+	}
+	gettime(&end);
+	rate = (double)numLoops / timeDiff(&start, &end);
+	BOOST_TEST_MESSAGE("Decoded " << numLoops << " IPC messages reusing one message with deferred timestamps at " << rate << " messages/sec");
+
+	BOOST_CHECK_EQUAL(frameSum, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
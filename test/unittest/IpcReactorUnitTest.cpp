@@ -6,12 +6,14 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
 #include <iostream>
 
 #include "IpcChannel.h"
 #include "IpcReactor.h"
 
 #include <stdlib.h>
+#include <unistd.h>
 #include <sstream>
 
 class ReactorTestFixture
@@ -21,6 +23,9 @@ public:
         send_channel(ZMQ_PAIR),
         recv_channel(ZMQ_PAIR),
         timer_count(0),
+        post_count(0),
+        recv_count(0),
+        socket_count(0),
         test_message("This is a test message")
     {
         BOOST_TEST_MESSAGE("Setup test fixture");
@@ -29,7 +34,7 @@ public:
         int endpoint_id = random();
         std::stringstream ss;
         ss << "inproc://reactor_channel_" << endpoint_id;
-        const char* random_endpoint = ss.str().c_str();
+        std::string random_endpoint = ss.str();
 
         // Bind the send channel and connect the receive channel
         send_channel.bind(random_endpoint);
@@ -48,6 +53,24 @@ public:
         timer_count++;
     }
 
+    void post_handler(void)
+    {
+        post_count++;
+    }
+
+    void post_tasks(FrameReceiver::IpcReactor* post_reactor, unsigned int num_tasks)
+    {
+        for (unsigned int task = 0; task < num_tasks; task++)
+        {
+            post_reactor->post(boost::bind(&ReactorTestFixture::post_handler, this));
+        }
+    }
+
+    void removed_timer_handler(void)
+    {
+        BOOST_ERROR("Removed timer fired");
+    }
+
     void recv_handler(void)
     {
         received_message = recv_channel.recv();
@@ -60,10 +83,154 @@ public:
         send_channel.send(test_message);
     }
 
+    void timed_send_poll_handler(void)
+    {
+        send_channel.send(test_message);
+        recv_channel.poll(0);
+    }
+
+    void stop_handler(FrameReceiver::IpcReactor* stop_reactor)
+    {
+        stop_reactor->stop();
+    }
+
+    void count_recv_handler(void)
+    {
+        received_message = recv_channel.recv();
+        recv_count++;
+    }
+
+    void socket_handler(int fd)
+    {
+        char byte;
+        if (read(fd, &byte, 1) == 1)
+        {
+            socket_count++;
+        }
+    }
+
+    void check_backend_dispatch(FrameReceiver::Defaults::ReactorBackend backend)
+    {
+        FrameReceiver::IpcReactor backend_reactor(backend);
+        BOOST_CHECK_EQUAL(backend_reactor.get_backend(), backend);
+
+        int pipe_fds[2];
+        BOOST_REQUIRE_EQUAL(pipe(pipe_fds), 0);
+
+        backend_reactor.register_channel(recv_channel, boost::bind(&ReactorTestFixture::count_recv_handler, this));
+        backend_reactor.register_socket(pipe_fds[0], boost::bind(&ReactorTestFixture::socket_handler, this, pipe_fds[0]));
+
+        // Handlers receive one message or byte per call, so several queued at once must each be dispatched
+        const unsigned int num_messages = 3;
+        for (unsigned int msg = 0; msg < num_messages; msg++)
+        {
+            send_channel.send(test_message);
+        }
+        BOOST_REQUIRE_EQUAL(write(pipe_fds[1], "abc", num_messages), num_messages);
+
+        int iterations = 0;
+        while (((recv_count < num_messages) || (socket_count < num_messages)) && (iterations++ < 100))
+        {
+            BOOST_CHECK_EQUAL(backend_reactor.run_once(10), 0);
+        }
+        BOOST_CHECK_EQUAL(recv_count, num_messages);
+        BOOST_CHECK_EQUAL(socket_count, num_messages);
+
+        // Removed channels and sockets are no longer dispatched
+        backend_reactor.remove_channel(recv_channel);
+        backend_reactor.remove_socket(pipe_fds[0]);
+        send_channel.send(test_message);
+        BOOST_REQUIRE_EQUAL(write(pipe_fds[1], "d", 1), 1);
+        BOOST_CHECK_EQUAL(backend_reactor.run_once(10), 0);
+        BOOST_CHECK_EQUAL(recv_count, num_messages);
+        BOOST_CHECK_EQUAL(socket_count, num_messages);
+
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+    }
+
+    void check_backend_timers(FrameReceiver::Defaults::ReactorBackend backend)
+    {
+        FrameReceiver::IpcReactor backend_reactor(backend);
+
+        const unsigned int max_count = 5;
+        const size_t delay_us = 500;
+        int removed_timer_id = backend_reactor.register_timer_us(delay_us / 2, 0,
+                boost::bind(&ReactorTestFixture::removed_timer_handler, this));
+        backend_reactor.register_timer_us(delay_us, max_count, boost::bind(&ReactorTestFixture::timer_handler, this));
+        backend_reactor.remove_timer(removed_timer_id);
+
+        // Timers removed long before they are due are discarded from the timer heap, without
+        // disturbing the timer remaining
+        for (unsigned int timer = 0; timer < 1000; timer++)
+        {
+            backend_reactor.remove_timer(backend_reactor.register_timer(1000000, 1,
+                    boost::bind(&ReactorTestFixture::removed_timer_handler, this)));
+        }
+
+        // The reactor runs until the remaining timer has expired, which must not be before it is due
+        FrameReceiver::TimeUs start_us = FrameReceiver::IpcReactorTimer::clock_mono_us();
+        BOOST_CHECK_EQUAL(backend_reactor.run(), 0);
+        FrameReceiver::TimeUs elapsed_us = FrameReceiver::IpcReactorTimer::clock_mono_us() - start_us;
+
+        BOOST_CHECK_EQUAL(timer_count, max_count);
+        BOOST_CHECK(elapsed_us >= (FrameReceiver::TimeUs)(delay_us * max_count));
+        BOOST_CHECK(elapsed_us < 1000000);
+    }
+
+    void check_backend_post(FrameReceiver::Defaults::ReactorBackend backend)
+    {
+        FrameReceiver::IpcReactor backend_reactor(backend);
+
+        // Tasks posted before the reactor runs are called on its next iteration
+        backend_reactor.post(boost::bind(&ReactorTestFixture::post_handler, this));
+        BOOST_CHECK_EQUAL(post_count, 0);
+        BOOST_CHECK_EQUAL(backend_reactor.run_once(0), 0);
+        BOOST_CHECK_EQUAL(post_count, 1);
+
+        // Tasks posted concurrently from several threads are each called once
+        const unsigned int num_threads = 4;
+        const unsigned int num_tasks = 10000;
+        boost::thread_group posting_threads;
+        for (unsigned int thread = 0; thread < num_threads; thread++)
+        {
+            posting_threads.create_thread(boost::bind(&ReactorTestFixture::post_tasks, this, &backend_reactor, num_tasks));
+        }
+
+        const unsigned int expected_count = 1 + (num_threads * num_tasks);
+        int iterations = 0;
+        while ((post_count < expected_count) && (iterations++ < 1000))
+        {
+            BOOST_CHECK_EQUAL(backend_reactor.run_once(100), 0);
+        }
+        posting_threads.join_all();
+        BOOST_CHECK_EQUAL(backend_reactor.run_once(0), 0);
+        BOOST_CHECK_EQUAL(post_count, expected_count);
+    }
+
+    void check_backend_used_channel(FrameReceiver::Defaults::ReactorBackend backend)
+    {
+        FrameReceiver::IpcReactor backend_reactor(backend);
+
+        // The timer handler polls the receive channel after sending, which clears its notification
+        // descriptor, so the message is only dispatched if channels used by handlers are checked. The
+        // reactor loop is run, rather than single iterations, which check every channel on each call.
+        backend_reactor.register_channel(recv_channel, boost::bind(&ReactorTestFixture::count_recv_handler, this));
+        backend_reactor.register_timer(10, 1, boost::bind(&ReactorTestFixture::timed_send_poll_handler, this));
+        backend_reactor.register_timer(200, 1, boost::bind(&ReactorTestFixture::stop_handler, this, &backend_reactor));
+
+        BOOST_CHECK_EQUAL(backend_reactor.run(), 0);
+        BOOST_CHECK_EQUAL(recv_count, 1);
+        BOOST_CHECK_EQUAL(test_message, received_message);
+    }
+
     FrameReceiver::IpcChannel send_channel;
     FrameReceiver::IpcChannel recv_channel;
     FrameReceiver::IpcReactor reactor;
     unsigned int timer_count;
+    unsigned int post_count;
+    unsigned int recv_count;
+    unsigned int socket_count;
     std::string  test_message;
     std::string  received_message;
 };
@@ -100,6 +267,84 @@ BOOST_AUTO_TEST_CASE( ReactorSendFromTimerTest )
     BOOST_CHECK_EQUAL(test_message, received_message);
 
 }
+
+BOOST_AUTO_TEST_CASE( ReactorRunOnceTest )
+{
+    reactor.register_channel(recv_channel, boost::bind(&ReactorTestFixture::recv_handler, this));
+    int timer_id = reactor.register_timer(10, 0, boost::bind(&ReactorTestFixture::timer_handler, this));
+
+    // A zero timeout iteration returns immediately with nothing to handle
+    BOOST_CHECK_EQUAL(reactor.run_once(0), 0);
+    BOOST_CHECK_EQUAL(timer_count, 0);
+    BOOST_CHECK(!reactor.is_stopped());
+
+    // Service the reactor from a caller loop until the timer has fired and the message received
+    send_channel.send(test_message);
+    int iterations = 0;
+    while ((!reactor.is_stopped() || (timer_count == 0)) && (iterations++ < 100))
+    {
+        BOOST_CHECK_EQUAL(reactor.run_once(5), 0);
+    }
+
+    BOOST_CHECK_EQUAL(test_message, received_message);
+    BOOST_CHECK(timer_count > 0);
+    BOOST_CHECK(reactor.is_stopped());
+}
+
+BOOST_AUTO_TEST_CASE( ReactorPollBackendTest )
+{
+    check_backend_dispatch(FrameReceiver::Defaults::ReactorBackendPoll);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE( ReactorEpollBackendTest )
+{
+    check_backend_dispatch(FrameReceiver::Defaults::ReactorBackendEpoll);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE( ReactorPollBackendTimerTest )
+{
+    check_backend_timers(FrameReceiver::Defaults::ReactorBackendPoll);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE( ReactorEpollBackendTimerTest )
+{
+    check_backend_timers(FrameReceiver::Defaults::ReactorBackendEpoll);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE( ReactorPollBackendPostTest )
+{
+    check_backend_post(FrameReceiver::Defaults::ReactorBackendPoll);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE( ReactorEpollBackendPostTest )
+{
+    check_backend_post(FrameReceiver::Defaults::ReactorBackendEpoll);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE( ReactorPollBackendUsedChannelTest )
+{
+    check_backend_used_channel(FrameReceiver::Defaults::ReactorBackendPoll);
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE( ReactorEpollBackendUsedChannelTest )
+{
+    check_backend_used_channel(FrameReceiver::Defaults::ReactorBackendEpoll);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE( ReactorIllegalBackendTest )
+{
+    BOOST_CHECK_THROW(FrameReceiver::IpcReactor illegal_reactor(FrameReceiver::Defaults::ReactorBackendIllegal),
+            FrameReceiver::IpcReactorException);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 
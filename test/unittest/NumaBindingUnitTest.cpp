@@ -0,0 +1,66 @@
+/*
+ * NumaBindingUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "NumaBinding.h"
+#include "FrameReceiverException.h"
+
+BOOST_AUTO_TEST_SUITE(NumaBindingUnitTest);
+
+BOOST_AUTO_TEST_CASE( ParseCpuList )
+{
+    std::vector<int> cpus;
+    FrameReceiver::NumaBinding::parse_cpu_list("0-3,8,10-11\n", cpus);
+
+    int expected[] = {0, 1, 2, 3, 8, 10, 11};
+    BOOST_CHECK_EQUAL_COLLECTIONS(cpus.begin(), cpus.end(), expected, expected + 7);
+
+    cpus.clear();
+    FrameReceiver::NumaBinding::parse_cpu_list("", cpus);
+    BOOST_CHECK(cpus.empty());
+}
+
+BOOST_AUTO_TEST_CASE( IllegalNumaNode )
+{
+    std::vector<int> cpus;
+    BOOST_CHECK_THROW(FrameReceiver::NumaBinding::get_node_cpus(-1, cpus), FrameReceiver::FrameReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::NumaBinding::get_node_cpus(1023, cpus), FrameReceiver::FrameReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::NumaBinding::bind_thread(1023), FrameReceiver::FrameReceiverException);
+}
+
+BOOST_AUTO_TEST_CASE( BindMemoryToNode )
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    void* region = 0;
+    BOOST_REQUIRE_EQUAL(posix_memalign(&region, page_size, 4 * page_size), 0);
+
+    // The default policy leaves the region alone, while other policies require nodes
+    std::vector<int> nodes;
+    BOOST_CHECK_NO_THROW(FrameReceiver::NumaBinding::bind_memory(region, 4 * page_size,
+            FrameReceiver::Defaults::NumaPolicyDefault, nodes));
+    BOOST_CHECK_THROW(FrameReceiver::NumaBinding::bind_memory(region, 4 * page_size,
+            FrameReceiver::Defaults::NumaPolicyBind, nodes), FrameReceiver::FrameReceiverException);
+
+    // Node 0 always exists on a NUMA-capable Linux system
+    std::vector<int> cpus;
+    FrameReceiver::NumaBinding::get_node_cpus(0, cpus);
+    BOOST_CHECK(!cpus.empty());
+
+    nodes.push_back(0);
+    BOOST_CHECK_NO_THROW(FrameReceiver::NumaBinding::bind_memory(reinterpret_cast<char*>(region) + 1, page_size,
+            FrameReceiver::Defaults::NumaPolicyBind, nodes));
+    BOOST_CHECK_NO_THROW(FrameReceiver::NumaBinding::bind_memory(region, 4 * page_size,
+            FrameReceiver::Defaults::NumaPolicyInterleave, nodes));
+
+    free(region);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,143 @@
+/*
+ * PacketRingReceiverUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <string>
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "PacketRingReceiver.h"
+#include "gettime.h"
+
+#ifdef __linux__
+
+const uint16_t ring_test_port  = 9123;
+const uint16_t other_test_port = 9124;
+
+class PacketRingReceiverTestFixture
+{
+public:
+    PacketRingReceiverTestFixture() :
+        logger(log4cxx::Logger::getLogger("PacketRingReceiverUnitTest"))
+    {
+        ports.push_back(ring_test_port);
+        handler = boost::bind(&PacketRingReceiverTestFixture::handle_packet, this, _1, _2, _3, _4);
+    }
+
+    void handle_packet(uint8_t* payload, size_t payload_size, int port, struct sockaddr_in* from_addr)
+    {
+        received_payloads.push_back(std::string(reinterpret_cast<char*>(payload), payload_size));
+        received_ports.push_back(port);
+    }
+
+    // Capturing on an interface requires CAP_NET_RAW, so allow tests to be skipped without it
+    bool can_capture(void)
+    {
+        int test_socket = socket(AF_PACKET, SOCK_RAW, 0);
+        if (test_socket < 0)
+        {
+            if ((errno == EPERM) || (errno == EACCES))
+            {
+                BOOST_TEST_MESSAGE("Skipping packet ring test, insufficient privilege to capture packets");
+                return false;
+            }
+        }
+        else
+        {
+            close(test_socket);
+        }
+        return true;
+    }
+
+    void send_packet(uint16_t port, const std::string& payload)
+    {
+        int send_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        struct sockaddr_in dest_addr;
+        memset(&dest_addr, 0, sizeof(dest_addr));
+        dest_addr.sin_family = AF_INET;
+        dest_addr.sin_port = htons(port);
+        dest_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        sendto(send_socket, payload.c_str(), payload.size(), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+        close(send_socket);
+    }
+
+    log4cxx::LoggerPtr logger;
+    std::vector<uint16_t> ports;
+    FrameReceiver::PacketRingHandler handler;
+    std::vector<std::string> received_payloads;
+    std::vector<int> received_ports;
+};
+
+BOOST_FIXTURE_TEST_SUITE(PacketRingReceiverUnitTest, PacketRingReceiverTestFixture);
+
+BOOST_AUTO_TEST_CASE( IllegalPacketRingConfiguration )
+{
+    if (!can_capture()) return;
+
+    BOOST_CHECK_THROW(FrameReceiver::PacketRingReceiver(logger, "nosuchif0", "0.0.0.0", ports, 1 << 20, 4, 10),
+            FrameReceiver::PacketRingReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::PacketRingReceiver(logger, "lo", "0.0.0.0", ports, 1000, 4, 10),
+            FrameReceiver::PacketRingReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::PacketRingReceiver(logger, "lo", "not.an.address", ports, 1 << 20, 4, 10),
+            FrameReceiver::PacketRingReceiverException);
+}
+
+BOOST_AUTO_TEST_CASE( LoopbackPacketRingCapture )
+{
+    if (!can_capture()) return;
+
+    FrameReceiver::PacketRingReceiver packet_ring(logger, "lo", "127.0.0.1", ports, 1 << 20, 4, 10);
+
+    const int num_packets = 10;
+    for (int packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        send_packet(ring_test_port, ss.str());
+        send_packet(other_test_port, "ignored");
+    }
+
+    // Wait for the ring blocks to be retired to user space and process them
+    struct timespec start_time, now;
+    gettime(&start_time);
+    while (received_payloads.size() < num_packets)
+    {
+        struct pollfd poll_fd;
+        poll_fd.fd = packet_ring.get_socket();
+        poll_fd.events = POLLIN;
+        poll(&poll_fd, 1, 100);
+        packet_ring.process_blocks(handler);
+
+        gettime(&now);
+        if (now.tv_sec - start_time.tv_sec > 2) break;
+    }
+
+    BOOST_REQUIRE_EQUAL(received_payloads.size(), num_packets);
+    for (int packet = 0; packet < num_packets; packet++)
+    {
+        std::stringstream ss;
+        ss << "packet " << packet;
+        BOOST_CHECK_EQUAL(received_payloads[packet], ss.str());
+        BOOST_CHECK_EQUAL(received_ports[packet], ring_test_port);
+    }
+    BOOST_CHECK_EQUAL(packet_ring.get_packets_received(), num_packets);
+    BOOST_CHECK(packet_ring.get_packets_ignored() >= num_packets);
+
+    packet_ring.update_statistics();
+    BOOST_CHECK(packet_ring.get_packets_captured() >= num_packets);
+    BOOST_CHECK_EQUAL(packet_ring.get_packets_dropped(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+#endif
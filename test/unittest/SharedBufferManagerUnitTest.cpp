@@ -7,7 +7,9 @@
 
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <string.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include "SharedBufferManager.h"
 
@@ -154,6 +156,272 @@ BOOST_AUTO_TEST_CASE( MapMissingSharedBufferTest )
 
 }
 
+BOOST_AUTO_TEST_CASE( SharedFrameRingsTest )
+{
+    // The fixture manager was created without frame rings
+    BOOST_CHECK(!shared_buffer_manager.has_frame_rings());
+    BOOST_CHECK_EQUAL(shared_buffer_manager.get_num_ready_rings(), 0);
+
+    const unsigned int num_ready_rings = 2;
+    FrameReceiver::SharedBufferManager ring_manager("TestSharedRingBuffer", shared_mem_size, buffer_size,
+            true, num_ready_rings);
+    BOOST_REQUIRE(ring_manager.has_frame_rings());
+    BOOST_CHECK_EQUAL(ring_manager.get_num_ready_rings(), num_ready_rings);
+    BOOST_CHECK_GE(ring_manager.get_ready_ring(0)->get_capacity(), num_buffers);
+    BOOST_CHECK_THROW(ring_manager.get_ready_ring(num_ready_rings), FrameReceiver::SharedBufferManagerException);
+
+    // Push descriptors as the frame receiver would, then check they are seen by a manager mapping the same
+    // shared memory by name, as the downstream process would
+    FrameReceiver::FrameDescriptor descriptor = {};
+    descriptor.frame_number = 1234;
+    descriptor.buffer_id = 3;
+    BOOST_CHECK(ring_manager.get_ready_ring(1)->push(descriptor));
+    ring_manager.get_ready_event()->signal();
+
+    FrameReceiver::SharedBufferManager mapped_manager("TestSharedRingBuffer");
+    BOOST_REQUIRE(mapped_manager.has_frame_rings());
+    BOOST_CHECK_EQUAL(mapped_manager.get_num_ready_rings(), num_ready_rings);
+    BOOST_CHECK_EQUAL(mapped_manager.get_ready_event()->get_sequence(), 1);
+    BOOST_CHECK_EQUAL(mapped_manager.get_ready_ring(0)->get_size(), 0);
+
+    FrameReceiver::FrameDescriptor popped;
+    BOOST_REQUIRE(mapped_manager.get_ready_ring(1)->pop(popped));
+    BOOST_CHECK_EQUAL(popped.frame_number, 1234);
+    BOOST_CHECK_EQUAL(popped.buffer_id, 3);
+    BOOST_CHECK(mapped_manager.get_release_ring()->push(popped));
+    BOOST_CHECK_EQUAL(ring_manager.get_release_ring()->get_size(), 1);
+
+    // Buffers are unaffected by the ring area
+    memset(ring_manager.get_buffer_address(num_buffers - 1), 0x5a, buffer_size);
+    BOOST_CHECK_EQUAL(mapped_manager.get_num_buffers(), num_buffers);
+    BOOST_CHECK_EQUAL(reinterpret_cast<char*>(mapped_manager.get_buffer_address(num_buffers - 1))[buffer_size - 1], 0x5a);
+}
+
+BOOST_AUTO_TEST_CASE( HugePageSharedBufferTest )
+{
+    // The fixture manager uses POSIX shared memory with the system page size
+    BOOST_CHECK(!shared_buffer_manager.is_huge_page_backed());
+    BOOST_CHECK_EQUAL(shared_buffer_manager.get_page_size(), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+
+    // Buffer strides are padded to whole pages, or to a power of two for buffers smaller than a page
+    const size_t huge_page_size = 2 * 1024 * 1024;
+    BOOST_CHECK_EQUAL(FrameReceiver::SharedBufferManager::get_huge_page_buffer_stride(100, huge_page_size), 128);
+    BOOST_CHECK_EQUAL(FrameReceiver::SharedBufferManager::get_huge_page_buffer_stride(4096, huge_page_size), 4096);
+    BOOST_CHECK_EQUAL(FrameReceiver::SharedBufferManager::get_huge_page_buffer_stride(huge_page_size, huge_page_size),
+            huge_page_size);
+    BOOST_CHECK_EQUAL(FrameReceiver::SharedBufferManager::get_huge_page_buffer_stride(huge_page_size + 1, huge_page_size),
+            2 * huge_page_size);
+
+    // A huge page directory that is not a hugetlbfs mount is rejected without leaving a file behind
+    BOOST_CHECK_THROW(FrameReceiver::SharedBufferManager illegal_manager("TestHugePageBuffer", shared_mem_size,
+            buffer_size, true, 0, "/tmp"), FrameReceiver::SharedBufferManagerException);
+    BOOST_CHECK_NE(access("/tmp/TestHugePageBuffer", F_OK), 0);
+}
+
+BOOST_AUTO_TEST_CASE( PrefaultSharedBufferTest )
+{
+    // Prefaulting must preserve the contents of the region
+    memset(shared_buffer_manager.get_buffer_address(0), 0x5a, buffer_size);
+    BOOST_CHECK(!shared_buffer_manager.is_locked());
+    BOOST_CHECK_NO_THROW(shared_buffer_manager.prefault(3, false));
+    BOOST_CHECK(!shared_buffer_manager.is_locked());
+    BOOST_CHECK_EQUAL(reinterpret_cast<char*>(shared_buffer_manager.get_buffer_address(0))[buffer_size - 1], 0x5a);
+
+    // More threads than pages are limited to one per page
+    FrameReceiver::SharedBufferManager ring_manager("TestPrefaultBuffer", shared_mem_size, buffer_size, true, 2);
+    BOOST_CHECK_NO_THROW(ring_manager.prefault(64, true));
+    BOOST_CHECK(ring_manager.is_locked());
+    BOOST_CHECK_EQUAL(ring_manager.get_ready_ring(0)->get_capacity(), 16);
+}
+
+BOOST_AUTO_TEST_CASE( BufferDescriptorTableTest )
+{
+    // A created manager always has a descriptor table with every buffer initially free
+    BOOST_REQUIRE(shared_buffer_manager.has_buffer_descriptors());
+    std::vector<size_t> occupancy;
+    shared_buffer_manager.get_buffer_occupancy(occupancy);
+    BOOST_REQUIRE_EQUAL(occupancy.size(), FrameReceiver::NumBufferStates);
+    BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateFree], num_buffers);
+
+    // Filling a buffer records the frame and owner and increments the generation
+    shared_buffer_manager.set_buffer_state(2, FrameReceiver::BufferStateFilling, 1234);
+    FrameReceiver::BufferDescriptor descriptor;
+    BOOST_REQUIRE(shared_buffer_manager.get_buffer_descriptor(2, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.state, FrameReceiver::BufferStateFilling);
+    BOOST_CHECK_EQUAL(descriptor.frame_number, 1234);
+    BOOST_CHECK_EQUAL(descriptor.owner, static_cast<uint32_t>(getpid()));
+    BOOST_CHECK_EQUAL(descriptor.generation, 1);
+    shared_buffer_manager.set_buffer_state(2, FrameReceiver::BufferStateReady, 1234);
+    BOOST_CHECK_THROW(shared_buffer_manager.set_buffer_state(num_buffers, FrameReceiver::BufferStateReady),
+            FrameReceiver::SharedBufferManagerException);
+
+    // A manager mapping the same shared memory by name sees the table and can claim ready buffers once
+    FrameReceiver::SharedBufferManager mapped_manager(shared_mem_name);
+    BOOST_REQUIRE(mapped_manager.has_buffer_descriptors());
+    BOOST_CHECK(!mapped_manager.claim_buffer(1, FrameReceiver::BufferStateReady, FrameReceiver::BufferStateInUse));
+    BOOST_CHECK(mapped_manager.claim_buffer(2, FrameReceiver::BufferStateReady, FrameReceiver::BufferStateInUse));
+    BOOST_CHECK(!mapped_manager.claim_buffer(2, FrameReceiver::BufferStateReady, FrameReceiver::BufferStateInUse));
+    BOOST_REQUIRE(shared_buffer_manager.get_buffer_descriptor(2, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.state, FrameReceiver::BufferStateInUse);
+    BOOST_CHECK_EQUAL(descriptor.frame_number, 1234);
+
+    mapped_manager.get_buffer_occupancy(occupancy);
+    BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateFree], num_buffers - 1);
+    BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateInUse], 1);
+
+    // Resetting frees every buffer but preserves the generation
+    shared_buffer_manager.reset_buffer_descriptors();
+    mapped_manager.get_buffer_occupancy(occupancy);
+    BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateFree], num_buffers);
+    BOOST_REQUIRE(mapped_manager.get_buffer_descriptor(2, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.owner, 0);
+    BOOST_CHECK_EQUAL(descriptor.generation, 1);
+}
+
+BOOST_AUTO_TEST_CASE( BufferSizeClassTest )
+{
+    // The fixture manager has a single size class
+    BOOST_CHECK_EQUAL(shared_buffer_manager.get_num_size_classes(), 1);
+    BOOST_CHECK_EQUAL(shared_buffer_manager.get_size_class(num_buffers - 1), 0);
+    BOOST_CHECK_EQUAL(shared_buffer_manager.find_size_class(1), 0);
+
+    // Smaller size classes are sorted, with sizes not smaller than the buffer size ignored, and
+    // share the memory equally with the full size buffers
+    std::vector<size_t> size_class_sizes;
+    size_class_sizes.push_back(25);
+    size_class_sizes.push_back(50);
+    size_class_sizes.push_back(buffer_size);
+    FrameReceiver::SharedBufferManager class_manager("TestSizeClassBuffer", 3 * shared_mem_size, buffer_size,
+            true, 2, "", size_class_sizes);
+    BOOST_REQUIRE_EQUAL(class_manager.get_num_size_classes(), 3);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_buffer_size(0), buffer_size);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_buffer_size(1), 50);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_buffer_size(2), 25);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_num_buffers(0), num_buffers);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_num_buffers(1), 2 * num_buffers);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class_num_buffers(2), 4 * num_buffers);
+    BOOST_CHECK_THROW(class_manager.get_size_class_buffer_size(3), FrameReceiver::SharedBufferManagerException);
+
+    const size_t total_buffers = 7 * num_buffers;
+    BOOST_CHECK_EQUAL(class_manager.get_num_buffers(), total_buffers);
+    BOOST_CHECK_EQUAL(class_manager.get_buffer_size(), buffer_size);
+    BOOST_CHECK_EQUAL(class_manager.get_buffer_size(num_buffers - 1), buffer_size);
+    BOOST_CHECK_EQUAL(class_manager.get_buffer_size(num_buffers), 50);
+    BOOST_CHECK_EQUAL(class_manager.get_buffer_size(total_buffers - 1), 25);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class(3 * num_buffers - 1), 1);
+    BOOST_CHECK_EQUAL(class_manager.get_size_class(3 * num_buffers), 2);
+    BOOST_CHECK_THROW(class_manager.get_buffer_address(total_buffers), FrameReceiver::SharedBufferManagerException);
+
+    // Frames are assigned the smallest class that holds them
+    BOOST_CHECK_EQUAL(class_manager.find_size_class(buffer_size), 0);
+    BOOST_CHECK_EQUAL(class_manager.find_size_class(51), 0);
+    BOOST_CHECK_EQUAL(class_manager.find_size_class(50), 1);
+    BOOST_CHECK_EQUAL(class_manager.find_size_class(26), 1);
+    BOOST_CHECK_EQUAL(class_manager.find_size_class(1), 2);
+    BOOST_CHECK_THROW(class_manager.find_size_class(buffer_size + 1), FrameReceiver::SharedBufferManagerException);
+
+    // Each descriptor records the class of its buffer
+    FrameReceiver::BufferDescriptor descriptor;
+    BOOST_REQUIRE(class_manager.get_buffer_descriptor(total_buffers - 1, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.size_class, 2);
+    BOOST_CHECK_EQUAL(descriptor.state, FrameReceiver::BufferStateFree);
+
+    // Fill every buffer, which must not overlap each other or the descriptor table and rings
+    for (unsigned int buffer = 0; buffer < total_buffers; buffer++)
+    {
+        memset(class_manager.get_buffer_address(buffer), buffer, class_manager.get_buffer_size(buffer));
+    }
+    class_manager.reset_buffer_descriptors();
+    BOOST_REQUIRE(class_manager.get_buffer_descriptor(num_buffers, descriptor));
+    BOOST_CHECK_EQUAL(descriptor.size_class, 1);
+    FrameReceiver::FrameDescriptor frame = {};
+    frame.buffer_id = total_buffers - 1;
+    BOOST_CHECK(class_manager.get_ready_ring(0)->push(frame));
+
+    // A manager mapping the same shared memory by name sees the same classes and buffers
+    FrameReceiver::SharedBufferManager mapped_manager("TestSizeClassBuffer");
+    BOOST_REQUIRE_EQUAL(mapped_manager.get_num_size_classes(), 3);
+    BOOST_REQUIRE_EQUAL(mapped_manager.get_num_buffers(), total_buffers);
+    for (unsigned int buffer = 0; buffer < total_buffers; buffer++)
+    {
+        size_t size = mapped_manager.get_buffer_size(buffer);
+        char* address = reinterpret_cast<char*>(mapped_manager.get_buffer_address(buffer));
+        BOOST_CHECK_EQUAL(size, class_manager.get_buffer_size(buffer));
+        BOOST_CHECK_EQUAL(address[0], static_cast<char>(buffer));
+        BOOST_CHECK_EQUAL(address[size - 1], static_cast<char>(buffer));
+    }
+    BOOST_REQUIRE(mapped_manager.has_frame_rings());
+    BOOST_REQUIRE(mapped_manager.get_ready_ring(0)->pop(frame));
+    BOOST_CHECK_EQUAL(frame.buffer_id, total_buffers - 1);
+}
+
+BOOST_AUTO_TEST_CASE( SpillFileTest )
+{
+    // The fixture manager has no spill buffers
+    BOOST_CHECK(!shared_buffer_manager.has_spill_buffers());
+    BOOST_CHECK(!shared_buffer_manager.is_spill_buffer(num_buffers - 1));
+
+    // Spill buffers follow the buffers in memory, including those of smaller size classes
+    const std::string spill_file_path = "/tmp/TestSpillFileBuffer.spill";
+    const size_t num_spill_buffers = 4;
+    std::vector<size_t> size_class_sizes(1, 50);
+    {
+        FrameReceiver::SharedBufferManager spill_manager("TestSpillFileBuffer", 2 * shared_mem_size, buffer_size,
+                true, 1, "", size_class_sizes, spill_file_path, (num_spill_buffers * buffer_size) + 10);
+        BOOST_REQUIRE(spill_manager.has_spill_buffers());
+        BOOST_CHECK_EQUAL(spill_manager.get_spill_file_path(), spill_file_path);
+        BOOST_CHECK_EQUAL(spill_manager.get_num_spill_buffers(), num_spill_buffers);
+
+        const size_t first_spill_buffer = 3 * num_buffers;
+        const size_t total_buffers = first_spill_buffer + num_spill_buffers;
+        BOOST_CHECK_EQUAL(spill_manager.get_num_buffers(), total_buffers);
+        BOOST_CHECK(!spill_manager.is_spill_buffer(first_spill_buffer - 1));
+        BOOST_CHECK(spill_manager.is_spill_buffer(first_spill_buffer));
+        BOOST_CHECK(!spill_manager.is_spill_buffer(total_buffers));
+        BOOST_CHECK_EQUAL(spill_manager.get_buffer_size(total_buffers - 1), buffer_size);
+        BOOST_CHECK_EQUAL(spill_manager.get_size_class(total_buffers - 1), 0);
+        BOOST_CHECK_THROW(spill_manager.get_buffer_address(total_buffers), FrameReceiver::SharedBufferManagerException);
+        BOOST_CHECK_GE(spill_manager.get_ready_ring(0)->get_capacity(), total_buffers);
+
+        // Spill buffers have descriptors like any other buffer
+        spill_manager.set_buffer_state(total_buffers - 1, FrameReceiver::BufferStateReady, 1234);
+        std::vector<size_t> occupancy;
+        spill_manager.get_buffer_occupancy(occupancy);
+        BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateReady], 1);
+        BOOST_CHECK_EQUAL(occupancy[FrameReceiver::BufferStateFree], total_buffers - 1);
+
+        for (unsigned int buffer = 0; buffer < total_buffers; buffer++)
+        {
+            memset(spill_manager.get_buffer_address(buffer), buffer, spill_manager.get_buffer_size(buffer));
+        }
+
+        // A manager mapping the segment by name also maps the spill file and sees the same buffers
+        FrameReceiver::SharedBufferManager mapped_manager("TestSpillFileBuffer");
+        BOOST_REQUIRE(mapped_manager.has_spill_buffers());
+        BOOST_CHECK_EQUAL(mapped_manager.get_spill_file_path(), spill_file_path);
+        BOOST_REQUIRE_EQUAL(mapped_manager.get_num_buffers(), total_buffers);
+        for (unsigned int buffer = first_spill_buffer - 1; buffer < total_buffers; buffer++)
+        {
+            char* address = reinterpret_cast<char*>(mapped_manager.get_buffer_address(buffer));
+            BOOST_CHECK_EQUAL(address[0], static_cast<char>(buffer));
+            BOOST_CHECK_EQUAL(address[mapped_manager.get_buffer_size(buffer) - 1], static_cast<char>(buffer));
+        }
+        FrameReceiver::BufferDescriptor descriptor;
+        BOOST_REQUIRE(mapped_manager.get_buffer_descriptor(total_buffers - 1, descriptor));
+        BOOST_CHECK_EQUAL(descriptor.state, FrameReceiver::BufferStateReady);
+        BOOST_CHECK_EQUAL(descriptor.frame_number, 1234);
+    }
+
+    // The spill file is removed with the segment
+    BOOST_CHECK_NE(access(spill_file_path.c_str(), F_OK), 0);
+
+    // The spill file must hold at least one buffer
+    BOOST_CHECK_THROW(FrameReceiver::SharedBufferManager illegal_manager("TestSpillFileBuffer", shared_mem_size,
+            buffer_size, true, 0, "", std::vector<size_t>(), spill_file_path, buffer_size - 1),
+            FrameReceiver::SharedBufferManagerException);
+    BOOST_CHECK_NE(access(spill_file_path.c_str(), F_OK), 0);
+}
+
 BOOST_AUTO_TEST_CASE( BufferBiggerThanSharedMemTest)
 {
     BOOST_CHECK_THROW(FrameReceiver::SharedBufferManager illegal_manager("BadSize", 100, 1000),
@@ -0,0 +1,145 @@
+/*
+ * SharedFrameRingUnitTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+#include "SharedFrameRing.h"
+#include "FrameReceiverException.h"
+
+const size_t ring_capacity = 8;
+
+class SharedFrameRingTestFixture
+{
+public:
+    SharedFrameRingTestFixture() :
+        ring_memory((FrameReceiver::SharedFrameRing::get_required_size(ring_capacity) / sizeof(uint64_t)) + 1),
+        event_memory((FrameReceiver::SharedFrameEvent::get_required_size() / sizeof(uint64_t)) + 1),
+        ring(&ring_memory[0], ring_capacity, true),
+        event(&event_memory[0], true)
+    {
+    }
+
+    void produce(unsigned int num_frames)
+    {
+        for (unsigned int frame = 0; frame < num_frames; frame++)
+        {
+            FrameReceiver::FrameDescriptor descriptor = {};
+            descriptor.frame_number = frame;
+            descriptor.buffer_id = frame % ring_capacity;
+            while (!ring.push(descriptor))
+            {
+                boost::this_thread::yield();
+            }
+            event.signal();
+        }
+    }
+
+    std::vector<uint64_t> ring_memory;
+    std::vector<uint64_t> event_memory;
+    FrameReceiver::SharedFrameRing ring;
+    FrameReceiver::SharedFrameEvent event;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SharedFrameRingUnitTest, SharedFrameRingTestFixture);
+
+BOOST_AUTO_TEST_CASE( RingPushPop )
+{
+    BOOST_CHECK_EQUAL(ring.get_capacity(), ring_capacity);
+    BOOST_CHECK_EQUAL(sizeof(FrameReceiver::FrameDescriptor), 32);
+
+    FrameReceiver::FrameDescriptor descriptor = {};
+    BOOST_CHECK(!ring.pop(descriptor));
+
+    // Fill the ring, after which pushes fail until a descriptor is popped
+    for (unsigned int idx = 0; idx < ring_capacity; idx++)
+    {
+        descriptor.frame_number = idx;
+        BOOST_CHECK(ring.push(descriptor));
+    }
+    BOOST_CHECK_EQUAL(ring.get_size(), ring_capacity);
+    BOOST_CHECK(!ring.push(descriptor));
+
+    BOOST_CHECK(ring.pop(descriptor));
+    BOOST_CHECK_EQUAL(descriptor.frame_number, 0);
+    BOOST_CHECK(ring.push(descriptor));
+    BOOST_CHECK_EQUAL(ring.get_num_pushed(), ring_capacity + 1);
+    BOOST_CHECK_EQUAL(ring.get_num_popped(), 1);
+
+    // Descriptors are popped in order across the wrap of the ring
+    for (unsigned int idx = 1; idx <= ring_capacity; idx++)
+    {
+        BOOST_REQUIRE(ring.pop(descriptor));
+        BOOST_CHECK_EQUAL(descriptor.frame_number, idx % ring_capacity);
+    }
+    BOOST_CHECK_EQUAL(ring.get_size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( RingAttach )
+{
+    FrameReceiver::FrameDescriptor descriptor = {};
+    descriptor.buffer_id = 5;
+    ring.push(descriptor);
+
+    // Attaching to an initialised ring preserves its contents, but must match its capacity
+    FrameReceiver::SharedFrameRing attached_ring(&ring_memory[0], ring_capacity, false);
+    BOOST_CHECK_EQUAL(attached_ring.get_size(), 1);
+    BOOST_CHECK(attached_ring.pop(descriptor));
+    BOOST_CHECK_EQUAL(descriptor.buffer_id, 5);
+
+    BOOST_CHECK_THROW(FrameReceiver::SharedFrameRing(&ring_memory[0], ring_capacity / 2, false),
+            FrameReceiver::FrameReceiverException);
+    BOOST_CHECK_THROW(FrameReceiver::SharedFrameRing(&ring_memory[0], 6, true),
+            FrameReceiver::FrameReceiverException);
+}
+
+BOOST_AUTO_TEST_CASE( EventWaitTimeout )
+{
+    uint32_t sequence = event.get_sequence();
+    BOOST_CHECK(!event.wait(sequence, 10));
+
+    // A signal after the sequence is read is not missed by a later wait
+    event.signal();
+    BOOST_CHECK(event.wait(sequence, 1000));
+    BOOST_CHECK_EQUAL(event.get_sequence(), sequence + 1);
+}
+
+BOOST_AUTO_TEST_CASE( RingProducerConsumer )
+{
+    const unsigned int num_frames = 10000;
+    boost::thread producer(boost::bind(&SharedFrameRingTestFixture::produce, this, num_frames));
+
+    unsigned int frames_popped = 0;
+    unsigned int frames_out_of_order = 0;
+    while (frames_popped < num_frames)
+    {
+        uint32_t sequence = event.get_sequence();
+        FrameReceiver::FrameDescriptor descriptor;
+        bool popped = false;
+        while (ring.pop(descriptor))
+        {
+            if (descriptor.frame_number != frames_popped)
+            {
+                frames_out_of_order++;
+            }
+            frames_popped++;
+            popped = true;
+        }
+        if (!popped)
+        {
+            event.wait(sequence, 1000);
+        }
+    }
+    producer.join();
+
+    BOOST_CHECK_EQUAL(frames_popped, num_frames);
+    BOOST_CHECK_EQUAL(frames_out_of_order, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
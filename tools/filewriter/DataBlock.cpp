@@ -6,6 +6,7 @@
  */
 
 #include <DataBlock.h>
+#include <sys/mman.h>
 
 namespace filewriter
 {
@@ -19,7 +20,8 @@ namespace filewriter
    */
   DataBlock::DataBlock(size_t nbytes) :
     logger_(log4cxx::Logger::getLogger("FW.DataBlock")),
-    allocatedBytes_(nbytes)
+    allocatedBytes_(nbytes),
+    locked_(false)
   {
     LOG4CXX_DEBUG(logger_, "Constructing DataBlock, allocating " << nbytes << " bytes");
     // Create this DataBlock's unique index
@@ -33,7 +35,10 @@ namespace filewriter
    */
   DataBlock::~DataBlock()
   {
-    // Free the memory
+    // Unlock and free the memory
+    if (locked_){
+      munlock(blockPtr_, allocatedBytes_);
+    }
     free(blockPtr_);
   }
 
@@ -73,7 +78,11 @@ namespace filewriter
     // If the new size requested is the different
     // to our current size then re-allocate
     if (nbytes != allocatedBytes_){
-      // Free the current allocation first
+      // Unlock and free the current allocation first
+      if (locked_){
+        munlock(blockPtr_, allocatedBytes_);
+        locked_ = false;
+      }
       free(blockPtr_);
       // Allocate the new number of bytes
       blockPtr_ = malloc(nbytes);
@@ -82,6 +91,24 @@ namespace filewriter
     }
   }
 
+  /**
+   * Prefault the memory of this data block, optionally locking it into memory.
+   * Every page of the block is written so that page faults are taken now rather
+   * than when frame data is first copied into the block.
+   *
+   * \param[in] lock - lock the memory so its pages cannot be swapped out.
+   * \return - false if the memory could not be locked.
+   */
+  bool DataBlock::prefault(bool lock)
+  {
+    memset(blockPtr_, 0, allocatedBytes_);
+    if (lock && !locked_){
+      locked_ = (mlock(blockPtr_, allocatedBytes_) == 0);
+      return locked_;
+    }
+    return true;
+  }
+
   /**
    * Copy from data source to the allocated memory within this data block.
    * If more bytes are requested to be copied than are available in this
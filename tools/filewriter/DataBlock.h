@@ -41,6 +41,7 @@ namespace filewriter
 
   private:
     void resize(size_t nbytes);
+    bool prefault(bool lock);
 
     /** Pointer to logger */
     log4cxx::LoggerPtr logger_;
@@ -50,6 +51,8 @@ namespace filewriter
     int index_;
     /** Void pointer to the allocated memory */
     void *blockPtr_;
+    /** Is the allocated memory locked into memory */
+    bool locked_;
     /** Static counter for the unique index */
     static int indexCounter_;
   };
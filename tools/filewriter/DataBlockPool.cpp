@@ -6,6 +6,7 @@
  */
 
 #include <DataBlockPool.h>
+#include "gettime.h"
 
 namespace filewriter
 {
@@ -21,15 +22,20 @@ namespace filewriter
 
   /**
    * Static method to force allocation of new DataBlocks which are added to
-   * the pool specified by the index parameter.
+   * the pool specified by the index parameter.  The new DataBlocks can be
+   * prefaulted, and optionally locked into memory, so that page faults are
+   * not taken when frames are first processed.
    *
    * \param[in] index - Index of DataBlockPool to add new DataBlocks to.
    * \param[in] nBlocks - Number of DataBlocks to allocate.
    * \param[in] nBytes - Number of bytes to allocate to each block.
+   * \param[in] prefault - Prefault the memory of the new DataBlocks.
+   * \param[in] lockMemory - Prefault and lock the memory of the new DataBlocks.
    */
-  void DataBlockPool::allocate(const std::string& index, size_t nBlocks, size_t nBytes)
+  void DataBlockPool::allocate(const std::string& index, size_t nBlocks, size_t nBytes,
+                               bool prefault, bool lockMemory)
   {
-    DataBlockPool::instance(index)->internalAllocate(nBlocks, nBytes);
+    DataBlockPool::instance(index)->internalAllocate(nBlocks, nBytes, prefault, lockMemory);
   }
 
   /**
@@ -139,28 +145,49 @@ namespace filewriter
 
   /**
    * Allocate new DataBlocks to this DataBlockPool.  This results in
-   * additional memory allocation.
+   * additional memory allocation.  The time taken to prefault or lock
+   * the new DataBlocks is reported.
    *
    * \param[in] nBlocks - Number of DataBlocks to allocate.
    * \param[in] nBytes - Number of bytes to allocate to each block.
+   * \param[in] prefault - Prefault the memory of the new DataBlocks.
+   * \param[in] lockMemory - Prefault and lock the memory of the new DataBlocks.
    */
-  void DataBlockPool::internalAllocate(size_t nBlocks, size_t nBytes)
+  void DataBlockPool::internalAllocate(size_t nBlocks, size_t nBytes, bool prefault, bool lockMemory)
   {
     LOG4CXX_DEBUG(logger_, "Allocating " << nBlocks << " additional DataBlocks of " << nBytes << " bytes");
 
     // Protect this method
     boost::lock_guard<boost::recursive_mutex> lock(mutex_);
 
+    struct timespec startTime, endTime;
+    gettime(&startTime, true);
+    size_t lockFailures = 0;
+
     // Allocate the number of data blocks, each of size nBytes
     boost::shared_ptr<DataBlock> block;
     for (size_t count = 0; count < nBlocks; count++){
        block = boost::shared_ptr<DataBlock>(new DataBlock(nBytes));
+       if ((prefault || lockMemory) && !block->prefault(lockMemory)){
+         lockFailures++;
+       }
        freeList_.push_front(block);
        // Record the newly allocated block
        freeBlocks_++;
        totalBlocks_++;
        memoryAllocated_ += nBytes;
     }
+
+    if (prefault || lockMemory){
+      gettime(&endTime, true);
+      double prefaultMs = ((endTime.tv_sec - startTime.tv_sec) * 1000.0) +
+                          ((endTime.tv_nsec - startTime.tv_nsec) / 1000000.0);
+      LOG4CXX_INFO(logger_, "Allocated and prefaulted " << (lockMemory ? "and locked " : "") << nBlocks
+                            << " DataBlocks of " << nBytes << " bytes in " << prefaultMs << "ms");
+      if (lockFailures){
+        LOG4CXX_ERROR(logger_, "Unable to lock " << lockFailures << " DataBlocks into memory, check RLIMIT_MEMLOCK");
+      }
+    }
   }
 
   /**
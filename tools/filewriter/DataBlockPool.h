@@ -33,7 +33,8 @@ namespace filewriter
   public:
     virtual ~DataBlockPool();
 
-    static void allocate(const std::string& index, size_t nBlocks, size_t nBytes);
+    static void allocate(const std::string& index, size_t nBlocks, size_t nBytes,
+                         bool prefault=false, bool lockMemory=false);
     static boost::shared_ptr<DataBlock> take(const std::string& index, size_t nBytes);
     static void release(const std::string& index, boost::shared_ptr<DataBlock> block);
     static size_t getFreeBlocks(const std::string& index);
@@ -44,7 +45,7 @@ namespace filewriter
   private:
     static DataBlockPool *instance(const std::string& index);
     DataBlockPool();
-    void internalAllocate(size_t nBlocks, size_t nBytes);
+    void internalAllocate(size_t nBlocks, size_t nBytes, bool prefault=false, bool lockMemory=false);
     boost::shared_ptr<DataBlock> internalTake(size_t nBytes);
     void internalRelease(boost::shared_ptr<DataBlock> block);
     size_t internalGetFreeBlocks();
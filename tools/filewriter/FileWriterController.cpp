@@ -18,10 +18,18 @@ namespace filewriter
   const std::string FileWriterController::CONFIG_FR_SHARED_MEMORY  = "fr_shared_mem";
   const std::string FileWriterController::CONFIG_FR_RELEASE        = "fr_release_cnxn";
   const std::string FileWriterController::CONFIG_FR_READY          = "fr_ready_cnxn";
+  const std::string FileWriterController::CONFIG_FR_CONSUMER_ID    = "fr_consumer_id";
   const std::string FileWriterController::CONFIG_FR_SETUP          = "fr_setup";
 
   const std::string FileWriterController::CONFIG_CTRL_ENDPOINT     = "ctrl_endpoint";
 
+  const std::string FileWriterController::CONFIG_DATABLOCKS          = "datablocks";
+  const std::string FileWriterController::CONFIG_DATABLOCKS_POOL     = "pool";
+  const std::string FileWriterController::CONFIG_DATABLOCKS_COUNT    = "count";
+  const std::string FileWriterController::CONFIG_DATABLOCKS_SIZE     = "size";
+  const std::string FileWriterController::CONFIG_DATABLOCKS_PREFAULT = "prefault";
+  const std::string FileWriterController::CONFIG_DATABLOCKS_LOCK     = "lock";
+
   const std::string FileWriterController::CONFIG_PLUGIN            = "plugin";
   const std::string FileWriterController::CONFIG_PLUGIN_LIST       = "list";
   const std::string FileWriterController::CONFIG_PLUGIN_LOAD       = "load";
@@ -31,6 +39,7 @@ namespace filewriter
   const std::string FileWriterController::CONFIG_PLUGIN_INDEX      = "index";
   const std::string FileWriterController::CONFIG_PLUGIN_LIBRARY    = "library";
   const std::string FileWriterController::CONFIG_PLUGIN_CONNECTION = "connection";
+  const std::string FileWriterController::CONFIG_PLUGIN_NUMA_NODE  = "numa_node";
 
   /** Construct a new FileWriterController class.
    *
@@ -121,6 +130,7 @@ namespace filewriter
    * CONFIG_CTRL_ENDPOINT - Calls the method setupControlInterface
    * CONFIG_PLUGIN - Calls the method configurePlugin
    * CONFIG_FR_SETUP - Calls the method setupFrameReceiverInterface
+   * CONFIG_DATABLOCKS - Pre-allocates DataBlocks into a DataBlockPool
    *
    * The method also searches for configuration objects that have the
    * same index as loaded plugins.  If any of these are found the they
@@ -166,7 +176,24 @@ namespace filewriter
         std::string shMemName = frConfig.get_param<std::string>(FileWriterController::CONFIG_FR_SHARED_MEMORY);
         std::string pubString = frConfig.get_param<std::string>(FileWriterController::CONFIG_FR_RELEASE);
         std::string subString = frConfig.get_param<std::string>(FileWriterController::CONFIG_FR_READY);
-        this->setupFrameReceiverInterface(shMemName, pubString, subString);
+        unsigned int consumerID = frConfig.get_param<unsigned int>(FileWriterController::CONFIG_FR_CONSUMER_ID, 0);
+        this->setupFrameReceiverInterface(shMemName, pubString, subString, consumerID);
+      }
+    }
+
+    // Check if we are being asked to pre-allocate DataBlocks, e.g. into the "raw" pool used
+    // for frames copied from shared memory
+    if (config.has_param(FileWriterController::CONFIG_DATABLOCKS)){
+      FrameReceiver::IpcMessage blockConfig(config.get_param<const rapidjson::Value&>(FileWriterController::CONFIG_DATABLOCKS));
+      if (blockConfig.has_param(FileWriterController::CONFIG_DATABLOCKS_POOL) &&
+          blockConfig.has_param(FileWriterController::CONFIG_DATABLOCKS_COUNT) &&
+          blockConfig.has_param(FileWriterController::CONFIG_DATABLOCKS_SIZE)){
+        std::string pool = blockConfig.get_param<std::string>(FileWriterController::CONFIG_DATABLOCKS_POOL);
+        unsigned int count = blockConfig.get_param<unsigned int>(FileWriterController::CONFIG_DATABLOCKS_COUNT);
+        uint64_t size = blockConfig.get_param<uint64_t>(FileWriterController::CONFIG_DATABLOCKS_SIZE);
+        bool prefault = blockConfig.get_param<bool>(FileWriterController::CONFIG_DATABLOCKS_PREFAULT, false);
+        bool lock = blockConfig.get_param<bool>(FileWriterController::CONFIG_DATABLOCKS_LOCK, false);
+        DataBlockPool::allocate(pool, count, size, prefault, lock);
       }
     }
 
@@ -187,7 +214,7 @@ namespace filewriter
    * configuration IpcMessage objects that are received.  The objects
    * are searched for:
    * CONFIG_PLUGIN_LIST - Replies with a list of loaded plugins
-   * CONFIG_PLUGIN_LOAD - Uses NAME, INDEX and LIBRARY to load a plugin
+   * CONFIG_PLUGIN_LOAD - Uses NAME, INDEX and LIBRARY, and optionally NUMA_NODE, to load a plugin
    * into the controller.
    * CONFIG_PLUGIN_CONNECT - Uses CONNECTION and INDEX to connect one
    * plugin input to another plugin output.
@@ -217,7 +244,8 @@ namespace filewriter
         std::string index = pluginConfig.get_param<std::string>(FileWriterController::CONFIG_PLUGIN_INDEX);
         std::string name = pluginConfig.get_param<std::string>(FileWriterController::CONFIG_PLUGIN_NAME);
         std::string library = pluginConfig.get_param<std::string>(FileWriterController::CONFIG_PLUGIN_LIBRARY);
-        this->loadPlugin(index, name, library);
+        int numaNode = pluginConfig.get_param<int>(FileWriterController::CONFIG_PLUGIN_NUMA_NODE, -1);
+        this->loadPlugin(index, name, library, numaNode);
       }
     }
 
@@ -249,13 +277,17 @@ namespace filewriter
    * Attempts to load the specified library dynamically using the classloader.
    * If the index specified is already used then throws an error.  Once the plugin
    * has been loaded it's processing thread is started.  The same plugin type can
-   * be loaded multiple times as long as each index is unique.
+   * be loaded multiple times as long as each index is unique.  The plugin worker
+   * thread can be bound to a NUMA node, e.g. the node local to the receiving NIC
+   * and shared memory buffer.
    *
    * \param[in] index - Unique index required for the plugin.
    * \param[in] name - Name of the plugin class.
    * \param[in] library - Full path of shared library file for the plugin.
+   * \param[in] numaNode - NUMA node to bind the plugin thread to, or -1 to leave it unbound.
    */
-  void FileWriterController::loadPlugin(const std::string& index, const std::string& name, const std::string& library)
+  void FileWriterController::loadPlugin(const std::string& index, const std::string& name, const std::string& library,
+                                        int numaNode)
   {
     // Verify a plugin of the same name doesn't already exist
     if (plugins_.count(index) == 0){
@@ -264,7 +296,8 @@ namespace filewriter
       boost::shared_ptr<FileWriterPlugin> plugin = ClassLoader<FileWriterPlugin>::load_class(name, library);
       plugin->setName(index);
       plugins_[index] = plugin;
-      // Start the plugin worker thread
+      // Bind and start the plugin worker thread
+      plugin->setNumaNode(numaNode);
       plugin->start();
     } else {
       LOG4CXX_ERROR(logger_, "Cannot load plugin with index = " << index << ", already loaded");
@@ -352,13 +385,17 @@ namespace filewriter
    * \param[in] sharedMemName - Name of the shared memory block opened by the frame receiver.
    * \param[in] frPublisherString - Endpoint for sending frame release notifications.
    * \param[in] frSubscriberString - Endpoint for receiving frame ready notifications.
+   * \param[in] consumerID - Index of this consumer in frame release notifications, when the
+   * frame receiver notifies frames to several consumers.
    */
   void FileWriterController::setupFrameReceiverInterface(const std::string& sharedMemName,
                                                          const std::string& frPublisherString,
-                                                         const std::string& frSubscriberString)
+                                                         const std::string& frSubscriberString,
+                                                         unsigned int consumerID)
   {
     LOG4CXX_DEBUG(logger_, "Shared Memory Config: Name=" << sharedMemName <<
-                  " Publisher=" << frPublisherString << " Subscriber=" << frSubscriberString);
+                  " Publisher=" << frPublisherString << " Subscriber=" << frSubscriberString <<
+                  " Consumer=" << consumerID);
 
     try
     {
@@ -376,8 +413,15 @@ namespace filewriter
       // Create the new shared memory controller and give it the parser and publisher
       sharedMemController_ = boost::shared_ptr<SharedMemoryController>(new SharedMemoryController(reactor_, frSubscriberString, frPublisherString));
       sharedMemController_->setSharedMemoryParser(sharedMemParser_);
+      sharedMemController_->setConsumerID(consumerID);
+
+      // Share the buffer manager mapping the shared memory with the controller, so that any frame rings it holds are used
+      sharedMemController_->setSharedBufferManager(sharedMemParser_->get_buffer_manager());
 
     } catch (const boost::interprocess::interprocess_exception& e)
+    {
+      LOG4CXX_ERROR(logger_, "Unable to access shared memory: " << e.what());
+    } catch (const FrameReceiver::SharedBufferManagerException& e)
     {
       LOG4CXX_ERROR(logger_, "Unable to access shared memory: " << e.what());
     }
@@ -39,7 +39,7 @@ namespace filewriter
     void handleCtrlChannel();
     void configure(FrameReceiver::IpcMessage& config, FrameReceiver::IpcMessage& reply);
     void configurePlugin(FrameReceiver::IpcMessage& config, FrameReceiver::IpcMessage& reply);
-    void loadPlugin(const std::string& index, const std::string& name, const std::string& library);
+    void loadPlugin(const std::string& index, const std::string& name, const std::string& library, int numaNode=-1);
     void connectPlugin(const std::string& index, const std::string& connectTo);
     void disconnectPlugin(const std::string& index, const std::string& disconnectFrom);
     void waitForShutdown();
@@ -56,12 +56,27 @@ namespace filewriter
     static const std::string CONFIG_FR_RELEASE;
     /** Configuration constant for connection string for frame ready **/
     static const std::string CONFIG_FR_READY;
+    /** Configuration constant for index of this consumer in frame release notifications **/
+    static const std::string CONFIG_FR_CONSUMER_ID;
     /** Configuration constant for executing setup of shared memory interface **/
     static const std::string CONFIG_FR_SETUP;
 
     /** Configuration constant for control socket endpoint **/
     static const std::string CONFIG_CTRL_ENDPOINT;
 
+    /** Configuration constant for pre-allocating DataBlocks **/
+    static const std::string CONFIG_DATABLOCKS;
+    /** Configuration constant for the DataBlockPool to pre-allocate into **/
+    static const std::string CONFIG_DATABLOCKS_POOL;
+    /** Configuration constant for the number of DataBlocks to pre-allocate **/
+    static const std::string CONFIG_DATABLOCKS_COUNT;
+    /** Configuration constant for the size in bytes of pre-allocated DataBlocks **/
+    static const std::string CONFIG_DATABLOCKS_SIZE;
+    /** Configuration constant for prefaulting pre-allocated DataBlocks **/
+    static const std::string CONFIG_DATABLOCKS_PREFAULT;
+    /** Configuration constant for locking pre-allocated DataBlocks into memory **/
+    static const std::string CONFIG_DATABLOCKS_LOCK;
+
     /** Configuration constant for plugin related items **/
     static const std::string CONFIG_PLUGIN;
     /** Configuration constant for listing loaded plugins **/
@@ -80,10 +95,13 @@ namespace filewriter
     static const std::string CONFIG_PLUGIN_LIBRARY;
     /** Configuration constant for setting up a plugin connection **/
     static const std::string CONFIG_PLUGIN_CONNECTION;
+    /** Configuration constant for the NUMA node to bind a plugin thread to **/
+    static const std::string CONFIG_PLUGIN_NUMA_NODE;
 
     void setupFrameReceiverInterface(const std::string& sharedMemName,
                                      const std::string& frPublisherString,
-                                     const std::string& frSubscriberString);
+                                     const std::string& frSubscriberString,
+                                     unsigned int consumerID=0);
     void setupControlInterface(const std::string& ctrlEndpointString);
     void runIpcService(void);
     void tickTimer(void);
@@ -118,6 +118,22 @@ BOOST_AUTO_TEST_CASE(DataBlockPoolTest)
   BOOST_CHECK_NE(block1->getSize(), block2->getSize());
 }
 
+BOOST_AUTO_TEST_CASE(DataBlockPoolPrefaultTest)
+{
+  boost::shared_ptr<filewriter::DataBlock> block;
+  // Allocate and prefault 10 blocks, locking them into memory
+  BOOST_CHECK_NO_THROW(filewriter::DataBlockPool::allocate("prefault", 10, 4096, true, true));
+  BOOST_CHECK_EQUAL(filewriter::DataBlockPool::getFreeBlocks("prefault"), 10);
+  BOOST_CHECK_EQUAL(filewriter::DataBlockPool::getMemoryAllocated("prefault"), 40960);
+  // Prefaulted blocks are zeroed
+  BOOST_CHECK_NO_THROW(block = filewriter::DataBlockPool::take("prefault", 4096));
+  const char *testPtr = (const char *)block->get_data();
+  for (int index = 0; index < 4096; index++){
+    BOOST_CHECK_EQUAL(testPtr[index], 0);
+  }
+  BOOST_CHECK_NO_THROW(filewriter::DataBlockPool::release("prefault", block));
+}
+
 BOOST_AUTO_TEST_SUITE_END(); //DataBlockUnitTest
 
 BOOST_AUTO_TEST_SUITE(FrameUnitTest);
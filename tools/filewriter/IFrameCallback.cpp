@@ -6,6 +6,7 @@
  */
 
 #include <IFrameCallback.h>
+#include "FrameReceiverException.h"
 
 namespace filewriter
 {
@@ -15,8 +16,10 @@ namespace filewriter
    * The constructor creates the new WorkQueue object.
    */
   IFrameCallback::IFrameCallback() :
+    logger_(Logger::getLogger("FW.IFrameCallback")),
     thread_(0),
-    working_(false)
+    working_(false),
+    numaNode_(-1)
   {
     // Create the work queue for message offload
     queue_ = boost::shared_ptr<WorkQueue<boost::shared_ptr<Frame> > >(new WorkQueue<boost::shared_ptr<Frame> >);
@@ -38,6 +41,19 @@ namespace filewriter
     return queue_;
   }
 
+  /** Set the NUMA node to bind the worker thread to.
+   *
+   * The worker thread is bound to the CPUs of the node when it starts, and the
+   * memory it allocates, e.g. for DataBlocks, prefers the node.  This must be
+   * called before the thread is started.
+   *
+   * \param[in] node - NUMA node to bind to, or -1 to leave the thread unbound.
+   */
+  void IFrameCallback::setNumaNode(int node)
+  {
+    numaNode_ = node;
+  }
+
   /** Start the worker thread.
    *
    * Check to ensure this object is not already working.  If it isn't then
@@ -104,6 +120,16 @@ namespace filewriter
    */
   void IFrameCallback::workerTask()
   {
+    // Bind to the configured NUMA node, if any, before processing any frames
+    if (numaNode_ >= 0){
+      try {
+        FrameReceiver::NumaBinding::bind_thread(numaNode_);
+        LOG4CXX_DEBUG(logger_, "Worker thread bound to NUMA node " << numaNode_);
+      } catch (const FrameReceiver::FrameReceiverException& e){
+        LOG4CXX_ERROR(logger_, "Unable to bind worker thread to NUMA node " << numaNode_ << ": " << e.what());
+      }
+    }
+
     // Main worker task of this callback
     // Check the queue for messages
     while (working_){
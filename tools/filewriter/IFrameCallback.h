@@ -20,6 +20,7 @@ using namespace log4cxx::helpers;
 
 #include "Frame.h"
 #include "WorkQueue.h"
+#include "NumaBinding.h"
 
 namespace filewriter
 {
@@ -36,6 +37,7 @@ namespace filewriter
     IFrameCallback();
     virtual ~IFrameCallback();
     boost::shared_ptr<WorkQueue<boost::shared_ptr<Frame> > > getWorkQueue();
+    void setNumaNode(int node);
     void start();
     void stop();
     void confirmRegistration(const std::string& name);
@@ -50,6 +52,8 @@ namespace filewriter
     boost::shared_ptr<WorkQueue<boost::shared_ptr<Frame> > > queue_;
     /** Is this IFrameCallback working */
     bool working_;
+    /** NUMA node to bind the worker thread to, or -1 if not bound */
+    int numaNode_;
     /** Map of confirmed registrations to this worker queue */
     std::map<std::string, std::string> registrations_;
 
@@ -38,6 +38,23 @@ namespace filewriter
     const PercivalEmulator::FrameHeader* hdrPtr = static_cast<const PercivalEmulator::FrameHeader*>(frame->get_data());
     LOG4CXX_TRACE(logger_, "Raw frame number: " << hdrPtr->frame_number);
 
+    // The header layout is versioned, so drop frames written with a layout this plugin does not understand
+    if (!PercivalEmulator::is_supported_header(hdrPtr))
+    {
+      LOG4CXX_ERROR(logger_, "Raw frame has header magic 0x" << std::hex << hdrPtr->header_magic << std::dec
+                             << " version " << hdrPtr->header_version << ", expected version "
+                             << PercivalEmulator::frame_header_version << ". Dropping frame");
+      return;
+    }
+
+    // Report incomplete frames, using the packet state bitmap to count packets without a per-packet scan
+    size_t packets_received = PercivalEmulator::count_packet_state(hdrPtr);
+    if (packets_received != PercivalEmulator::num_frame_packets)
+    {
+      LOG4CXX_WARN(logger_, "Raw frame " << hdrPtr->frame_number << " is incomplete, "
+                            << packets_received << " of " << PercivalEmulator::num_frame_packets << " packets received");
+    }
+
     boost::shared_ptr<Frame> reset_frame;
     reset_frame = boost::shared_ptr<Frame>(new Frame("reset"));
     reset_frame->set_frame_number(hdrPtr->frame_number);
@@ -28,7 +28,9 @@ namespace filewriter
                                                  const std::string& txEndPoint) :
     reactor_(reactor),
     rxChannel_(ZMQ_SUB),
-    txChannel_(ZMQ_PUB)
+    txChannel_(ZMQ_PUB),
+    consumerID_(0),
+    ringThreadRunning_(false)
   {
     // Setup logging for the class
     logger_ = Logger::getLogger("FW.SharedMemoryController");
@@ -70,6 +72,12 @@ namespace filewriter
   SharedMemoryController::~SharedMemoryController()
   {
     LOG4CXX_TRACE(logger_, "SharedMemoryController destructor.");
+    if (ringThread_){
+      ringThreadRunning_ = false;
+      // Wake the frame ring thread so that it exits without waiting for the event timeout
+      sbm_->get_ready_event()->signal();
+      ringThread_->join();
+    }
   }
 
   /** setSharedMemoryParser
@@ -83,6 +91,36 @@ namespace filewriter
     smp_ = smp;
   }
 
+  /** setConsumerID
+   * Sets the index identifying this process in frame release notifications, when
+   * the frame receiver notifies frames to several consumers which must each release
+   * them.
+   *
+   * \param[in] consumerID - index of this consumer.
+   */
+  void SharedMemoryController::setConsumerID(unsigned int consumerID)
+  {
+    consumerID_ = consumerID;
+  }
+
+  /** setSharedBufferManager
+   * Takes a shared pointer to the shared buffer manager mapping the frame
+   * receiver shared memory. If the shared memory holds frame rings, a thread
+   * is started to receive frame ready notifications from the rings.
+   *
+   * \param[in] sbm - shared pointer to a SharedBufferManager object.
+   */
+  void SharedMemoryController::setSharedBufferManager(boost::shared_ptr<FrameReceiver::SharedBufferManager> sbm)
+  {
+    sbm_ = sbm;
+    if (sbm_->has_frame_rings() && !ringThread_){
+      LOG4CXX_DEBUG(logger_, "Receiving frames through " << sbm_->get_num_ready_rings() << " shared memory frame ring(s)");
+      ringThreadRunning_ = true;
+      ringThread_ = boost::shared_ptr<boost::thread>(
+          new boost::thread(boost::bind(&SharedMemoryController::runFrameRings, this)));
+    }
+  }
+
   /** Called whenever a new IpcMessage is received to notify that a frame is ready.
    *
    * Reads the raw message bytes from the rxChannel_ and constructs an IpcMessage object
@@ -97,10 +135,35 @@ namespace filewriter
     // Receive a message from the main thread channel
     std::string rxMsgEncoded = rxChannel_.recv();
 
-    LOG4CXX_DEBUG(logger_, "RX thread called with message: " << rxMsgEncoded);
-
     // Parse and handle the message
     try {
+      // Handle a binary frame notification, replying with a binary release so that the
+      // release channel uses the same format as the frame receiver ready channel
+      if (FrameReceiver::FrameNotification::is_binary(rxMsgEncoded)){
+        FrameReceiver::FrameNotification rxNotification(rxMsgEncoded);
+        LOG4CXX_DEBUG(logger_, "RX thread called with binary notification for frame "
+                      << rxNotification.get_frame_number() << " in buffer " << rxNotification.get_buffer_id()
+                      << (rxNotification.is_spilled() ? " (spilled)" : ""));
+
+        if (rxNotification.get_msg_val() == FrameReceiver::IpcMessage::MsgValNotifyFrameReady){
+          processFrame(rxNotification.get_frame_number(), rxNotification.get_buffer_id());
+
+          FrameReceiver::FrameNotification txNotification(FrameReceiver::IpcMessage::MsgValNotifyFrameRelease,
+                                                          rxNotification.get_frame_number(),
+                                                          rxNotification.get_buffer_id(),
+                                                          rxNotification.get_frame_state(),
+                                                          rxNotification.get_frame_timestamp_ns(),
+                                                          consumerID_);
+          std::string txEncoded = txNotification.encode();
+          txChannel_.send(txEncoded);
+        } else {
+          LOG4CXX_ERROR(logger_, "RX thread got unexpected binary frame notification");
+        }
+        return;
+      }
+
+      LOG4CXX_DEBUG(logger_, "RX thread called with message: " << rxMsgEncoded);
+
       FrameReceiver::IpcMessage rxMsg(rxMsgEncoded.c_str());
 
       if ((rxMsg.get_msg_type() == FrameReceiver::IpcMessage::MsgTypeNotify) &&
@@ -108,18 +171,7 @@ namespace filewriter
         int bufferID = rxMsg.get_param<int>("buffer_id", -1);
 
         if (bufferID != -1){
-          // Create a frame object and copy in the raw frame data
-          boost::shared_ptr<Frame> frame;
-          frame = boost::shared_ptr<Frame>(new Frame("raw"));
-          smp_->get_frame((*frame), bufferID);
-          // Set the frame number
-          frame->set_frame_number(rxMsg.get_param<int>("frame", 0));
-
-          // Loop over registered callbacks, placing the frame onto each queue
-          std::map<std::string, boost::shared_ptr<IFrameCallback> >::iterator cbIter;
-          for (cbIter = callbacks_.begin(); cbIter != callbacks_.end(); ++cbIter){
-            cbIter->second->getWorkQueue()->add(frame);
-          }
+          processFrame(rxMsg.get_param<int>("frame", 0), bufferID);
 
           // We want to send the notify frame release message back to the frameReceiver
           FrameReceiver::IpcMessage txMsg(FrameReceiver::IpcMessage::MsgTypeNotify,
@@ -127,6 +179,7 @@ namespace filewriter
 
           txMsg.set_param("frame", rxMsg.get_param<int>("frame"));
           txMsg.set_param("buffer_id", rxMsg.get_param<int>("buffer_id"));
+          txMsg.set_param("consumer", consumerID_);
           LOG4CXX_DEBUG(logger_, "Sending response: " << txMsg.encode());
 
           // Now publish the release message, to notify the frame receiver that we are
@@ -154,6 +207,95 @@ namespace filewriter
     }
   }
 
+  /** Create a Frame from a shared memory buffer and pass it to the registered callbacks.
+   *
+   * The buffer is marked in use in the shared buffer descriptor table while the frame
+   * is copied out. Other consumers may be reading the same buffer, so it is left to the
+   * frame receiver to mark the buffer free once every consumer has released it.
+   *
+   * \param[in] frameNumber - number of the frame.
+   * \param[in] bufferID - ID of the shared memory buffer holding the frame.
+   */
+  void SharedMemoryController::processFrame(int frameNumber, int bufferID)
+  {
+    if (sbm_ && !sbm_->claim_buffer(bufferID, FrameReceiver::BufferStateReady, FrameReceiver::BufferStateInUse)){
+      LOG4CXX_DEBUG(logger_, "Buffer " << bufferID << " holding frame " << frameNumber << " was not marked ready");
+    }
+
+    // Create a frame object and copy in the raw frame data
+    boost::shared_ptr<Frame> frame;
+    frame = boost::shared_ptr<Frame>(new Frame("raw"));
+    smp_->get_frame((*frame), bufferID);
+    // Set the frame number
+    frame->set_frame_number(frameNumber);
+
+    // Loop over registered callbacks, placing the frame onto each queue
+    boost::lock_guard<boost::mutex> lock(callbackMutex_);
+    std::map<std::string, boost::shared_ptr<IFrameCallback> >::iterator cbIter;
+    for (cbIter = callbacks_.begin(); cbIter != callbacks_.end(); ++cbIter){
+      cbIter->second->getWorkQueue()->add(frame);
+    }
+  }
+
+  /** Service the shared memory frame rings.
+   *
+   * Runs in a dedicated thread, popping frame ready descriptors from each of the
+   * ready rings in turn and processing the frames, then pushing a descriptor for
+   * each released buffer onto the release ring. The frame receiver marks the buffer
+   * free when it drains the release ring, so a buffer is only free once it is back
+   * in the receiver pool. If the release ring is full the thread retries until there
+   * is space. When the ready rings are empty the thread waits on the ready event,
+   * which the frame receiver signals after pushing.
+   */
+  void SharedMemoryController::runFrameRings()
+  {
+    FrameReceiver::SharedFrameEventPtr readyEvent = sbm_->get_ready_event();
+    FrameReceiver::SharedFrameRingPtr releaseRing = sbm_->get_release_ring();
+    std::vector<FrameReceiver::SharedFrameRingPtr> readyRings;
+    for (unsigned int ringIdx = 0; ringIdx < sbm_->get_num_ready_rings(); ringIdx++){
+      readyRings.push_back(sbm_->get_ready_ring(ringIdx));
+    }
+
+    while (ringThreadRunning_){
+      // Read the event sequence before checking the rings so that no signal is missed
+      uint32_t sequence = readyEvent->get_sequence();
+      unsigned int framesProcessed = 0;
+
+      for (unsigned int ringIdx = 0; ringIdx < readyRings.size(); ringIdx++){
+        FrameReceiver::FrameDescriptor descriptor;
+        while (readyRings[ringIdx]->pop(descriptor)){
+          uint32_t frameState = descriptor.reserved[FrameReceiver::frame_descriptor_state_idx];
+          bool spilled = (descriptor.reserved[FrameReceiver::frame_descriptor_flags_idx] &
+                          FrameReceiver::frame_descriptor_flag_spilled) != 0;
+          LOG4CXX_DEBUG(logger_, "Frame ring " << ringIdx << " notified frame " << descriptor.frame_number
+                        << " in buffer " << descriptor.buffer_id << " with state " << frameState
+                        << (spilled ? " (spilled)" : ""));
+          if ((frameState != 0) && (frameState != FrameReceiver::FrameDecoder::FrameReceiveStateComplete)){
+            LOG4CXX_WARN(logger_, "Frame " << descriptor.frame_number << " in buffer " << descriptor.buffer_id
+                         << " was not received completely, state " << frameState);
+          }
+          processFrame(descriptor.frame_number, descriptor.buffer_id);
+
+          // Notify the frame receiver that we are finished with that block of shared memory,
+          // polling for space on the release ring rather than leaking the buffer
+          while (!releaseRing->push(descriptor)){
+            if (!ringThreadRunning_){
+              LOG4CXX_ERROR(logger_, "Frame release ring is full at shutdown, unable to release buffer "
+                            << descriptor.buffer_id);
+              break;
+            }
+            boost::this_thread::sleep(boost::posix_time::microseconds(100));
+          }
+          framesProcessed++;
+        }
+      }
+
+      if (!framesProcessed){
+        readyEvent->wait(sequence, 100);
+      }
+    }
+  }
+
   /** Register a callback for Frame updates with this class.
    *
    * The callback (IFrameCallback subclass) is added to the map of callbacks, indexed
@@ -166,6 +308,7 @@ namespace filewriter
   void SharedMemoryController::registerCallback(const std::string& name, boost::shared_ptr<IFrameCallback> cb)
   {
     // Check if we own the callback already
+    boost::lock_guard<boost::mutex> lock(callbackMutex_);
     if (callbacks_.count(name) == 0){
       // Record the callback pointer
       callbacks_[name] = cb;
@@ -183,6 +326,7 @@ namespace filewriter
   void SharedMemoryController::removeCallback(const std::string& name)
   {
     boost::shared_ptr<IFrameCallback> cb;
+    boost::lock_guard<boost::mutex> lock(callbackMutex_);
     if (callbacks_.count(name) > 0){
       // Get the pointer
       cb = callbacks_[name];
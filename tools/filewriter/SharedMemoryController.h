@@ -16,12 +16,17 @@ using namespace log4cxx;
 using namespace log4cxx::helpers;
 
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
 
 #include "IFrameCallback.h"
 #include "IpcReactor.h"
 #include "IpcChannel.h"
 #include "IpcMessage.h"
+#include "FrameNotification.h"
+#include "FrameDecoder.h"
 #include "SharedMemoryParser.h"
+#include "SharedBufferManager.h"
 
 namespace filewriter
 {
@@ -35,6 +40,10 @@ namespace filewriter
    * Frame to contain the data and meta data, and then notifies any listening
    * plugins.  This class also notifies the frame receiver service once the
    * shared memory location is available for re-use.
+   *
+   * If the shared memory buffer holds frame rings, frame ready and release
+   * notifications are instead passed as descriptors through the rings, which
+   * are serviced by a dedicated thread rather than the IpcReactor.
    */
   class SharedMemoryController
   {
@@ -42,23 +51,38 @@ namespace filewriter
     SharedMemoryController(boost::shared_ptr<FrameReceiver::IpcReactor> reactor, const std::string& rxEndPoint, const std::string& txEndPoint);
     virtual ~SharedMemoryController();
     void setSharedMemoryParser(boost::shared_ptr<SharedMemoryParser> smp);
+    void setSharedBufferManager(boost::shared_ptr<FrameReceiver::SharedBufferManager> sbm);
+    void setConsumerID(unsigned int consumerID);
     void registerCallback(const std::string& name, boost::shared_ptr<IFrameCallback> cb);
     void removeCallback(const std::string& name);
     void handleRxChannel();
 
   private:
+    void processFrame(int frameNumber, int bufferID);
+    void runFrameRings();
+
     /** Pointer to logger */
     LoggerPtr logger_;
     /** Pointer to SharedMemoryParser object */
     boost::shared_ptr<SharedMemoryParser> smp_;
     /** Map of IFrameCallback pointers, indexed by name */
     std::map<std::string, boost::shared_ptr<IFrameCallback> > callbacks_;
+    /** Mutex protecting the callback map, which is used by the frame ring thread */
+    boost::mutex callbackMutex_;
     /** IpcReactor pointer, for managing IpcMessage objects */
     boost::shared_ptr<FrameReceiver::IpcReactor> reactor_;
     /** IpcChannel for receiving notifications of new frames */
     FrameReceiver::IpcChannel             rxChannel_;
     /** IpcChannel for sending notifications of frame release */
     FrameReceiver::IpcChannel             txChannel_;
+    /** Index of this consumer in frame release notifications */
+    unsigned int                          consumerID_;
+    /** Shared buffer manager holding the frame rings, if used */
+    boost::shared_ptr<FrameReceiver::SharedBufferManager> sbm_;
+    /** Flag to keep the frame ring thread running, cleared by the controller thread */
+    boost::atomic<bool>                   ringThreadRunning_;
+    /** Thread servicing the frame rings */
+    boost::shared_ptr<boost::thread>      ringThread_;
   };
 
 } /* namespace filewriter */
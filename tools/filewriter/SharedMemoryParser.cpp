@@ -13,27 +13,22 @@ namespace filewriter
   /** Constructor.
    *
    * The constructor sets up logging used within the class.  It also opens the shared
-   * memory buffer and maps the specific region used by the IPC classes.  Memory is
-   * allocated for the shared memory buffer header information and this is memcopied
-   * from the shared memory location into the allocated program memory.
+   * memory buffer by name through a SharedBufferManager, which maps either a POSIX
+   * shared memory object or a huge page file in the default hugetlbfs mount.  A
+   * SharedBufferManagerException is thrown if neither exists.
    *
    * \param[in] shared_mem_name - name of the shared memory buffer.
    */
   SharedMemoryParser::SharedMemoryParser(const std::string& shared_mem_name) :
-    shared_mem(boost::interprocess::open_only, shared_mem_name.c_str(), boost::interprocess::read_write),
     logger(log4cxx::Logger::getLogger("FW.SharedMemParser")),
-    shared_mem_header(static_cast<Header*>(malloc(sizeof(Header))))
+    buffer_manager(new FrameReceiver::SharedBufferManager(shared_mem_name))
   {
     LOG4CXX_DEBUG(logger, "Registering shared memory region \"" << shared_mem_name << "\"");
-
-    // Map the whole shared memory region into this process
-    this->shared_mem_region = boost::interprocess::mapped_region(this->shared_mem, boost::interprocess::read_write);
-
-    // Copy the buffer manager header - it's quite small
-    memcpy(this->shared_mem_header, reinterpret_cast<const void*>(shared_mem_region.get_address()), sizeof(Header));
-    LOG4CXX_DEBUG(logger, "Shared mem: buffers=" << this->shared_mem_header->num_buffers
-                          << " bufsize=" << this->shared_mem_header->buffer_size
-                          << " headersize=" << sizeof(Header));
+    LOG4CXX_DEBUG(logger, "Shared mem: buffers=" << buffer_manager->get_num_buffers()
+                          << " bufsize=" << buffer_manager->get_buffer_size()
+                          << " sizeclasses=" << buffer_manager->get_num_size_classes()
+                          << " pagesize=" << buffer_manager->get_page_size()
+                          << (buffer_manager->is_huge_page_backed() ? " (huge pages)" : ""));
   }
 
   /**
@@ -41,7 +36,6 @@ namespace filewriter
    */
   SharedMemoryParser::~SharedMemoryParser()
   {
-    free(this->shared_mem_header);
   }
 
   /** Copy a raw data frame into a Frame object.
@@ -49,7 +43,8 @@ namespace filewriter
    * The buffer_id value is used to determine which section of shared memory should
    * be copied.  The shared memory is memcopied into the Frame DataBlock of the
    * Frame reference passed into this method.  The address and buffer size are provided
-   * by the shared memory header information.
+   * by the shared memory header information, the size depending on the size class of
+   * the buffer.
    *
    * \param[out] dest_frame - reference to the Frame object to store the raw data.
    * \param[in] buffer_id - the ID of the shared memory buffer that contains the raw data.
@@ -57,7 +52,7 @@ namespace filewriter
   void SharedMemoryParser::get_frame(Frame& dest_frame, unsigned int buffer_id)
   {
     LOG4CXX_DEBUG(logger, "get_frame called for buffer " << buffer_id);
-    dest_frame.copy_data(this->get_buffer_address(buffer_id), this->get_buffer_size());
+    dest_frame.copy_data(this->get_buffer_address(buffer_id), this->get_buffer_size(buffer_id));
   }
 
   /** Return the size of a shared memory buffer in bytes.
@@ -66,7 +61,19 @@ namespace filewriter
    */
   size_t SharedMemoryParser::get_buffer_size()
   {
-    return this->shared_mem_header->buffer_size;
+    return buffer_manager->get_buffer_size();
+  }
+
+  /** Return the size of a particular shared memory buffer in bytes.
+   *
+   * Buffers of smaller size classes are smaller than the size returned by get_buffer_size().
+   *
+   * \param[in] bufferid - the ID of the shared memory buffer.
+   * \return the size in bytes of the shared memory buffer.
+   */
+  size_t SharedMemoryParser::get_buffer_size(unsigned int bufferid) const
+  {
+    return buffer_manager->get_buffer_size(bufferid);
   }
 
   /** Return a pointer to a shared memory buffer.
@@ -76,9 +83,19 @@ namespace filewriter
    */
   const void * SharedMemoryParser::get_buffer_address(unsigned int bufferid) const
   {
-    return static_cast<const void *>(static_cast<char*>(shared_mem_region.get_address())
-                                     + sizeof(Header)
-                                     + bufferid * shared_mem_header->buffer_size);
+    return buffer_manager->get_buffer_address(bufferid);
+  }
+
+  /** Return the buffer manager mapping the shared memory buffer.
+   *
+   * This allows other users of the shared memory, e.g. its frame rings, to share the
+   * mapping made by the parser rather than mapping the buffer again.
+   *
+   * \return a shared pointer to the SharedBufferManager.
+   */
+  boost::shared_ptr<FrameReceiver::SharedBufferManager> SharedMemoryParser::get_buffer_manager() const
+  {
+    return buffer_manager;
   }
 
 } /* namespace filewriter */
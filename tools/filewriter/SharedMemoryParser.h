@@ -11,12 +11,12 @@
 #include <string>
 #include <stdint.h>
 
-#include <boost/interprocess/shared_memory_object.hpp>
-#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <log4cxx/logger.h>
 
 #include "Frame.h"
+#include "SharedBufferManager.h"
 
 typedef unsigned long long dimsize_t;
 typedef std::vector<dimsize_t> dimensions_t;
@@ -26,8 +26,9 @@ namespace filewriter
 
   /** Parses shared memory buffer and populates Frame objects.
    *
-   * The SharedMemoryParser class manages the boost shared memory objects,
-   * and is used to extract raw data from shared memory buffers and copy the
+   * The SharedMemoryParser class maps the shared memory buffer through a
+   * SharedBufferManager, so that buffers backed by either POSIX shared memory
+   * or huge pages can be opened by name, and is used to extract raw data from shared memory buffers and copy the
    * data into Frame objects for further processing.
    */
   class SharedMemoryParser
@@ -37,7 +38,9 @@ namespace filewriter
     ~SharedMemoryParser();
     void get_frame(Frame& dest_frame, unsigned int buffer_id);
     size_t get_buffer_size();
+    size_t get_buffer_size(unsigned int bufferid) const;
     const void* get_buffer_address(unsigned int bufferid) const;
+    boost::shared_ptr<FrameReceiver::SharedBufferManager> get_buffer_manager() const;
 
   private:
     SharedMemoryParser();
@@ -48,12 +51,8 @@ namespace filewriter
 
     /** Pointer to logger */
     log4cxx::LoggerPtr logger;
-    /** Shared memory object */
-    boost::interprocess::shared_memory_object shared_mem;
-    /** Shared memory region object */
-    boost::interprocess::mapped_region        shared_mem_region;
-    /** IPC shared memory header */
-    Header*                                   shared_mem_header;
+    /** Shared buffer manager mapping the shared memory buffer */
+    boost::shared_ptr<FrameReceiver::SharedBufferManager> buffer_manager;
   };
 
 } /* namespace filewriter */
@@ -1,5 +1,6 @@
 from frame_receiver.ipc_channel import IpcChannel, IpcChannelException
 from frame_receiver.ipc_message import IpcMessage, IpcMessageException
+from frame_receiver.frame_notification import FrameNotification, FrameNotificationException
 from frame_receiver.shared_buffer_manager import SharedBufferManager, SharedBufferManagerException
 from frame_processor_config import FrameProcessorConfig
 from percival_emulator_frame_decoder import PercivalEmulatorFrameDecoder, PercivalFrameHeader, PercivalFrameData
@@ -117,6 +118,12 @@ class FrameProcessor(object):
             if (self.ready_channel.poll(100)):
 
                 ready_msg = self.ready_channel.recv() 
+                
+                # Handle binary frame notifications, replying in the same format
+                if FrameNotification.is_binary(ready_msg):
+                    self.process_binary_notification(ready_msg)
+                    continue
+                
                 ready_decoded = IpcMessage(from_str=ready_msg)
                 
                 if ready_decoded.get_msg_type() == 'notify' and ready_decoded.get_msg_val() == 'frame_ready':
@@ -131,6 +138,7 @@ class FrameProcessor(object):
                     release_msg = IpcMessage(msg_type='notify', msg_val='frame_release')
                     release_msg.set_param('frame', frame_number)
                     release_msg.set_param('buffer_id', buffer_id)
+                    release_msg.set_param('consumer', self.config.consumer)
                     self.release_channel.send(release_msg.encode())
                     
                     self.frames_received += 1
@@ -141,6 +149,30 @@ class FrameProcessor(object):
         
         self.logger.info("Frame processing thread interrupted, terminating")
         
+    def process_binary_notification(self, ready_msg):
+        
+        try:
+            ready = FrameNotification(from_str=ready_msg)
+        except FrameNotificationException as e:
+            self.logger.error("Got illegal binary notification on ready channel: %s" % str(e))
+            return
+        
+        if ready.get_msg_val() != 'frame_ready':
+            self.logger.error("Got unexpected binary notification on ready channel: %s" % ready.get_msg_val())
+            return
+        
+        self.logger.debug("Got binary frame ready notification for frame %d buffer ID %d" % 
+                          (ready.frame_number, ready.buffer_id))
+        
+        if not self.config.bypass_mode:
+            self.handle_frame(ready.frame_number, ready.buffer_id)
+            
+        release = FrameNotification('frame_release', ready.frame_number, ready.buffer_id,
+                                    ready.frame_state, ready.frame_timestamp_ns, self.config.consumer)
+        self.release_channel.send_bytes(release.encode())
+        
+        self.frames_received += 1
+        
     def handle_frame(self, frame_number, buffer_id):
         
         self.frame_decoder.decode_header(buffer_id)
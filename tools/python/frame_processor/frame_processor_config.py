@@ -14,6 +14,7 @@ class FrameProcessorConfig(object):
         defaults['bypass_mode']      = False
         defaults['packet_state']     = False
         defaults['frames']           = 0
+        defaults['consumer']         = 0
         defaults['boost_mmap_mode']  = False
 
         # Parse the command-line argument list        
@@ -49,6 +50,8 @@ class FrameProcessorConfig(object):
                             help='Enable printing of packet state info during frame decoding')
         parser.add_argument('--frames', type=int, default=None, dest='frames',
                             help="Specify the number of frames to receive before shutting down")
+        parser.add_argument('--consumer', type=int, default=None, dest='consumer',
+                            help="Specify the index of this consumer in frame release notifications")
         parser.add_argument('--boost_mmap_mode',  action='store_true',
                             help="Enable boost MMAP shared memory mode")
         
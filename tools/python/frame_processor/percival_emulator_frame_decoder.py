@@ -5,10 +5,19 @@ p2m_emulator_new_firmware = True
 
 class PercivalFrameHeader(Struct):
     
+    frame_header_magic = 0x5043564c
+    frame_header_version = 3
+    
+    # The magic value and version lead the header, which is only decoded if both match.
+    # Packet state is a bitmap of 64-bit words indexed by the linear packet index in the frame
     if p2m_emulator_new_firmware:
-        frame_header_format = '<LLQQL42B1696B2B'
+        frame_header_format = '<LLLLQQ42B6x27Q'
+        frame_info_size = 42
+        num_frame_packets = 1696
     else:
-        frame_header_format = '<LLQQL14B1024B6B'
+        frame_header_format = '<LLLLQQ14B2x16Q'
+        frame_info_size = 14
+        num_frame_packets = 1024
     
     @classmethod
     def size(cls):       
@@ -20,19 +29,36 @@ class PercivalFrameHeader(Struct):
         
         header_vals = self.unpack(header_raw)
 
-        self.frame_number = header_vals[0]
-        self.frame_state = header_vals[1]
-        self.frame_start_time = datetime.fromtimestamp(float(header_vals[2]) + float(header_vals[3])/1000000000)
-        self.packets_received = header_vals[4]
-        if p2m_emulator_new_firmware:
-            self.frame_info = header_vals[5:47]
-            self.packet_state = header_vals[47:-2]
-            self.padding = header_vals[-2:]
-        else:
-            self.frame_info = header_vals[5:19]
-            self.packet_state = header_vals[19:-6]
-            self.padding = header_vals[-6:]
+        self.header_magic = header_vals[0]
+        self.header_version = header_vals[1]
+        if (self.header_magic != PercivalFrameHeader.frame_header_magic or
+                self.header_version != PercivalFrameHeader.frame_header_version):
+            raise ValueError("Frame header magic 0x{:08x} version {} is not supported, expected version {}".format(
+                self.header_magic, self.header_version, PercivalFrameHeader.frame_header_version))
+
+        self.frame_number = header_vals[2]
+        self.frame_state = header_vals[3]
+        self.frame_start_time = datetime.fromtimestamp(float(header_vals[4]) + float(header_vals[5])/1000000000)
+        
+        info_end = 6 + PercivalFrameHeader.frame_info_size
+        self.frame_info = header_vals[6:info_end]
+        self.packet_state_words = header_vals[info_end:]
+        self.packets_received = self.count_packets()
         
+    @property
+    def packet_state(self):
+        
+        return [(self.packet_state_words[idx // 64] >> (idx % 64)) & 1 
+                for idx in range(PercivalFrameHeader.num_frame_packets)]
+    
+    def count_packets(self):
+        
+        return sum(bin(word).count('1') for word in self.packet_state_words)
+        
+    def missing_packets(self):
+        
+        return [idx for idx in range(PercivalFrameHeader.num_frame_packets) 
+                if not (self.packet_state_words[idx // 64] >> (idx % 64)) & 1]
 
 class PercivalFrameData(Struct):
     
@@ -92,6 +118,8 @@ class PercivalEmulatorFrameDecoder(object):
  
         if self.header is not None:
 
+            packet_state = self.header.packet_state
+
             for data_type in range(PercivalFrameData.num_data_types):
                 for subframe in range(PercivalFrameData.num_subframes):
                     type_str = "Reset" if data_type == 1 else "Image"
@@ -107,7 +135,7 @@ class PercivalEmulatorFrameDecoder(object):
                        end_idx = start_idx + step
                        if (offset + step) > num_packets:
                            end_idx -= ((offset + step) - num_packets)
-                       packet_state_str += step_format.format(''.join('{:1}'.format('.' if val == 0 else '*') for val in self.header.packet_state[start_idx:end_idx]))
+                       packet_state_str += step_format.format(''.join('{:1}'.format('.' if val == 0 else '*') for val in packet_state[start_idx:end_idx]))
                 packet_state_str += "|\n"
                 offset += step
            
@@ -0,0 +1,81 @@
+import time
+from struct import Struct
+
+class FrameNotificationException(Exception):
+    
+    def __init__(self, msg, errno=None):
+        self.msg = msg
+        self.errno = errno
+        
+    def __str__(self):
+        return str(self.msg)
+    
+class FrameNotification(object):
+    """Compact binary frame ready and release notification.
+    
+    Mirrors the FrameNotification C++ class: a packed little-endian structure that may be sent
+    on the frame ready and release channels instead of an IpcMessage JSON notification. Use
+    is_binary() to determine which format a received message is in, and reply to a frame ready
+    notification in the same format.
+    """
+    
+    Format  = Struct('<LHHLlLLQQ')
+    MAGIC   = 0x544e5246
+    VERSION = 1
+    
+    # Flag set in the frame state of a frame held in a spill buffer rather than in shared memory
+    FRAME_STATE_SPILLED = 0x80000000
+    
+    # Message values, matching the IpcMessage::MsgVal enumeration
+    msg_vals = {'frame_ready': 3, 'frame_release': 4}
+    
+    def __init__(self, msg_val=None, frame_number=0, buffer_id=-1, frame_state=0,
+                 frame_timestamp_ns=0, consumer_id=0, from_str=None):
+        
+        if from_str == None:
+            if msg_val not in self.msg_vals:
+                raise FrameNotificationException("Illegal frame notification value: " + str(msg_val))
+            self.msg_val = msg_val
+            self.frame_number = frame_number
+            self.buffer_id = buffer_id
+            self.frame_state = frame_state
+            self.frame_timestamp_ns = frame_timestamp_ns
+            self.consumer_id = consumer_id
+            self.notify_timestamp_ns = int(time.time() * 1e9)
+            
+        else:
+            if not FrameNotification.is_binary(from_str):
+                raise FrameNotificationException("Illegal binary frame notification format")
+            
+            (magic, version, msg_val, self.frame_number, self.buffer_id, self.frame_state, self.consumer_id,
+             self.frame_timestamp_ns, self.notify_timestamp_ns) = self.Format.unpack(from_str)
+            
+            if version != self.VERSION:
+                raise FrameNotificationException("Unsupported binary frame notification version %d" % version)
+            
+            self.msg_val = None
+            for (name, val) in self.msg_vals.items():
+                if val == msg_val:
+                    self.msg_val = name
+            if self.msg_val == None:
+                raise FrameNotificationException("Illegal binary frame notification value %d" % msg_val)
+                
+    @staticmethod
+    def is_binary(data):
+        
+        return (len(data) == FrameNotification.Format.size and
+                Struct('<L').unpack_from(data)[0] == FrameNotification.MAGIC)
+        
+    def get_msg_val(self):
+        
+        return self.msg_val
+    
+    def is_spilled(self):
+        
+        return (self.frame_state & self.FRAME_STATE_SPILLED) != 0
+    
+    def encode(self):
+        
+        return self.Format.pack(self.MAGIC, self.VERSION, self.msg_vals[self.msg_val], 
+                                self.frame_number, self.buffer_id, self.frame_state, self.consumer_id,
+                                self.frame_timestamp_ns, self.notify_timestamp_ns)
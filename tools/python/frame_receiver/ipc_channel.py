@@ -49,6 +49,11 @@ class IpcChannel(object):
             data = data + '\0'
         self.socket.send_string(data)
         
+    def send_bytes(self, data):
+        
+        # Binary messages are always terminated, as receivers strip the last byte
+        self.socket.send(data + b'\0')
+        
     def recv(self):
         
         data = self.socket.recv()
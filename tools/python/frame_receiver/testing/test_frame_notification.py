@@ -0,0 +1,42 @@
+from frame_receiver.frame_notification import FrameNotification, FrameNotificationException
+from nose.tools import assert_equals, assert_raises, assert_true, assert_false
+
+def test_frame_notification_round_trip():
+    
+    ready = FrameNotification('frame_ready', frame_number=1234, buffer_id=7, frame_state=1,
+                              frame_timestamp_ns=1000)
+    encoded = ready.encode()
+    
+    # Encoded notifications are fixed size and distinguishable from JSON messages
+    assert_equals(len(encoded), 40)
+    assert_true(FrameNotification.is_binary(encoded))
+    assert_false(FrameNotification.is_binary('{"msg_type":"notify","msg_val":"frame_ready"}'))
+    
+    decoded = FrameNotification(from_str=encoded)
+    assert_equals(decoded.get_msg_val(), 'frame_ready')
+    assert_equals(decoded.frame_number, 1234)
+    assert_equals(decoded.buffer_id, 7)
+    assert_equals(decoded.frame_state, 1)
+    assert_equals(decoded.frame_timestamp_ns, 1000)
+    assert_equals(decoded.notify_timestamp_ns, ready.notify_timestamp_ns)
+    assert_equals(decoded.consumer_id, 0)
+    assert_false(decoded.is_spilled())
+    
+    release = FrameNotification('frame_release', frame_number=1234, buffer_id=7, consumer_id=3)
+    assert_equals(FrameNotification(from_str=release.encode()).consumer_id, 3)
+    
+    spilled = FrameNotification('frame_ready', frame_number=1235, buffer_id=8,
+                                frame_state=FrameNotification.FRAME_STATE_SPILLED)
+    assert_true(FrameNotification(from_str=spilled.encode()).is_spilled())
+
+def test_frame_notification_illegal():
+    
+    with assert_raises(FrameNotificationException):
+        FrameNotification('status')
+        
+    with assert_raises(FrameNotificationException):
+        FrameNotification(from_str='{}')
+        
+    bad_version = FrameNotification.Format.pack(FrameNotification.MAGIC, 99, 3, 0, 0, 0, 0, 0, 0)
+    with assert_raises(FrameNotificationException):
+        FrameNotification(from_str=bad_version)